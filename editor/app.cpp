@@ -14,6 +14,7 @@
 #include "editor/components/lights.hpp"
 #include "editor/components/mesh_renderer.hpp"
 #include "editor/components/gizmo_renderer.hpp"
+#include "editor/components/bounds.hpp"
 
 #include <imgui.h>
 #include <glm/gtx/transform.hpp>
@@ -49,34 +50,8 @@ int App::run() {
     std::unordered_map<std::string, engine::core::renderer::cache::MeshCacheId> default_meshes = _renderer->register_default_meshes();
     std::unordered_map<std::string, engine::core::renderer::cache::MaterialCacheId> default_materials = _renderer->register_default_materials();
 
-    // create scene // TODO: move to a helper function
-    _default_scene = std::move(engine::core::scene::Scene());
-
-    // default entity
-    engine::core::scene::Entity default_entity = _default_scene.create_entity();
-    _default_scene.add_component<components::Transform>(default_entity,
-        glm::vec3(0.0f, 0.0f, 0.0f),
-        glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
-        glm::vec3(1.0f, 1.0f, 1.0f)
-    );
-    _default_scene.add_component<components::MeshRenderer>(default_entity,
-        _renderer->mesh_id("sphere"),
-        _renderer->material_id("unlit")
-    );
-
-    engine::core::scene::Entity default_entity_2 = _default_scene.create_entity();
-    _default_scene.add_component<components::Transform>(default_entity_2,
-        glm::vec3(-2.0f, 0.0f, 0.0f),
-        glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
-        glm::vec3(1.0f, 1.0f, 1.0f)
-    );
-    _default_scene.add_component<components::MeshRenderer>(default_entity_2,
-        _renderer->mesh_id("cube"),
-        _renderer->material_id("unlit")
-    );
-
-    // set scene
-    _renderer->set_scene(&_default_scene);
+    // entities draw the placeholder until their meshes are up, the editor runs while they load
+    _scene_load = load_default_scene();
 
     // main loop
     auto last_time = std::chrono::high_resolution_clock::now();
@@ -112,7 +87,57 @@ int App::run() {
         
         _renderer->render();
     }
+
+    // loads still running resume into the scene, which must outlive them
+    _renderer->finish_loads();
     return 0;
 }
 
+engine::core::thread::Task<> App::load_default_scene() {
+    // create scene
+    _default_scene = std::move(engine::core::scene::Scene());
+
+    // default entity
+    engine::core::scene::Entity default_entity = _default_scene.create_entity();
+    _default_scene.add_component<components::Transform>(default_entity,
+        glm::vec3(0.0f, 0.0f, 0.0f),
+        glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+        glm::vec3(1.0f, 1.0f, 1.0f)
+    );
+    _default_scene.add_component<components::MeshRenderer>(default_entity,
+        _renderer->placeholder_mesh(),
+        _renderer->material_id("unlit")
+    );
+    _default_scene.add_component<components::Bounds>(default_entity);
+
+    engine::core::scene::Entity default_entity_2 = _default_scene.create_entity();
+    _default_scene.add_component<components::Transform>(default_entity_2,
+        glm::vec3(-2.0f, 0.0f, 0.0f),
+        glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+        glm::vec3(1.0f, 1.0f, 1.0f)
+    );
+    _default_scene.add_component<components::MeshRenderer>(default_entity_2,
+        _renderer->placeholder_mesh(),
+        _renderer->material_id("unlit")
+    );
+    _default_scene.add_component<components::Bounds>(default_entity_2);
+
+    // set scene
+    _renderer->set_scene(&_default_scene);
+
+    // both loads are underway before either is awaited
+    engine::core::thread::Task<engine::core::renderer::cache::MeshCacheId> sphere = _renderer->load_mesh("res/sphere.obj");
+    engine::core::thread::Task<engine::core::renderer::cache::MeshCacheId> cube = _renderer->load_mesh("res/cube.obj");
+
+    // back on the render thread; entities deleted in the meantime are skipped, failed loads keep the placeholder
+    auto assign = [this](engine::core::scene::Entity entity, engine::core::renderer::cache::MeshCacheId mesh_id) {
+        if (mesh_id == engine::core::memory::INVALID_SLOT_HANDLE) return;
+        for (auto [candidate, mesh_renderer] : _default_scene.view<components::MeshRenderer>()) {
+            if (candidate == entity) mesh_renderer.mesh_id = mesh_id;
+        }
+    };
+    assign(default_entity, co_await sphere);
+    assign(default_entity_2, co_await cube);
+}
+
 } // namespace editor
@@ -3,6 +3,7 @@
 
 #include "engine/core/window/window.hpp"
 #include "engine/core/scene/scene.hpp"
+#include "engine/core/thread/task.hpp"
 
 #include "editor/renderer/editor_renderer.hpp"
 
@@ -22,9 +23,13 @@ public:
     int run();
 
 private:
+    // resumes across frames as the scene's meshes finish loading
+    engine::core::thread::Task<> load_default_scene();
+
     std::unique_ptr<engine::core::window::Window> _window;
     std::unique_ptr<renderer::EditorRenderer> _renderer;
     engine::core::scene::Scene _default_scene;
+    engine::core::thread::Task<> _scene_load;
 };
 
 } // namespace editor
@@ -0,0 +1,61 @@
+#ifndef editor_components_BOUNDS_HPP
+#define editor_components_BOUNDS_HPP
+
+#include "editor/components/transform.hpp"
+
+#include "engine/core/renderer/cache/mesh_cache.hpp"
+#include "engine/import/mesh_bounds.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace editor::components {
+
+// world space bounds of an entity's mesh, refreshed whenever its Transform or mesh differs from the last update
+struct Bounds {
+    glm::vec3 min{0.0f};
+    glm::vec3 max{0.0f};
+    glm::vec3 center{0.0f};
+    float radius = 0.0f;
+
+    // what the world bounds were computed from
+    Transform source{};
+    engine::core::renderer::cache::MeshCacheId mesh = engine::core::memory::INVALID_SLOT_HANDLE;
+    bool valid = false;
+
+    bool stale(const Transform& transform, engine::core::renderer::cache::MeshCacheId mesh_id) const {
+        return !valid || mesh != mesh_id || !(source == transform);
+    }
+
+    // the box is the transformed local box's own box (arvo 1990), the sphere grows with the largest axis scale
+    void update(const Transform& transform, engine::core::renderer::cache::MeshCacheId mesh_id, const engine::import::MeshBounds& local) {
+        glm::mat4 m = transform.matrix();
+        glm::vec3 local_center = (local.min + local.max) * 0.5f;
+        glm::vec3 local_extent = (local.max - local.min) * 0.5f;
+
+        glm::vec3 world_center(m[3].x, m[3].y, m[3].z);
+        glm::vec3 world_extent(0.0f);
+        for (int column = 0; column < 3; ++column) {
+            for (int row = 0; row < 3; ++row) {
+                world_center[row] += m[column][row] * local_center[column];
+                world_extent[row] += std::abs(m[column][row]) * local_extent[column];
+            }
+        }
+        min = world_center - world_extent;
+        max = world_center + world_extent;
+
+        glm::vec4 sphere_center = m * glm::vec4(local.center, 1.0f);
+        center = glm::vec3(sphere_center.x, sphere_center.y, sphere_center.z);
+        radius = local.radius * std::max({ std::abs(transform.scale.x), std::abs(transform.scale.y), std::abs(transform.scale.z) });
+
+        source = transform;
+        mesh = mesh_id;
+        valid = true;
+    }
+};
+
+} // namespace editor::components
+
+#endif // editor_components_BOUNDS_HPP
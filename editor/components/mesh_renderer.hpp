@@ -15,6 +15,7 @@ struct MeshRenderer {
     engine::core::renderer::cache::MeshCacheId mesh_id;
     engine::core::renderer::cache::MaterialCacheId material_id;
     bool visible = true;
+    uint32_t lod = 0;   // picked each frame from the on-screen size, kept between frames for hysteresis
 };
 
 } // namespace editor::components
@@ -16,6 +16,10 @@ struct Transform {
     glm::mat4 matrix() const noexcept {
         return glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
     }
+
+    bool operator==(const Transform& other) const noexcept {
+        return position == other.position && rotation == other.rotation && scale == other.scale;
+    }
 };
 
 } // namespace editor::components
@@ -1,6 +1,7 @@
 #include "editor_gui.hpp"
 
 #include "engine/core/graphics/device.hpp"
+#include "engine/drivers/vulkan/convert_vulkan.hpp"
 
 #include "panels/viewport_panel.hpp"
 #include "panels/inspector_panel.hpp"
@@ -65,6 +66,16 @@ EditorGui::EditorGui(const engine::core::graphics::Instance& instance,
     init_info.ImageCount = 3;
     init_info.PipelineInfoMain.RenderPass = static_cast<VkRenderPass>(pipeline.native_render_pass());
     init_info.PipelineInfoMain.Subpass = 0;
+    if (init_info.PipelineInfoMain.RenderPass == VK_NULL_HANDLE) {
+        // pipeline uses dynamic rendering
+        _color_format = engine::drivers::vulkan::ToVkFormat(pipeline.color_format());
+
+        init_info.UseDynamicRendering = true;
+        init_info.PipelineInfoMain.PipelineRenderingCreateInfo = {};
+        init_info.PipelineInfoMain.PipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        init_info.PipelineInfoMain.PipelineRenderingCreateInfo.colorAttachmentCount = 1;
+        init_info.PipelineInfoMain.PipelineRenderingCreateInfo.pColorAttachmentFormats = &_color_format;
+    }
     init_info.PipelineInfoMain.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
     init_info.CheckVkResultFn = CheckVkResult;
 
@@ -72,7 +83,7 @@ EditorGui::EditorGui(const engine::core::graphics::Instance& instance,
 
     _is_first_frame = true;
 
-    // _panels.emplace_back(std::make_unique<panels::SceneViewPanel>());
+    _panels.emplace_back(std::make_unique<panels::ViewportPanel>());
     _panels.emplace_back(std::make_unique<panels::InspectorPanel>());
     _panels.emplace_back(std::make_unique<panels::ConsolePanel>());
 }
@@ -37,6 +37,9 @@ struct GuiContext {
         ImVec2 out_size{0, 0};
         ImVec2 out_pos{0, 0};
     } scene_view;
+
+    // shown in the viewport overlay
+    engine::core::graphics::DescriptorStats descriptor_stats{};
 };
 
 class EditorGui {
@@ -52,6 +55,7 @@ public:
 
 private:
     VkDevice _device;
+    VkFormat _color_format = VK_FORMAT_UNDEFINED;
 
     bool _is_first_frame = false;
     std::vector<std::unique_ptr<panels::Panel>> _panels;
@@ -3,6 +3,7 @@
 #include "editor/gui/editor_gui.hpp"
 #include "editor/components/transform.hpp"
 #include "editor/components/mesh_renderer.hpp"
+#include "editor/components/bounds.hpp"
 
 #include "engine/core/scene/scene.hpp"
 
@@ -36,6 +37,13 @@ void InspectorPanel::on_gui(GuiContext& context) {
             ImGui::SeparatorText("MeshRenderer");
             ImGui::Text("Mesh: %d", m.mesh_id);
             ImGui::Text("Material: %d", m.material_id);
+            ImGui::Text("LOD: %u", m.lod);
+        } else if (type == typeid(components::Bounds)) {
+            auto& b = *reinterpret_cast<components::Bounds*>(ptr);
+            ImGui::SeparatorText("Bounds");
+            ImGui::Text("Min: %.2f %.2f %.2f", b.min.x, b.min.y, b.min.z);
+            ImGui::Text("Max: %.2f %.2f %.2f", b.max.x, b.max.y, b.max.z);
+            ImGui::Text("Sphere: %.2f %.2f %.2f r %.2f", b.center.x, b.center.y, b.center.z, b.radius);
         } else {
             ImGui::SeparatorText(type.name());
             ImGui::TextDisabled("(no component drawer implemented)");
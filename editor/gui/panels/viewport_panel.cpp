@@ -39,6 +39,9 @@ void ViewportPanel::on_gui(GuiContext& context) {
     ImGui::Button("Select");
     ImGui::Button("Move");
     ImGui::Button("Rotate");
+    ImGui::Separator();
+    ImGui::Text("Descriptor pools: %u", context.descriptor_stats.pool_count);
+    ImGui::Text("Descriptor sets: %u live, %u free", context.descriptor_stats.sets_allocated, context.descriptor_stats.sets_recycled);
 
     // clamp position
     if (avail.x > 1 && avail.y > 1) {
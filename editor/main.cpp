@@ -1,9 +1,29 @@
 #include <iostream>
+#include <string>
 
 #include "app.hpp"
 #include "engine/core/debug/logger.hpp"
+#include "engine/import/mesh.hpp"
+#include "engine/import/meshlet.hpp"
+#include "engine/import/texture_compress.hpp"
+
+int main(int argc, char** argv) {
+    // editor --bench-obj <file.obj> compares obj import paths and exits
+    if (argc == 3 && std::string(argv[1]) == "--bench-obj") {
+        engine::import::BenchmarkObjImport(argv[2]);
+        return 0;
+    }
+    // editor --bench-bc <image> logs block compression throughput and quality and exits
+    if (argc == 3 && std::string(argv[1]) == "--bench-bc") {
+        engine::import::BenchmarkTextureCompression(argv[2]);
+        return 0;
+    }
+    // editor --check-culling [seed] compares meshlet culling against per triangle results and exits
+    if ((argc == 2 || argc == 3) && std::string(argv[1]) == "--check-culling") {
+        uint32_t seed = (argc == 3) ? static_cast<uint32_t>(std::stoul(argv[2])) : 1;
+        return engine::import::CheckMeshletCulling(200, seed) ? 0 : 1;
+    }
 
-int main() {
     editor::App app;
     engine::core::debug::Logger::get_singleton();
 
@@ -2,18 +2,31 @@
 
 #include "engine/drivers/vulkan/vulkan_instance.hpp"
 #include "engine/import/mesh.hpp"
+#include "engine/import/cooked_mesh.hpp"
+#include "engine/import/cooked_texture.hpp"
+#include "engine/import/vertex_quantize.hpp"
 
 #include "engine/core/renderer/frame_graph/render_pass.hpp"
 #include "engine/core/renderer/frame_graph/attachment.hpp"
+#include "engine/core/renderer/lod_selector.hpp"
+#include "engine/core/thread/thread_pool.hpp"
 
 #include "engine/core/debug/logger.hpp"
 #include "engine/core/debug/assert.hpp"
 
 #include "editor/gui/editor_gui.hpp"
+#include "editor/renderer/editor_scene_view_renderer.hpp"
+#include "editor/components/transform.hpp"
+#include "editor/components/mesh_renderer.hpp"
+#include "editor/components/bounds.hpp"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
 using namespace engine::core;
 using namespace engine::core::graphics;
 using namespace engine::core::renderer;
@@ -21,6 +34,37 @@ using namespace engine::core::renderer::framegraph;
 
 namespace editor::renderer {
 
+namespace {
+
+// a unit cube, built in memory so it is drawable before anything has loaded
+engine::import::ObjModel PlaceholderModel() {
+    engine::import::ObjMesh mesh;
+    mesh.name = "placeholder";
+    for (int axis = 0; axis < 3; ++axis) {
+        for (float sign : { -1.0f, 1.0f }) {
+            glm::vec3 normal(0.0f), u(0.0f), v(0.0f);
+            normal[axis] = sign;
+            u[(axis + 1) % 3] = 1.0f;
+            v[(axis + 2) % 3] = sign; // u x v points along the normal, so every face winds counter clockwise
+
+            const uint32_t base = static_cast<uint32_t>(mesh.vertices.size());
+            const glm::vec2 corners[4] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+            for (const glm::vec2& corner : corners) {
+                mesh.vertices.push_back(engine::import::ObjVertex{
+                    0.5f * (normal + corner.x * u + corner.y * v), normal, 0.5f * (corner + 1.0f) });
+            }
+            mesh.indices.insert(mesh.indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+        }
+    }
+    mesh.bounds = engine::import::ComputeMeshBounds(mesh.vertices);
+
+    engine::import::ObjModel model;
+    model.meshes.push_back(std::move(mesh));
+    return model;
+}
+
+} // namespace
+
 EditorRenderer::EditorRenderer(const window::Window& main_window) {
     _width = main_window.width();
     _height = main_window.height();
@@ -29,20 +73,34 @@ EditorRenderer::EditorRenderer(const window::Window& main_window) {
     _instance = std::make_unique<engine::drivers::vulkan::VulkanInstance>();
     _device = _instance->create_device(main_window);
 
+    // unchanged assets come straight from the cooked cache
+    _asset_database = std::make_unique<engine::import::AssetDatabase>(ASSET_CACHE_DIRECTORY);
+    const engine::import::TextureCompression texture_compression = _device->block_compression_supported()
+        ? engine::import::TextureCompression::BC7 : engine::import::TextureCompression::NONE;
+    _asset_database->register_importer("mesh", engine::import::MeshImporter(MESH_LAYOUT));
+    _asset_database->register_importer("color", engine::import::TextureImporter(true, texture_compression));
+    _asset_database->register_importer("linear", engine::import::TextureImporter(false, texture_compression));
+
+    // textures and material parameters indexed per draw
+    if (_device->bindless_supported()) {
+        _bindless_table = _device->create_bindless_table(BINDLESS_MAX_TEXTURES, BINDLESS_MAX_MATERIALS, sizeof(MaterialParams));
+    }
+
     // create caches
     _mesh_cache = std::make_unique<engine::core::renderer::cache::MeshCache>(*_device);
     _shader_cache = std::make_unique<engine::core::renderer::cache::ShaderCache>(*_device);
-    _material_cache = std::make_unique<engine::core::renderer::cache::MaterialCache>(*_device);
+    _texture_cache = std::make_unique<engine::core::renderer::cache::TextureCache>(*_device, _bindless_table.get());
+    _material_cache = std::make_unique<engine::core::renderer::cache::MaterialCache>(*_device, _bindless_table.get(), _texture_cache.get());
     _pipeline_cache = std::make_unique<engine::core::renderer::cache::PipelineCache>(*_device);
 
     // register imgui shaders
     engine::core::renderer::cache::ShaderCacheId imgui_vid = _shader_cache->register_shader(
         ShaderStageFlags::VERTEX,
-        "shaders/imgui.vert.spv"
+        _asset_database->cook("shaders/imgui.vert.spv")
     );
     engine::core::renderer::cache::ShaderCacheId imgui_fid = _shader_cache->register_shader(
         ShaderStageFlags::FRAGMENT,
-        "shaders/imgui.frag.spv"
+        _asset_database->cook("shaders/imgui.frag.spv")
     );
 
     // create gui pipeline
@@ -97,6 +155,15 @@ EditorRenderer::EditorRenderer(const window::Window& main_window) {
         main_window
     );
 
+    register_default_descriptor_layouts();
+    register_default_shaders();
+    register_default_pipelines();
+
+    _scene_view_uniforms = std::make_unique<ViewUniforms>(
+        *_pipeline_cache->get(_named_pipelines["mesh"]),
+        *_named_descriptor_layouts["global_ubo"]
+    );
+
     // create frame graph
     _frame_graph = std::make_unique<FrameGraph>(
         _device.get(),
@@ -104,13 +171,24 @@ EditorRenderer::EditorRenderer(const window::Window& main_window) {
         *_pipeline_cache.get()
     );
 
+    // scene view passes, drawn into the texture the viewport panel shows
+    _scene_view = std::make_unique<EditorSceneViewRenderer>(*this, _width, _height);
+    AttachmentId scene_color = _scene_view->register_passes(*_frame_graph);
+    // lods are picked for the view they are drawn in
+    set_scene_camera(&_scene_view->camera());
+
     // present pass
     engine::core::renderer::framegraph::RenderPass gui_pass;
     gui_pass.set_clear_color(glm::vec4(0.05f, 0.05f, 0.05f, 1.0f));
+    gui_pass.add_read_color(scene_color);
 
     gui_pass.set_execute([this](engine::core::renderer::framegraph::RenderPassContext& context) {
         gui::GuiContext gui_context;
         gui_context.command_buffer = context.command_buffer;
+        gui_context.scene_view.texture_id = _scene_view->texture_id();
+        gui_context.scene_view.scene_state = _scene_state;
+        gui_context.scene_view.camera = &_scene_view->camera();
+        gui_context.descriptor_stats = _device->descriptor_stats();
 
         _editor_gui->on_gui(gui_context);
     });
@@ -125,13 +203,10 @@ EditorRenderer::EditorRenderer(const window::Window& main_window) {
     _frame_graph->add_pass(gui_pass);
 
     _frame_graph->bake();
-
-    register_default_descriptor_layouts();
-    register_default_shaders();
-    register_default_pipelines();
 }
 
 EditorRenderer::~EditorRenderer() {
+    finish_loads();
     _device->wait_idle();
 }
 
@@ -144,15 +219,66 @@ void EditorRenderer::resize(uint32_t width, uint32_t height) {
 
     _device->wait_idle();
     _main_swapchain->resize(width, height);
+    _scene_view->resize(*_frame_graph, width, height);
     _frame_graph->bake();
 }
 
 void EditorRenderer::render() {
+    // recycle the oldest frame's uniform memory
+    _device->next_frame();
+
+    // textures that finished loading go up with their coarse mips, streaming ones gain their next levels
+    _texture_cache->next_frame();
+    // materials sampling textures that moved follow them to new table slots
+    _material_cache->next_frame();
+
+    if (_scene_state.scene) update_bounds();
+    if (_scene_state.scene && _scene_state.camera) select_lods(*_scene_state.camera);
+
+    // camera constants for every scene pass
+    _scene_view->update(_scene_state.scene);
+
     // execute frame graph
     _frame_graph->execute();
 
     // present swapchain
     _main_swapchain->present();
+
+    // evict meshes that have not been drawn recently if over budget
+    _mesh_cache->next_frame();
+
+    // loads waiting on the render thread resume now that their meshes are published
+    _frame_scheduler.run();
+
+    // assets released by other threads since the last frame; pipelines and materials may still be in flight
+    _shader_cache->reclaim();
+    if (_pipeline_cache->reclaimable() || _material_cache->reclaimable()) {
+        _device->wait_idle();
+        _pipeline_cache->reclaim();
+        _material_cache->reclaim();
+    }
+}
+
+void EditorRenderer::update_bounds() {
+    for (auto [entity, transform, mesh_renderer, bounds] :
+         _scene_state.scene->view<components::Transform, components::MeshRenderer, components::Bounds>())
+    {
+        if (!bounds.stale(transform, mesh_renderer.mesh_id)) continue;
+        bounds.update(transform, mesh_renderer.mesh_id, _mesh_cache->bounds(mesh_renderer.mesh_id));
+    }
+}
+
+void EditorRenderer::select_lods(const engine::core::scene::Camera& camera) {
+    for (auto [entity, transform, mesh_renderer] :
+         _scene_state.scene->view<components::Transform, components::MeshRenderer>())
+    {
+        if (!mesh_renderer.visible) continue;
+
+        // lod errors are in object space, the largest scale axis bounds how far they stretch in the world
+        float scale = std::max({ std::abs(transform.scale.x), std::abs(transform.scale.y), std::abs(transform.scale.z) });
+        float pixels_per_unit = camera.pixels_per_unit(transform.position) * scale;
+        mesh_renderer.lod = SelectLod(_mesh_cache->lods(mesh_renderer.mesh_id), pixels_per_unit, mesh_renderer.lod);
+    }
 }
 
 void EditorRenderer::register_default_descriptor_layouts() {
@@ -161,7 +287,7 @@ void EditorRenderer::register_default_descriptor_layouts() {
                 .add_binding(
                     engine::core::graphics::DescriptorLayoutBinding{}
                         .set_binding(0)
-                        .set_type(DescriptorType::UNIFORM_BUFFER)
+                        .set_type(DescriptorType::UNIFORM_BUFFER_DYNAMIC)
                         .set_visibility(ShaderStageFlags::VERTEX)
                 )
     );
@@ -181,53 +307,31 @@ void EditorRenderer::register_default_descriptor_layouts() {
                 .add_binding(
                     DescriptorLayoutBinding{}
                         .set_binding(0)
-                        .set_type(DescriptorType::UNIFORM_BUFFER)
+                        .set_type(DescriptorType::UNIFORM_BUFFER_DYNAMIC)
                         .set_visibility(ShaderStageFlags::VERTEX | ShaderStageFlags::FRAGMENT)
                 )
     );
 }
 
 void EditorRenderer::register_default_shaders() {
-    _named_shaders["mesh_vert"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::VERTEX, "shaders/mesh.vert.spv");
-    _named_shaders["mesh_frag"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::FRAGMENT, "shaders/mesh.frag.spv");
+    _named_shaders["mesh_vert"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::VERTEX, _asset_database->cook("shaders/mesh.vert.spv"));
+    _named_shaders["mesh_frag"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::FRAGMENT, _asset_database->cook("shaders/mesh.frag.spv"));
+    _named_shaders["mesh_normal_frag"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::FRAGMENT, _asset_database->cook("shaders/mesh_normal.frag.spv"));
 
-    _named_shaders["mesh_outline_vert"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::VERTEX, "shaders/mesh_outline.vert.spv");
-    _named_shaders["mesh_outline_frag"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::FRAGMENT, "shaders/mesh_outline.frag.spv");
+    _named_shaders["mesh_outline_vert"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::VERTEX, _asset_database->cook("shaders/mesh_outline.vert.spv"));
+    _named_shaders["mesh_outline_frag"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::FRAGMENT, _asset_database->cook("shaders/mesh_outline.frag.spv"));
 
-    _named_shaders["mesh_pick_vert"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::VERTEX, "shaders/mesh_pick.vert.spv");
-    _named_shaders["mesh_pick_frag"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::FRAGMENT, "shaders/mesh_pick.frag.spv");
+    _named_shaders["mesh_pick_vert"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::VERTEX, _asset_database->cook("shaders/mesh_pick.vert.spv"));
+    _named_shaders["mesh_pick_frag"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::FRAGMENT, _asset_database->cook("shaders/mesh_pick.frag.spv"));
 
-    _named_shaders["gizmo_vert"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::VERTEX, "shaders/gizmo.vert.spv");
-    _named_shaders["gizmo_frag"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::FRAGMENT, "shaders/gizmo.frag.spv");
+    _named_shaders["gizmo_vert"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::VERTEX, _asset_database->cook("shaders/gizmo.vert.spv"));
+    _named_shaders["gizmo_frag"] = _shader_cache->register_shader(engine::core::graphics::ShaderStageFlags::FRAGMENT, _asset_database->cook("shaders/gizmo.frag.spv"));
 }
 
 void EditorRenderer::register_default_pipelines() {
-    // vertex bindings
-    engine::core::graphics::VertexBindingDescription position_binding =
-        engine::core::graphics::VertexBindingDescription{}
-            .set_binding(0)
-            .set_stride(sizeof(engine::import::ObjVertex))
-            .set_attributes({
-                engine::core::graphics::VertexAttribute{}
-                    .set_location(0)
-                    .set_format(VertexFormat::FLOAT_3)
-                    .set_offset(offsetof(engine::import::ObjVertex, engine::import::ObjVertex::position))
-            });
-
-    VertexBindingDescription position_normal_binding =
-        VertexBindingDescription{}
-            .set_binding(0)
-            .set_stride(sizeof(engine::import::ObjVertex))
-            .set_attributes({
-                VertexAttribute{}
-                    .set_location(0)
-                    .set_format(VertexFormat::FLOAT_3)
-                    .set_offset(offsetof(engine::import::ObjVertex, engine::import::ObjVertex::position)),
-                VertexAttribute{}
-                    .set_location(1)
-                    .set_format(VertexFormat::FLOAT_3)
-                    .set_offset(offsetof(engine::import::ObjVertex, engine::import::ObjVertex::normal))
-            });
+    // vertex bindings, binding 0 is the position stream and binding 1 the other attributes
+    std::vector<VertexBindingDescription> mesh_bindings = engine::import::QuantizedVertexLayout(MESH_LAYOUT);
+    std::vector<VertexBindingDescription> position_bindings = { mesh_bindings[0] };
 
     // attachment formats
     std::vector<ImageAttachmentInfo> color_depth_attachments = {
@@ -241,7 +345,12 @@ void EditorRenderer::register_default_pipelines() {
         .set_depth_write(true)
         .set_blending(false)
         .set_cull_mode(CullMode::BACK)
-        .set_push_constant(sizeof(glm::mat4), ShaderStageFlags::VERTEX);
+        .set_push_constant(sizeof(ScenePushConstants), ShaderStageFlags::VERTEX | ShaderStageFlags::FRAGMENT)
+        .set_bindless(_bindless_table.get());
+
+    // mesh.frag reads materials from the bindless table, without one meshes are shaded by their normals
+    const engine::core::renderer::cache::ShaderCacheId mesh_frag = _bindless_table
+        ? _named_shaders["mesh_frag"] : _named_shaders["mesh_normal_frag"];
 
     PipelineConfig outline_cfg = PipelineConfig{}
         .set_depth_test(true)
@@ -261,9 +370,9 @@ void EditorRenderer::register_default_pipelines() {
     // register pipelines
     _named_pipelines["mesh"] = _pipeline_cache->register_pipeline(
         *_shader_cache->get(_named_shaders["mesh_vert"]),
-        *_shader_cache->get(_named_shaders["mesh_frag"]),
-        *_named_descriptor_layouts["per_object_ubo"],
-        position_normal_binding,
+        *_shader_cache->get(mesh_frag),
+        *_named_descriptor_layouts["global_ubo"],
+        mesh_bindings,
         color_depth_attachments,
         mesh_cfg
     );
@@ -271,8 +380,8 @@ void EditorRenderer::register_default_pipelines() {
     _named_pipelines["outline"] = _pipeline_cache->register_pipeline(
         *_shader_cache->get(_named_shaders["mesh_outline_vert"]),
         *_shader_cache->get(_named_shaders["mesh_outline_frag"]),
-        *_named_descriptor_layouts["per_object_ubo"],
-        position_normal_binding,
+        *_named_descriptor_layouts["global_ubo"],
+        mesh_bindings,
         color_depth_attachments,
         outline_cfg
     );
@@ -280,38 +389,54 @@ void EditorRenderer::register_default_pipelines() {
     _named_pipelines["gizmo"] = _pipeline_cache->register_pipeline(
         *_shader_cache->get(_named_shaders["gizmo_vert"]),
         *_shader_cache->get(_named_shaders["gizmo_frag"]),
-        *_named_descriptor_layouts["per_object_ubo"],
-        position_binding,
+        *_named_descriptor_layouts["global_ubo"],
+        position_bindings,
         color_depth_attachments,
         gizmo_cfg
     );
 }
 
 std::unordered_map<std::string, engine::core::renderer::cache::MeshCacheId> EditorRenderer::register_default_meshes() {
-    engine::import::ObjModel sphere_model = engine::import::ReadObj("res/sphere.obj");
-    _named_meshes["sphere"] = _mesh_cache->register_mesh(sphere_model);
+    _named_meshes["placeholder"] = _mesh_cache->register_mesh(PlaceholderModel(), MESH_LAYOUT);
+    return _named_meshes;
+}
 
-    engine::import::ObjModel cube_model = engine::import::ReadObj("res/cube.obj");
-    _named_meshes["cube"] = _mesh_cache->register_mesh(cube_model);
+engine::core::thread::Task<engine::core::renderer::cache::MeshCacheId> EditorRenderer::load_mesh(std::string source_path) {
+    ++_loads_in_flight;
 
-    return _named_meshes;
+    // cooked on first launch, later launches map the cached .jmesh file; either way off the render thread
+    co_await engine::core::thread::ThreadPool::get_singleton().schedule();
+    const std::string cooked_path = _asset_database->cook(source_path, "mesh");
+    engine::core::renderer::cache::MeshCacheId id = cooked_path.empty()
+        ? engine::core::memory::INVALID_SLOT_HANDLE : _mesh_cache->register_mesh(cooked_path);
+
+    // meshes registered off the render thread are uploaded and published by the cache's next_frame
+    do {
+        co_await _frame_scheduler.next_frame();
+    } while (_mesh_cache->pending(id));
+
+    if (!_mesh_cache->contains(id)) {
+        engine::core::debug::Logger::get_singleton().error("Failed to load mesh {}", source_path);
+        id = engine::core::memory::INVALID_SLOT_HANDLE;
+    }
+    --_loads_in_flight;
+    co_return id;
 }
 
-std::unordered_map<std::string, engine::core::renderer::cache::MaterialCacheId> EditorRenderer::register_default_materials() {
-    {
-        const graphics::Pipeline* pipeline = _pipeline_cache->get(_named_pipelines["unlit"]);
-        const engine::core::graphics::DescriptorLayoutDescription layout_desc = engine::core::graphics::DescriptorLayoutDescription{}
-            .add_binding(
-                engine::core::graphics::DescriptorLayoutBinding{}
-                    .set_binding(0)
-                    .set_type(DescriptorType::UNIFORM_BUFFER)
-                    .set_visibility(ShaderStageFlags::VERTEX)
-            );
-
-        size_t ubo_size = sizeof(glm::mat4) * 2;
-        _named_materials["unlit"] = _material_cache->register_material(*pipeline, layout_desc, ubo_size);
+void EditorRenderer::finish_loads() {
+    while (_loads_in_flight.load() > 0) {
+        _mesh_cache->next_frame();
+        _frame_scheduler.run();
+        std::this_thread::yield();
     }
-    return _named_shaders;
+}
+
+std::unordered_map<std::string, engine::core::renderer::cache::MaterialCacheId> EditorRenderer::register_default_materials() {
+    // scene materials live in the bindless table, without one the scene pipelines ignore them
+    MaterialParams unlit;
+    _named_materials["unlit"] = _bindless_table
+        ? _material_cache->register_material(&unlit) : engine::core::memory::INVALID_SLOT_HANDLE;
+    return _named_materials;
 }
 
 } // namespace editor::renderer
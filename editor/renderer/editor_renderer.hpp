@@ -6,16 +6,25 @@
 #include "engine/core/graphics/pipeline.hpp"
 #include "engine/core/graphics/render_target.hpp"
 #include "engine/core/graphics/descriptor_set_layout.hpp"
+#include "engine/core/graphics/bindless_table.hpp"
 
 #include "engine/core/renderer/renderer.hpp"
+#include "engine/core/renderer/view_uniforms.hpp"
 #include "engine/core/renderer/cache/shader_cache.hpp"
 #include "engine/core/renderer/cache/mesh_cache.hpp"
+#include "engine/core/renderer/cache/texture_cache.hpp"
 #include "engine/core/renderer/cache/material_cache.hpp"
 #include "engine/core/renderer/cache/pipeline_cache.hpp"
 #include "engine/core/renderer/frame_graph/frame_graph.hpp"
 
 #include "engine/core/window/window.hpp"
 #include "engine/core/scene/scene.hpp"
+#include "engine/core/scene/camera.hpp"
+
+#include "engine/core/thread/task.hpp"
+#include "engine/core/thread/frame_scheduler.hpp"
+
+#include "engine/import/asset_database.hpp"
 
 #include "engine/core/debug/assert.hpp"
 #include "engine/core/debug/logger.hpp"
@@ -27,6 +36,7 @@
 #include <cstdint>
 #include <unordered_map>
 #include <optional>
+#include <atomic>
 
 namespace editor::gui {
 
@@ -36,9 +46,18 @@ class EditorGui;
 
 namespace editor::renderer {
 
+class EditorSceneViewRenderer;
+
+// push constants of the scene pipelines, PushConstants in mesh.vert and mesh.frag
+struct ScenePushConstants {
+    glm::mat4 model;
+    uint32_t material_index;    // bindless table slot, unused without a table
+};
+
 struct SceneState {
     engine::core::scene::Scene* scene;
     std::optional<engine::core::scene::Entity> selected_entity;
+    const engine::core::scene::Camera* camera = nullptr;
 };
 
 class EditorRenderer final : public engine::core::renderer::Renderer {
@@ -49,6 +68,7 @@ public:
     void resize(uint32_t width, uint32_t height);
     void render();
 
+    // only the in-memory placeholder, files come through load_mesh
     std::unordered_map<std::string, engine::core::renderer::cache::MeshCacheId> register_default_meshes();
     std::unordered_map<std::string, engine::core::renderer::cache::MaterialCacheId> register_default_materials();
 
@@ -56,12 +76,32 @@ public:
         _scene_state.scene = scene;
     }
 
+    // the camera lods are picked for, none keeps every mesh at its current lod
+    void set_scene_camera(const engine::core::scene::Camera* camera) {
+        _scene_state.camera = camera;
+    }
+
     engine::core::renderer::cache::MeshCacheId mesh_id(const std::string& mesh) const {
         auto it = _named_meshes.find(mesh);
         ENGINE_ASSERT(it != _named_meshes.end(), "Mesh not found in mesh cache entries: {}", mesh);
         return it->second;
     }
 
+    // drawn in place of meshes that are still loading
+    engine::core::renderer::cache::MeshCacheId placeholder_mesh() const { return mesh_id("placeholder"); }
+
+    // reads, cooks and maps the mesh on a worker, and resumes the awaiter on the render thread at the frame
+    // boundary where the mesh became drawable. invalid when the source cannot be loaded
+    engine::core::thread::Task<engine::core::renderer::cache::MeshCacheId> load_mesh(std::string source_path);
+    // runs frame boundaries until every load and whatever awaited it has resumed; blocks, for shutdown
+    void finish_loads();
+
+    engine::core::renderer::cache::PipelineCacheId pipeline_id(const std::string& pipeline) const {
+        auto it = _named_pipelines.find(pipeline);
+        ENGINE_ASSERT(it != _named_pipelines.end(), "Pipeline not found in pipeline cache entries: {}", pipeline);
+        return it->second;
+    }
+
     engine::core::renderer::cache::ShaderCacheId shader_id(const std::string& shader) const {
         auto it = _named_shaders.find(shader);
         ENGINE_ASSERT(it != _named_shaders.end(), "Shader not found in shader cache entries: {}", shader);
@@ -74,18 +114,52 @@ public:
         return it->second;
     }
 
+    const engine::core::graphics::DescriptorSetLayout& descriptor_layout(const std::string& layout) const {
+        auto it = _named_descriptor_layouts.find(layout);
+        ENGINE_ASSERT(it != _named_descriptor_layouts.end(), "Descriptor layout not found: {}", layout);
+        return *it->second;
+    }
+
     engine::core::graphics::Device* device() const { return _device.get(); }
+    engine::core::renderer::ViewUniforms& scene_view_uniforms() const { return *_scene_view_uniforms; }
+    // null when the device has no descriptor indexing
+    engine::core::graphics::BindlessTable* bindless_table() const { return _bindless_table.get(); }
 
+    // importers: "mesh" for obj files, "color" and "linear" for images; assets without one load as they are
+    engine::import::AssetDatabase& asset_database() const { return *_asset_database; }
     engine::core::renderer::cache::MeshCache& mesh_cache() const { return *_mesh_cache; }
+    engine::core::renderer::cache::TextureCache& texture_cache() const { return *_texture_cache; }
     engine::core::renderer::cache::ShaderCache& shader_cache() const { return *_shader_cache; }
     engine::core::renderer::cache::MaterialCache& material_cache() const { return *_material_cache; }
     engine::core::renderer::cache::PipelineCache& pipeline_cache() const { return *_pipeline_cache; }
 
 private:
+    static constexpr uint32_t BINDLESS_MAX_TEXTURES = 4096;
+    static constexpr uint32_t BINDLESS_MAX_MATERIALS = 4096;
+    // cooked assets and the database, beside the executable's res and shaders folders
+    static constexpr const char* ASSET_CACHE_DIRECTORY = "cache";
+    // float attributes with positions in their own stream, so position-only passes fetch 12 bytes a vertex.
+    // every editor mesh pipeline is built for this layout, the mesh, outline and pick shaders read float attributes
+    static constexpr engine::import::VertexQuantization MESH_LAYOUT = {
+        engine::import::PositionEncoding::FLOAT, false, false, true
+    };
+
+    // MaterialParams in mesh.frag, std430
+    struct MaterialParams {
+        glm::vec4 base_color{1.0f};
+        uint32_t albedo_texture = engine::core::graphics::INVALID_BINDLESS_INDEX;
+        uint32_t _pad[3]{};
+    };
+
     void register_default_descriptor_layouts();
     void register_default_shaders();
     void register_default_pipelines();
 
+    // recomputes world bounds of entities whose transform or mesh changed since the last frame
+    void update_bounds();
+    // moves every mesh renderer in the scene to the lod its on-screen size calls for
+    void select_lods(const engine::core::scene::Camera& camera);
+
     uint32_t _width = 0;
     uint32_t _height = 0;
 
@@ -94,19 +168,29 @@ private:
     std::unique_ptr<engine::core::graphics::Device> _device;
 
     // resource caches
+    std::unique_ptr<engine::import::AssetDatabase> _asset_database;
     std::unordered_map<std::string, const engine::core::graphics::DescriptorSetLayout*> _named_descriptor_layouts;
 
     std::unique_ptr<engine::core::renderer::cache::MeshCache> _mesh_cache;
     std::unordered_map<std::string, engine::core::renderer::cache::MeshCacheId> _named_meshes;
+    engine::core::thread::FrameScheduler _frame_scheduler;
+    std::atomic<uint32_t> _loads_in_flight{ 0 };
 
     std::unique_ptr<engine::core::renderer::cache::ShaderCache> _shader_cache;
     std::unordered_map<std::string, engine::core::renderer::cache::ShaderCacheId> _named_shaders;
 
+    std::unique_ptr<engine::core::renderer::cache::PipelineCache> _pipeline_cache;
+    std::unordered_map<std::string, engine::core::renderer::cache::PipelineCacheId> _named_pipelines;
+
+    // textures and material parameters indexed per draw, shared by the scene pipelines at set 1
+    std::unique_ptr<engine::core::graphics::BindlessTable> _bindless_table;
+    // declared after the table, their textures and materials give their slots back before the table goes
+    std::unique_ptr<engine::core::renderer::cache::TextureCache> _texture_cache;
     std::unique_ptr<engine::core::renderer::cache::MaterialCache> _material_cache;
     std::unordered_map<std::string, engine::core::renderer::cache::MaterialCacheId> _named_materials;
 
-    std::unique_ptr<engine::core::renderer::cache::PipelineCache> _pipeline_cache;
-    std::unordered_map<std::string, engine::core::renderer::cache::PipelineCacheId> _named_pipelines;
+    // scene camera constants, shared by every scene pass at set 0
+    std::unique_ptr<engine::core::renderer::ViewUniforms> _scene_view_uniforms;
 
     // graphics resources
     std::unique_ptr<engine::core::graphics::DescriptorSetLayout> _vertex_ubo_layout;
@@ -124,6 +208,8 @@ private:
     engine::core::renderer::cache::PipelineCacheId _imgui_pipeline_id{};
     std::unique_ptr<engine::core::graphics::DescriptorSetLayout> _imgui_layout;
     std::unique_ptr<gui::EditorGui> _editor_gui;
+    // after the gui, its viewport texture is unregistered before the gui shuts down
+    std::unique_ptr<EditorSceneViewRenderer> _scene_view;
 
     SceneState _scene_state;
 };
@@ -2,58 +2,45 @@
 
 #include "editor/components/transform.hpp"
 #include "editor/components/mesh_renderer.hpp"
-#include "editor/components/gizmo_renderer.hpp"
-#include "engine/core/debug/logger.hpp"
+#include "engine/core/renderer/frame_graph/render_pass.hpp"
+#include "engine/core/renderer/frame_graph/attachment.hpp"
+#include "engine/core/debug/assert.hpp"
 #include "editor_renderer.hpp"
 
-#include <imgui_internal.h>
-#include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_vulkan.h>
 
 #include <algorithm>
 
 namespace editor::renderer {
 
+namespace {
+
+// the attachments the scene pipelines are built for
+constexpr engine::core::graphics::ImageFormat COLOR_FORMAT = engine::core::graphics::ImageFormat::RGBA8_UNORM;
+constexpr engine::core::graphics::ImageFormat DEPTH_FORMAT = engine::core::graphics::ImageFormat::D32_FLOAT;
+
+} // namespace
+
 EditorSceneViewRenderer::EditorSceneViewRenderer(
     EditorRenderer& editor_renderer,
     uint32_t width,
     uint32_t height)
-    : _width(width),
-      _height(height),
-      _device(editor_renderer.device()),
-      _gui(editor_renderer.gui()),
+    : _device(editor_renderer.device()),
       _pipeline_cache(editor_renderer.pipeline_cache()),
       _mesh_cache(editor_renderer.mesh_cache()),
-      _material_cache(editor_renderer.material_cache())
+      _material_cache(editor_renderer.material_cache()),
+      _bindless(editor_renderer.bindless_table()),
+      _view_uniforms(editor_renderer.scene_view_uniforms()),
+      _width(width),
+      _height(height)
 {
-    _mesh_normal_pipeline_id = editor_renderer.pipeline_id("mesh_normal");
-    _mesh_pick_pipeline_id = editor_renderer.pipeline_id("mesh_pick");
-    _mesh_pick_material_id = editor_renderer.material_id("mesh_pick");
-    _mesh_outline_pipeline_id = editor_renderer.pipeline_id("mesh_outline");
-    _mesh_outline_material_id = editor_renderer.material_id("mesh_outline");
-    _cube_id = editor_renderer.mesh_id("cube");
-    _skybox_pipeline_id = editor_renderer.pipeline_id("skybox");
-    _skybox_material_id = editor_renderer.material_id("skybox");
-    _gizmo_pipeline_id = editor_renderer.pipeline_id("gizmo");
-    _gizmo_material_id = editor_renderer.material_id("gizmo");
+    _mesh_pipeline_id = editor_renderer.pipeline_id("mesh");
 
     // camera
     _camera = std::make_unique<editor::scene::EditorCamera>();
     _camera->resize(width, height);
     _camera->look_at(glm::vec3(0.0f));
 
-    // render targets
-    _view_target = _device->create_texture_render_target(
-        _pipeline_cache.get(_mesh_normal_pipeline_id),
-        width,
-        height
-    );
-    _pick_target = _device->create_texture_render_target(
-        _pipeline_cache.get(_mesh_pick_pipeline_id),
-        width,
-        height
-    );
-
     // sampler
     _sampler = wk::Sampler(
         static_cast<VkDevice>(_device->native_device()),
@@ -71,308 +58,133 @@ EditorSceneViewRenderer::EditorSceneViewRenderer(
             .to_vk()
     );
 
-    // imgui texture registration
-    _imgui_texture_ids.clear();
-    for (uint32_t i = 0; i < _view_target->frame_count(); ++i) {
-        ImTextureID id = reinterpret_cast<ImTextureID>(
-            ImGui_ImplVulkan_AddTexture(
-                _sampler.handle(),
-                static_cast<VkImageView>(_view_target->native_frame_image_view(i)),
-                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-            )
-        );
-        _imgui_texture_ids.emplace_back(id);
+    create_targets();
+}
+
+EditorSceneViewRenderer::~EditorSceneViewRenderer() {
+    if (_imgui_texture_id) {
+        ImGui_ImplVulkan_RemoveTexture(reinterpret_cast<VkDescriptorSet>(_imgui_texture_id));
     }
 }
 
-void EditorSceneViewRenderer::register_passes(
-    engine::core::scene::Scene& scene,
-    engine::core::renderer::FrameGraph& graph
+engine::core::renderer::framegraph::AttachmentId EditorSceneViewRenderer::register_passes(
+    engine::core::renderer::framegraph::FrameGraph& graph
 ) {
-    // skybox pass
-    graph.add_pass(
-        &_pipeline_cache.get(_skybox_pipeline_id),
-        _view_target.get(),
-        [this](engine::core::renderer::RenderPassContext& ctx, engine::core::renderer::RenderPassId) {
-            ctx.command_buffer = ctx.target->begin_frame(*ctx.pipeline);
-            ENGINE_ASSERT(ctx.command_buffer, "FrameGraph expects a valid command buffer");
+    _color_attachment = graph.register_attachment(
+        engine::core::renderer::framegraph::AttachmentDescription{ COLOR_FORMAT, _width, _height, _color_texture.get() }
+    );
+    _depth_attachment = graph.register_attachment(
+        engine::core::renderer::framegraph::AttachmentDescription{ DEPTH_FORMAT, _width, _height, _depth_texture.get() }
+    );
 
-            ctx.pipeline->bind(ctx.command_buffer);
+    // scene color pass
+    engine::core::renderer::framegraph::RenderPass scene_pass;
+    scene_pass.set_clear_color(glm::vec4(0.1f, 0.1f, 0.1f, 1.0f));
+    scene_pass.set_clear_depth(glm::vec2(1.0f, 0.0f));
+    scene_pass.add_write_color(_color_attachment);
+    scene_pass.set_write_depth(_depth_attachment);
+    scene_pass.set_pipeline_override(_mesh_pipeline_id);
+    scene_pass.set_view_uniforms(&_view_uniforms);
+    scene_pass.set_execute([this](engine::core::renderer::framegraph::RenderPassContext& context) {
+        render_scene_pass(context);
+    });
+    graph.add_pass(scene_pass);
+
+    return _color_attachment;
+}
 
-            engine::core::graphics::Material& material = _material_cache.get(_skybox_material_id);
-            engine::core::graphics::MeshBuffer& mesh = _mesh_cache.get(_cube_id);
+void EditorSceneViewRenderer::update(engine::core::scene::Scene* scene) {
+    _scene = scene;
 
-            UniformBufferObject ubo;
-            ubo.view = glm::mat4(glm::mat3(_camera->view()));
-            ubo.proj = _camera->projection();
-            ubo.proj[1][1] *= -1.0f;
+    engine::core::renderer::ViewConstants view_constants;
+    view_constants.view = _camera->view();
+    view_constants.proj = _camera->projection();
+    view_constants.proj[1][1] *= -1.0f;
+    _view_uniforms.update(view_constants);
+}
 
-            material.update_uniform_buffer(&ubo);
+void EditorSceneViewRenderer::resize(
+    engine::core::renderer::framegraph::FrameGraph& graph,
+    uint32_t width,
+    uint32_t height
+) {
+    if (width == 0 || height == 0) return;
+    if (width == _width && height == _height) return;
 
-            mesh.bind(ctx.command_buffer);
-            material.bind(ctx.command_buffer);
-            _view_target->submit_draws(mesh.index_count());
-        }
-    );
+    _width = width;
+    _height = height;
+    _camera->resize(width, height);
 
-    // scene color pass
-    graph.add_pass(
-        &_pipeline_cache.get(_mesh_normal_pipeline_id),
-        _view_target.get(),
-        [this, &scene](engine::core::renderer::RenderPassContext& ctx, engine::core::renderer::RenderPassId) {
-            ENGINE_ASSERT(ctx.command_buffer, "FrameGraph expects a valid command buffer");
-
-            ctx.pipeline->bind(ctx.command_buffer);
-
-            for (auto [entity, transform, mesh_renderer] :
-                 scene.view<components::Transform, components::MeshRenderer>())
-            {
-                if (!mesh_renderer.visible) continue;
-
-                engine::core::graphics::MeshBuffer& mesh = _mesh_cache.get(mesh_renderer.mesh_id);
-                engine::core::graphics::Material& material = _material_cache.get(mesh_renderer.material_id);
-
-                UniformBufferObject ubo;
-                ubo.view = _camera->view();
-                ubo.proj = _camera->projection();
-                ubo.proj[1][1] *= -1.0f;
-
-                PushConstants pc;
-                pc.model = transform.matrix();
-
-                material.update_uniform_buffer(&ubo);
-                _view_target->push_constants(ctx.command_buffer, ctx.pipeline->native_pipeline_layout(), &pc, sizeof(pc),
-                        engine::core::graphics::ShaderStageFlags::VERTEX);
-
-                mesh.bind(ctx.command_buffer);
-                material.bind(ctx.command_buffer);
-                _view_target->submit_draws(mesh.index_count());
-            }
-        }
-    );
+    if (_imgui_texture_id) {
+        ImGui_ImplVulkan_RemoveTexture(reinterpret_cast<VkDescriptorSet>(_imgui_texture_id));
+        _imgui_texture_id = ImTextureID{};
+    }
+    create_targets();
 
-    // selection outline pass
-    graph.add_pass(
-        &_pipeline_cache.get(_mesh_outline_pipeline_id),
-        _view_target.get(),
-        [this, &scene](engine::core::renderer::RenderPassContext& ctx, engine::core::renderer::RenderPassId) {
-            ENGINE_ASSERT(ctx.command_buffer, "FrameGraph expects a valid command buffer");
-
-            ctx.pipeline->bind(ctx.command_buffer);
-            
-            engine::core::graphics::Material& material = _material_cache.get(_mesh_outline_material_id);
-
-            for (auto [entity, transform, mesh_renderer] :
-                 scene.view<components::Transform, components::MeshRenderer>())
-            {
-                if (!mesh_renderer.visible) continue;
-                if (_selected_entity != entity) continue;
-
-                engine::core::graphics::MeshBuffer& mesh = _mesh_cache.get(mesh_renderer.mesh_id);
-
-                UniformBufferObject ubo;
-                ubo.view = _camera->view();
-                ubo.proj = _camera->projection();
-                ubo.proj[1][1] *= -1.0f;
-
-                struct {
-                    glm::mat4 model;
-                    glm::vec4 color;
-                    float width;
-                } pc{
-                    transform.matrix(),
-                    glm::vec4{1.0f, 1.0f, 1.0f, 1.0f},
-                    0.02f
-                };
-
-                material.update_uniform_buffer(&ubo);
-                _view_target->push_constants(ctx.command_buffer, ctx.pipeline->native_pipeline_layout(), &pc, sizeof(pc),
-                        engine::core::graphics::ShaderStageFlags::VERTEX);
-
-                mesh.bind(ctx.command_buffer);
-                material.bind(ctx.command_buffer);
-
-                _view_target->submit_draws(mesh.index_count());
-            }
-        }
-    );
+    graph.update_attachment_texture(_color_attachment, _color_texture.get());
+    graph.update_attachment_texture(_depth_attachment, _depth_texture.get());
+}
 
-    // scene gizmo pass
-    graph.add_pass(
-        &_pipeline_cache.get(_gizmo_pipeline_id),
-        _view_target.get(),
-        [this, &scene](engine::core::renderer::RenderPassContext& ctx, engine::core::renderer::RenderPassId) {
-            ENGINE_ASSERT(ctx.command_buffer, "FrameGraph expects a valid command buffer");
-
-            ctx.pipeline->bind(ctx.command_buffer);
-
-            engine::core::graphics::Material& material = _material_cache.get(_gizmo_material_id);
-
-            for (auto [entity, transform, gizmo_renderer] :
-                 scene.view<components::Transform, components::GizmoRenderer>())
-            {
-                if (!gizmo_renderer.visible) continue;
-
-                engine::core::graphics::MeshBuffer& mesh = _mesh_cache.get(gizmo_renderer.mesh_id);
-
-                UniformBufferObject ubo;
-                ubo.view = _camera->view();
-                ubo.proj = _camera->projection();
-                ubo.proj[1][1] *= -1.0f;
-
-                struct {
-                    glm::mat4 model;
-                    glm::vec4 color;
-                } pc{
-                    transform.matrix(),
-                    glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)
-                };
-
-                material.update_uniform_buffer(&ubo);
-                _view_target->push_constants(ctx.command_buffer, ctx.pipeline->native_pipeline_layout(), &pc, sizeof(pc),
-                        engine::core::graphics::ShaderStageFlags::VERTEX | engine::core::graphics::ShaderStageFlags::FRAGMENT);
-
-                mesh.bind(ctx.command_buffer);
-                material.bind(ctx.command_buffer);
-                _view_target->submit_draws(mesh.index_count());
-            }
-            
-            ctx.target->end_frame();
-        }
+void EditorSceneViewRenderer::create_targets() {
+    _color_texture = _device->create_texture(
+        _width, _height, COLOR_FORMAT, 1, 1,
+        engine::core::graphics::TextureUsage::COLOR_ATTACHMENT | engine::core::graphics::TextureUsage::SAMPLED_IMAGE
     );
-
-    // scene pick pass
-    const uint32_t readback_index = _pick_target->frame_index();
-    graph.add_pass(
-        &_pipeline_cache.get(_mesh_pick_pipeline_id),
-        _pick_target.get(),
-        [this, &scene, readback_index](engine::core::renderer::RenderPassContext& ctx, engine::core::renderer::RenderPassId) {
-            ctx.command_buffer = ctx.target->begin_frame(*ctx.pipeline);
-            ENGINE_ASSERT(ctx.command_buffer, "FrameGraph expects a valid command buffer");
-            
-            ctx.pipeline->bind(ctx.command_buffer);
-            
-            engine::core::graphics::Material& material = _material_cache.get(_mesh_pick_material_id);
-
-            for (auto [entity, transform, mesh_renderer] :
-                scene.view<components::Transform, components::MeshRenderer>())
-            {
-                if (!mesh_renderer.visible) continue;
-
-                engine::core::graphics::MeshBuffer& mesh = _mesh_cache.get(mesh_renderer.mesh_id);
-
-                UniformBufferObject ubo;
-                ubo.view = _camera->view();
-                ubo.proj = _camera->projection();
-                ubo.proj[1][1] *= -1.0f;
-
-                struct {
-                    glm::mat4 model;
-                    uint32_t entity_id;
-                } pc{
-                    transform.matrix(),
-                    static_cast<uint32_t>(entity & 0xFFFFFFFFu)
-                };
-
-                material.update_uniform_buffer(&ubo);
-                _pick_target->push_constants(ctx.command_buffer, ctx.pipeline->native_pipeline_layout(), &pc, sizeof(pc),
-                        engine::core::graphics::ShaderStageFlags::VERTEX | engine::core::graphics::ShaderStageFlags::FRAGMENT);
-
-                mesh.bind(ctx.command_buffer);
-                material.bind(ctx.command_buffer);
-                _pick_target->submit_draws(mesh.index_count());
-            }
-
-            for (auto [entity, transform, gizmo_renderer] :
-                scene.view<components::Transform, components::GizmoRenderer>())
-            {
-                if (!gizmo_renderer.visible) continue;
-
-                engine::core::graphics::MeshBuffer& mesh = _mesh_cache.get(gizmo_renderer.mesh_id);
-
-                UniformBufferObject ubo;
-                ubo.view = _camera->view();
-                ubo.proj = _camera->projection();
-                ubo.proj[1][1] *= -1.0f;
-
-                struct {
-                    glm::mat4 model;
-                    uint32_t entity_id;
-                } pc{
-                    transform.matrix(),
-                    static_cast<uint32_t>(entity & 0xFFFFFFFFu)
-                };
-
-                material.update_uniform_buffer(&ubo);
-                _pick_target->push_constants(ctx.command_buffer, ctx.pipeline->native_pipeline_layout(), &pc, sizeof(pc),
-                        engine::core::graphics::ShaderStageFlags::VERTEX | engine::core::graphics::ShaderStageFlags::FRAGMENT);
-
-                mesh.bind(ctx.command_buffer);
-                material.bind(ctx.command_buffer);
-                _pick_target->submit_draws(mesh.index_count());
-            }
-
-            ctx.target->end_frame();
-        }
+    _depth_texture = _device->create_texture(
+        _width, _height, DEPTH_FORMAT, 1, 1,
+        engine::core::graphics::TextureUsage::DEPTH_ATTACHMENT
     );
 
-    // handle resize
-    if (_pending_resize) {
-        _device->wait_idle();
-
-        _width  = _pending_resize->x;
-        _height = _pending_resize->y;
-
-        _camera->resize(_width, _height);
-        _view_target->resize(_width, _height);
-        _pick_target->resize(_width, _height);
-
-        for (uint32_t i = 0; i < _view_target->frame_count(); ++i)
-            ImGui_ImplVulkan_RemoveTexture(reinterpret_cast<VkDescriptorSet>(_imgui_texture_ids[i]));
-
-        _imgui_texture_ids.clear();
-        for (uint32_t i = 0; i < _view_target->frame_count(); ++i) {
-            ImTextureID id = reinterpret_cast<ImTextureID>(
-                ImGui_ImplVulkan_AddTexture(
-                    _sampler.handle(),
-                    static_cast<VkImageView>(_view_target->native_frame_image_view(i)),
-                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-                )
-            );
-            _imgui_texture_ids.emplace_back(id);
-        }
-
-        _pending_resize.reset();
-    }
+    // the graph moves the color texture to shader read before the gui pass samples it
+    _imgui_texture_id = reinterpret_cast<ImTextureID>(
+        ImGui_ImplVulkan_AddTexture(
+            _sampler.handle(),
+            static_cast<VkImageView>(_color_texture->native_image_view()),
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        )
+    );
 }
 
-void EditorSceneViewRenderer::handle_picking(uint32_t frame_index, glm::vec2 view_pos, glm::vec2 view_size) {
-    if (!ImGui::IsMouseClicked(ImGuiMouseButton_Left)) return;
+void EditorSceneViewRenderer::render_scene_pass(engine::core::renderer::framegraph::RenderPassContext& context) {
+    ENGINE_ASSERT(context.command_buffer, "FrameGraph expects a valid command buffer");
+    if (!_scene) return;
 
-    _view_pos = view_pos;
-    _view_size = view_size;
+    context.pipeline->bind(context.command_buffer->native_command_buffer());
+    context.command_buffer->set_viewport(0.0f, 0.0f, static_cast<float>(_width), static_cast<float>(_height), 0.0f, 1.0f);
+    context.command_buffer->set_scissor(static_cast<float>(_width), static_cast<float>(_height), 0.0f, 1.0f);
 
-    ImVec2 mouse = ImGui::GetMousePos();
+    // bound once for the pass, draws only push their material's slot. the graph binds it for pipelines it
+    // builds, this pass brings its own
+    if (_bindless) {
+        _bindless->bind(context.command_buffer->native_command_buffer(), context.pipeline->native_pipeline_layout());
+    }
 
-    if (mouse.x >= _view_pos.x && mouse.x <= _view_pos.x + _view_size.x &&
-        mouse.y >= _view_pos.y && mouse.y <= _view_pos.y + _view_size.y)
+    for (auto [entity, transform, mesh_renderer] :
+         _scene->view<components::Transform, components::MeshRenderer>())
     {
-        int px = static_cast<int>((mouse.x - _view_pos.x) * (static_cast<float>(_width) / _view_size.x));
-        int py = static_cast<int>(((_view_pos.y + _view_size.y) - mouse.y) * (static_cast<float>(_height) / _view_size.y));
-
-        px = std::clamp(px, 0, static_cast<int>(_width - 1));
-        py = std::clamp(py, 0, static_cast<int>(_height - 1));
+        if (!mesh_renderer.visible) continue;
+
+        // still uploading or reloading after eviction, drawn once next_frame has it resident
+        engine::core::graphics::MeshBuffer* mesh = _mesh_cache.get(mesh_renderer.mesh_id);
+        if (!mesh) continue;
+
+        ScenePushConstants pc;
+        pc.model = transform.matrix() * _mesh_cache.dequantization(mesh_renderer.mesh_id).transform();
+        pc.material_index = 0;
+        if (_bindless) {
+            // nothing to shade it with
+            if (!_material_cache.contains(mesh_renderer.material_id)) continue;
+            pc.material_index = _material_cache.bindless_index(mesh_renderer.material_id);
+        }
 
-        std::vector<uint32_t> pixels = _pick_target->copy_color_to_cpu(frame_index);
-        uint32_t picked_id = pixels[py * _width + px];
+        context.render_target->push_constants(context.command_buffer, context.pipeline->native_pipeline_layout(),
+            &pc, sizeof(pc), engine::core::graphics::ShaderStageFlags::VERTEX | engine::core::graphics::ShaderStageFlags::FRAGMENT);
 
-        _selected_entity = static_cast<engine::core::scene::Entity>(picked_id);
-    }
-}
+        // picked before the graph runs, clamped for a mesh swapped in since
+        uint32_t lod = std::min(mesh_renderer.lod, static_cast<uint32_t>(mesh->lods().size() - 1));
 
-void EditorSceneViewRenderer::resize(uint32_t width, uint32_t height) {
-    if (width != _width || height != _height) {
-        _pending_resize = glm::vec2(width, height);
+        mesh->bind(context.command_buffer);
+        mesh->draw_lod(context.command_buffer, lod);
     }
 }
 
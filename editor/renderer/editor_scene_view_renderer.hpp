@@ -6,26 +6,25 @@
 
 #include "engine/core/renderer/frame_graph/frame_graph.hpp"
 #include "engine/core/renderer/cache/pipeline_cache.hpp"
-#include "engine/core/renderer/cache/material_cache.hpp"
 #include "engine/core/renderer/cache/mesh_cache.hpp"
-#include "engine/core/renderer/cache/shader_cache.hpp"
+#include "engine/core/renderer/cache/material_cache.hpp"
+#include "engine/core/renderer/view_uniforms.hpp"
 
 #include "engine/core/graphics/device.hpp"
-#include "engine/core/graphics/render_target.hpp"
-#include "engine/core/graphics/descriptor_set_layout.hpp"
+#include "engine/core/graphics/texture.hpp"
+#include "engine/core/graphics/bindless_table.hpp"
 
-#include "editor/gui/editor_gui.hpp"
+#include <wk/wulkan.hpp>
 
 #include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
 #include <memory>
-#include <vector>
 #include <imgui.h>
 
 namespace editor::renderer {
 
 class EditorRenderer;
 
+// renders the scene from the editor camera into a texture the viewport panel shows
 class EditorSceneViewRenderer {
 public:
     EditorSceneViewRenderer(
@@ -33,61 +32,51 @@ public:
         uint32_t width,
         uint32_t height
     );
+    ~EditorSceneViewRenderer();
 
-    void register_passes(
-        engine::core::scene::Scene& scene,
-        engine::core::renderer::FrameGraph& graph
-    );
-        
-    void resize(uint32_t width, uint32_t height);
+    EditorSceneViewRenderer(const EditorSceneViewRenderer&) = delete;
+    EditorSceneViewRenderer& operator=(const EditorSceneViewRenderer&) = delete;
+
+    // adds the scene passes, the returned attachment holds the finished view for passes that sample it
+    engine::core::renderer::framegraph::AttachmentId register_passes(engine::core::renderer::framegraph::FrameGraph& graph);
 
-    ImTextureID texture_id(uint32_t frame_index) const { return _imgui_texture_ids[frame_index]; }
+    // uploads the camera's view constants, call once per frame before the graph executes
+    void update(engine::core::scene::Scene* scene);
 
-    engine::core::scene::Entity selected_entity() const { return _selected_entity; }
+    // the device must be idle, the graph is re-baked by the caller
+    void resize(engine::core::renderer::framegraph::FrameGraph& graph, uint32_t width, uint32_t height);
 
-    uint32_t frame_index() const { return _view_target->frame_index(); }
+    ImTextureID texture_id() const { return _imgui_texture_id; }
     editor::scene::EditorCamera& camera() { return *_camera; }
-    
-    void handle_picking(uint32_t frame_index, glm::vec2 view_pos, glm::vec2 view_size);
+    const editor::scene::EditorCamera& camera() const { return *_camera; }
 
 private:
-    void render_scene_pass(engine::core::scene::Scene& scene);
-    void render_pick_pass(engine::core::scene::Scene& scene);
+    void create_targets();
+    void render_scene_pass(engine::core::renderer::framegraph::RenderPassContext& context);
 
     engine::core::graphics::Device* _device;
     engine::core::renderer::cache::PipelineCache& _pipeline_cache;
-    engine::core::renderer::cache::MaterialCache& _material_cache;
     engine::core::renderer::cache::MeshCache& _mesh_cache;
-    gui::EditorGui& _gui;
+    engine::core::renderer::cache::MaterialCache& _material_cache;
+    const engine::core::graphics::BindlessTable* _bindless;
+    engine::core::renderer::ViewUniforms& _view_uniforms;
 
     std::unique_ptr<editor::scene::EditorCamera> _camera;
+    engine::core::scene::Scene* _scene = nullptr;
 
-    std::unique_ptr<engine::core::graphics::RenderTarget> _view_target;
-    std::unique_ptr<engine::core::graphics::RenderTarget> _pick_target;
-
-    engine::core::renderer::framegraph::FrameGraph _frame_graph;
+    // owned here rather than by the graph so they can be sampled by the gui
+    std::unique_ptr<engine::core::graphics::Texture> _color_texture;
+    std::unique_ptr<engine::core::graphics::Texture> _depth_texture;
+    engine::core::renderer::framegraph::AttachmentId _color_attachment{};
+    engine::core::renderer::framegraph::AttachmentId _depth_attachment{};
 
-    std::vector<ImTextureID> _imgui_texture_ids;
+    ImTextureID _imgui_texture_id{};
     wk::Sampler _sampler;
-    glm::vec2 _view_pos{0.0f, 0.0f};
-    glm::vec2 _view_size{0.0f, 0.0f};
 
     uint32_t _width = 0;
     uint32_t _height = 0;
 
-    std::optional<glm::vec2> _pending_resize;
-    engine::core::scene::Entity _selected_entity{0};
-
-    engine::core::renderer::cache::PipelineCacheId _mesh_normal_pipeline_id;
-    engine::core::renderer::cache::PipelineCacheId _mesh_pick_pipeline_id;
-    engine::core::renderer::cache::MaterialCacheId _mesh_pick_material_id;
-    engine::core::renderer::cache::PipelineCacheId _mesh_outline_pipeline_id;
-    engine::core::renderer::cache::MaterialCacheId _mesh_outline_material_id;
-    engine::core::renderer::cache::MeshCacheId _cube_id;
-    engine::core::renderer::cache::PipelineCacheId _skybox_pipeline_id;
-    engine::core::renderer::cache::MaterialCacheId _skybox_material_id;
-    engine::core::renderer::cache::PipelineCacheId _gizmo_pipeline_id;
-    engine::core::renderer::cache::MaterialCacheId _gizmo_material_id;
+    engine::core::renderer::cache::PipelineCacheId _mesh_pipeline_id;
 };
 
 } // namespace editor::renderer
@@ -1,8 +1,36 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+const uint INVALID_BINDLESS_INDEX = 0xFFFFFFFFu;
+
+// the bindless table, indexed by the draw's material
+struct MaterialParams {
+    vec4 base_color;
+    uint albedo_texture;
+};
+
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+layout(set = 1, binding = 1) readonly buffer Materials {
+    MaterialParams materials[];
+};
+
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    uint material_index;
+} pc;
 
 layout(location = 0) in vec3 v_normal;
+layout(location = 1) in vec2 v_texcoord;
 layout(location = 0) out vec4 out_color;
 
 void main() {
-    out_color = vec4(v_normal, 1.0);
+    MaterialParams material = materials[pc.material_index];
+
+    vec4 color = material.base_color;
+    if (material.albedo_texture != INVALID_BINDLESS_INDEX) {
+        color *= texture(textures[nonuniformEXT(material.albedo_texture)], v_texcoord);
+    }
+
+    // tinted by the normal so shapes read without scene lights
+    out_color = vec4(color.rgb * (0.5 + 0.5 * normalize(v_normal)), color.a);
 }
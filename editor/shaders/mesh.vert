@@ -7,14 +7,18 @@ layout(set = 0, binding = 0) uniform UBO {
 
 layout(push_constant) uniform PushConstants {
     mat4 model;
+    uint material_index;
 } pc;
 
 layout(location = 0) in vec3 in_position;
 layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec2 in_texcoord;
 
 layout(location = 0) out vec3 v_normal;
+layout(location = 1) out vec2 v_texcoord;
 
 void main() {
     gl_Position = ubo.proj * ubo.view * pc.model * vec4(in_position, 1.0);
     v_normal = in_normal;
+    v_texcoord = in_texcoord;
 }
@@ -0,0 +1,50 @@
+#ifndef engine_core_graphics_BINDLESS_TABLE_HPP
+#define engine_core_graphics_BINDLESS_TABLE_HPP
+
+#include "texture.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace engine::core::graphics {
+
+using BindlessIndex = uint32_t;
+constexpr BindlessIndex INVALID_BINDLESS_INDEX = UINT32_MAX;
+
+// one descriptor set shared by every draw: a sampled texture array and a buffer of material parameters.
+// shaders index both through a per-draw material index, typically a push constant:
+//   layout(set = 1, binding = 0) uniform sampler2D textures[];
+//   layout(set = 1, binding = 1) readonly buffer Materials { MaterialParams materials[]; };
+class BindlessTable {
+public:
+    static constexpr uint32_t SET = 1;
+    static constexpr uint32_t TEXTURE_BINDING = 0;
+    static constexpr uint32_t MATERIAL_BINDING = 1;
+
+    virtual ~BindlessTable() = default;
+
+    // texture must be in the SAMPLE layout whenever a draw reads it
+    virtual BindlessIndex register_texture(const Texture& texture) = 0;
+    virtual void release_texture(BindlessIndex index) = 0;
+
+    // params is material_stride() bytes, laid out as the shader's MaterialParams. slots are never rewritten,
+    // frames in flight may be reading them: a changed material is registered again and the old slot released
+    virtual BindlessIndex register_material(const void* params) = 0;
+    virtual void release_material(BindlessIndex index) = 0;
+
+    virtual uint32_t material_stride() const = 0;
+    virtual uint32_t texture_count() const = 0;
+    virtual uint32_t material_count() const = 0;
+
+    virtual void bind(void* cb, void* pipeline_layout) const = 0;
+
+    virtual void* native_descriptor_set_layout() const = 0;
+    virtual std::string backend_name() const = 0;
+
+protected:
+    BindlessTable() = default;
+};
+
+} // namespace engine::core::graphics
+
+#endif // engine_core_graphics_BINDLESS_TABLE_HPP
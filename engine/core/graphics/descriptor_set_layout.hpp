@@ -1,6 +1,8 @@
 #ifndef engine_core_graphics_DESCRIPTOR_SET_LAYOUT_HPP
 #define engine_core_graphics_DESCRIPTOR_SET_LAYOUT_HPP
 
+#include "descriptor_types.hpp"
+
 #include <string>
 
 namespace engine::core::graphics {
@@ -9,6 +11,7 @@ class DescriptorSetLayout {
 public:
     virtual ~DescriptorSetLayout() = default;
 
+    virtual const DescriptorLayoutDescription& description() const = 0;
     virtual void* native_descriptor_set_layout() const = 0;
     virtual std::string backend_name() const = 0;
 
@@ -2,9 +2,11 @@
 #define engine_core_graphics_DESCRIPTOR_TYPES_HPP
 
 #include "engine/core/debug/assert.hpp"
+#include "engine/core/memory/hash.hpp"
 
 #include <cstdint>
 #include <vector>
+#include <functional>
 
 namespace engine::core::graphics {
 
@@ -63,7 +65,8 @@ enum class DescriptorType : uint32_t {
     STORAGE_TEXEL_BUFFER,
     UNIFORM_BUFFER,
     STORAGE_BUFFER,
-    INPUT_ATTACHMENT
+    INPUT_ATTACHMENT,
+    UNIFORM_BUFFER_DYNAMIC
 };
 
 struct DescriptorLayoutBinding {
@@ -139,19 +142,31 @@ struct DescriptorLayoutDescription {
         return bindings == other.bindings;
     }
 
-    size_t hash() const {
-        size_t h = 0;
-        for (const auto& b : bindings) {
-            // chat gpt generated hash
-            h ^= std::hash<uint32_t>{}(b.binding) + 0x9e3779b9 + (h << 6) + (h >> 2);
-            h ^= std::hash<uint32_t>{}(static_cast<uint32_t>(b.type)) + 0x9e3779b9 + (h << 6) + (h >> 2);
-            h ^= std::hash<uint32_t>{}(b.count) + 0x9e3779b9 + (h << 6) + (h >> 2);
-            h ^= std::hash<uint32_t>{}(static_cast<uint32_t>(b.visibility)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    void hash(memory::Hasher& hasher) const noexcept {
+        hasher.add(static_cast<uint32_t>(bindings.size()));
+        for (const DescriptorLayoutBinding& b : bindings) {
+            hasher.add(b.binding).add(b.type).add(b.count).add(b.visibility);
         }
-        return h;
+    }
+
+    size_t hash() const noexcept {
+        memory::Hasher hasher;
+        hash(hasher);
+        return static_cast<size_t>(hasher.finish());
     }
 };
 
 }
 
+namespace std {
+
+template <>
+struct hash<engine::core::graphics::DescriptorLayoutDescription> {
+    size_t operator()(const engine::core::graphics::DescriptorLayoutDescription& desc) const noexcept {
+        return desc.hash();
+    }
+};
+
+} // namespace std
+
 #endif
\ No newline at end of file
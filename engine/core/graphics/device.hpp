@@ -11,6 +11,7 @@
 #include "swapchain_render_target.hpp"
 #include "descriptor_set_layout.hpp"
 #include "descriptor_types.hpp"
+#include "bindless_table.hpp"
 
 #include "engine/core/window/window.hpp"
 
@@ -18,17 +19,40 @@
 
 namespace engine::core::graphics {
 
+struct DescriptorStats {
+    uint32_t pool_count = 0;
+    uint32_t sets_allocated = 0;    // live sets
+    uint32_t sets_recycled = 0;     // freed sets waiting to be reused
+};
+
 class Device {
 public:
     virtual ~Device() = default;
 
     virtual void wait_idle() = 0;
+    // call once per frame before recording, recycles per-frame transient memory
+    virtual void next_frame() = 0;
 
     virtual std::unique_ptr<Shader> create_shader(ShaderStageFlags stage, const std::string& filepath) const = 0;
     virtual std::unique_ptr<MeshBuffer> create_mesh_buffer(
-        const void* vertex_data, uint32_t vertex_size, uint32_t vertex_count,
-        const void* index_data, uint32_t index_size, uint32_t index_count
+        const std::vector<VertexStream>& vertex_streams, uint32_t vertex_count,
+        const void* index_data, uint32_t index_size, uint32_t index_count,
+        const std::vector<SubMesh>& submeshes = {},
+        const std::vector<MeshLod>& lods = {}
     ) const = 0;
+    virtual void defragment_mesh_buffers() = 0;
+    // gives the shared mesh buffers' unused capacity back once most of it is free, so freed meshes free memory.
+    // rate limited, so calling it every frame is cheap
+    virtual void trim_mesh_buffers() = 0;
+    // device memory the shared mesh buffers hold, occupied or not
+    virtual uint64_t mesh_buffer_capacity() const = 0;
+
+    // device-local heaps, in bytes
+    virtual uint64_t memory_budget() const = 0;
+    virtual uint64_t memory_usage() const = 0;
+
+    virtual DescriptorStats descriptor_stats() const = 0;
+
     virtual std::unique_ptr<core::graphics::Texture> create_texture(
         uint32_t width,
         uint32_t height,
@@ -50,7 +74,7 @@ public:
     virtual std::unique_ptr<Pipeline> create_pipeline(
         const Shader& vert, const Shader& frag,
         const DescriptorSetLayout& layout,
-        const VertexBindingDescription& vertex_binding, 
+        const std::vector<VertexBindingDescription>& vertex_bindings,
         const std::vector<ImageAttachmentInfo>& attachment_info,
         const core::graphics::PipelineConfig& config
     ) const = 0;
@@ -68,6 +92,17 @@ public:
         const DescriptorLayoutDescription& description
     ) const = 0;
 
+    // false when the device lacks descriptor indexing, callers keep per-material sets
+    virtual bool bindless_supported() const = 0;
+    virtual std::unique_ptr<BindlessTable> create_bindless_table(
+        uint32_t max_textures,
+        uint32_t max_materials,
+        uint32_t material_stride
+    ) const = 0;
+
+    // false when BC formats cannot be sampled, textures then stay uncompressed
+    virtual bool block_compression_supported() const = 0;
+
     virtual ImageFormat present_format() const = 0;
     virtual ColorSpace present_color_space() const = 0;
     virtual ImageFormat depth_format() const = 0;
@@ -3,6 +3,8 @@
 
 #include "engine/core/debug/assert.hpp"
 
+#include <cstdint>
+
 namespace engine::core::graphics {
 
 enum class ImageFormat {
@@ -33,6 +35,15 @@ enum class ImageFormat {
     RGBA16_FLOAT,
     RGBA32_FLOAT,
 
+    // block compressed formats, 4x4 texels per block
+    BC1_RGBA_UNORM,
+    BC1_RGBA_SRGB,
+    BC3_UNORM,
+    BC3_SRGB,
+    BC5_UNORM,
+    BC7_UNORM,
+    BC7_SRGB,
+
     // depth / stencil formats
     D16_UNORM,
     D24_UNORM_S8_UINT,
@@ -92,6 +103,10 @@ struct ImageAttachmentInfo {
         usage = u;
         return *this;
     }
+
+    bool operator==(const ImageAttachmentInfo& other) const noexcept {
+        return format == other.format && usage == other.usage;
+    }
 };
 
 static bool IsDepthFormat(graphics::ImageFormat fmt) {
@@ -105,6 +120,26 @@ static bool IsDepthFormat(graphics::ImageFormat fmt) {
     }
 }
 
+inline bool IsCompressedFormat(graphics::ImageFormat fmt) {
+    using IF = graphics::ImageFormat;
+    switch (fmt) {
+        case IF::BC1_RGBA_UNORM: case IF::BC1_RGBA_SRGB:
+        case IF::BC3_UNORM: case IF::BC3_SRGB:
+        case IF::BC5_UNORM:
+        case IF::BC7_UNORM: case IF::BC7_SRGB:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// bytes in one 4x4 block of a compressed format
+inline uint32_t CompressedBlockBytes(graphics::ImageFormat fmt) {
+    using IF = graphics::ImageFormat;
+    ENGINE_ASSERT(IsCompressedFormat(fmt), "Block size asked of an uncompressed format");
+    return (fmt == IF::BC1_RGBA_UNORM || fmt == IF::BC1_RGBA_SRGB) ? 8 : 16;
+}
+
 } // namespace engine::core::graphics
 
 #endif // engine_core_graphics_IMAGE_TYPES_HPP
\ No newline at end of file
@@ -12,6 +12,8 @@ public:
     virtual ~Material() = default;
 
     virtual void bind(void* cb) const = 0;
+    // binds at an explicit set through another pipeline's layout, for sets shared across pipelines
+    virtual void bind(void* cb, void* pipeline_layout, uint32_t set) const = 0;
 
     virtual void update_uniform_buffer(const void* data) = 0;
 
@@ -5,18 +5,51 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace engine::core::graphics {
 
+// index range of one shape inside a mesh buffer, relative to the buffer's first index
+struct SubMesh {
+    std::string name;
+    uint32_t first_index = 0;
+    uint32_t index_count = 0;
+};
+
+// one detail level, every submesh's triangles at that level as one index range relative to the buffer's
+// first index. level 0 is the full detail the submesh table describes
+struct MeshLod {
+    uint32_t first_index = 0;
+    uint32_t index_count = 0;
+    float error = 0.0f; // object space distance from the full detail surface
+};
+
+// one vertex buffer binding's worth of per-vertex data, stream i of a mesh is bound at binding i
+struct VertexStream {
+    const void* data = nullptr;
+    uint32_t stride = 0;
+};
+
 class MeshBuffer {
 public:
     virtual ~MeshBuffer() = default;
 
     virtual void bind(CommandBuffer* command_buffer) const = 0;
+    // draws lod 0
     virtual void draw(CommandBuffer* command_buffer) const = 0;
+    virtual void draw_lod(CommandBuffer* command_buffer, uint32_t lod) const = 0;
+    virtual void draw_submesh(CommandBuffer* command_buffer, uint32_t submesh) const = 0;
 
     virtual uint32_t vertex_count() const = 0;
+    virtual uint32_t vertex_stream_count() const = 0;
     virtual uint32_t index_count() const = 0;
+    virtual const std::vector<SubMesh>& submeshes() const = 0;
+    virtual const std::vector<MeshLod>& lods() const = 0;
+
+    // location inside the shared vertex/index buffers
+    virtual uint32_t base_vertex() const = 0;
+    virtual uint32_t first_index() const = 0;
 
     virtual void* vertex_buffer_handle() const = 0;
     virtual void* index_buffer_handle() const = 0;
@@ -5,6 +5,7 @@
 #include "descriptor_set_layout.hpp"
 #include "image_types.hpp"
 #include "descriptor_types.hpp"
+#include "bindless_table.hpp"
 
 #include <string>
 #include <memory>
@@ -54,6 +55,10 @@ struct PipelineConfig {
     struct PushConstantRange{
         uint32_t size = 0;
         ShaderStageFlags stage_flags = ShaderStageFlags::NONE;
+
+        bool operator==(const PushConstantRange& other) const noexcept {
+            return size == other.size && stage_flags == other.stage_flags;
+        }
     };
 
     bool blending_enabled = true;
@@ -62,6 +67,7 @@ struct PipelineConfig {
     CullMode cull_mode = CullMode::BACK;
     PolygonMode polygon_mode = PolygonMode::FILL;
     PushConstantRange push_constant;
+    const BindlessTable* bindless = nullptr; // appended to the pipeline layout at BindlessTable::SET
 
     PipelineConfig& set_blending(bool b) { blending_enabled = b; return *this; }
     PipelineConfig& set_depth_test(bool b) { depth_test_enabled = b; return *this; }
@@ -69,6 +75,17 @@ struct PipelineConfig {
     PipelineConfig& set_cull_mode(CullMode m) { cull_mode = m; return *this; }
     PipelineConfig& set_polygon_mode(PolygonMode m) { polygon_mode = m; return *this; }
     PipelineConfig& set_push_constant(uint32_t s, ShaderStageFlags f) { push_constant.size = s; push_constant.stage_flags = f; return *this; }
+    PipelineConfig& set_bindless(const BindlessTable* t) { bindless = t; return *this; }
+
+    bool operator==(const PipelineConfig& other) const noexcept {
+        return blending_enabled == other.blending_enabled &&
+            depth_test_enabled == other.depth_test_enabled &&
+            depth_write_enabled == other.depth_write_enabled &&
+            cull_mode == other.cull_mode &&
+            polygon_mode == other.polygon_mode &&
+            push_constant == other.push_constant &&
+            bindless == other.bindless;
+    }
 };
 
 class Pipeline {
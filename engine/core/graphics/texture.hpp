@@ -38,6 +38,16 @@ public:
     virtual void transition(const TextureBarrier& layout) = 0;
     virtual void resize(uint32_t width, uint32_t height) = 0;
 
+    // stages one mip level, rows tightly packed (rows of 4x4 blocks for compressed formats), for a texture
+    // created with COPY_DST. it lands before any later submit reads the texture and leaves that level ready to
+    // sample; call from the render thread
+    virtual void upload(uint32_t mip, const void* data, uint64_t size) = 0;
+
+    // native_image_view() samples mips [base_mip, mip_levels) so a streamed texture can be drawn before its
+    // finer levels arrive. views made for earlier bases stay alive with the texture
+    virtual void set_base_mip(uint32_t mip) = 0;
+    virtual uint32_t base_mip() const = 0;
+
     virtual uint32_t width() const { return _width; };
     virtual uint32_t height() const {return _height; };
     virtual uint32_t layers() const = 0;
@@ -31,7 +31,9 @@ enum class VertexFormat {
     HALF_3,
     HALF_4,
 
-    UNORM8_4
+    UNORM8_4,
+    UNORM16_4,
+    SNORM16_2
 };
 
 
@@ -57,6 +59,12 @@ struct VertexAttribute {
         offset = o;
         return *this;
     }
+
+    bool operator==(const VertexAttribute& other) const noexcept {
+        return location == other.location &&
+            format == other.format &&
+            offset == other.offset;
+    }
 };
 
 struct VertexBindingDescription {
@@ -99,6 +107,12 @@ struct VertexBindingDescription {
         attributes = a;
         return *this;
     }
+
+    bool operator==(const VertexBindingDescription& other) const noexcept {
+        return binding == other.binding &&
+            stride == other.stride &&
+            attributes == other.attributes;
+    }
 };
 
 } // namespace engine::core::graphics
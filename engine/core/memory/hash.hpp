@@ -0,0 +1,340 @@
+#ifndef engine_core_memory_HASH_HPP
+#define engine_core_memory_HASH_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ENGINE_HASH_SSE2 1
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+#endif
+
+namespace engine::core::memory {
+
+// 64-bit byte hash laid out after xxh3: short inputs take a branchy path, long inputs are folded 64 bytes
+// at a time into eight independent lanes (two sse2 registers per half stripe where available).
+// the secret is generated here rather than copied from xxhash, so values are not compatible with it
+namespace hash_detail {
+
+constexpr uint64_t PRIME32_1 = 0x9E3779B1u;
+constexpr uint64_t PRIME32_2 = 0x85EBCA77u;
+constexpr uint64_t PRIME32_3 = 0xC2B2AE3Du;
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ull;
+constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ull;
+constexpr uint64_t PRIME_MX1 = 0x165667919E3779F9ull;
+constexpr uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ull;
+
+constexpr size_t SECRET_SIZE = 192;
+constexpr size_t STRIPE_SIZE = 64;
+constexpr size_t SECRET_CONSUME_RATE = 8;
+constexpr size_t ACC_LANES = STRIPE_SIZE / sizeof(uint64_t);
+constexpr size_t STRIPES_PER_BLOCK = (SECRET_SIZE - STRIPE_SIZE) / SECRET_CONSUME_RATE;
+constexpr size_t BLOCK_SIZE = STRIPE_SIZE * STRIPES_PER_BLOCK;
+
+// splitmix64 stream, little endian
+constexpr std::array<uint8_t, SECRET_SIZE> MakeSecret() {
+    std::array<uint8_t, SECRET_SIZE> secret{};
+    uint64_t state = PRIME64_1;
+    for (size_t i = 0; i < SECRET_SIZE; i += 8) {
+        state += 0x9E3779B97F4A7C15ull;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        for (size_t b = 0; b < 8; ++b) secret[i + b] = static_cast<uint8_t>(z >> (b * 8));
+    }
+    return secret;
+}
+
+inline constexpr std::array<uint8_t, SECRET_SIZE> SECRET = MakeSecret();
+
+inline uint32_t Read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t Read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void Write64(uint8_t* p, uint64_t v) { std::memcpy(p, &v, sizeof(v)); }
+
+constexpr uint64_t Rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+constexpr uint32_t Swap32(uint32_t x) {
+    return ((x << 24) & 0xFF000000u) | ((x << 8) & 0x00FF0000u) | ((x >> 8) & 0x0000FF00u) | ((x >> 24) & 0x000000FFu);
+}
+
+constexpr uint64_t Swap64(uint64_t x) {
+    return (static_cast<uint64_t>(Swap32(static_cast<uint32_t>(x))) << 32) | Swap32(static_cast<uint32_t>(x >> 32));
+}
+
+// low and high halves of the 128-bit product, xored
+inline uint64_t Mul128Fold64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t high;
+    uint64_t low = _umul128(a, b, &high);
+    return low ^ high;
+#else
+    uint64_t lo_lo = (a & 0xFFFFFFFFull) * (b & 0xFFFFFFFFull);
+    uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFFull);
+    uint64_t lo_hi = (a & 0xFFFFFFFFull) * (b >> 32);
+    uint64_t hi_hi = (a >> 32) * (b >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFull) + lo_hi;
+    uint64_t high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t low = (cross << 32) | (lo_lo & 0xFFFFFFFFull);
+    return low ^ high;
+#endif
+}
+
+constexpr uint64_t Avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= PRIME_MX1;
+    return h ^ (h >> 32);
+}
+
+constexpr uint64_t Avalanche64(uint64_t h) {
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    return h ^ (h >> 32);
+}
+
+constexpr uint64_t Rrmxmx(uint64_t h, uint64_t len) {
+    h ^= Rotl64(h, 49) ^ Rotl64(h, 24);
+    h *= PRIME_MX2;
+    h ^= (h >> 35) + len;
+    h *= PRIME_MX2;
+    return h ^ (h >> 28);
+}
+
+inline uint64_t Mix16(const uint8_t* p, const uint8_t* s, uint64_t seed) {
+    return Mul128Fold64(Read64(p) ^ (Read64(s) + seed), Read64(p + 8) ^ (Read64(s + 8) - seed));
+}
+
+inline uint64_t Hash0To16(const uint8_t* p, size_t len, const uint8_t* s, uint64_t seed) {
+    if (len > 8) {
+        uint64_t bitflip1 = (Read64(s + 24) ^ Read64(s + 32)) + seed;
+        uint64_t bitflip2 = (Read64(s + 40) ^ Read64(s + 48)) - seed;
+        uint64_t lo = Read64(p) ^ bitflip1;
+        uint64_t hi = Read64(p + len - 8) ^ bitflip2;
+        return Avalanche(len + Swap64(lo) + hi + Mul128Fold64(lo, hi));
+    }
+    if (len >= 4) {
+        seed ^= static_cast<uint64_t>(Swap32(static_cast<uint32_t>(seed))) << 32;
+        uint64_t bitflip = (Read64(s + 8) ^ Read64(s + 16)) - seed;
+        uint64_t input = Read32(p + len - 4) + (static_cast<uint64_t>(Read32(p)) << 32);
+        return Rrmxmx(input ^ bitflip, len);
+    }
+    if (len > 0) {
+        uint32_t combined = (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[len >> 1]) << 24)
+            | static_cast<uint32_t>(p[len - 1]) | (static_cast<uint32_t>(len) << 8);
+        uint64_t bitflip = (Read32(s) ^ Read32(s + 4)) + seed;
+        return Avalanche64(combined ^ bitflip);
+    }
+    return Avalanche64(seed ^ Read64(s + 56) ^ Read64(s + 64));
+}
+
+inline uint64_t Hash17To128(const uint8_t* p, size_t len, const uint8_t* s, uint64_t seed) {
+    uint64_t acc = len * PRIME64_1;
+    if (len > 32) {
+        if (len > 64) {
+            if (len > 96) {
+                acc += Mix16(p + 48, s + 96, seed);
+                acc += Mix16(p + len - 64, s + 112, seed);
+            }
+            acc += Mix16(p + 32, s + 64, seed);
+            acc += Mix16(p + len - 48, s + 80, seed);
+        }
+        acc += Mix16(p + 16, s + 32, seed);
+        acc += Mix16(p + len - 32, s + 48, seed);
+    }
+    acc += Mix16(p, s, seed);
+    acc += Mix16(p + len - 16, s + 16, seed);
+    return Avalanche(acc);
+}
+
+inline uint64_t Hash129To240(const uint8_t* p, size_t len, const uint8_t* s, uint64_t seed) {
+    uint64_t acc = len * PRIME64_1;
+    size_t rounds = len / 16;
+    for (size_t i = 0; i < 8; ++i) acc += Mix16(p + 16 * i, s + 16 * i, seed);
+    acc = Avalanche(acc);
+    for (size_t i = 8; i < rounds; ++i) acc += Mix16(p + 16 * i, s + 16 * (i - 8) + 3, seed);
+    acc += Mix16(p + len - 16, s + 136 - 17, seed);
+    return Avalanche(acc);
+}
+
+inline void Accumulate512(uint64_t* acc, const uint8_t* p, const uint8_t* s) {
+#if defined(ENGINE_HASH_SSE2)
+    __m128i* xacc = reinterpret_cast<__m128i*>(acc);
+    for (size_t i = 0; i < ACC_LANES / 2; ++i) {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p) + i);
+        __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s) + i);
+        __m128i data_key = _mm_xor_si128(data, key);
+        __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        __m128i product = _mm_mul_epu32(data_key, data_key_hi);
+        __m128i data_swap = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        xacc[i] = _mm_add_epi64(product, _mm_add_epi64(xacc[i], data_swap));
+    }
+#else
+    for (size_t i = 0; i < ACC_LANES; ++i) {
+        uint64_t data = Read64(p + 8 * i);
+        uint64_t data_key = data ^ Read64(s + 8 * i);
+        acc[i ^ 1] += data;
+        acc[i] += (data_key & 0xFFFFFFFFull) * (data_key >> 32);
+    }
+#endif
+}
+
+inline void Scramble(uint64_t* acc, const uint8_t* s) {
+#if defined(ENGINE_HASH_SSE2)
+    __m128i* xacc = reinterpret_cast<__m128i*>(acc);
+    const __m128i prime = _mm_set1_epi32(static_cast<int>(PRIME32_1));
+    for (size_t i = 0; i < ACC_LANES / 2; ++i) {
+        __m128i a = _mm_xor_si128(xacc[i], _mm_srli_epi64(xacc[i], 47));
+        a = _mm_xor_si128(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(s) + i));
+        __m128i a_hi = _mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1));
+        __m128i product_lo = _mm_mul_epu32(a, prime);
+        __m128i product_hi = _mm_mul_epu32(a_hi, prime);
+        xacc[i] = _mm_add_epi64(product_lo, _mm_slli_epi64(product_hi, 32));
+    }
+#else
+    for (size_t i = 0; i < ACC_LANES; ++i) {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= Read64(s + 8 * i);
+        acc[i] = a * PRIME32_1;
+    }
+#endif
+}
+
+inline uint64_t HashLong(const uint8_t* p, size_t len, const uint8_t* s) {
+    alignas(16) uint64_t acc[ACC_LANES] = {
+        PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1
+    };
+
+    size_t blocks = (len - 1) / BLOCK_SIZE;
+    for (size_t b = 0; b < blocks; ++b) {
+        const uint8_t* block = p + b * BLOCK_SIZE;
+        for (size_t k = 0; k < STRIPES_PER_BLOCK; ++k) {
+            Accumulate512(acc, block + k * STRIPE_SIZE, s + k * SECRET_CONSUME_RATE);
+        }
+        Scramble(acc, s + SECRET_SIZE - STRIPE_SIZE);
+    }
+
+    // partial last block, then the final stripe which may overlap it
+    const uint8_t* tail = p + blocks * BLOCK_SIZE;
+    size_t stripes = ((len - 1) - blocks * BLOCK_SIZE) / STRIPE_SIZE;
+    for (size_t k = 0; k < stripes; ++k) {
+        Accumulate512(acc, tail + k * STRIPE_SIZE, s + k * SECRET_CONSUME_RATE);
+    }
+    Accumulate512(acc, p + len - STRIPE_SIZE, s + SECRET_SIZE - STRIPE_SIZE - 7);
+
+    uint64_t result = len * PRIME64_1;
+    for (size_t i = 0; i < ACC_LANES / 2; ++i) {
+        result += Mul128Fold64(acc[2 * i] ^ Read64(s + 11 + 16 * i), acc[2 * i + 1] ^ Read64(s + 11 + 16 * i + 8));
+    }
+    return Avalanche(result);
+}
+
+} // namespace hash_detail
+
+inline uint64_t Hash64(const void* data, size_t len, uint64_t seed = 0) {
+    using namespace hash_detail;
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* s = SECRET.data();
+
+    if (len <= 16) return Hash0To16(p, len, s, seed);
+    if (len <= 128) return Hash17To128(p, len, s, seed);
+    if (len <= 240) return Hash129To240(p, len, s, seed);
+    if (seed == 0) return HashLong(p, len, s);
+
+    // seeded long inputs use a secret derived from the seed
+    alignas(16) uint8_t custom[SECRET_SIZE];
+    for (size_t i = 0; i < SECRET_SIZE; i += 16) {
+        Write64(custom + i, Read64(s + i) + seed);
+        Write64(custom + i + 8, Read64(s + i + 8) - seed);
+    }
+    return HashLong(p, len, custom);
+}
+
+// gathers the fields of a key into an inline buffer and hashes it in one pass, so a key made of many small
+// fields costs one Hash64 instead of a chain of combines. never allocates, so it is safe inside noexcept
+// std::hash specializations. keys longer than the buffer are hashed a block at a time, each block seeding
+// the next. only types without padding may be added
+class Hasher {
+public:
+    // the longest input Hash64 takes without the long path
+    static constexpr size_t BUFFER_SIZE = 240;
+
+    // floats are hashed by value like == compares them, -0 as +0 and every nan alike
+    template <typename T>
+    Hasher& add(const T& value) noexcept {
+        static_assert(std::is_trivially_copyable_v<T>, "Hasher can only add trivially copyable values");
+        if constexpr (std::is_floating_point_v<T>) {
+            static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "Hasher cannot add types with padding bits");
+            T canonical = value;
+            if (canonical == T(0)) canonical = T(0);
+            if (canonical != canonical) canonical = std::numeric_limits<T>::quiet_NaN();
+            return add_bytes(&canonical, sizeof(T));
+        } else {
+            static_assert(std::has_unique_object_representations_v<T>, "Hasher cannot add types with padding bits");
+            return add_bytes(&value, sizeof(T));
+        }
+    }
+
+    Hasher& add_bytes(const void* data, size_t size) noexcept {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0) {
+            if (_size == BUFFER_SIZE) flush();
+            size_t count = std::min(size, BUFFER_SIZE - _size);
+            std::memcpy(_bytes + _size, bytes, count);
+            _size += count;
+            bytes += count;
+            size -= count;
+        }
+        return *this;
+    }
+
+    // keys that fit the buffer hash exactly like Hash64 over their bytes
+    uint64_t finish(uint64_t seed = 0) const noexcept {
+        if (_blocks == 0) return Hash64(_bytes, _size, seed);
+        return Hash64(_bytes, _size, _state ^ hash_detail::Avalanche64(seed + _blocks));
+    }
+
+private:
+    void flush() noexcept {
+        _state = Hash64(_bytes, _size, _state);
+        ++_blocks;
+        _size = 0;
+    }
+
+    uint8_t _bytes[BUFFER_SIZE];
+    size_t _size = 0;
+    uint64_t _state = 0;
+    uint64_t _blocks = 0;
+};
+
+} // namespace engine::core::memory
+
+#endif // engine_core_memory_HASH_HPP
@@ -0,0 +1,211 @@
+#ifndef engine_core_memory_OFFSET_ALLOCATOR_HPP
+#define engine_core_memory_OFFSET_ALLOCATOR_HPP
+
+#include "engine/core/debug/assert.hpp"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+namespace engine::core::memory {
+
+// best-fit range allocator over an abstract [0, capacity) space, used to suballocate gpu buffers
+class OffsetAllocator {
+public:
+    static constexpr uint64_t INVALID_OFFSET = UINT64_MAX;
+
+    struct Relocation {
+        uint64_t old_offset;
+        uint64_t new_offset;
+        uint64_t size;
+    };
+
+    explicit OffsetAllocator(uint64_t capacity = 0) : _capacity(capacity) {
+        if (_capacity > 0) insert_free_block(0, _capacity);
+    }
+
+    OffsetAllocator(OffsetAllocator&&) = default;
+    OffsetAllocator& operator=(OffsetAllocator&&) = default;
+
+    OffsetAllocator(const OffsetAllocator&) = delete;
+    OffsetAllocator& operator=(const OffsetAllocator&) = delete;
+
+    ~OffsetAllocator() = default;
+
+    // returns INVALID_OFFSET when no free block fits; alignment need not be a power of two
+    uint64_t allocate(uint64_t size, uint64_t alignment = 1) {
+        ENGINE_ASSERT(size > 0, "OffsetAllocator cannot allocate zero bytes");
+        ENGINE_ASSERT(alignment > 0, "OffsetAllocator alignment must be non-zero");
+
+        for (auto it = _free_by_size.lower_bound(size); it != _free_by_size.end(); ++it) {
+            uint64_t block_offset = it->second;
+            uint64_t block_size = it->first;
+            uint64_t aligned = AlignUp(block_offset, alignment);
+            if (aligned + size > block_offset + block_size) continue;
+
+            erase_free_block(block_offset, block_size);
+
+            // alignment padding and the tail go back to the free list
+            uint64_t begin = block_offset;
+            if (aligned > block_offset) {
+                insert_free_block(block_offset, aligned - block_offset);
+                begin = aligned;
+            }
+            uint64_t end = aligned + size;
+            if (end < block_offset + block_size) {
+                insert_free_block(end, block_offset + block_size - end);
+            }
+
+            _allocations[aligned] = Allocation{ begin, end - begin, size, alignment };
+            _used += end - begin;
+            return aligned;
+        }
+        return INVALID_OFFSET;
+    }
+
+    void free(uint64_t offset) {
+        auto it = _allocations.find(offset);
+        ENGINE_ASSERT(it != _allocations.end(), "OffsetAllocator::free called with unknown offset");
+        if (it == _allocations.end()) return;
+
+        uint64_t begin = it->second.begin;
+        uint64_t size = it->second.block_size;
+        _used -= size;
+        _allocations.erase(it);
+
+        // coalesce with neighbours
+        auto next = _free_blocks.lower_bound(begin);
+        if (next != _free_blocks.end() && next->first == begin + size) {
+            size += next->second;
+            erase_free_block(next->first, next->second);
+        }
+        auto prev = _free_blocks.lower_bound(begin);
+        if (prev != _free_blocks.begin()) {
+            --prev;
+            if (prev->first + prev->second == begin) {
+                begin = prev->first;
+                size += prev->second;
+                erase_free_block(prev->first, prev->second);
+            }
+        }
+        insert_free_block(begin, size);
+    }
+
+    // extends the space; existing offsets stay valid
+    void grow(uint64_t new_capacity) {
+        ENGINE_ASSERT(new_capacity >= _capacity, "OffsetAllocator cannot shrink");
+        if (new_capacity == _capacity) return;
+
+        uint64_t begin = _capacity;
+        uint64_t size = new_capacity - _capacity;
+        if (!_free_blocks.empty()) {
+            auto last = std::prev(_free_blocks.end());
+            if (last->first + last->second == _capacity) {
+                begin = last->first;
+                size += last->second;
+                erase_free_block(last->first, last->second);
+            }
+        }
+        insert_free_block(begin, size);
+        _capacity = new_capacity;
+    }
+
+    // drops free space at the end; nothing may be allocated past new_capacity
+    void shrink(uint64_t new_capacity) {
+        ENGINE_ASSERT(new_capacity <= _capacity, "OffsetAllocator cannot shrink to a larger capacity");
+        ENGINE_ASSERT(new_capacity >= allocated_end(), "OffsetAllocator cannot shrink below a live allocation");
+        if (new_capacity == _capacity) return;
+
+        auto last = std::prev(_free_blocks.end());
+        uint64_t begin = last->first;
+        erase_free_block(last->first, last->second);
+        if (new_capacity > begin) insert_free_block(begin, new_capacity - begin);
+        _capacity = new_capacity;
+    }
+
+    // packs live allocations towards offset zero, in address order; the caller moves the data
+    std::vector<Relocation> defragment() {
+        std::vector<Relocation> relocations;
+        std::map<uint64_t, Allocation> packed;
+
+        uint64_t cursor = 0;
+        for (const auto& [offset, allocation] : _allocations) {
+            uint64_t new_offset = AlignUp(cursor, allocation.alignment);
+            if (new_offset != offset) {
+                relocations.push_back({ offset, new_offset, allocation.size });
+            }
+            packed[new_offset] = Allocation{ new_offset, allocation.size, allocation.size, allocation.alignment };
+            cursor = new_offset + allocation.size;
+        }
+
+        _allocations = std::move(packed);
+        _free_blocks.clear();
+        _free_by_size.clear();
+
+        _used = 0;
+        for (const auto& [offset, allocation] : _allocations) _used += allocation.block_size;
+
+        // gaps left by alignment are returned as free blocks too
+        uint64_t previous_end = 0;
+        for (const auto& [offset, allocation] : _allocations) {
+            if (allocation.begin > previous_end) insert_free_block(previous_end, allocation.begin - previous_end);
+            previous_end = allocation.begin + allocation.block_size;
+        }
+        if (previous_end < _capacity) insert_free_block(previous_end, _capacity - previous_end);
+
+        return relocations;
+    }
+
+    uint64_t capacity() const { return _capacity; }
+    uint64_t used() const { return _used; }
+    uint64_t free_space() const { return _capacity - _used; }
+    // end of the highest allocation, where a shrink may cut
+    uint64_t allocated_end() const {
+        if (_allocations.empty()) return 0;
+        const Allocation& last = std::prev(_allocations.end())->second;
+        return last.begin + last.block_size;
+    }
+    uint64_t largest_free_block() const { return _free_by_size.empty() ? 0 : std::prev(_free_by_size.end())->first; }
+    size_t allocation_count() const { return _allocations.size(); }
+    size_t free_block_count() const { return _free_blocks.size(); }
+
+    static uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+private:
+    struct Allocation {
+        uint64_t begin;
+        uint64_t block_size;
+        uint64_t size;
+        uint64_t alignment;
+    };
+
+    void insert_free_block(uint64_t offset, uint64_t size) {
+        _free_blocks[offset] = size;
+        _free_by_size.emplace(size, offset);
+    }
+
+    void erase_free_block(uint64_t offset, uint64_t size) {
+        _free_blocks.erase(offset);
+        auto range = _free_by_size.equal_range(size);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == offset) {
+                _free_by_size.erase(it);
+                break;
+            }
+        }
+    }
+
+    uint64_t _capacity = 0;
+    uint64_t _used = 0;
+
+    std::map<uint64_t, uint64_t> _free_blocks;         // offset -> size
+    std::multimap<uint64_t, uint64_t> _free_by_size;   // size -> offset
+    std::map<uint64_t, Allocation> _allocations;       // aligned offset -> allocation
+};
+
+} // namespace engine::core::memory
+
+#endif // engine_core_memory_OFFSET_ALLOCATOR_HPP
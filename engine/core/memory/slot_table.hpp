@@ -0,0 +1,223 @@
+#ifndef engine_core_memory_SLOT_TABLE_HPP
+#define engine_core_memory_SLOT_TABLE_HPP
+
+#include "engine/core/debug/assert.hpp"
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace engine::core::memory {
+
+using SlotHandle = uint32_t;
+constexpr SlotHandle INVALID_SLOT_HANDLE = UINT32_MAX;
+
+// storage addressed by generational handles, released slots are reused and old handles to them go stale.
+// a handle packs the slot index in the low bits and the slot's generation in the high bits, so the first
+// handle of every slot equals its index.
+//
+// insert, reserve, publish and release may be called from any thread; get and contains never block and
+// never see a value before it is published. slots live in fixed chunks that never move, and released
+// values are only destroyed by reclaim(), which the owner calls once no thread still holds a pointer from get()
+template <typename T>
+class SlotTable {
+public:
+    using Handle = SlotHandle;
+
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t MAX_GENERATION = (UINT32_MAX >> INDEX_BITS) - 1;
+    static constexpr Handle INVALID_HANDLE = INVALID_SLOT_HANDLE;
+
+    static constexpr uint32_t Index(Handle handle) { return handle & INDEX_MASK; }
+    static constexpr uint32_t Generation(Handle handle) { return handle >> INDEX_BITS; }
+
+    SlotTable() = default;
+
+    SlotTable(const SlotTable&) = delete;
+    SlotTable& operator=(const SlotTable&) = delete;
+
+    ~SlotTable() = default;
+
+    // stores and publishes in one step
+    Handle insert(T&& value) {
+        Handle handle = reserve(std::move(value));
+        publish(handle);
+        return handle;
+    }
+
+    // stores the value under a handle that get() does not resolve until publish
+    Handle reserve(T&& value) {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        uint32_t index;
+        if (!_free.empty()) {
+            index = _free.back();
+            _free.pop_back();
+        } else {
+            index = _slot_count.load(std::memory_order_relaxed);
+            ENGINE_ASSERT(index < INDEX_MASK, "SlotTable is out of slot indices");
+            if ((index % CHUNK_SIZE) == 0) {
+                _owned_chunks.push_back(std::make_unique<Chunk>());
+                _chunks[index / CHUNK_SIZE].store(_owned_chunks.back().get(), std::memory_order_release);
+            }
+            _slot_count.store(index + 1, std::memory_order_release);
+        }
+
+        Slot& slot = slot_at(index);
+        uint32_t generation = slot.state.load(std::memory_order_relaxed) >> STATE_BITS;
+        slot.value.emplace(std::move(value));
+        slot.state.store((generation << STATE_BITS) | OCCUPIED, std::memory_order_release);
+        _size.fetch_add(1, std::memory_order_relaxed);
+        return Pack(index, generation);
+    }
+
+    void publish(Handle handle) {
+        Slot* slot = find(handle);
+        ENGINE_ASSERT(slot != nullptr, "Attempted to publish an invalid SlotTable handle");
+
+        uint32_t expected = (Generation(handle) << STATE_BITS) | OCCUPIED;
+        slot->state.compare_exchange_strong(expected, expected | PUBLISHED, std::memory_order_release);
+    }
+
+    // the handle goes stale immediately, the value is destroyed by the next reclaim(); false when already stale
+    bool release(Handle handle) {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        Slot* slot = find(handle);
+        if (!slot) return false;
+
+        uint32_t state = slot->state.load(std::memory_order_relaxed);
+        if ((state >> STATE_BITS) != Generation(handle) || !(state & OCCUPIED)) return false;
+
+        slot->state.store((Generation(handle) + 1) << STATE_BITS, std::memory_order_release);
+        _released.push_back(Index(handle));
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // releases every value, all outstanding handles go stale
+    void clear() {
+        uint32_t count = _slot_count.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t state = slot_at(i).state.load(std::memory_order_acquire);
+            if (state & OCCUPIED) release(Pack(i, state >> STATE_BITS));
+        }
+    }
+
+    // destroys released values and makes their slots reusable, on_destroy sees each value first
+    template <typename F>
+    void reclaim(F&& on_destroy) {
+        std::vector<uint32_t> released;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            released.swap(_released);
+        }
+
+        for (uint32_t index : released) {
+            Slot& slot = slot_at(index);
+            on_destroy(*slot.value);
+            slot.value.reset();
+        }
+
+        // a slot whose generation would wrap is never reused, so no stale handle can alias a new one
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (uint32_t index : released) {
+            if ((slot_at(index).state.load(std::memory_order_relaxed) >> STATE_BITS) <= MAX_GENERATION) {
+                _free.push_back(index);
+            }
+        }
+    }
+
+    void reclaim() { reclaim([](T&) {}); }
+
+    // true when released values are waiting for reclaim()
+    bool reclaimable() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return !_released.empty();
+    }
+
+    bool contains(Handle handle) const {
+        const Slot* slot = find(handle);
+        return slot && slot->state.load(std::memory_order_acquire) == ((Generation(handle) << STATE_BITS) | OCCUPIED | PUBLISHED);
+    }
+
+    // reserved but not yet published
+    bool pending(Handle handle) const {
+        const Slot* slot = find(handle);
+        return slot && slot->state.load(std::memory_order_acquire) == ((Generation(handle) << STATE_BITS) | OCCUPIED);
+    }
+
+    // null for stale or unpublished handles
+    T* get(Handle handle) { return contains(handle) ? &*find(handle)->value : nullptr; }
+    const T* get(Handle handle) const { return contains(handle) ? &*find(handle)->value : nullptr; }
+
+    // for whoever reserved the handle, to finish the value before publishing it
+    T* get_pending(Handle handle) { return pending(handle) ? &*find(handle)->value : nullptr; }
+
+    // visits published values as (handle, value)
+    template <typename F>
+    void for_each(F&& fn) {
+        uint32_t count = _slot_count.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; ++i) {
+            Slot& slot = slot_at(i);
+            uint32_t state = slot.state.load(std::memory_order_acquire);
+            if ((state & (OCCUPIED | PUBLISHED)) == (OCCUPIED | PUBLISHED)) fn(Pack(i, state >> STATE_BITS), *slot.value);
+        }
+    }
+
+    size_t size() const { return _size.load(std::memory_order_relaxed); }
+    size_t capacity() const { return _slot_count.load(std::memory_order_relaxed); }
+    bool empty() const { return size() == 0; }
+
+private:
+    static constexpr uint32_t CHUNK_BITS = 10;
+    static constexpr uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+    static constexpr uint32_t MAX_CHUNKS = (INDEX_MASK + 1) / CHUNK_SIZE;
+
+    // low state bits, the generation sits above them
+    static constexpr uint32_t STATE_BITS = 2;
+    static constexpr uint32_t OCCUPIED = 1u << 0;
+    static constexpr uint32_t PUBLISHED = 1u << 1;
+
+    struct Slot {
+        std::atomic<uint32_t> state{0};
+        std::optional<T> value;
+    };
+
+    using Chunk = std::array<Slot, CHUNK_SIZE>;
+
+    static constexpr Handle Pack(uint32_t index, uint32_t generation) {
+        return (generation << INDEX_BITS) | index;
+    }
+
+    Slot& slot_at(uint32_t index) const {
+        return (*_chunks[index / CHUNK_SIZE].load(std::memory_order_acquire))[index % CHUNK_SIZE];
+    }
+
+    Slot* find(Handle handle) const {
+        if (handle == INVALID_HANDLE) return nullptr;
+        uint32_t index = Index(handle);
+        if (index >= _slot_count.load(std::memory_order_acquire)) return nullptr;
+        return &slot_at(index);
+    }
+
+    std::array<std::atomic<Chunk*>, MAX_CHUNKS> _chunks{};
+    std::atomic<uint32_t> _slot_count{0};
+    std::atomic<size_t> _size{0};
+
+    // writers only
+    mutable std::mutex _mutex;
+    std::vector<std::unique_ptr<Chunk>> _owned_chunks;
+    std::vector<uint32_t> _free;
+    std::vector<uint32_t> _released;
+};
+
+} // namespace engine::core::memory
+
+#endif // engine_core_memory_SLOT_TABLE_HPP
@@ -6,6 +6,11 @@
 #include "engine/core/graphics/descriptor_set_layout.hpp"
 #include "engine/core/graphics/material.hpp"
 #include "engine/core/graphics/pipeline.hpp"
+#include "engine/core/graphics/bindless_table.hpp"
+
+#include "engine/core/renderer/cache/texture_cache.hpp"
+
+#include "engine/core/memory/slot_table.hpp"
 
 #include "engine/core/debug/assert.hpp"
 #include "engine/core/debug/logger.hpp"
@@ -13,20 +18,33 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <cstring>
 #include <cstdint>
 
 namespace engine::core::renderer::cache {
 
-using MaterialCacheId = uint32_t;
+using MaterialCacheId = memory::SlotHandle;
 
+// descriptor set materials, or with a bindless table, parameter blocks in the table that draws index through a
+// push constant. a bindless material's textures are written into its parameters as their current table slots
 class MaterialCache {
 public:
-    MaterialCache(graphics::Device& device) : _device(device), _next_id(0) {}
+    // textures are resolved through the texture cache, which must share the table
+    MaterialCache(graphics::Device& device, graphics::BindlessTable* bindless = nullptr, const TextureCache* textures = nullptr)
+        : _device(device), _bindless(bindless), _textures(textures) {}
 
     MaterialCache(const MaterialCache&) = delete;
     MaterialCache& operator=(const MaterialCache&) = delete;
-    ~MaterialCache() = default;
 
+    ~MaterialCache() {
+        // the table may outlive the cache
+        if (!_bindless) return;
+        _materials.clear();
+        reclaim();
+    }
+
+    // safe from any thread
     MaterialCacheId register_material(
         const graphics::Pipeline& pipeline,
         const graphics::DescriptorLayoutDescription& desc,
@@ -34,47 +52,177 @@ public:
     {
         const graphics::DescriptorSetLayout& layout = get_or_create_layout(desc);
 
-        std::unique_ptr<graphics::Material> material = pipeline.create_material(layout, uniform_size);
+        Entry entry;
+        entry.material = pipeline.create_material(layout, uniform_size);
+        return _materials.insert(std::move(entry));
+    }
+
+    // where a texture's table slot goes inside a bindless material's parameters
+    struct TextureBinding {
+        size_t offset;      // of a BindlessIndex
+        TextureCacheId texture;
+    };
+
+    // params is the table's material_stride() bytes, laid out as the shaders' MaterialParams; render thread only.
+    // invalid when the table is full
+    MaterialCacheId register_material(const void* params, std::vector<TextureBinding> textures = {}) {
+        ENGINE_ASSERT(_bindless, "Bindless materials require a MaterialCache with a bindless table");
+        ENGINE_ASSERT(textures.empty() || _textures, "Bindless material textures require a MaterialCache with a texture cache");
+
+        Entry entry;
+        entry.params.resize(_bindless->material_stride());
+        std::memcpy(entry.params.data(), params, entry.params.size());
+        entry.textures = std::move(textures);
+        write_textures(entry.params, entry.textures);
+
+        entry.bindless_index = _bindless->register_material(entry.params.data());
+        if (entry.bindless_index == graphics::INVALID_BINDLESS_INDEX) return memory::INVALID_SLOT_HANDLE;
+        return _materials.insert(std::move(entry));
+    }
+
+    // render thread. the material moves to a fresh slot and frames in flight keep reading the old one; with the
+    // table full it keeps its old parameters until next_frame finds room
+    void update_material(MaterialCacheId id, const void* params) {
+        Entry* entry = _materials.get(id);
+        ENGINE_ASSERT(entry && entry->bindless_index != graphics::INVALID_BINDLESS_INDEX, "Invalid or stale bindless MaterialCacheId for MaterialCache");
+        if (!entry) return;
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(params);
+        entry->pending_params.assign(bytes, bytes + entry->params.size());
+        if (move_slot(*entry, entry->pending_params)) entry->pending_params.clear();
+    }
+
+    // the slot draws push, it moves when the material is updated or one of its textures moves to another slot
+    graphics::BindlessIndex bindless_index(MaterialCacheId id) const {
+        const Entry* entry = _materials.get(id);
+        ENGINE_ASSERT(entry, "Invalid or stale MaterialCacheId for MaterialCache");
+        return entry ? entry->bindless_index : graphics::INVALID_BINDLESS_INDEX;
+    }
+
+    // render thread, once per frame after the texture cache's next_frame. materials whose textures streamed into
+    // other slots move to a fresh slot with the new indices, so the slot frames in flight read is never rewritten
+    void next_frame() {
+        if (!_bindless) return;
+
+        // a full table keeps the old slot and tries again next frame
+        _materials.for_each([this](MaterialCacheId, Entry& entry) {
+            if (entry.bindless_index == graphics::INVALID_BINDLESS_INDEX) return;
+            if (!entry.pending_params.empty()) {
+                if (move_slot(entry, entry.pending_params)) entry.pending_params.clear();
+            } else if (textures_moved(entry)) {
+                move_slot(entry, entry.params);
+            }
+        });
+    }
+
+    // the id goes stale now, the material is destroyed by the next reclaim() and its descriptor set
+    // recycled by the device once in-flight frames are done with it
+    void release(MaterialCacheId id) {
+        if (!_materials.release(id)) {
+            core::debug::Logger::get_singleton().warn("Released stale MaterialCacheId {}", id);
+        }
+    }
 
-        MaterialCacheId id = _next_id++;
-        _materials.emplace_back(std::move(material));
-        return id;
+    // render thread, once no material pointer from get() is held anymore
+    void reclaim() {
+        // table slots are reused only once in-flight frames are done with them
+        _materials.reclaim([this](Entry& entry) {
+            if (entry.bindless_index != graphics::INVALID_BINDLESS_INDEX) _bindless->release_material(entry.bindless_index);
+        });
     }
+    bool reclaimable() const { return _materials.reclaimable(); }
 
+    // render thread only, every outstanding id goes stale
     void clear() {
         _materials.clear();
+        reclaim();
+
+        std::lock_guard<std::mutex> lock(_layout_mutex);
         _layouts.clear();
     }
 
+    // null for bindless materials
     graphics::Material* get(MaterialCacheId id) {
-        ENGINE_ASSERT(id < _next_id, "Invalid MaterialCacheId for MaterialCache");
-        return _materials[id].get();
+        ENGINE_ASSERT(_materials.contains(id), "Invalid or stale MaterialCacheId for MaterialCache");
+        return _materials.get(id)->material.get();
     }
 
     const graphics::Material* get(MaterialCacheId id) const {
-        ENGINE_ASSERT(id < _next_id, "Invalid MaterialCacheId for MaterialCache");
-        return _materials[id].get();
+        ENGINE_ASSERT(_materials.contains(id), "Invalid or stale MaterialCacheId for MaterialCache");
+        return _materials.get(id)->material.get();
     }
 
+    bool contains(MaterialCacheId id) const { return _materials.contains(id); }
+    size_t size() const { return _materials.size(); }
+
     const graphics::DescriptorSetLayout& get_or_create_layout(
         const graphics::DescriptorLayoutDescription& desc)
     {
-        size_t hash = desc.hash();
-        auto it = _layouts.find(hash);
+        std::lock_guard<std::mutex> lock(_layout_mutex);
+
+        auto it = _layouts.find(desc);
         if (it != _layouts.end())
             return *it->second;
 
         std::unique_ptr<graphics::DescriptorSetLayout> layout = _device.create_descriptor_set_layout(desc);
-        _layouts[hash] = std::move(layout);
-        return *_layouts[hash];
+        return *_layouts.emplace(desc, std::move(layout)).first->second;
     }
 
 private:
+    struct Entry {
+        std::unique_ptr<graphics::Material> material;
+
+        // bindless materials
+        graphics::BindlessIndex bindless_index = graphics::INVALID_BINDLESS_INDEX;
+        std::vector<uint8_t> params;
+        std::vector<uint8_t> pending_params;    // an update still waiting for a free slot
+        std::vector<TextureBinding> textures;
+    };
+
+    static graphics::BindlessIndex TextureSlot(const std::vector<uint8_t>& params, const TextureBinding& binding) {
+        ENGINE_ASSERT(binding.offset + sizeof(graphics::BindlessIndex) <= params.size(), "Bindless material texture offset out of range");
+        graphics::BindlessIndex index;
+        std::memcpy(&index, params.data() + binding.offset, sizeof(index));
+        return index;
+    }
+
+    // true when a texture moved to another slot since the params were written
+    bool textures_moved(const Entry& entry) const {
+        for (const TextureBinding& binding : entry.textures) {
+            if (TextureSlot(entry.params, binding) != _textures->bindless_index(binding.texture)) return true;
+        }
+        return false;
+    }
+
+    // registers params with the textures' current slots and releases the old slot, which stays readable until
+    // frames in flight are done with it. false with the table full
+    bool move_slot(Entry& entry, std::vector<uint8_t> params) {
+        write_textures(params, entry.textures);
+        graphics::BindlessIndex moved = _bindless->register_material(params.data());
+        if (moved == graphics::INVALID_BINDLESS_INDEX) return false;
+
+        _bindless->release_material(entry.bindless_index);
+        entry.bindless_index = moved;
+        entry.params = std::move(params);
+        return true;
+    }
+
+    // writes every texture's current slot into params, loading textures are invalid and shaders skip them
+    void write_textures(std::vector<uint8_t>& params, const std::vector<TextureBinding>& textures) const {
+        for (const TextureBinding& binding : textures) {
+            ENGINE_ASSERT(binding.offset + sizeof(graphics::BindlessIndex) <= params.size(), "Bindless material texture offset out of range");
+            graphics::BindlessIndex index = _textures->bindless_index(binding.texture);
+            std::memcpy(params.data() + binding.offset, &index, sizeof(index));
+        }
+    }
+
     const graphics::Device& _device;
+    graphics::BindlessTable* _bindless;
+    const TextureCache* _textures;
 
-    MaterialCacheId _next_id;
-    std::unordered_map<size_t, std::unique_ptr<graphics::DescriptorSetLayout>> _layouts;
-    std::vector<std::unique_ptr<graphics::Material>> _materials;
+    std::mutex _layout_mutex;
+    std::unordered_map<graphics::DescriptorLayoutDescription, std::unique_ptr<graphics::DescriptorSetLayout>> _layouts;
+    memory::SlotTable<Entry> _materials;
 };
 
 } // namespace engine::core::renderer::cache
@@ -4,58 +4,470 @@
 #include "engine/core/graphics/device.hpp"
 #include "engine/core/graphics/mesh_buffer.hpp"
 #include "engine/import/mesh.hpp"
+#include "engine/import/cooked_mesh.hpp"
+#include "engine/import/vertex_quantize.hpp"
+#include "engine/import/meshlet.hpp"
+
+#include "engine/core/memory/slot_table.hpp"
+#include "engine/core/thread/thread_pool.hpp"
 
 #include "engine/core/debug/assert.hpp"
 #include "engine/core/debug/logger.hpp"
 
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <future>
+#include <chrono>
+#include <mutex>
+#include <thread>
 #include <cstdint>
 
 namespace engine::core::renderer::cache {
 
-using MeshCacheId = uint32_t;
+using MeshCacheId = memory::SlotHandle;
 
+// owns mesh buffers and evicts the least recently drawn ones when over the memory budget.
+// the thread that constructs the cache is its render thread and owns get, next_frame and clear;
+// register_mesh and release may be called from any thread
 class MeshCache {
 public:
-    MeshCache(const graphics::Device& device) : _device(device), _next_id(0) {}
+    MeshCache(graphics::Device& device) : _device(device), _render_thread(std::this_thread::get_id()) {}
     MeshCache(const MeshCache&) = delete;
     MeshCache& operator=(const MeshCache&) = delete;
     ~MeshCache() = default;
 
-    MeshCacheId register_mesh(const import::ObjModel& model) {
-        if (model.meshes.empty()) return -1;
+    // keeps a cpu copy of the packed mesh to re-upload from after eviction. a mesh packed with anything but
+    // VertexQuantization::None() needs a pipeline built with its QuantizedVertexLayout, and a quantized one its
+    // dequantization folded into the model matrix
+    MeshCacheId register_mesh(const import::ObjModel& model,
+        const import::VertexQuantization& quantization = import::VertexQuantization::None()) {
+        Entry entry;
+        if (!Pack(model, entry, quantization)) return memory::INVALID_SLOT_HANDLE;
+        return add(std::move(entry));
+    }
 
-        const auto& mesh = model.meshes[0];
-        std::unique_ptr<graphics::MeshBuffer> mesh_buffer = _device.create_mesh_buffer(
-            mesh.vertices.data(), sizeof(import::ObjVertex), mesh.vertices.size(),
-            mesh.indices.data(), sizeof(uint32_t), mesh.indices.size()
-        );
-        MeshCacheId id = _next_id++;
-        _meshes.emplace_back(std::move(mesh_buffer));
-        return id;
+    // keeps only the path, evicted meshes are read from disk again. a cooked .jmesh is uploaded straight
+    // from its mapping, anything else goes through the obj importer
+    MeshCacheId register_mesh(const std::string& filepath) {
+        Entry entry;
+        if (!Load(filepath, entry)) return memory::INVALID_SLOT_HANDLE;
+        entry.source_path = filepath;
+        return add(std::move(entry));
+    }
+
+    // the id goes stale now, the buffer lives until frames that drew it have finished
+    void release(MeshCacheId id) {
+        if (!_meshes.release(id)) {
+            core::debug::Logger::get_singleton().warn("Released stale MeshCacheId {}", id);
+        }
     }
 
-    void clear() noexcept {
+    // every outstanding id goes stale, the buffers are retired like released ones and freed by next_frame
+    // once frames that drew them have finished
+    void clear() {
         _meshes.clear();
+        retire_released();
+
+        _reloading.clear();
+
+        std::lock_guard<std::mutex> lock(_pending_mutex);
+        _pending_uploads.clear();
     }
 
+    // marks the mesh as used this frame. null while a mesh registered on another thread still waits for its
+    // upload, and while an evicted one is reloaded: that happens in next_frame, reading the file again on the
+    // thread pool, so nothing is uploaded while a frame records. a mesh whose reload failed stays null
     graphics::MeshBuffer* get(MeshCacheId id) {
-        ENGINE_ASSERT(id < _next_id, "Invalid MeshCacheId for MeshCache");
-        return _meshes.at(id).get();
+        Entry* entry = _meshes.get(id);
+        if (!entry) {
+            ENGINE_ASSERT(_meshes.pending(id), "Invalid or stale MeshCacheId for MeshCache");
+            return nullptr;
+        }
+        entry->last_used_frame = _frame;
+        if (!entry->buffer && !entry->reload_queued && !entry->reload_failed) queue_reload(id, *entry);
+        return entry->buffer.get();
     }
 
+    // null when the mesh is currently evicted or not uploaded yet
     const graphics::MeshBuffer* get(MeshCacheId id) const {
-        ENGINE_ASSERT(id < _next_id, "Invalid MeshCacheId for MeshCache");
-        return _meshes.at(id).get();
+        const Entry* entry = _meshes.get(id);
+        if (!entry) {
+            ENGINE_ASSERT(_meshes.pending(id), "Invalid or stale MeshCacheId for MeshCache");
+            return nullptr;
+        }
+        return entry->buffer.get();
+    }
+
+    // identity for float positions
+    import::PositionDequantization dequantization(MeshCacheId id) const {
+        const Entry* entry = _meshes.get(id);
+        ENGINE_ASSERT(entry, "Invalid or stale MeshCacheId for MeshCache");
+        return entry ? entry->dequantization : import::PositionDequantization{};
+    }
+
+    // finest first, known without the mesh being resident so lod selection does not force an upload
+    const std::vector<graphics::MeshLod>& lods(MeshCacheId id) const {
+        static const std::vector<graphics::MeshLod> none;
+        const Entry* entry = _meshes.get(id);
+        ENGINE_ASSERT(entry, "Invalid or stale MeshCacheId for MeshCache");
+        return entry ? entry->lods : none;
+    }
+
+    // object space, available while the mesh is evicted
+    const import::MeshBounds& bounds(MeshCacheId id) const {
+        static const import::MeshBounds none;
+        const Entry* entry = _meshes.get(id);
+        ENGINE_ASSERT(entry, "Invalid or stale MeshCacheId for MeshCache");
+        return entry ? entry->bounds : none;
+    }
+
+    // meshlet vertices index the packed model's vertices, like its indices do
+    const import::Meshlets& meshlets(MeshCacheId id) const {
+        static const import::Meshlets none;
+        const Entry* entry = _meshes.get(id);
+        ENGINE_ASSERT(entry, "Invalid or stale MeshCacheId for MeshCache");
+        return entry ? entry->meshlets : none;
+    }
+
+    bool contains(MeshCacheId id) const { return _meshes.contains(id); }
+    // registered on another thread and waiting for next_frame to upload it
+    bool pending(MeshCacheId id) const { return _meshes.pending(id); }
+    size_t size() const { return _meshes.size(); }
+
+    // call once per frame, after the frame's draws are recorded
+    void next_frame() {
+        ++_frame;
+        upload_pending();
+        finish_reloads();
+
+        retire_released();
+        const size_t retired_count = _retired.size();
+        std::erase_if(_retired, [this](const Retired& retired) { return _frame - retired.last_used_frame >= _eviction_age; });
+
+        // freed ranges only return to the shared mesh buffers, which give memory back once mostly empty
+        const uint64_t evictions = _eviction_count;
+        evict_to_budget(0);
+        if (_retired.size() != retired_count || _eviction_count != evictions) _device.trim_mesh_buffers();
     }
 
+    // 0 uses the device's reported budget
+    void set_budget(uint64_t bytes) { _budget = bytes; }
+    // meshes drawn within this many frames are never evicted, must cover the frames in flight
+    void set_eviction_age(uint64_t frames) { _eviction_age = std::max<uint64_t>(frames, 1); }
+
+    uint64_t budget() const { return _budget; }
+    uint64_t resident_bytes() const { return _resident_bytes; }
+    uint64_t eviction_count() const { return _eviction_count; }
+    uint64_t reupload_count() const { return _reupload_count; }
+
 private:
-    const graphics::Device& _device;
-    
-    MeshCacheId _next_id;
-    std::vector<std::unique_ptr<graphics::MeshBuffer>> _meshes;
+    struct Entry {
+        std::unique_ptr<graphics::MeshBuffer> buffer;
+
+        // re-upload source, either the packed data or the file it came from
+        std::vector<std::vector<uint8_t>> vertex_streams;   // vertex_count vertices of vertex_strides[i] bytes each
+        std::vector<uint8_t> indices;   // index_count indices of index_size bytes each
+        std::vector<graphics::SubMesh> submeshes;
+        std::vector<graphics::MeshLod> lods;
+        import::Meshlets meshlets;      // lod 0, kept through eviction for culling
+        import::MeshBounds bounds;      // of every submesh together, kept like meshlets
+        import::CookedMesh cooked;      // mapped instead of vertices and indices for .jmesh sources
+        std::vector<uint32_t> vertex_strides;
+        uint32_t vertex_count = 0;
+        import::PositionDequantization dequantization;
+        uint32_t index_size = sizeof(uint32_t);
+        uint32_t index_count = 0;
+        std::string source_path;
+
+        std::future<std::unique_ptr<Entry>> reloading; // valid while a disk backed reload is read, null on failure
+        bool reload_queued = false;
+        bool reload_failed = false;     // not retried, the file is not going to come back by itself
+
+        uint64_t size_bytes = 0;
+        uint64_t last_used_frame = 0;
+    };
+
+    struct Retired {
+        std::unique_ptr<graphics::MeshBuffer> buffer;
+        uint64_t last_used_frame;
+    };
+
+    // every shape of the model goes into one allocation, addressable as a submesh, with 16-bit indices
+    // whenever the combined vertex count allows it. the index data is level major, every submesh at lod 0
+    // and then every submesh at each coarser lod
+    static bool Pack(const import::ObjModel& model, Entry& entry,
+        const import::VertexQuantization& quantization = import::VertexQuantization::None()) {
+        const size_t lod_count = model.lod_count();
+        size_t vertex_count = 0;
+        size_t index_count = 0;
+        for (const auto& mesh : model.meshes) {
+            if (mesh.indices.empty()) continue;
+            vertex_count += mesh.vertices.size();
+            for (size_t level = 0; level < lod_count; ++level) index_count += mesh.lod_indices(level).size();
+        }
+        if (index_count == 0) return false;
+
+        entry.index_size = import::FitsIndex16(vertex_count) ? sizeof(uint16_t) : sizeof(uint32_t);
+        entry.index_count = static_cast<uint32_t>(index_count);
+        entry.indices.resize(index_count * entry.index_size);
+        entry.submeshes.reserve(model.meshes.size());
+        entry.lods.reserve(lod_count);
+
+        std::vector<import::ObjVertex> vertices;
+        vertices.reserve(vertex_count);
+        std::vector<uint32_t> base_vertices;
+        for (const auto& mesh : model.meshes) {
+            base_vertices.push_back(static_cast<uint32_t>(vertices.size()));
+            if (!mesh.indices.empty()) vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+        }
+
+        uint32_t first_index = 0;
+        for (size_t level = 0; level < lod_count; ++level) {
+            graphics::MeshLod lod{ first_index, 0, 0.0f };
+            for (size_t m = 0; m < model.meshes.size(); ++m) {
+                const auto& mesh = model.meshes[m];
+                if (mesh.indices.empty()) continue;
+
+                const std::vector<uint32_t>& indices = mesh.lod_indices(level);
+                if (level == 0) {
+                    entry.submeshes.push_back(graphics::SubMesh{ mesh.name, first_index, static_cast<uint32_t>(indices.size()) });
+                }
+                if (entry.index_size == sizeof(uint16_t)) {
+                    uint16_t* out = reinterpret_cast<uint16_t*>(entry.indices.data()) + first_index;
+                    for (uint32_t index : indices) *out++ = static_cast<uint16_t>(base_vertices[m] + index);
+                } else {
+                    uint32_t* out = reinterpret_cast<uint32_t*>(entry.indices.data()) + first_index;
+                    for (uint32_t index : indices) *out++ = base_vertices[m] + index;
+                }
+                first_index += static_cast<uint32_t>(indices.size());
+                lod.error = std::max(lod.error, mesh.lod_error(level));
+            }
+            lod.index_count = first_index - lod.first_index;
+            entry.lods.push_back(lod);
+        }
+
+        entry.meshlets = import::BuildMeshlets(model);
+        entry.bounds = import::ComputeMeshBounds(vertices);
+
+        // quantized over the whole model, so every submesh shares one dequantization
+        import::QuantizedVertices packed = import::QuantizeVertices(vertices, quantization);
+        entry.vertex_streams = std::move(packed.streams);
+        entry.vertex_strides.clear();
+        for (const graphics::VertexBindingDescription& binding : packed.layout) entry.vertex_strides.push_back(binding.stride);
+        entry.vertex_count = static_cast<uint32_t>(vertices.size());
+        entry.dequantization = packed.dequantization;
+
+        entry.size_bytes = entry.indices.size();
+        for (const std::vector<uint8_t>& stream : entry.vertex_streams) entry.size_bytes += stream.size();
+        return true;
+    }
+
+    static bool Load(const std::string& filepath, Entry& entry) {
+        if (!filepath.ends_with(".jmesh")) return Pack(import::ReadObj(filepath), entry);
+
+        import::CookedMesh cooked(filepath);
+        if (!cooked.valid()) return false;
+
+        entry.submeshes = cooked.submeshes();
+        entry.lods = cooked.lods();
+        entry.meshlets = cooked.meshlets();
+        entry.bounds = cooked.bounds();
+        entry.vertex_strides.clear();
+        for (const graphics::VertexStream& stream : cooked.vertex_streams()) entry.vertex_strides.push_back(stream.stride);
+        entry.vertex_count = cooked.vertex_count();
+        entry.dequantization = cooked.dequantization();
+        entry.index_size = cooked.index_size();
+        entry.index_count = cooked.index_count();
+        entry.size_bytes = cooked.blob_size();
+        entry.cooked = std::move(cooked);
+        return true;
+    }
+
+    MeshCacheId add(Entry&& entry) {
+        // other threads only reserve the id, the render thread uploads and publishes it on its next frame
+        if (std::this_thread::get_id() != _render_thread) {
+            MeshCacheId id = _meshes.reserve(std::move(entry));
+            std::lock_guard<std::mutex> lock(_pending_mutex);
+            _pending_uploads.push_back(id);
+            return id;
+        }
+
+        evict_to_budget(entry.size_bytes);
+        make_resident(entry);
+        return _meshes.insert(std::move(entry));
+    }
+
+    // data is staged before publishing, and every submit waits on staged uploads, so a published mesh is always drawable
+    void upload_pending() {
+        std::vector<MeshCacheId> pending;
+        {
+            std::lock_guard<std::mutex> lock(_pending_mutex);
+            pending.swap(_pending_uploads);
+        }
+
+        for (MeshCacheId id : pending) {
+            Entry* entry = _meshes.get_pending(id);
+            if (!entry) continue; // released before it was uploaded
+
+            evict_to_budget(entry->size_bytes);
+            make_resident(*entry);
+            _meshes.publish(id);
+        }
+    }
+
+    // released entries hand their buffers to the retired list, which outlives the frames in flight
+    void retire_released() {
+        _meshes.reclaim([this](Entry& entry) {
+            if (!entry.buffer) return;
+            _resident_bytes -= entry.size_bytes;
+            _retired.push_back(Retired{ std::move(entry.buffer), entry.last_used_frame });
+        });
+    }
+
+    void make_resident(Entry& entry) {
+        upload(entry);
+        entry.last_used_frame = _frame;
+
+        // disk backed meshes do not keep the cpu copy around
+        if (!entry.source_path.empty()) release_cpu_copy(entry);
+    }
+
+    void upload(Entry& entry) {
+        std::vector<graphics::VertexStream> vertex_streams;
+        if (entry.cooked.valid()) {
+            vertex_streams = entry.cooked.vertex_streams();
+        } else {
+            for (size_t s = 0; s < entry.vertex_streams.size(); ++s) {
+                vertex_streams.push_back(graphics::VertexStream{ entry.vertex_streams[s].data(), entry.vertex_strides[s] });
+            }
+        }
+        const void* index_data = entry.cooked.valid() ? entry.cooked.index_data() : entry.indices.data();
+
+        entry.buffer = _device.create_mesh_buffer(
+            vertex_streams, entry.vertex_count,
+            index_data, entry.index_size, entry.index_count,
+            entry.submeshes, entry.lods
+        );
+        _resident_bytes += entry.size_bytes;
+    }
+
+    void queue_reload(MeshCacheId id, Entry& entry) {
+        entry.reload_queued = true;
+        if (!entry.source_path.empty()) {
+            entry.reloading = thread::ThreadPool::get_singleton().submit([filepath = entry.source_path]() {
+                auto loaded = std::make_unique<Entry>();
+                if (!Load(filepath, *loaded)) loaded.reset();
+                return loaded;
+            });
+        }
+        _reloading.push_back(id);
+    }
+
+    // in memory meshes upload straight away, disk backed ones once the worker has read them
+    void finish_reloads() {
+        std::erase_if(_reloading, [this](MeshCacheId id) {
+            Entry* entry = _meshes.get(id);
+            if (!entry) return true; // released while reloading
+
+            if (entry->reloading.valid()) {
+                if (entry->reloading.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+                std::unique_ptr<Entry> loaded = entry->reloading.get();
+                if (!loaded) {
+                    core::debug::Logger::get_singleton().error("Failed to reload evicted mesh from {}", entry->source_path);
+                    entry->reload_queued = false;
+                    entry->reload_failed = true;
+                    return true;
+                }
+                entry->vertex_streams = std::move(loaded->vertex_streams);
+                entry->indices = std::move(loaded->indices);
+                entry->submeshes = std::move(loaded->submeshes);
+                entry->lods = std::move(loaded->lods);
+                entry->meshlets = std::move(loaded->meshlets);
+                entry->bounds = loaded->bounds;
+                entry->cooked = std::move(loaded->cooked);
+                entry->vertex_strides = std::move(loaded->vertex_strides);
+                entry->vertex_count = loaded->vertex_count;
+                entry->dequantization = loaded->dequantization;
+                entry->index_size = loaded->index_size;
+                entry->index_count = loaded->index_count;
+                entry->size_bytes = loaded->size_bytes;
+            }
+
+            evict_to_budget(entry->size_bytes);
+            upload(*entry);
+            if (!entry->source_path.empty()) release_cpu_copy(*entry);
+            entry->reload_queued = false;
+            ++_reupload_count;
+            return true;
+        });
+    }
+
+    static void release_cpu_copy(Entry& entry) {
+        entry.vertex_streams = {};
+        entry.indices = {};
+        entry.cooked = {};
+    }
+
+    uint64_t effective_budget() const {
+        if (_budget != 0) return _budget;
+
+        // the device budget is shared with every other allocation, only claim what is left plus what we hold.
+        // the shared mesh buffers are ours whole: their free space is where the next upload goes, so it is
+        // budgeted like resident bytes rather than counted as someone else's usage
+        uint64_t device_budget = _device.memory_budget();
+        uint64_t device_usage = _device.memory_usage();
+        if (device_budget == 0) return UINT64_MAX;
+        uint64_t mesh_buffers = std::max(_device.mesh_buffer_capacity(), _resident_bytes);
+        uint64_t others = (device_usage > mesh_buffers) ? device_usage - mesh_buffers : 0;
+        return (device_budget > others) ? device_budget - others : 0;
+    }
+
+    // evicts least recently used meshes until incoming bytes fit, skipping anything drawn recently
+    void evict_to_budget(uint64_t incoming) {
+        uint64_t budget = effective_budget();
+        if (_resident_bytes + incoming <= budget) return;
+
+        std::vector<Entry*> candidates;
+        _meshes.for_each([&](MeshCacheId, Entry& entry) {
+            if (entry.buffer && _frame - entry.last_used_frame >= _eviction_age) candidates.push_back(&entry);
+        });
+        std::sort(candidates.begin(), candidates.end(),
+            [](const Entry* a, const Entry* b) { return a->last_used_frame < b->last_used_frame; });
+
+        for (Entry* entry : candidates) {
+            if (_resident_bytes + incoming <= budget) break;
+            entry->buffer.reset();
+            _resident_bytes -= entry->size_bytes;
+            ++_eviction_count;
+        }
+
+        if (incoming > 0 && _resident_bytes + incoming > budget) {
+            core::debug::Logger::get_singleton().warn("Mesh cache over budget: {} bytes resident, {} byte budget",
+                _resident_bytes + incoming, budget);
+        }
+    }
+
+    graphics::Device& _device;
+    std::thread::id _render_thread;
+
+    memory::SlotTable<Entry> _meshes;
+    std::vector<Retired> _retired;
+    std::vector<MeshCacheId> _reloading;
+
+    std::mutex _pending_mutex;
+    std::vector<MeshCacheId> _pending_uploads;
+
+    uint64_t _budget = 0;
+    uint64_t _eviction_age = 8;
+    uint64_t _frame = 0;
+    uint64_t _resident_bytes = 0;
+
+    uint64_t _eviction_count = 0;
+    uint64_t _reupload_count = 0;
 };
 
 } // namespace engine::core::renderer::cache
 
-#endif // engine_core_renderer_cache_MESH_CACHE_HPP
\ No newline at end of file
+#endif // engine_core_renderer_cache_MESH_CACHE_HPP
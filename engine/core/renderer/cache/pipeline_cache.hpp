@@ -6,6 +6,8 @@
 #include "engine/core/graphics/shader.hpp"
 #include "engine/core/graphics/descriptor_set_layout.hpp"
 
+#include "engine/core/memory/slot_table.hpp"
+
 #include "engine/core/debug/assert.hpp"
 #include "engine/core/debug/logger.hpp"
 
@@ -16,17 +18,30 @@
 
 namespace engine::core::renderer::cache {
 
-using PipelineCacheId = uint32_t;
+using PipelineCacheId = memory::SlotHandle;
 
 class PipelineCache {
 public:
     explicit PipelineCache(graphics::Device& device)
-        : _device(device), _next_id(0) {}
+        : _device(device) {}
 
     PipelineCache(const PipelineCache&) = delete;
     PipelineCache& operator=(const PipelineCache&) = delete;
     ~PipelineCache() = default;
 
+    // safe from any thread
+    PipelineCacheId register_pipeline(
+        const graphics::Shader& vert_shader,
+        const graphics::Shader& frag_shader,
+        const graphics::DescriptorSetLayout& layout,
+        const std::vector<graphics::VertexBindingDescription>& vertex_bindings,
+        const std::vector<graphics::ImageAttachmentInfo>& attachments,
+        const core::graphics::PipelineConfig& config)
+    {
+        return _pipelines.insert(_device.create_pipeline(vert_shader, frag_shader, layout, vertex_bindings, attachments, config));
+    }
+
+    // meshes with a single vertex stream
     PipelineCacheId register_pipeline(
         const graphics::Shader& vert_shader,
         const graphics::Shader& frag_shader,
@@ -35,33 +50,43 @@ public:
         const std::vector<graphics::ImageAttachmentInfo>& attachments,
         const core::graphics::PipelineConfig& config)
     {
-        std::unique_ptr<graphics::Pipeline> pipeline = _device.create_pipeline(vert_shader, frag_shader, layout, vertex_binding, attachments, config);
+        return register_pipeline(vert_shader, frag_shader, layout, std::vector{ vertex_binding }, attachments, config);
+    }
 
-        PipelineCacheId id = _next_id++;
-        _pipelines.emplace_back(std::move(pipeline));
-        return id;
+    // the id goes stale now, the pipeline is destroyed by the next reclaim()
+    void release(PipelineCacheId id) {
+        if (!_pipelines.release(id)) {
+            core::debug::Logger::get_singleton().warn("Released stale PipelineCacheId {}", id);
+        }
     }
 
+    // render thread, once no recorded frame still uses a released pipeline
+    void reclaim() { _pipelines.reclaim(); }
+    bool reclaimable() const { return _pipelines.reclaimable(); }
+
+    // render thread only, every outstanding id goes stale
     void clear() {
         _pipelines.clear();
-        _next_id = 0;
+        _pipelines.reclaim();
     }
 
     graphics::Pipeline* get(PipelineCacheId id) {
-        ENGINE_ASSERT(id < _next_id, "Invalid PipelineCacheId for PipelineCache");
-        return _pipelines.at(id).get();
+        ENGINE_ASSERT(_pipelines.contains(id), "Invalid or stale PipelineCacheId for PipelineCache");
+        return _pipelines.get(id)->get();
     }
 
     const graphics::Pipeline* get(PipelineCacheId id) const {
-        ENGINE_ASSERT(id < _next_id, "Invalid PipelineCacheId for PipelineCache");
-        return _pipelines.at(id).get();
+        ENGINE_ASSERT(_pipelines.contains(id), "Invalid or stale PipelineCacheId for PipelineCache");
+        return _pipelines.get(id)->get();
     }
 
+    bool contains(PipelineCacheId id) const { return _pipelines.contains(id); }
+    size_t size() const { return _pipelines.size(); }
+
 private:
     graphics::Device& _device;
 
-    PipelineCacheId _next_id;
-    std::vector<std::unique_ptr<graphics::Pipeline>> _pipelines;
+    memory::SlotTable<std::unique_ptr<graphics::Pipeline>> _pipelines;
 };
 
 } // namespace engine::core::renderer::cache
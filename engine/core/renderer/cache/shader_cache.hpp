@@ -4,6 +4,8 @@
 #include "engine/core/graphics/device.hpp"
 #include "engine/core/graphics/shader.hpp"
 
+#include "engine/core/memory/slot_table.hpp"
+
 #include "engine/core/debug/assert.hpp"
 #include "engine/core/debug/logger.hpp"
 
@@ -15,7 +17,7 @@
 
 namespace engine::core::renderer::cache {
 
-using ShaderCacheId = uint32_t;
+using ShaderCacheId = memory::SlotHandle;
 
 class ShaderCache {
 public:
@@ -26,33 +28,45 @@ public:
     ShaderCache& operator=(const ShaderCache&) = delete;
     ~ShaderCache() = default;
 
+    // safe from any thread
     ShaderCacheId register_shader(graphics::ShaderStageFlags stage, const std::string& path) {
-        std::unique_ptr<graphics::Shader> shader = _device.create_shader(stage, path);
-        ShaderCacheId id = _next_id++;
-        _shaders.emplace_back(std::move(shader));
-        return id;
+        return _shaders.insert(_device.create_shader(stage, path));
+    }
+
+    // the id goes stale now, the module is destroyed by the next reclaim()
+    void release(ShaderCacheId id) {
+        if (!_shaders.release(id)) {
+            core::debug::Logger::get_singleton().warn("Released stale ShaderCacheId {}", id);
+        }
     }
 
     graphics::Shader* get(ShaderCacheId id) {
-        ENGINE_ASSERT(id < _next_id, "Invalid ShaderCacheId for ShaderCache");
-        return _shaders.at(id).get();
+        ENGINE_ASSERT(_shaders.contains(id), "Invalid or stale ShaderCacheId for ShaderCache");
+        return _shaders.get(id)->get();
     }
 
     const graphics::Shader* get(ShaderCacheId id) const {
-        ENGINE_ASSERT(id < _next_id, "Invalid ShaderCacheId for ShaderCache");
-        return _shaders.at(id).get();
+        ENGINE_ASSERT(_shaders.contains(id), "Invalid or stale ShaderCacheId for ShaderCache");
+        return _shaders.get(id)->get();
     }
 
-    void clear() noexcept {
+    bool contains(ShaderCacheId id) const { return _shaders.contains(id); }
+    size_t size() const { return _shaders.size(); }
+
+    // render thread, once no shader pointer from get() is held anymore
+    void reclaim() { _shaders.reclaim(); }
+    bool reclaimable() const { return _shaders.reclaimable(); }
+
+    // render thread only, every outstanding id goes stale
+    void clear() {
         _shaders.clear();
-        _next_id = 0;
+        _shaders.reclaim();
     }
 
 private:
     const graphics::Device& _device;
 
-    ShaderCacheId _next_id = 0;
-    std::vector<std::unique_ptr<graphics::Shader>> _shaders;
+    memory::SlotTable<std::unique_ptr<graphics::Shader>> _shaders;
 };
 
 } // namespace engine::core::renderer::cache
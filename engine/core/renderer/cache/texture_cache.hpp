@@ -0,0 +1,323 @@
+#ifndef engine_core_renderer_cache_TEXTURE_CACHE_HPP
+#define engine_core_renderer_cache_TEXTURE_CACHE_HPP
+
+#include "engine/core/graphics/device.hpp"
+#include "engine/core/graphics/texture.hpp"
+#include "engine/core/graphics/bindless_table.hpp"
+#include "engine/import/texture.hpp"
+#include "engine/import/cooked_texture.hpp"
+
+#include "engine/core/memory/slot_table.hpp"
+#include "engine/core/thread/thread_pool.hpp"
+
+#include "engine/core/debug/assert.hpp"
+#include "engine/core/debug/logger.hpp"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <future>
+#include <chrono>
+#include <queue>
+#include <cstdint>
+
+namespace engine::core::renderer::cache {
+
+using TextureCacheId = memory::SlotHandle;
+
+// owns sampled textures read from image files. decoding, mip generation and block compression run on the thread
+// pool, so a load never holds up a frame: once the data is ready next_frame creates the texture, uploads the
+// coarse tail of the chain at once and streams the finer levels in over the following frames, smallest first
+// across every texture, within a per-frame upload budget. when a whole chain would not fit the memory budget its
+// finest levels are dropped up front. the cache belongs to the render thread
+class TextureCache {
+public:
+    // levels this size or smaller go up with the texture, so it is drawable on its first frame
+    static constexpr uint64_t INITIAL_MIP_BYTES = 64 * 64 * 4;
+
+    // with a bindless table every resident texture keeps a slot in it
+    TextureCache(const graphics::Device& device, graphics::BindlessTable* bindless = nullptr)
+        : _device(device), _bindless(bindless) {}
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    ~TextureCache() {
+        // the table may outlive the cache
+        if (!_bindless) return;
+        _textures.for_each([this](TextureCacheId, Entry& entry) {
+            if (entry.bindless_index != graphics::INVALID_BINDLESS_INDEX) _bindless->release_texture(entry.bindless_index);
+        });
+    }
+
+    // returns straight away, the file is read and compressed on the thread pool; a cooked .jtex is read as it
+    // is and the other arguments are ignored. colors want srgb; normals, roughness and masks do not. devices
+    // without bc support get the chain uncompressed
+    TextureCacheId load(const std::string& filepath, bool srgb = true,
+        import::TextureCompression compression = import::TextureCompression::BC7)
+    {
+        if (!_device.block_compression_supported()) compression = import::TextureCompression::NONE;
+
+        Entry entry;
+        entry.source_path = filepath;
+        entry.loading = thread::ThreadPool::get_singleton().submit([filepath, srgb, compression]() {
+            return import::LoadTexture(filepath, srgb, compression);
+        });
+
+        TextureCacheId id = _textures.reserve(std::move(entry));
+        _loading.push_back(id);
+        return id;
+    }
+
+    // the id goes stale now, the texture lives until frames that sampled it have finished
+    void release(TextureCacheId id) {
+        if (!_textures.release(id)) {
+            core::debug::Logger::get_singleton().warn("Released stale TextureCacheId {}", id);
+        }
+    }
+
+    // every outstanding id goes stale, loads still running are dropped when they finish
+    void clear() {
+        _textures.clear();
+        reclaim();
+        _loading.clear();
+    }
+
+    // null while loading, and for files that failed to load
+    graphics::Texture* get(TextureCacheId id) const {
+        const Entry* entry = _textures.get(id);
+        if (!entry) {
+            ENGINE_ASSERT(_textures.pending(id), "Invalid or stale TextureCacheId for TextureCache");
+            return nullptr;
+        }
+        return entry->texture.get();
+    }
+
+    // INVALID_BINDLESS_INDEX without a table or while loading. the slot moves whenever finer levels arrive,
+    // so read it when writing material parameters rather than holding on to it
+    graphics::BindlessIndex bindless_index(TextureCacheId id) const {
+        const Entry* entry = _textures.get(id);
+        if (!entry) {
+            ENGINE_ASSERT(_textures.pending(id), "Invalid or stale TextureCacheId for TextureCache");
+            return graphics::INVALID_BINDLESS_INDEX;
+        }
+        return entry->bindless_index;
+    }
+
+    // finest level that can be sampled, numbered in the source chain; the texture's own level 0 is
+    // first_mip, which is above 0 only when the budget dropped levels
+    uint32_t resident_mip(TextureCacheId id) const {
+        const Entry* entry = _textures.get(id);
+        return entry && entry->texture ? entry->resident_mip : UINT32_MAX;
+    }
+    uint32_t first_mip(TextureCacheId id) const {
+        const Entry* entry = _textures.get(id);
+        return entry && entry->texture ? entry->first_mip : UINT32_MAX;
+    }
+
+    // resident with every level it will get
+    bool complete(TextureCacheId id) const {
+        const Entry* entry = _textures.get(id);
+        return entry && entry->texture && entry->resident_mip == entry->first_mip;
+    }
+
+    bool contains(TextureCacheId id) const { return _textures.contains(id); }
+    size_t size() const { return _textures.size(); }
+
+    // call once per frame, before the frame's materials are written
+    void next_frame() {
+        ++_frame;
+        finish_loads();
+        stream();
+        reclaim();
+    }
+
+    // gpu memory for textures, 0 uses what the device reports as left
+    void set_budget(uint64_t bytes) { _budget = bytes; }
+    // bytes streamed per frame; a level larger than this still goes up on a frame with nothing else to upload
+    void set_upload_budget(uint64_t bytes) { _upload_budget = bytes; }
+    // released textures live this many frames, must cover the frames in flight
+    void set_retire_age(uint64_t frames) { _retire_age = std::max<uint64_t>(frames, 1); }
+
+    uint64_t budget() const { return _budget; }
+    uint64_t upload_budget() const { return _upload_budget; }
+    // levels uploaded so far
+    uint64_t resident_bytes() const { return _resident_bytes; }
+    // whole chains, streamed in or not
+    uint64_t allocated_bytes() const { return _allocated_bytes; }
+    size_t loading_count() const { return _loading.size(); }
+    size_t streaming_count() const { return _streaming.size(); }
+    uint64_t dropped_mip_count() const { return _dropped_mip_count; }
+
+private:
+    struct Entry {
+        std::future<import::TextureData> loading;   // valid until the worker's result is taken
+        import::TextureData data;                   // source of the levels still to stream, dropped once complete
+        std::unique_ptr<graphics::Texture> texture;
+        graphics::BindlessIndex bindless_index = graphics::INVALID_BINDLESS_INDEX;
+        std::string source_path;
+
+        uint32_t first_mip = 0;
+        uint32_t resident_mip = 0;
+        uint64_t size_bytes = 0;
+        uint64_t resident_bytes = 0;
+    };
+
+    struct Retired {
+        std::unique_ptr<graphics::Texture> texture;
+        uint64_t released_frame;
+    };
+
+    void finish_loads() {
+        std::erase_if(_loading, [this](TextureCacheId id) {
+            Entry* entry = _textures.get_pending(id);
+            if (!entry) return true; // released while loading
+            if (entry->loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+            entry->data = entry->loading.get();
+            if (entry->data.empty()) {
+                core::debug::Logger::get_singleton().error("Failed to load texture {}", entry->source_path);
+            } else if (graphics::IsCompressedFormat(entry->data.format) && !_device.block_compression_supported()) {
+                core::debug::Logger::get_singleton().error("Texture {} is block compressed, which this device cannot sample", entry->source_path);
+                entry->data = {};
+            } else {
+                create(*entry);
+            }
+            _textures.publish(id);
+            return true;
+        });
+    }
+
+    void create(Entry& entry) {
+        const import::TextureData& data = entry.data;
+        const uint32_t mip_count = data.mip_count();
+
+        auto chain_bytes = [&data, mip_count](uint32_t first) {
+            uint64_t bytes = 0;
+            for (uint32_t level = first; level < mip_count; ++level) bytes += data.mips[level].size;
+            return bytes;
+        };
+
+        // each dropped level takes three quarters of what is left with it
+        const uint64_t budget = effective_budget();
+        uint32_t first = 0;
+        while (first + 1 < mip_count && _allocated_bytes + chain_bytes(first) > budget) ++first;
+        if (first > 0) {
+            core::debug::Logger::get_singleton().warn("Texture {} over budget, dropped {} mips to {}x{}",
+                entry.source_path, first, data.mips[first].width, data.mips[first].height);
+            _dropped_mip_count += first;
+        }
+
+        entry.first_mip = first;
+        entry.size_bytes = chain_bytes(first);
+        entry.texture = _device.create_texture(data.mips[first].width, data.mips[first].height, data.format, 1,
+            mip_count - first, graphics::TextureUsage::SAMPLED_IMAGE | graphics::TextureUsage::COPY_DST);
+        _allocated_bytes += entry.size_bytes;
+
+        // the 1x1 level always goes, then every level up to the initial size
+        entry.resident_mip = mip_count;
+        while (entry.resident_mip > first &&
+            (entry.resident_mip == mip_count || data.mips[entry.resident_mip - 1].size <= INITIAL_MIP_BYTES)) {
+            upload_level(entry, entry.resident_mip - 1);
+        }
+        publish_level(entry);
+
+        if (entry.resident_mip == first) {
+            entry.data = {};
+        } else {
+            _streaming.push_back(&entry);
+        }
+    }
+
+    // smallest pending level first across every streaming texture, so everything sharpens evenly
+    void stream() {
+        if (_streaming.empty()) return;
+
+        auto next_size = [](const Entry* entry) { return entry->data.mips[entry->resident_mip - 1].size; };
+        auto larger = [&next_size](const Entry* a, const Entry* b) { return next_size(a) > next_size(b); };
+        std::priority_queue<Entry*, std::vector<Entry*>, decltype(larger)> queue(larger, std::move(_streaming));
+        _streaming.clear();
+
+        std::vector<Entry*> touched;
+        uint64_t uploaded = 0;
+        while (!queue.empty()) {
+            Entry* entry = queue.top();
+            const uint64_t size = next_size(entry);
+            if (uploaded > 0 && uploaded + size > _upload_budget) break;
+            queue.pop();
+
+            if (std::find(touched.begin(), touched.end(), entry) == touched.end()) touched.push_back(entry);
+            upload_level(*entry, entry->resident_mip - 1);
+            uploaded += size;
+
+            if (entry->resident_mip > entry->first_mip) queue.push(entry);
+        }
+        for (; !queue.empty(); queue.pop()) _streaming.push_back(queue.top());
+
+        for (Entry* entry : touched) {
+            publish_level(*entry);
+            if (entry->resident_mip == entry->first_mip) entry->data = {};
+        }
+    }
+
+    void upload_level(Entry& entry, uint32_t level) {
+        const import::TextureMip& mip = entry.data.mips[level];
+        entry.texture->upload(level - entry.first_mip, entry.data.mip_data(level), mip.size);
+        entry.resident_mip = level;
+        entry.resident_bytes += mip.size;
+        _resident_bytes += mip.size;
+    }
+
+    // uploads land before the next submit, so sampling can move to the new levels right away
+    void publish_level(Entry& entry) {
+        entry.texture->set_base_mip(entry.resident_mip - entry.first_mip);
+        if (!_bindless) return;
+
+        // the old slot may still be read by frames in flight, it is rewritten only after they finish
+        graphics::BindlessIndex previous = entry.bindless_index;
+        entry.bindless_index = _bindless->register_texture(*entry.texture);
+        if (previous != graphics::INVALID_BINDLESS_INDEX) _bindless->release_texture(previous);
+    }
+
+    void reclaim() {
+        _textures.reclaim([this](Entry& entry) {
+            std::erase(_streaming, &entry);
+            if (!entry.texture) return;
+            _allocated_bytes -= entry.size_bytes;
+            _resident_bytes -= entry.resident_bytes;
+            if (_bindless && entry.bindless_index != graphics::INVALID_BINDLESS_INDEX) _bindless->release_texture(entry.bindless_index);
+            _retired.push_back(Retired{ std::move(entry.texture), _frame });
+        });
+        std::erase_if(_retired, [this](const Retired& retired) { return _frame - retired.released_frame >= _retire_age; });
+    }
+
+    uint64_t effective_budget() const {
+        if (_budget != 0) return _budget;
+
+        // the device budget is shared with every other allocation, only claim what is left plus what we hold
+        uint64_t device_budget = _device.memory_budget();
+        uint64_t device_usage = _device.memory_usage();
+        if (device_budget == 0) return UINT64_MAX;
+        uint64_t others = (device_usage > _allocated_bytes) ? device_usage - _allocated_bytes : 0;
+        return (device_budget > others) ? device_budget - others : 0;
+    }
+
+    const graphics::Device& _device;
+    graphics::BindlessTable* _bindless;
+
+    memory::SlotTable<Entry> _textures;
+    std::vector<TextureCacheId> _loading;
+    std::vector<Entry*> _streaming;     // slot values never move, so pointers stay good until reclaim
+    std::vector<Retired> _retired;
+
+    uint64_t _budget = 0;
+    uint64_t _upload_budget = 8ull * 1024 * 1024;
+    uint64_t _retire_age = 8;
+    uint64_t _frame = 0;
+    uint64_t _resident_bytes = 0;
+    uint64_t _allocated_bytes = 0;
+    uint64_t _dropped_mip_count = 0;
+};
+
+} // namespace engine::core::renderer::cache
+
+#endif // engine_core_renderer_cache_TEXTURE_CACHE_HPP
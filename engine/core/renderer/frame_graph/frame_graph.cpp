@@ -167,8 +167,8 @@ void FrameGraph::bake() {
             PipelineDescription desc;
             desc.vertex_shader = pass.vertex_shader();
             desc.fragment_shader = pass.fragment_shader();
-            desc.descriptor_set_layout = pass.descriptor_set_layout();
-            desc.vertex_binding = pass.vertex_binding();
+            desc.descriptor_layout = pass.descriptor_set_layout()->description();
+            desc.vertex_bindings = pass.vertex_bindings();
             desc.config = pass.pipeline_config();
 
             // collect target attachments
@@ -196,12 +196,9 @@ void FrameGraph::bake() {
                 pipeline_attachment_info.push_back(depth_info);
             }
 
-            // compute hash
-            size_t hash = desc.hash();
-
-            // get frame graph deduplicated pipeline handle
+            // get frame graph deduplicated pipeline handle, matched on the full description
             const graphics::Pipeline* pipeline = nullptr;
-            auto it = _pipeline_instances.find(hash);
+            auto it = _pipeline_instances.find(desc);
             if (it != _pipeline_instances.end()) {
                 pipeline = it->second;
             } else {
@@ -210,13 +207,13 @@ void FrameGraph::bake() {
                         *_shader_cache.get(pass.vertex_shader()),
                         *_shader_cache.get(pass.fragment_shader()),
                         *pass.descriptor_set_layout(),
-                        pass.vertex_binding(),
+                        pass.vertex_bindings(),
                         pipeline_attachment_info,
                         pass.pipeline_config()
                     )
                 );
                 
-                _pipeline_instances[hash] = pipeline;
+                _pipeline_instances.emplace(std::move(desc), pipeline);
             }
             instance.pipeline = pipeline;
         }
@@ -345,6 +342,7 @@ void FrameGraph::execute() {
 
         RenderPassContext context;
         context.pipeline = pass_instance.pipeline;
+        context.render_target = pass_instance.render_target;
         glm::vec4 clear_color = pass.clear_color().value_or(glm::vec4(0, 0, 0, 1));
         glm::vec2 clear_depth = pass.clear_depth().value_or(glm::vec2(0, 1));
 
@@ -352,6 +350,18 @@ void FrameGraph::execute() {
             *context.pipeline, clear_color, clear_depth
         );
 
+        // per-view constants once per pass instead of once per draw
+        if (pass.view_uniforms()) {
+            pass.view_uniforms()->bind(context.command_buffer, *context.pipeline);
+        }
+
+        // the bindless table stays bound for the whole pass, draws only push their material index
+        if (pass.pipeline_config().bindless && !pass.has_pipeline_override()) {
+            pass.pipeline_config().bindless->bind(
+                context.command_buffer->native_command_buffer(), context.pipeline->native_pipeline_layout()
+            );
+        }
+
         pass.execute(context);
         pass_instance.render_target->end_frame();
     }
@@ -16,6 +16,7 @@
 #include <vector>
 #include <string>
 #include <optional>
+#include <unordered_map>
 
 namespace engine::core::renderer::framegraph {
 
@@ -124,7 +125,7 @@ private:
     std::vector<size_t> _baked_pass_order;
     std::vector<AttachmentLifetime> _attachment_lifetimes;
     std::vector<size_t> _pass_to_render_target;
-    std::unordered_map<size_t, const graphics::Pipeline*> _pipeline_instances;
+    std::unordered_map<PipelineDescription, const graphics::Pipeline*> _pipeline_instances;
 };
 
 } // namespace engine::core::renderer::framegraph
@@ -4,12 +4,14 @@
 #include "engine/core/graphics/pipeline.hpp"
 #include "engine/core/graphics/image_types.hpp"
 #include "engine/core/graphics/vertex_types.hpp"
-#include "engine/core/graphics/descriptor_set_layout.hpp"
+#include "engine/core/graphics/descriptor_types.hpp"
 #include "engine/core/renderer/cache/shader_cache.hpp"
+#include "engine/core/memory/hash.hpp"
 
 #include <optional>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 
 namespace engine::core::renderer {
@@ -18,63 +20,74 @@ struct PipelineDescription {
     cache::ShaderCacheId vertex_shader;
     cache::ShaderCacheId fragment_shader;
 
-    const graphics::DescriptorSetLayout* descriptor_set_layout = nullptr;
-    graphics::VertexBindingDescription vertex_binding{};
+    // by value, so equal layouts created separately still dedupe and the key never points at a destroyed layout
+    graphics::DescriptorLayoutDescription descriptor_layout{};
+    std::vector<graphics::VertexBindingDescription> vertex_bindings;
     graphics::PipelineConfig config{};
 
     std::vector<graphics::ImageAttachmentInfo> color_attachments;
     std::optional<graphics::ImageAttachmentInfo> depth_attachment;
 
-    // chatgpt hash combining
-    static inline void hash_combine(std::size_t& seed, std::size_t value) {
-        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    bool operator==(const PipelineDescription& other) const noexcept {
+        return vertex_shader == other.vertex_shader &&
+            fragment_shader == other.fragment_shader &&
+            descriptor_layout == other.descriptor_layout &&
+            vertex_bindings == other.vertex_bindings &&
+            config == other.config &&
+            color_attachments == other.color_attachments &&
+            depth_attachment == other.depth_attachment;
     }
 
-    // chatgpt hash definition
     std::size_t hash() const noexcept {
-        std::size_t h = 0;
+        memory::Hasher hasher;
 
-        // hash shader ids
-        hash_combine(h, std::hash<uint64_t>{}(vertex_shader));
-        hash_combine(h, std::hash<uint64_t>{}(fragment_shader));
+        hasher.add(vertex_shader).add(fragment_shader);
 
-        // hash descriptor set layout pointer
-        hash_combine(h, std::hash<const void*>{}(descriptor_set_layout));
+        descriptor_layout.hash(hasher);
 
-        // hash pipeline config
-        hash_combine(h, std::hash<bool>{}(config.blending_enabled));
-        hash_combine(h, std::hash<bool>{}(config.depth_test_enabled));
-        hash_combine(h, std::hash<bool>{}(config.depth_write_enabled));
-        hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(config.cull_mode)));
-        hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(config.polygon_mode)));
-        hash_combine(h, std::hash<uint32_t>{}(config.push_constant.size));
-        hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(config.push_constant.stage_flags)));
+        hasher.add(config.blending_enabled)
+            .add(config.depth_test_enabled)
+            .add(config.depth_write_enabled)
+            .add(static_cast<uint32_t>(config.cull_mode))
+            .add(static_cast<uint32_t>(config.polygon_mode))
+            .add(config.push_constant.size)
+            .add(static_cast<uint32_t>(config.push_constant.stage_flags))
+            .add(reinterpret_cast<uintptr_t>(config.bindless));
 
-        // hash color attachments
+        hasher.add(static_cast<uint32_t>(color_attachments.size()));
         for (const graphics::ImageAttachmentInfo& att : color_attachments) {
-            hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(att.format)));
-            hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(att.usage)));
+            hasher.add(static_cast<uint32_t>(att.format)).add(static_cast<uint32_t>(att.usage));
         }
 
+        hasher.add(depth_attachment.has_value());
         if (depth_attachment.has_value()) {
-            hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(depth_attachment->format)));
-            hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(depth_attachment->usage)));
+            hasher.add(static_cast<uint32_t>(depth_attachment->format)).add(static_cast<uint32_t>(depth_attachment->usage));
         }
 
-        // hash vertex binding description
-        hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(vertex_binding.binding)));
-        hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(vertex_binding.stride)));
-
-        for (const graphics::VertexAttribute& att : vertex_binding.attributes) {
-            hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(att.format)));
-            hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(att.location)));
-            hash_combine(h, std::hash<uint32_t>{}(static_cast<uint32_t>(att.offset)));
+        hasher.add(static_cast<uint32_t>(vertex_bindings.size()));
+        for (const graphics::VertexBindingDescription& vertex_binding : vertex_bindings) {
+            hasher.add(vertex_binding.binding).add(vertex_binding.stride);
+            hasher.add(static_cast<uint32_t>(vertex_binding.attributes.size()));
+            for (const graphics::VertexAttribute& att : vertex_binding.attributes) {
+                hasher.add(static_cast<uint32_t>(att.format)).add(att.location).add(att.offset);
+            }
         }
 
-        return h;
+        return static_cast<std::size_t>(hasher.finish());
     }
 };
 
 } // namespace engine::core::renderer
 
+namespace std {
+
+template <>
+struct hash<engine::core::renderer::PipelineDescription> {
+    size_t operator()(const engine::core::renderer::PipelineDescription& desc) const noexcept {
+        return desc.hash();
+    }
+};
+
+} // namespace std
+
 #endif // engine_core_renderer_frame_graph_PIPELINE_DESCRIPTION_HPP
@@ -10,6 +10,7 @@
 
 #include "engine/core/renderer/cache/shader_cache.hpp"
 #include "engine/core/renderer/cache/pipeline_cache.hpp"
+#include "engine/core/renderer/view_uniforms.hpp"
 
 #include <glm/glm.hpp>
 
@@ -25,6 +26,7 @@ using RenderPassId = FrameGraphId<struct RenderPassTag>;
 struct RenderPassContext {
     const graphics::Pipeline* pipeline;
     graphics::CommandBuffer* command_buffer;
+    graphics::RenderTarget* render_target;
 };
 
 class RenderPass {
@@ -45,7 +47,8 @@ public:
     void set_fragment_shader(cache::ShaderCacheId id) { _fragment_shader = id; }
 
     void set_descriptor_set_layout(graphics::DescriptorSetLayout* layout) { _descriptor_set_layout = layout; }
-    void set_vertex_binding(const graphics::VertexBindingDescription& binding) { _vertex_binding = binding; }
+    void set_vertex_binding(const graphics::VertexBindingDescription& binding) { _vertex_bindings = { binding }; }
+    void set_vertex_bindings(std::vector<graphics::VertexBindingDescription> bindings) { _vertex_bindings = std::move(bindings); }
     void set_pipeline_config(graphics::PipelineConfig config) { _config = std::move(config); }
 
     void set_pipeline_override(cache::PipelineCacheId id) {
@@ -58,6 +61,9 @@ public:
         _has_render_target_override = true;
     }
 
+    // bound at set 0 before execute runs, the pass' pipeline must share the view layout
+    void set_view_uniforms(const ViewUniforms* view) { _view_uniforms = view; }
+
     void set_execute(ExecuteFn fn) { _execute = std::move(fn); }
 
     const std::optional<glm::vec4>& clear_color() const { return _clear_color; }
@@ -72,13 +78,14 @@ public:
     const cache::ShaderCacheId& fragment_shader() const { return _fragment_shader; }
 
     const graphics::DescriptorSetLayout* descriptor_set_layout() const { return _descriptor_set_layout; }
-    const graphics::VertexBindingDescription& vertex_binding() const { return _vertex_binding; }
+    const std::vector<graphics::VertexBindingDescription>& vertex_bindings() const { return _vertex_bindings; }
     const graphics::PipelineConfig& pipeline_config() const { return _config; }
 
     const cache::PipelineCacheId& pipeline_override() const { return _pipeline_override; }
     const bool has_pipeline_override() const { return _has_pipeline_override; }
     graphics::RenderTarget* render_target_override() const { return _render_target_override; }
     const bool has_render_target_override() const { return _has_render_target_override; }
+    const ViewUniforms* view_uniforms() const { return _view_uniforms; }
 
     void execute(RenderPassContext& context) const {
         if (_execute) _execute(context);
@@ -99,7 +106,7 @@ private:
     cache::ShaderCacheId _fragment_shader{};
 
     graphics::DescriptorSetLayout* _descriptor_set_layout = nullptr;
-    graphics::VertexBindingDescription _vertex_binding{};
+    std::vector<graphics::VertexBindingDescription> _vertex_bindings;
     graphics::PipelineConfig _config{};
 
     cache::PipelineCacheId _pipeline_override{};
@@ -108,6 +115,8 @@ private:
     graphics::RenderTarget* _render_target_override{};
     bool _has_render_target_override = false;
 
+    const ViewUniforms* _view_uniforms = nullptr;
+
     ExecuteFn _execute = nullptr;
 };
 
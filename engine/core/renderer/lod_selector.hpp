@@ -0,0 +1,32 @@
+#ifndef engine_core_renderer_LOD_SELECTOR_HPP
+#define engine_core_renderer_LOD_SELECTOR_HPP
+
+#include "engine/core/graphics/mesh_buffer.hpp"
+
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+
+namespace engine::core::renderer {
+
+// the coarsest lod whose error covers at most threshold_pixels on screen, pixels_per_unit being how many
+// pixels one object space unit spans at the mesh. a lod only changes once its projected error leaves a band
+// of +-hysteresis around the threshold, so a mesh resting at a boundary does not flicker between levels
+inline uint32_t SelectLod(const std::vector<graphics::MeshLod>& lods, float pixels_per_unit, uint32_t current,
+    float threshold_pixels = 1.0f, float hysteresis = 0.25f) {
+    if (lods.empty()) return 0;
+    current = std::min(current, static_cast<uint32_t>(lods.size() - 1));
+
+    auto projected = [&](uint32_t lod) { return lods[lod].error * pixels_per_unit; };
+
+    if (projected(current) > threshold_pixels * (1.0f + hysteresis)) {
+        while (current > 0 && projected(current) > threshold_pixels) --current;
+        return current;
+    }
+    while (current + 1 < lods.size() && projected(current + 1) <= threshold_pixels * (1.0f - hysteresis)) ++current;
+    return current;
+}
+
+} // namespace engine::core::renderer
+
+#endif // engine_core_renderer_LOD_SELECTOR_HPP
@@ -0,0 +1,96 @@
+#ifndef engine_core_renderer_MESHLET_CULLING_HPP
+#define engine_core_renderer_MESHLET_CULLING_HPP
+
+#include "engine/import/meshlet.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+namespace engine::core::renderer {
+
+// the six planes of a view projection, normals pointing inside, extracted from its rows (gribb and hartmann).
+// the near plane assumes the -1..1 clip depth the scene cameras use, which is conservative for 0..1
+struct Frustum {
+    glm::vec4 planes[6];
+
+    static Frustum FromMatrix(const glm::mat4& view_projection) {
+        auto row = [&view_projection](int i) {
+            return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+        };
+        glm::vec4 x = row(0), y = row(1), z = row(2), w = row(3);
+
+        Frustum frustum;
+        frustum.planes[0] = w + x;
+        frustum.planes[1] = w - x;
+        frustum.planes[2] = w + y;
+        frustum.planes[3] = w - y;
+        frustum.planes[4] = w + z;
+        frustum.planes[5] = w - z;
+        for (glm::vec4& plane : frustum.planes) {
+            float length = glm::length(glm::vec3(plane.x, plane.y, plane.z));
+            if (length > 0.0f) plane = plane * (1.0f / length);
+        }
+        return frustum;
+    }
+
+    bool intersects_sphere(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& plane : planes) {
+            if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) return false;
+        }
+        return true;
+    }
+};
+
+struct MeshletCullStats {
+    uint32_t total = 0;
+    uint32_t frustum_culled = 0;
+    uint32_t backface_culled = 0;
+};
+
+// cpu reference for the gpu cluster culling: appends the meshlets of one instance that survive the frustum
+// and normal cone tests to visible. bounds are object space, model takes them to world space
+inline MeshletCullStats CullMeshlets(const import::Meshlets& meshlets, const glm::mat4& model,
+    const Frustum& frustum, const glm::vec3& camera_position, std::vector<uint32_t>& visible) {
+    MeshletCullStats stats;
+    stats.total = static_cast<uint32_t>(meshlets.meshlets.size());
+
+    // spheres grow by the largest axis scale. the cone test runs in object space, where a triangle faces away
+    // from the viewpoint exactly when it does in world space, except under a mirroring transform
+    const glm::vec3 axis_x(model[0].x, model[0].y, model[0].z);
+    const glm::vec3 axis_y(model[1].x, model[1].y, model[1].z);
+    const glm::vec3 axis_z(model[2].x, model[2].y, model[2].z);
+    const float scale = std::sqrt(std::max({ glm::dot(axis_x, axis_x), glm::dot(axis_y, axis_y), glm::dot(axis_z, axis_z) }));
+    const bool cone_valid = glm::dot(glm::cross(axis_x, axis_y), axis_z) > 0.0f;
+    const glm::vec4 local_camera = glm::inverse(model) * glm::vec4(camera_position, 1.0f);
+    const glm::vec3 viewpoint(local_camera.x, local_camera.y, local_camera.z);
+
+    for (uint32_t i = 0; i < stats.total; ++i) {
+        const import::MeshletBounds& bounds = meshlets.bounds[i];
+
+        glm::vec4 center = model * glm::vec4(bounds.center, 1.0f);
+        if (!frustum.intersects_sphere(glm::vec3(center.x, center.y, center.z), bounds.radius * scale)) {
+            ++stats.frustum_culled;
+            continue;
+        }
+
+        if (cone_valid && bounds.cone_cutoff < 1.0f) {
+            glm::vec3 to_apex = bounds.cone_apex - viewpoint;
+            float distance = glm::length(to_apex);
+            if (distance > 0.0f && glm::dot(to_apex, bounds.cone_axis) >= bounds.cone_cutoff * distance) {
+                ++stats.backface_culled;
+                continue;
+            }
+        }
+
+        visible.push_back(i);
+    }
+    return stats;
+}
+
+} // namespace engine::core::renderer
+
+#endif // engine_core_renderer_MESHLET_CULLING_HPP
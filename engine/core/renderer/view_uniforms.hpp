@@ -0,0 +1,57 @@
+#ifndef engine_core_renderer_VIEW_UNIFORMS_HPP
+#define engine_core_renderer_VIEW_UNIFORMS_HPP
+
+#include "engine/core/graphics/pipeline.hpp"
+#include "engine/core/graphics/material.hpp"
+#include "engine/core/graphics/command_buffer.hpp"
+#include "engine/core/graphics/descriptor_set_layout.hpp"
+
+#include "engine/core/debug/assert.hpp"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <cstdint>
+
+namespace engine::core::renderer {
+
+// matches the set 0 block every scene shader declares
+struct ViewConstants {
+    glm::mat4 view{1.0f};
+    glm::mat4 proj{1.0f};
+};
+
+// per-camera constants, uploaded once per frame and bound once per pass at set 0
+class ViewUniforms {
+public:
+    static constexpr uint32_t SET = 0;
+
+    // layout must be a single dynamic uniform buffer at binding 0, shared by every pipeline rendering the view
+    ViewUniforms(const graphics::Pipeline& pipeline, const graphics::DescriptorSetLayout& layout)
+        : _set(pipeline.create_material(layout, sizeof(ViewConstants))) {}
+
+    ViewUniforms(const ViewUniforms&) = delete;
+    ViewUniforms& operator=(const ViewUniforms&) = delete;
+
+    ~ViewUniforms() = default;
+
+    void update(const ViewConstants& constants) {
+        _constants = constants;
+        _set->update_uniform_buffer(&_constants);
+    }
+
+    void bind(graphics::CommandBuffer* command_buffer, const graphics::Pipeline& pipeline) const {
+        ENGINE_ASSERT(command_buffer != nullptr, "Attempted to bind view uniforms with null command buffer");
+        _set->bind(command_buffer->native_command_buffer(), pipeline.native_pipeline_layout(), SET);
+    }
+
+    const ViewConstants& constants() const { return _constants; }
+
+private:
+    std::unique_ptr<graphics::Material> _set;
+    ViewConstants _constants{};
+};
+
+} // namespace engine::core::renderer
+
+#endif // engine_core_renderer_VIEW_UNIFORMS_HPP
@@ -6,6 +6,8 @@
 #include <glm/gtx/transform.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 
 namespace engine::core::scene {
@@ -49,6 +51,13 @@ public:
         update_view();
     }
 
+    // screen pixels one world unit covers at world_position, the same formula serves both projections
+    // since an orthographic clip w is always 1
+    float pixels_per_unit(const glm::vec3& world_position) const {
+        glm::vec4 clip = _projection * _view * glm::vec4(world_position, 1.0f);
+        return std::abs(_projection[1][1]) * 0.5f * static_cast<float>(_height) / std::max(clip.w, 1e-4f);
+    }
+
     const glm::vec3& position() const { return _position; }
     const glm::quat& rotation() const { return _rotation; }
 
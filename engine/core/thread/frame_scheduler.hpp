@@ -0,0 +1,56 @@
+#ifndef engine_core_thread_FRAME_SCHEDULER_HPP
+#define engine_core_thread_FRAME_SCHEDULER_HPP
+
+#include <coroutine>
+#include <vector>
+#include <mutex>
+#include <cstddef>
+
+namespace engine::core::thread {
+
+// coroutines waiting for the render thread. co_await next_frame() from any thread, and the coroutine resumes
+// inside the render thread's next run(), which it calls at a frame boundary where gpu resources may change
+class FrameScheduler {
+public:
+    FrameScheduler() = default;
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+    ~FrameScheduler() = default;
+
+    auto next_frame() noexcept {
+        struct Awaiter {
+            FrameScheduler& scheduler;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) {
+                std::lock_guard<std::mutex> lock(scheduler._mutex);
+                scheduler._waiting.push_back(handle);
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{ *this };
+    }
+
+    // resumes everything that was waiting when called, coroutines that wait again go to the following run
+    void run() {
+        std::vector<std::coroutine_handle<>> waiting;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            waiting.swap(_waiting);
+        }
+        for (std::coroutine_handle<> handle : waiting) handle.resume();
+    }
+
+    size_t waiting() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _waiting.size();
+    }
+
+private:
+    std::vector<std::coroutine_handle<>> _waiting;
+    mutable std::mutex _mutex;
+};
+
+} // namespace engine::core::thread
+
+#endif // engine_core_thread_FRAME_SCHEDULER_HPP
@@ -0,0 +1,131 @@
+#ifndef engine_core_thread_TASK_HPP
+#define engine_core_thread_TASK_HPP
+
+#include <coroutine>
+#include <optional>
+#include <atomic>
+#include <utility>
+#include <exception>
+
+namespace engine::core::thread {
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+// whichever of the coroutine finishing and its awaiter (or owner) arriving comes second hands control on,
+// so a task may finish on a worker before anyone awaits it
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation;
+    std::atomic<bool> joined{ false };
+
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            TaskPromiseBase& promise = handle.promise();
+            if (!promise.joined.exchange(true, std::memory_order_acq_rel)) return std::noop_coroutine();
+            if (promise.continuation) return promise.continuation;
+
+            // the task was dropped while running, nobody is left to free it
+            handle.destroy();
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    // the engine does not throw, an escaping exception is a bug
+    void unhandled_exception() noexcept { std::terminate(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+    void return_value(T result) { value.emplace(std::move(result)); }
+    T take() { return std::move(*value); }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() noexcept {}
+    void take() noexcept {}
+};
+
+} // namespace detail
+
+// an eagerly started coroutine, running on the calling thread up to its first suspension. co_await it for
+// its result, which resumes the awaiter on whichever thread the task finished on. dropping an unfinished
+// task detaches it, and it frees itself when done
+template <typename T = void>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task() = default;
+    explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task(Task&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            release();
+            _handle = std::exchange(other._handle, nullptr);
+        }
+        return *this;
+    }
+    ~Task() { release(); }
+
+    bool valid() const { return static_cast<bool>(_handle); }
+
+    // await once, the result is moved out
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                // false when the task finished in the meantime, the awaiter carries on without suspending
+                return !handle.promise().joined.exchange(true, std::memory_order_acq_rel);
+            }
+            T await_resume() { return handle.promise().take(); }
+        };
+        return Awaiter{ _handle };
+    }
+
+private:
+    void release() {
+        if (!_handle) return;
+        // already joined means the coroutine reached its final suspend, otherwise it frees itself there
+        if (_handle.promise().joined.exchange(true, std::memory_order_acq_rel)) _handle.destroy();
+        _handle = nullptr;
+    }
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+} // namespace engine::core::thread
+
+#endif // engine_core_thread_TASK_HPP
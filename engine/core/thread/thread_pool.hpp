@@ -0,0 +1,149 @@
+#ifndef engine_core_thread_THREAD_POOL_HPP
+#define engine_core_thread_THREAD_POOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <coroutine>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+
+namespace engine::core::thread {
+
+// fixed set of workers pulling from one fifo queue. jobs may submit more jobs, but a job that waits on
+// another should do it through parallel_for, which runs pending work on the waiting thread instead of blocking
+class ThreadPool {
+public:
+    static ThreadPool& get_singleton() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // 0 picks one worker per hardware thread, leaving one for the render thread
+    explicit ThreadPool(uint32_t worker_count = 0) {
+        if (worker_count == 0) worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        _workers.reserve(worker_count);
+        for (uint32_t i = 0; i < worker_count; ++i) _workers.emplace_back([this]() { work(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // finishes every queued job before joining
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_all();
+        for (std::thread& worker : _workers) worker.join();
+    }
+
+    template <typename F>
+    auto submit(F&& job) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+        std::future<Result> future = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+    // co_await schedule() moves the rest of a coroutine onto a worker
+    auto schedule() noexcept {
+        struct Awaiter {
+            ThreadPool& pool;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { pool.enqueue([handle]() { handle.resume(); }); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{ *this };
+    }
+
+    // calls body(begin, end) over [0, count) split into chunks of at least grain items, and returns when
+    // every chunk is done. the calling thread takes chunks too, so this is safe to call from a job
+    template <typename F>
+    void parallel_for(size_t count, size_t grain, F&& body) {
+        if (count == 0) return;
+        grain = std::max<size_t>(grain, 1);
+        const size_t chunk_count = std::min((count + grain - 1) / grain, static_cast<size_t>(_workers.size()) + 1);
+        if (chunk_count <= 1) {
+            body(size_t(0), count);
+            return;
+        }
+
+        struct Shared {
+            std::atomic<size_t> next{ 0 };
+            std::atomic<size_t> done{ 0 };
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+        auto shared = std::make_shared<Shared>();
+        const size_t chunk_size = (count + chunk_count - 1) / chunk_count;
+
+        auto run = [shared, chunk_count, chunk_size, count, &body]() {
+            for (size_t chunk; (chunk = shared->next.fetch_add(1)) < chunk_count;) {
+                const size_t begin = chunk * chunk_size;
+                body(begin, std::min(begin + chunk_size, count));
+                if (shared->done.fetch_add(1) + 1 == chunk_count) {
+                    std::lock_guard<std::mutex> lock(shared->mutex);
+                    shared->finished.notify_all();
+                }
+            }
+        };
+
+        // helpers that start after the caller took the last chunk return straight away, body is not touched
+        for (size_t i = 1; i < chunk_count; ++i) enqueue(run);
+        run();
+
+        std::unique_lock<std::mutex> lock(shared->mutex);
+        shared->finished.wait(lock, [&shared, chunk_count]() { return shared->done.load() == chunk_count; });
+    }
+
+    uint32_t worker_count() const { return static_cast<uint32_t>(_workers.size()); }
+
+    size_t queued() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _jobs.size();
+    }
+
+private:
+    void enqueue(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.push_back(std::move(job));
+        }
+        _wake.notify_one();
+    }
+
+    void work() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+                if (_jobs.empty()) return;
+                job = std::move(_jobs.front());
+                _jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _jobs;
+    mutable std::mutex _mutex;
+    std::condition_variable _wake;
+    bool _stopping = false;
+};
+
+} // namespace engine::core::thread
+
+#endif // engine_core_thread_THREAD_POOL_HPP
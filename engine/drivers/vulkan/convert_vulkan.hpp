@@ -26,6 +26,14 @@ inline VkFormat ToVkFormat(core::graphics::ImageFormat fmt) {
         case IF::RGBA16_FLOAT:       return VK_FORMAT_R16G16B16A16_SFLOAT;
         case IF::RGBA32_FLOAT:       return VK_FORMAT_R32G32B32A32_SFLOAT;
 
+        case IF::BC1_RGBA_UNORM:     return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case IF::BC1_RGBA_SRGB:      return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+        case IF::BC3_UNORM:          return VK_FORMAT_BC3_UNORM_BLOCK;
+        case IF::BC3_SRGB:           return VK_FORMAT_BC3_SRGB_BLOCK;
+        case IF::BC5_UNORM:          return VK_FORMAT_BC5_UNORM_BLOCK;
+        case IF::BC7_UNORM:          return VK_FORMAT_BC7_UNORM_BLOCK;
+        case IF::BC7_SRGB:           return VK_FORMAT_BC7_SRGB_BLOCK;
+
         case IF::R8_UINT:            return VK_FORMAT_R8_UINT;
         case IF::R16_UINT:           return VK_FORMAT_R16_UINT;
         case IF::R32_UINT:           return VK_FORMAT_R32_UINT;
@@ -62,6 +70,14 @@ inline core::graphics::ImageFormat FromImageVkFormat(VkFormat fmt) {
         case VK_FORMAT_R16G16B16A16_SFLOAT:  return IF::RGBA16_FLOAT;
         case VK_FORMAT_R32G32B32A32_SFLOAT:  return IF::RGBA32_FLOAT;
 
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK: return IF::BC1_RGBA_UNORM;
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:  return IF::BC1_RGBA_SRGB;
+        case VK_FORMAT_BC3_UNORM_BLOCK:      return IF::BC3_UNORM;
+        case VK_FORMAT_BC3_SRGB_BLOCK:       return IF::BC3_SRGB;
+        case VK_FORMAT_BC5_UNORM_BLOCK:      return IF::BC5_UNORM;
+        case VK_FORMAT_BC7_UNORM_BLOCK:      return IF::BC7_UNORM;
+        case VK_FORMAT_BC7_SRGB_BLOCK:       return IF::BC7_SRGB;
+
         case VK_FORMAT_R8_UINT:              return IF::R8_UINT;
         case VK_FORMAT_R16_UINT:             return IF::R16_UINT;
         case VK_FORMAT_R32_UINT:             return IF::R32_UINT;
@@ -107,6 +123,8 @@ inline VkFormat ToVkFormat(core::graphics::VertexFormat fmt) {
         case VF::HALF_4:   return VK_FORMAT_R16G16B16A16_SFLOAT;
 
         case VF::UNORM8_4: return VK_FORMAT_R8G8B8A8_UNORM;
+        case VF::UNORM16_4: return VK_FORMAT_R16G16B16A16_UNORM;
+        case VF::SNORM16_2: return VK_FORMAT_R16G16_SNORM;
 
         default:
             ENGINE_ASSERT(false, "Unrecognized VertexFormat enum in ToVkFormat()");
@@ -198,6 +216,7 @@ inline VkDescriptorType ToVkDescriptorType(core::graphics::DescriptorType type)
         case DescriptorType::UNIFORM_BUFFER:          return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
         case DescriptorType::STORAGE_BUFFER:          return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
         case DescriptorType::INPUT_ATTACHMENT:        return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        case DescriptorType::UNIFORM_BUFFER_DYNAMIC:  return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         default:
             ENGINE_ASSERT(false, "Unrecognized DescriptorType enum in ToVkDescriptorType()");
             return VK_DESCRIPTOR_TYPE_MAX_ENUM;
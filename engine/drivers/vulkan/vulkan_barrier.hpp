@@ -0,0 +1,104 @@
+#ifndef engine_drivers_vulkan_VULKAN_BARRIER_HPP
+#define engine_drivers_vulkan_VULKAN_BARRIER_HPP
+
+#include <wk/wulkan.hpp>
+
+namespace engine::drivers::vulkan {
+
+inline bool HasStencilComponent(VkFormat format) {
+    return format == VK_FORMAT_D32_SFLOAT_S8_UINT
+        || format == VK_FORMAT_D24_UNORM_S8_UINT
+        || format == VK_FORMAT_D16_UNORM_S8_UINT
+        || format == VK_FORMAT_S8_UINT;
+}
+
+inline bool IsDepthVkFormat(VkFormat format) {
+    return format == VK_FORMAT_D16_UNORM
+        || format == VK_FORMAT_D32_SFLOAT
+        || HasStencilComponent(format);
+}
+
+inline VkImageAspectFlags ToVkAspectMask(VkFormat format) {
+    if (!IsDepthVkFormat(format)) return VK_IMAGE_ASPECT_COLOR_BIT;
+
+    VkImageAspectFlags aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (HasStencilComponent(format)) aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    return aspect;
+}
+
+inline void ToVkLayoutStageAccess(VkImageLayout layout, VkPipelineStageFlags& stage, VkAccessFlags& access) {
+    switch (layout) {
+        case VK_IMAGE_LAYOUT_UNDEFINED:
+            stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            access = 0;
+            break;
+        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+            stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            access = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            break;
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+            stage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            break;
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+            stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            access = VK_ACCESS_SHADER_READ_BIT;
+            break;
+        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+            stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            access = VK_ACCESS_TRANSFER_READ_BIT;
+            break;
+        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+            stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            access = VK_ACCESS_TRANSFER_WRITE_BIT;
+            break;
+        case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+            stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            access = 0;
+            break;
+        default:
+            stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            access = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            break;
+    }
+}
+
+// records a layout transition into an open command buffer
+inline void CmdTransitionImage(VkCommandBuffer cmd, VkImage image, VkFormat format,
+    VkImageLayout old_layout, VkImageLayout new_layout,
+    uint32_t mip_levels = 1, uint32_t layers = 1)
+{
+    VkPipelineStageFlags src_stage, dst_stage;
+    VkAccessFlags src_access, dst_access;
+    ToVkLayoutStageAccess(old_layout, src_stage, src_access);
+    ToVkLayoutStageAccess(new_layout, dst_stage, dst_access);
+
+    // discarding contents still has to wait for prior writes of the same stage (and swapchain acquire)
+    if (old_layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+        src_stage = dst_stage;
+        src_access = dst_access & (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+    }
+
+    VkImageMemoryBarrier barrier = wk::ImageMemoryBarrier{}
+        .set_old_layout(old_layout)
+        .set_new_layout(new_layout)
+        .set_src_access(src_access)
+        .set_dst_access(dst_access)
+        .set_image(image)
+        .set_subresource_range(
+            wk::ImageSubresourceRange{}
+                .set_aspect_mask(ToVkAspectMask(format))
+                .set_base_mip_level(0)
+                .set_level_count(mip_levels)
+                .set_base_array_layer(0)
+                .set_layer_count(layers)
+                .to_vk()
+        )
+        .to_vk();
+
+    vkCmdPipelineBarrier(cmd, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+} // namespace engine::drivers::vulkan
+
+#endif // engine_drivers_vulkan_VULKAN_BARRIER_HPP
@@ -0,0 +1,216 @@
+#include "vulkan_bindless_table.hpp"
+
+#include "vulkan_device.hpp"
+
+#include "engine/core/debug/assert.hpp"
+#include "engine/core/debug/logger.hpp"
+
+#include <iterator>
+
+namespace engine::drivers::vulkan {
+
+VulkanBindlessTable::VulkanBindlessTable(const VulkanDevice& device, uint32_t max_textures, uint32_t max_materials, uint32_t material_stride)
+    : _owner(device), _device(device.device()), _upload_manager(device.upload_manager()),
+      _max_textures(max_textures), _max_materials(max_materials), _material_stride(material_stride)
+{
+    ENGINE_ASSERT(device.bindless_supported(), "Bindless table requires descriptor indexing");
+    ENGINE_ASSERT(max_textures > 0 && max_materials > 0, "Bindless table requires room for textures and materials");
+    ENGINE_ASSERT(material_stride > 0 && material_stride % 16 == 0, "Bindless material stride must be a multiple of 16 bytes");
+
+    // layout, slots that were never written or were released stay unbound
+    VkDescriptorSetLayoutBinding bindings[] = {
+        VkDescriptorSetLayoutBinding{
+            TEXTURE_BINDING, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, _max_textures,
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, nullptr
+        },
+        VkDescriptorSetLayoutBinding{
+            MATERIAL_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, nullptr
+        }
+    };
+
+    VkDescriptorBindingFlags binding_flags[] = {
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+            | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+    };
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_ci{};
+    binding_flags_ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    binding_flags_ci.bindingCount = static_cast<uint32_t>(std::size(binding_flags));
+    binding_flags_ci.pBindingFlags = binding_flags;
+
+    VkDescriptorSetLayoutCreateInfo layout_ci = wk::DescriptorSetLayoutCreateInfo{}
+        .set_flags(VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT)
+        .set_bindings(static_cast<uint32_t>(std::size(bindings)), bindings)
+        .to_vk();
+    layout_ci.pNext = &binding_flags_ci;
+
+    _layout = wk::DescriptorSetLayout(_device.handle(), layout_ci);
+
+    // pool holding just the one set
+    VkDescriptorPoolSize pool_sizes[] = {
+        wk::DescriptorPoolSize{}
+            .set_type(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+            .set_descriptor_count(_max_textures)
+            .to_vk(),
+        wk::DescriptorPoolSize{}
+            .set_type(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+            .set_descriptor_count(1)
+            .to_vk()
+    };
+
+    _pool = wk::DescriptorPool(_device.handle(),
+        wk::DescriptorPoolCreateInfo{}
+            .set_flags(VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT)
+            .set_max_sets(1)
+            .set_pool_sizes(static_cast<uint32_t>(std::size(pool_sizes)), pool_sizes)
+            .to_vk()
+    );
+
+    VkDescriptorSetLayout vk_layout = _layout.handle();
+    VkDescriptorSetAllocateInfo allocate_info = wk::DescriptorSetAllocateInfo{}
+        .set_descriptor_pool(_pool.handle())
+        .set_set_layouts(1, &vk_layout)
+        .to_vk();
+    if (vkAllocateDescriptorSets(_device.handle(), &allocate_info, &_set) != VK_SUCCESS) {
+        core::debug::Logger::get_singleton().fatal("Failed to allocate bindless descriptor set");
+    }
+
+    // every texture is sampled the same way
+    _sampler = wk::Sampler(_device.handle(),
+        wk::SamplerCreateInfo{}
+            .set_mag_filter(VK_FILTER_LINEAR)
+            .set_min_filter(VK_FILTER_LINEAR)
+            .set_mipmap_mode(VK_SAMPLER_MIPMAP_MODE_LINEAR)
+            .set_address_mode_u(VK_SAMPLER_ADDRESS_MODE_REPEAT)
+            .set_address_mode_v(VK_SAMPLER_ADDRESS_MODE_REPEAT)
+            .set_address_mode_w(VK_SAMPLER_ADDRESS_MODE_REPEAT)
+            .set_anisotropy_enable(false)
+            .set_min_lod(0.0f)
+            .set_max_lod(VK_LOD_CLAMP_NONE)
+            .set_border_color(VK_BORDER_COLOR_INT_OPAQUE_BLACK)
+            .to_vk()
+    );
+
+    // material parameters, written on the transfer queue and read on the graphics queue
+    _queue_families = { device.graphics_queue().family_index() };
+    if (_upload_manager.queue_family() != _queue_families.front()) {
+        _queue_families.push_back(_upload_manager.queue_family());
+    }
+
+    VkBufferCreateInfo buffer_ci = wk::BufferCreateInfo{}
+        .set_size(static_cast<VkDeviceSize>(_max_materials) * _material_stride)
+        .set_usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+        .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
+        .to_vk();
+    if (_queue_families.size() > 1) {
+        buffer_ci.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        buffer_ci.queueFamilyIndexCount = static_cast<uint32_t>(_queue_families.size());
+        buffer_ci.pQueueFamilyIndices = _queue_families.data();
+    }
+
+    _material_buffer = wk::Buffer(
+        device.allocator().handle(),
+        buffer_ci,
+        wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_GPU_ONLY).to_vk()
+    );
+
+    VkDescriptorBufferInfo buffer_info = wk::DescriptorBufferInfo{}
+        .set_buffer(_material_buffer.handle())
+        .set_offset(0)
+        .set_range(VK_WHOLE_SIZE)
+        .to_vk();
+
+    VkWriteDescriptorSet material_write = wk::WriteDescriptorSet{}
+        .set_dst_set(_set)
+        .set_dst_binding(MATERIAL_BINDING)
+        .set_descriptor_type(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        .set_descriptor_count(1)
+        .set_p_buffer_info(&buffer_info)
+        .to_vk();
+
+    vkUpdateDescriptorSets(_device.handle(), 1, &material_write, 0, nullptr);
+}
+
+core::graphics::BindlessIndex VulkanBindlessTable::register_texture(const core::graphics::Texture& texture) {
+    core::graphics::BindlessIndex index = acquire(_free_textures, _texture_high_water, _max_textures);
+    if (index == core::graphics::INVALID_BINDLESS_INDEX) {
+        core::debug::Logger::get_singleton().error("Bindless texture table is full ({} textures)", _max_textures);
+        return index;
+    }
+
+    VkDescriptorImageInfo image_info = wk::DescriptorImageInfo{}
+        .set_sampler(_sampler.handle())
+        .set_image_view(static_cast<VkImageView>(texture.native_image_view()))
+        .set_image_layout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+        .to_vk();
+
+    VkWriteDescriptorSet texture_write = wk::WriteDescriptorSet{}
+        .set_dst_set(_set)
+        .set_dst_binding(TEXTURE_BINDING)
+        .set_dst_array_element(index)
+        .set_descriptor_type(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+        .set_descriptor_count(1)
+        .set_p_image_info(&image_info)
+        .to_vk();
+
+    vkUpdateDescriptorSets(_device.handle(), 1, &texture_write, 0, nullptr);
+    return index;
+}
+
+void VulkanBindlessTable::release_texture(core::graphics::BindlessIndex index) {
+    ENGINE_ASSERT(index < _texture_high_water, "Invalid bindless texture index");
+    _free_textures.push_back(Released{ index, _owner.frame_count() });
+}
+
+core::graphics::BindlessIndex VulkanBindlessTable::register_material(const void* params) {
+    core::graphics::BindlessIndex index = acquire(_free_materials, _material_high_water, _max_materials);
+    if (index == core::graphics::INVALID_BINDLESS_INDEX) {
+        core::debug::Logger::get_singleton().error("Bindless material table is full ({} materials)", _max_materials);
+        return index;
+    }
+
+    // a fresh or retired slot, no frame in flight reads it
+    write_material(index, params);
+    return index;
+}
+
+void VulkanBindlessTable::release_material(core::graphics::BindlessIndex index) {
+    ENGINE_ASSERT(index < _material_high_water, "Invalid bindless material index");
+    _free_materials.push_back(Released{ index, _owner.frame_count() });
+}
+
+void VulkanBindlessTable::write_material(core::graphics::BindlessIndex index, const void* params) {
+    ENGINE_ASSERT(params != nullptr, "Attempted to write bindless material with null params");
+
+    // lands before the next submitted frame, which waits on the upload
+    _upload_manager.upload_buffer(_material_buffer.handle(),
+        static_cast<VkDeviceSize>(index) * _material_stride, params, _material_stride);
+}
+
+void VulkanBindlessTable::bind(void* cb, void* pipeline_layout) const {
+    ENGINE_ASSERT(cb != nullptr, "Attempted to bind bindless table with null command buffer");
+    ENGINE_ASSERT(pipeline_layout != nullptr, "Attempted to bind bindless table with null pipeline layout");
+
+    vkCmdBindDescriptorSets(static_cast<VkCommandBuffer>(cb),
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        static_cast<VkPipelineLayout>(pipeline_layout),
+        SET,
+        1, &_set,
+        0, nullptr);
+}
+
+core::graphics::BindlessIndex VulkanBindlessTable::acquire(std::deque<Released>& free_list, uint32_t& high_water, uint32_t capacity) const {
+    // a released slot may still be read by a frame in flight, so it is reused only once those have finished
+    if (!free_list.empty() && _owner.frame_count() - free_list.front().frame >= _owner.frames_in_flight()) {
+        uint32_t index = free_list.front().index;
+        free_list.pop_front();
+        return index;
+    }
+
+    if (high_water < capacity) return high_water++;
+    return core::graphics::INVALID_BINDLESS_INDEX;
+}
+
+} // namespace engine::drivers::vulkan
@@ -0,0 +1,77 @@
+#ifndef engine_drivers_vulkan_VULKAN_BINDLESS_TABLE_HPP
+#define engine_drivers_vulkan_VULKAN_BINDLESS_TABLE_HPP
+
+#include "engine/core/graphics/bindless_table.hpp"
+
+#include "vulkan_upload_manager.hpp"
+
+#include <wk/wulkan.hpp>
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+
+namespace engine::drivers::vulkan {
+
+class VulkanDevice;
+
+// update-after-bind descriptor indexing set, bound once per pass instead of once per material
+class VulkanBindlessTable final : public core::graphics::BindlessTable {
+public:
+    VulkanBindlessTable(const VulkanDevice& device, uint32_t max_textures, uint32_t max_materials, uint32_t material_stride);
+
+    VulkanBindlessTable(const VulkanBindlessTable&) = delete;
+    VulkanBindlessTable& operator=(const VulkanBindlessTable&) = delete;
+
+    ~VulkanBindlessTable() override = default;
+
+    core::graphics::BindlessIndex register_texture(const core::graphics::Texture& texture) override;
+    void release_texture(core::graphics::BindlessIndex index) override;
+
+    core::graphics::BindlessIndex register_material(const void* params) override;
+    void release_material(core::graphics::BindlessIndex index) override;
+
+    uint32_t material_stride() const override { return _material_stride; }
+    uint32_t texture_count() const override { return _texture_high_water - static_cast<uint32_t>(_free_textures.size()); }
+    uint32_t material_count() const override { return _material_high_water - static_cast<uint32_t>(_free_materials.size()); }
+
+    void bind(void* cb, void* pipeline_layout) const override;
+
+    void* native_descriptor_set_layout() const override { return static_cast<void*>(_layout.handle()); }
+    std::string backend_name() const override { return "Vulkan"; }
+
+private:
+    struct Released {
+        uint32_t index;
+        uint64_t frame;
+    };
+
+    void write_material(core::graphics::BindlessIndex index, const void* params);
+    core::graphics::BindlessIndex acquire(std::deque<Released>& free_list, uint32_t& high_water, uint32_t capacity) const;
+
+    const VulkanDevice& _owner;
+    const wk::Device& _device;
+    VulkanUploadManager& _upload_manager;
+
+    wk::DescriptorSetLayout _layout;
+    wk::DescriptorPool _pool;
+    VkDescriptorSet _set = VK_NULL_HANDLE;
+    wk::Sampler _sampler;
+
+    wk::Buffer _material_buffer;
+    std::vector<uint32_t> _queue_families;
+
+    uint32_t _max_textures;
+    uint32_t _max_materials;
+    uint32_t _material_stride;
+
+    // indices below the high water mark are either live or on the free list, oldest release first
+    uint32_t _texture_high_water = 0;
+    uint32_t _material_high_water = 0;
+    std::deque<Released> _free_textures;
+    std::deque<Released> _free_materials;
+};
+
+} // namespace engine::drivers::vulkan
+
+#endif // engine_drivers_vulkan_VULKAN_BINDLESS_TABLE_HPP
@@ -0,0 +1,131 @@
+#include "vulkan_descriptor_allocator.hpp"
+
+#include "engine/core/debug/assert.hpp"
+#include "engine/core/debug/logger.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace engine::drivers::vulkan {
+
+VulkanDescriptorAllocator::VulkanDescriptorAllocator(const wk::Device& device, uint32_t sets_per_pool, uint32_t frames_in_flight)
+    : _device(device), _sets_per_pool(std::max<uint32_t>(sets_per_pool, 1)),
+      _frames_in_flight(std::max<uint32_t>(frames_in_flight, 1))
+{
+    _pools.push_back(create_pool());
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+    ENGINE_ASSERT(layout != VK_NULL_HANDLE, "Attempted to allocate a descriptor set with null layout");
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _free_sets.find(layout);
+    if (it != _free_sets.end() && !it->second.empty()) {
+        VkDescriptorSet set = it->second.back();
+        it->second.pop_back();
+        --_sets_recycled;
+        ++_sets_allocated;
+        return set;
+    }
+
+    // only the newest pool can have room, older ones filled up before it was chained
+    VkResult result = VK_SUCCESS;
+    VkDescriptorSet set = try_allocate(_pools.back().handle(), layout, result);
+    if (set == VK_NULL_HANDLE && (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)) {
+        _pools.push_back(create_pool());
+        core::debug::Logger::get_singleton().info("Descriptor allocator grew to {} pools", _pools.size());
+        set = try_allocate(_pools.back().handle(), layout, result);
+    }
+
+    if (set == VK_NULL_HANDLE) {
+        core::debug::Logger::get_singleton().fatal("Failed to allocate descriptor set: {}", static_cast<int>(result));
+    }
+
+    ++_sets_allocated;
+    return set;
+}
+
+void VulkanDescriptorAllocator::free(VkDescriptorSetLayout layout, VkDescriptorSet set) {
+    if (set == VK_NULL_HANDLE) return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending_frees.push_back(PendingFree{ layout, set, _frame });
+    --_sets_allocated;
+}
+
+void VulkanDescriptorAllocator::release_layout(VkDescriptorSetLayout layout) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // the sets stay in their pools until the allocator goes, pools are never reset
+    auto it = _free_sets.find(layout);
+    if (it != _free_sets.end()) {
+        _sets_recycled -= static_cast<uint32_t>(it->second.size());
+        _free_sets.erase(it);
+    }
+    std::erase_if(_pending_frees, [layout](const PendingFree& pending) { return pending.layout == layout; });
+}
+
+void VulkanDescriptorAllocator::next_frame() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_frame;
+
+    // sets freed frames_in_flight frames ago are no longer referenced by any recorded command buffer
+    auto retired = std::stable_partition(_pending_frees.begin(), _pending_frees.end(),
+        [this](const PendingFree& pending) { return _frame - pending.frame < _frames_in_flight; });
+    for (auto it = retired; it != _pending_frees.end(); ++it) {
+        _free_sets[it->layout].push_back(it->set);
+        ++_sets_recycled;
+    }
+    _pending_frees.erase(retired, _pending_frees.end());
+}
+
+VulkanDescriptorAllocator::Stats VulkanDescriptorAllocator::stats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Stats stats;
+    stats.pool_count = static_cast<uint32_t>(_pools.size());
+    stats.sets_allocated = _sets_allocated;
+    stats.sets_recycled = _sets_recycled;
+    return stats;
+}
+
+wk::DescriptorPool VulkanDescriptorAllocator::create_pool() const {
+    // per-type counts are proportional to the set count, tuned for the material layouts we create
+    VkDescriptorPoolSize pool_sizes[] = {
+        wk::DescriptorPoolSize{}
+            .set_type(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+            .set_descriptor_count(_sets_per_pool)
+            .to_vk(),
+        wk::DescriptorPoolSize{}
+            .set_type(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+            .set_descriptor_count(_sets_per_pool)
+            .to_vk(),
+        wk::DescriptorPoolSize{}
+            .set_type(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+            .set_descriptor_count(_sets_per_pool)
+            .to_vk(),
+        wk::DescriptorPoolSize{}
+            .set_type(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+            .set_descriptor_count(std::max<uint32_t>(_sets_per_pool / 4, 1))
+            .to_vk()
+    };
+
+    return wk::DescriptorPool(_device.handle(),
+        wk::DescriptorPoolCreateInfo{}
+            .set_max_sets(_sets_per_pool)
+            .set_pool_sizes(static_cast<uint32_t>(std::size(pool_sizes)), pool_sizes)
+            .to_vk()
+    );
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::try_allocate(VkDescriptorPool pool, VkDescriptorSetLayout layout, VkResult& result) const {
+    VkDescriptorSetAllocateInfo allocate_info = wk::DescriptorSetAllocateInfo{}
+        .set_descriptor_pool(pool)
+        .set_set_layouts(1, &layout)
+        .to_vk();
+
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    result = vkAllocateDescriptorSets(_device.handle(), &allocate_info, &set);
+    return (result == VK_SUCCESS) ? set : VK_NULL_HANDLE;
+}
+
+} // namespace engine::drivers::vulkan
@@ -0,0 +1,71 @@
+#ifndef engine_drivers_vulkan_VULKAN_DESCRIPTOR_ALLOCATOR_HPP
+#define engine_drivers_vulkan_VULKAN_DESCRIPTOR_ALLOCATOR_HPP
+
+#include <wk/wulkan.hpp>
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+namespace engine::drivers::vulkan {
+
+// chains descriptor pools as they fill up and recycles freed sets per layout, safe to use from any thread
+class VulkanDescriptorAllocator {
+public:
+    struct Stats {
+        uint32_t pool_count = 0;
+        uint32_t sets_allocated = 0;    // live sets
+        uint32_t sets_recycled = 0;     // freed sets waiting in a free list
+    };
+
+    // sets_per_pool scales every pool's descriptor counts, frames_in_flight bounds how long freed sets stay untouched
+    VulkanDescriptorAllocator(const wk::Device& device, uint32_t sets_per_pool, uint32_t frames_in_flight);
+
+    VulkanDescriptorAllocator(const VulkanDescriptorAllocator&) = delete;
+    VulkanDescriptorAllocator& operator=(const VulkanDescriptorAllocator&) = delete;
+
+    ~VulkanDescriptorAllocator() = default;
+
+    // lives until free is called, reusing a retired set of the same layout when possible
+    VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+    // the set is only handed out again once the frames that may still read it have finished. free every set
+    // of a layout before destroying it
+    void free(VkDescriptorSetLayout layout, VkDescriptorSet set);
+
+    // call before destroying a layout. its recycled sets are dropped, a new layout created with the same handle
+    // value must not be handed sets of the old one
+    void release_layout(VkDescriptorSetLayout layout);
+
+    // call once the gpu is done with the oldest frame in flight, retires freed sets
+    void next_frame();
+
+    Stats stats() const;
+
+private:
+    struct PendingFree {
+        VkDescriptorSetLayout layout;
+        VkDescriptorSet set;
+        uint64_t frame;
+    };
+
+    wk::DescriptorPool create_pool() const;
+    VkDescriptorSet try_allocate(VkDescriptorPool pool, VkDescriptorSetLayout layout, VkResult& result) const;
+
+    const wk::Device& _device;
+    mutable std::mutex _mutex;
+    uint32_t _sets_per_pool;
+    uint32_t _frames_in_flight;
+
+    std::vector<wk::DescriptorPool> _pools;
+    std::unordered_map<VkDescriptorSetLayout, std::vector<VkDescriptorSet>> _free_sets;
+    std::vector<PendingFree> _pending_frees;
+
+    uint64_t _frame = 0;
+    uint32_t _sets_allocated = 0;
+    uint32_t _sets_recycled = 0;
+};
+
+} // namespace engine::drivers::vulkan
+
+#endif // engine_drivers_vulkan_VULKAN_DESCRIPTOR_ALLOCATOR_HPP
@@ -8,7 +8,7 @@ namespace engine::drivers::vulkan {
 VulkanDescriptorSetLayout::VulkanDescriptorSetLayout(
     const VulkanDevice& device,
     const engine::core::graphics::DescriptorLayoutDescription& description)
-    : _device(device.device())
+    : _device(device.device()), _descriptor_allocator(&device.descriptor_allocator()), _description(description)
 {
     std::vector<VkDescriptorSetLayoutBinding> layout_bindings;
     layout_bindings.reserve(description.bindings.size());
@@ -31,4 +31,9 @@ VulkanDescriptorSetLayout::VulkanDescriptorSetLayout(
     );
 }
 
+VulkanDescriptorSetLayout::~VulkanDescriptorSetLayout() {
+    // moved from layouts have no handle
+    if (_layout.handle() != VK_NULL_HANDLE) _descriptor_allocator->release_layout(_layout.handle());
+}
+
 } // namespace engine::drivers::vulkan
@@ -4,6 +4,8 @@
 #include "engine/core/graphics/descriptor_set_layout.hpp"
 #include "engine/core/graphics/descriptor_types.hpp"
 
+#include "vulkan_descriptor_allocator.hpp"
+
 #include <wk/wulkan.hpp>
 
 namespace engine::drivers::vulkan {
@@ -22,15 +24,18 @@ public:
     VulkanDescriptorSetLayout(const VulkanDescriptorSetLayout&) = delete;
     VulkanDescriptorSetLayout& operator=(const VulkanDescriptorSetLayout&) = delete;
 
-    ~VulkanDescriptorSetLayout() override = default;
+    ~VulkanDescriptorSetLayout() override;
 
+    const engine::core::graphics::DescriptorLayoutDescription& description() const override { return _description; }
     void* native_descriptor_set_layout() const override { return static_cast<void*>(_layout.handle()); }
     std::string backend_name() const { return "Vulkan"; }
 
 private:
     const wk::Device& _device;
+    VulkanDescriptorAllocator* _descriptor_allocator;
 
     wk::DescriptorSetLayout _layout;
+    engine::core::graphics::DescriptorLayoutDescription _description;
 };
 
 } // namespace engine::drivers::vulkan
@@ -9,6 +9,7 @@
 #include "vulkan_texture_render_target.hpp"
 #include "vulkan_material.hpp"
 #include "vulkan_descriptor_set_layout.hpp"
+#include "vulkan_bindless_table.hpp"
 #include "convert_vulkan.hpp"
 
 #include "engine/core/debug/assert.hpp"
@@ -99,6 +100,69 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, const core::window::W
         core::debug::Logger::get_singleton().fatal("Failed to find supported depth format for this physical device");
     }
 
+    // optional features
+    VkPhysicalDeviceProperties physical_device_properties{};
+    vkGetPhysicalDeviceProperties(_physical_device.handle(), &physical_device_properties);
+
+    if (physical_device_properties.apiVersion < VK_API_VERSION_1_2) {
+        core::debug::Logger::get_singleton().fatal("Vulkan 1.2 is required for timeline semaphores");
+    }
+
+    VkPhysicalDeviceVulkan12Features supported_features_12{};
+    supported_features_12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceVulkan13Features supported_features_13{};
+    supported_features_13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    if (physical_device_properties.apiVersion >= VK_API_VERSION_1_3) {
+        supported_features_12.pNext = &supported_features_13;
+    }
+    VkPhysicalDeviceFeatures2 supported_features{};
+    supported_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supported_features.pNext = &supported_features_12;
+    vkGetPhysicalDeviceFeatures2(_physical_device.handle(), &supported_features);
+
+    if (supported_features_12.timelineSemaphore != VK_TRUE) {
+        core::debug::Logger::get_singleton().fatal("Selected physical device does not support timeline semaphores");
+    }
+
+    // dynamic rendering (core in 1.3), falls back to render passes when unavailable
+#ifndef ENGINE_VULKAN_NO_DYNAMIC_RENDERING
+    _dynamic_rendering = physical_device_properties.apiVersion >= VK_API_VERSION_1_3
+        && supported_features_13.dynamicRendering == VK_TRUE;
+#endif
+    core::debug::Logger::get_singleton().info("Vulkan dynamic rendering {}", _dynamic_rendering ? "enabled" : "disabled, using render passes");
+
+    // descriptor indexing (core in 1.2), without it materials keep their own sets
+    _bindless = supported_features_12.runtimeDescriptorArray == VK_TRUE
+        && supported_features_12.descriptorBindingPartiallyBound == VK_TRUE
+        && supported_features_12.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE
+        && supported_features_12.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE
+        && supported_features_12.descriptorBindingUpdateUnusedWhilePending == VK_TRUE
+        && supported_features_12.shaderSampledImageArrayNonUniformIndexing == VK_TRUE;
+    core::debug::Logger::get_singleton().info("Vulkan bindless descriptors {}", _bindless ? "enabled" : "disabled");
+
+    // bc textures (every desktop gpu), without them textures are uploaded as rgba8
+    _block_compression = supported_features.features.textureCompressionBC == VK_TRUE;
+    core::debug::Logger::get_singleton().info("Vulkan BC texture compression {}", _block_compression ? "enabled" : "disabled");
+
+    // uploads go to a transfer-only family when there is one, then any non-graphics family
+    _transfer_family = _queue_families.graphics_family.value();
+    for (uint32_t i = 0; i < queue_family_count; ++i) {
+        VkQueueFlags flags = queue_families[i].queueFlags;
+        if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+            _transfer_family = i;
+            break;
+        }
+    }
+    if (_transfer_family == _queue_families.graphics_family.value()) {
+        for (uint32_t i = 0; i < queue_family_count; ++i) {
+            VkQueueFlags flags = queue_families[i].queueFlags;
+            if ((flags & (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT)) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+                _transfer_family = i;
+                break;
+            }
+        }
+    }
+
     // device
     const float QUEUE_PRIORITY = 1.0f;
     std::vector<VkDeviceQueueCreateInfo> queue_create_infos = {
@@ -118,15 +182,51 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, const core::window::W
                 .to_vk());
     }
 
-    _device = wk::Device(_physical_device.handle(), _queue_families,
-        wk::DeviceCreateInfo{}
-            .set_p_enabled_features(&_physical_device.features())
-            .set_enabled_extensions(_physical_device.extensions().size(),
-                                    _physical_device.extensions().data())
-            .set_queue_create_infos(queue_create_infos.size(), queue_create_infos.data())
-            .to_vk());
+    if (_transfer_family != _queue_families.graphics_family.value() && _transfer_family != _present_family) {
+        queue_create_infos.push_back(
+            wk::DeviceQueueCreateInfo{}
+                .set_queue_family_index(_transfer_family)
+                .set_queue_count(1)
+                .set_p_queue_priorities(&QUEUE_PRIORITY)
+                .to_vk());
+    }
+
+    VkPhysicalDeviceFeatures enabled_features = _physical_device.features();
+    if (_block_compression) enabled_features.textureCompressionBC = VK_TRUE;
+
+    VkDeviceCreateInfo device_ci = wk::DeviceCreateInfo{}
+        .set_p_enabled_features(&enabled_features)
+        .set_enabled_extensions(_physical_device.extensions().size(),
+                                _physical_device.extensions().data())
+        .set_queue_create_infos(queue_create_infos.size(), queue_create_infos.data())
+        .to_vk();
+
+    VkPhysicalDeviceVulkan12Features enabled_features_12{};
+    enabled_features_12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    enabled_features_12.timelineSemaphore = VK_TRUE;
+    if (_bindless) {
+        enabled_features_12.runtimeDescriptorArray = VK_TRUE;
+        enabled_features_12.descriptorBindingPartiallyBound = VK_TRUE;
+        enabled_features_12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        enabled_features_12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        enabled_features_12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        enabled_features_12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    }
+    enabled_features_12.pNext = const_cast<void*>(device_ci.pNext);
+    device_ci.pNext = &enabled_features_12;
+
+    VkPhysicalDeviceVulkan13Features enabled_features_13{};
+    enabled_features_13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    enabled_features_13.dynamicRendering = VK_TRUE;
+    if (_dynamic_rendering) {
+        enabled_features_13.pNext = const_cast<void*>(device_ci.pNext);
+        device_ci.pNext = &enabled_features_13;
+    }
+
+    _device = wk::Device(_physical_device.handle(), _queue_families, device_ci);
 
     _graphics_queue = wk::Queue(_device.handle(), _queue_families.graphics_family.value());
+    _transfer_queue = wk::Queue(_device.handle(), _transfer_family);
 
     // command pool
     _command_pool = wk::CommandPool(_device.handle(),
@@ -137,12 +237,16 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, const core::window::W
             .to_vk()
     );
 
-    // descriptor pool
+    // descriptor pool for imgui
     VkDescriptorPoolSize pool_sizes[] = {
         wk::DescriptorPoolSize{}
             .set_type(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
             .set_descriptor_count(1024)
             .to_vk(),
+        wk::DescriptorPoolSize{}
+            .set_type(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+            .set_descriptor_count(1024)
+            .to_vk(),
         wk::DescriptorPoolSize{}
             .set_type(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
             .set_descriptor_count(1024)
@@ -172,12 +276,33 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, const core::window::W
             .set_p_vulkan_functions(&vulkan_functions)
             .to_vk()
     );
+
+    // staging ring and batched uploads
+    _upload_manager = std::make_unique<VulkanUploadManager>(*this, UPLOAD_STAGING_CAPACITY);
+
+    // per-frame uniform data
+    _uniform_allocator = std::make_unique<VulkanUniformAllocator>(*this, UNIFORM_RING_SEGMENT_SIZE, UNIFORM_RING_SEGMENTS);
+
+    // growable descriptor pools, retired on the same cadence as the uniform ring
+    _descriptor_allocator = std::make_unique<VulkanDescriptorAllocator>(_device, DESCRIPTOR_SETS_PER_POOL, UNIFORM_RING_SEGMENTS);
+
+    // shared mesh buffers, grown on demand
+    _mesh_pool = std::make_unique<VulkanMeshPool>(*this, MESH_POOL_VERTEX_CAPACITY, MESH_POOL_INDEX_CAPACITY);
 }
 
 void VulkanDevice::wait_idle() {
     vkDeviceWaitIdle(_device.handle());
 }
 
+void VulkanDevice::next_frame() {
+    // the uniform ring waits on the oldest frame in flight, after which its descriptors and replaced mesh
+    // buffers can be recycled
+    _uniform_allocator->next_frame();
+    _descriptor_allocator->next_frame();
+    _mesh_pool->next_frame();
+    ++_frame_count;
+}
+
 std::unique_ptr<core::graphics::Shader> VulkanDevice::create_shader(core::graphics::ShaderStageFlags stage, const std::string& filepath) const {
     return std::make_unique<VulkanShader>(
         *this,
@@ -186,18 +311,70 @@ std::unique_ptr<core::graphics::Shader> VulkanDevice::create_shader(core::graphi
 }
 
 std::unique_ptr<core::graphics::MeshBuffer> VulkanDevice::create_mesh_buffer(
-    const void* vertex_data, uint32_t vertex_size, uint32_t vertex_count,
-    const void* index_data, uint32_t index_size, uint32_t index_count) const 
+    const std::vector<core::graphics::VertexStream>& vertex_streams, uint32_t vertex_count,
+    const void* index_data, uint32_t index_size, uint32_t index_count,
+    const std::vector<core::graphics::SubMesh>& submeshes,
+    const std::vector<core::graphics::MeshLod>& lods) const 
 {
-    ENGINE_ASSERT(vertex_data != nullptr, "Vertex buffer creation requires valid data pointer");
-    ENGINE_ASSERT(vertex_size > 0 && vertex_count > 0, "Vertex buffer size/count must be greater than zero");
+    ENGINE_ASSERT(!vertex_streams.empty(), "Vertex buffer creation requires at least one vertex stream");
+    for (const core::graphics::VertexStream& stream : vertex_streams) {
+        ENGINE_ASSERT(stream.data != nullptr, "Vertex buffer creation requires valid data pointer");
+        ENGINE_ASSERT(stream.stride > 0, "Vertex stream stride must be greater than zero");
+    }
+    ENGINE_ASSERT(vertex_count > 0, "Vertex buffer count must be greater than zero");
     return std::make_unique<VulkanMeshBuffer>(
         *this,
-        vertex_data, vertex_size, vertex_count,
-        index_data, index_size, index_count
+        vertex_streams, vertex_count,
+        index_data, index_size, index_count,
+        submeshes, lods
     );
 }
 
+void VulkanDevice::defragment_mesh_buffers() {
+    _mesh_pool->defragment();
+}
+
+void VulkanDevice::trim_mesh_buffers() {
+    _mesh_pool->trim();
+}
+
+uint64_t VulkanDevice::mesh_buffer_capacity() const {
+    return _mesh_pool->capacity();
+}
+
+uint64_t VulkanDevice::memory_budget() const {
+    const VkPhysicalDeviceMemoryProperties* memory_properties = nullptr;
+    vmaGetMemoryProperties(_allocator.handle(), &memory_properties);
+
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS]{};
+    vmaGetHeapBudgets(_allocator.handle(), budgets);
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < memory_properties->memoryHeapCount; ++i) {
+        if (memory_properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) total += budgets[i].budget;
+    }
+    return total;
+}
+
+uint64_t VulkanDevice::memory_usage() const {
+    const VkPhysicalDeviceMemoryProperties* memory_properties = nullptr;
+    vmaGetMemoryProperties(_allocator.handle(), &memory_properties);
+
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS]{};
+    vmaGetHeapBudgets(_allocator.handle(), budgets);
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < memory_properties->memoryHeapCount; ++i) {
+        if (memory_properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) total += budgets[i].usage;
+    }
+    return total;
+}
+
+core::graphics::DescriptorStats VulkanDevice::descriptor_stats() const {
+    VulkanDescriptorAllocator::Stats stats = _descriptor_allocator->stats();
+    return core::graphics::DescriptorStats{ stats.pool_count, stats.sets_allocated, stats.sets_recycled };
+}
+
 std::unique_ptr<core::graphics::Texture> VulkanDevice::create_texture(
     uint32_t width,
     uint32_t height,
@@ -242,14 +419,14 @@ std::unique_ptr<core::graphics::Texture> VulkanDevice::create_texture_from_nativ
 std::unique_ptr<core::graphics::Pipeline> VulkanDevice::create_pipeline(
     const core::graphics::Shader& vert, const core::graphics::Shader& frag,
     const core::graphics::DescriptorSetLayout& layout,
-    const core::graphics::VertexBindingDescription& vertex_binding, 
+    const std::vector<core::graphics::VertexBindingDescription>& vertex_bindings,
     const std::vector<core::graphics::ImageAttachmentInfo>& attachment_info,
     const core::graphics::PipelineConfig& config
 ) const {
     return std::make_unique<VulkanPipeline>(
         *this,
         static_cast<VkShaderModule>(vert.native_shader()), static_cast<VkShaderModule>(frag.native_shader()),
-        vertex_binding,
+        vertex_bindings,
         layout,
         attachment_info,
         config
@@ -283,4 +460,18 @@ std::unique_ptr<core::graphics::DescriptorSetLayout> VulkanDevice::create_descri
     );
 }
 
+std::unique_ptr<core::graphics::BindlessTable> VulkanDevice::create_bindless_table(
+    uint32_t max_textures,
+    uint32_t max_materials,
+    uint32_t material_stride
+) const {
+    if (!_bindless) {
+        core::debug::Logger::get_singleton().error("Bindless table requested on a device without descriptor indexing");
+        return nullptr;
+    }
+    return std::make_unique<VulkanBindlessTable>(
+        *this, max_textures, max_materials, material_stride
+    );
+}
+
 }
\ No newline at end of file
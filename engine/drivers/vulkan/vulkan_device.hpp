@@ -14,6 +14,11 @@
 
 #include "engine/core/window/window.hpp"
 
+#include "vulkan_mesh_pool.hpp"
+#include "vulkan_upload_manager.hpp"
+#include "vulkan_uniform_allocator.hpp"
+#include "vulkan_descriptor_allocator.hpp"
+
 #include <wk/wulkan.hpp>
 #include <wk/ext/glfw/surface.hpp>
 
@@ -34,12 +39,21 @@ public:
     ~VulkanDevice() override = default;
 
     void wait_idle() override;
+    void next_frame() override;
 
     std::unique_ptr<core::graphics::Shader> create_shader(engine::core::graphics::ShaderStageFlags stage, const std::string& filepath) const override;
     std::unique_ptr<core::graphics::MeshBuffer> create_mesh_buffer(
-        const void* vertex_data, uint32_t vertex_size, uint32_t vertex_count,
-        const void* index_data, uint32_t index_size, uint32_t index_count
+        const std::vector<core::graphics::VertexStream>& vertex_streams, uint32_t vertex_count,
+        const void* index_data, uint32_t index_size, uint32_t index_count,
+        const std::vector<core::graphics::SubMesh>& submeshes = {},
+        const std::vector<core::graphics::MeshLod>& lods = {}
     ) const override;
+    void defragment_mesh_buffers() override;
+    void trim_mesh_buffers() override;
+    uint64_t mesh_buffer_capacity() const override;
+    uint64_t memory_budget() const override;
+    uint64_t memory_usage() const override;
+    core::graphics::DescriptorStats descriptor_stats() const override;
     std::unique_ptr<core::graphics::Texture> create_texture(
         uint32_t width,
         uint32_t height,
@@ -61,7 +75,7 @@ public:
     std::unique_ptr<core::graphics::Pipeline> create_pipeline(
         const core::graphics::Shader& vert, const core::graphics::Shader& frag,
         const core::graphics::DescriptorSetLayout& layout,
-        const core::graphics::VertexBindingDescription& vertex_binding, 
+        const std::vector<core::graphics::VertexBindingDescription>& vertex_bindings,
         const std::vector<core::graphics::ImageAttachmentInfo>& attachment_info,
         const core::graphics::PipelineConfig& config
     ) const override;
@@ -78,6 +92,13 @@ public:
     std::unique_ptr<core::graphics::DescriptorSetLayout> create_descriptor_set_layout(
         const core::graphics::DescriptorLayoutDescription& description
     ) const override;
+    bool bindless_supported() const override { return _bindless; }
+    bool block_compression_supported() const override { return _block_compression; }
+    std::unique_ptr<core::graphics::BindlessTable> create_bindless_table(
+        uint32_t max_textures,
+        uint32_t max_materials,
+        uint32_t material_stride
+    ) const override;
 
     const wk::PhysicalDevice& physical_device() const { return _physical_device; }
 
@@ -86,7 +107,17 @@ public:
     const wk::CommandPool& command_pool() const { return _command_pool; }
     const wk::DescriptorPool& descriptor_pool() const { return _descriptor_pool; }
     const wk::Queue& graphics_queue() const { return _graphics_queue; }
+    const wk::Queue& transfer_queue() const { return _transfer_queue; }
+    VulkanUploadManager& upload_manager() const { return *_upload_manager; }
+    VulkanMeshPool& mesh_pool() const { return *_mesh_pool; }
+    VulkanUniformAllocator& uniform_allocator() const { return *_uniform_allocator; }
+    VulkanDescriptorAllocator& descriptor_allocator() const { return *_descriptor_allocator; }
     uint32_t present_family() const { return _present_family; }
+    bool dynamic_rendering_enabled() const { return _dynamic_rendering; }
+
+    // frames started so far, and how many of them may still be executing on the gpu
+    uint64_t frame_count() const { return _frame_count; }
+    uint32_t frames_in_flight() const { return UNIFORM_RING_SEGMENTS; }
 
     const wk::DeviceQueueFamilyIndices& queue_families() const { return _queue_families; }
 
@@ -103,6 +134,13 @@ public:
     std::string backend_name() const override { return "Vulkan"; }
 
 private:
+    static constexpr VkDeviceSize MESH_POOL_VERTEX_CAPACITY = 32ull * 1024 * 1024;
+    static constexpr VkDeviceSize MESH_POOL_INDEX_CAPACITY = 16ull * 1024 * 1024;
+    static constexpr VkDeviceSize UPLOAD_STAGING_CAPACITY = 64ull * 1024 * 1024;
+    static constexpr VkDeviceSize UNIFORM_RING_SEGMENT_SIZE = 4ull * 1024 * 1024;
+    static constexpr uint32_t UNIFORM_RING_SEGMENTS = 4;
+    static constexpr uint32_t DESCRIPTOR_SETS_PER_POOL = 256;
+
     const wk::Instance& _instance;
 
     wk::PhysicalDevice _physical_device;
@@ -111,15 +149,27 @@ private:
     wk::DeviceQueueFamilyIndices _queue_families;
 
     wk::Queue _graphics_queue;
+    wk::Queue _transfer_queue;
+    uint32_t _transfer_family;
 
     wk::Allocator _allocator;
     wk::CommandPool _command_pool;
-    wk::DescriptorPool _descriptor_pool;
+    wk::DescriptorPool _descriptor_pool; // imgui only, engine sets come from the descriptor allocator
 
     uint32_t _present_family;
     core::graphics::ImageFormat _present_format;
     core::graphics::ColorSpace _present_color_space;
     core::graphics::ImageFormat _depth_format;
+
+    bool _dynamic_rendering = false;
+    bool _bindless = false;
+    bool _block_compression = false;
+    uint64_t _frame_count = 0;
+
+    std::unique_ptr<VulkanUploadManager> _upload_manager;
+    std::unique_ptr<VulkanUniformAllocator> _uniform_allocator;
+    std::unique_ptr<VulkanDescriptorAllocator> _descriptor_allocator;
+    std::unique_ptr<VulkanMeshPool> _mesh_pool;
 };
 
 } // namespace engine::drivers::vulkan
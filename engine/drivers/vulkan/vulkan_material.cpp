@@ -6,30 +6,48 @@
 #include "engine/core/debug/assert.hpp"
 
 #include <cstring>
+#include <utility>
 
 namespace engine::drivers::vulkan {
 
 VulkanMaterial::VulkanMaterial(
     const VulkanPipeline& pipeline,
-    VkDescriptorSetLayout layout,
+    const core::graphics::DescriptorSetLayout& layout,
     uint32_t uniform_buffer_size
 )
     : _device(pipeline.device()),
       _allocator(pipeline.allocator()),
-      _descriptor_pool(pipeline.descriptor_pool()),
+      _descriptor_allocator(pipeline.descriptor_allocator()),
       _pipeline_layout(pipeline.pipeline_layout()),
+      _uniform_allocator(pipeline.uniform_allocator()),
       _uniform_buffer_size(uniform_buffer_size)
 {
     // descriptor set
-    _descriptor_set = wk::DescriptorSet(
-        _device.handle(),
-        wk::DescriptorSetAllocateInfo{}
-            .set_descriptor_pool(_descriptor_pool.handle())
-            .set_set_layouts(1, &layout)
-            .to_vk()
-    );
-
-    if (_uniform_buffer_size > 0) {
+    _set_layout = static_cast<VkDescriptorSetLayout>(layout.native_descriptor_set_layout());
+    _descriptor_set = _descriptor_allocator.allocate(_set_layout);
+
+    for (const core::graphics::DescriptorLayoutBinding& binding : layout.description().bindings) {
+        if (binding.binding == 0 && binding.type == core::graphics::DescriptorType::UNIFORM_BUFFER_DYNAMIC) _dynamic_uniform = true;
+    }
+
+    if (_uniform_buffer_size > 0 && _dynamic_uniform) {
+        // the offset into the ring is supplied at bind time
+        VkDescriptorBufferInfo buffer_info = wk::DescriptorBufferInfo{}
+            .set_buffer(_uniform_allocator.buffer())
+            .set_offset(0)
+            .set_range(_uniform_buffer_size)
+            .to_vk();
+
+        VkWriteDescriptorSet ubo_write = wk::WriteDescriptorSet{}
+            .set_dst_set(_descriptor_set)
+            .set_dst_binding(0)
+            .set_descriptor_type(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+            .set_descriptor_count(1)
+            .set_p_buffer_info(&buffer_info)
+            .to_vk();
+
+        vkUpdateDescriptorSets(_device.handle(), 1, &ubo_write, 0, nullptr);
+    } else if (_uniform_buffer_size > 0) {
         // uniform buffer
         _uniform_buffer = wk::Buffer(
             _allocator.handle(),
@@ -51,7 +69,7 @@ VulkanMaterial::VulkanMaterial(
             .to_vk();
 
         VkWriteDescriptorSet ubo_write = wk::WriteDescriptorSet{}
-            .set_dst_set(_descriptor_set.handle())
+            .set_dst_set(_descriptor_set)
             .set_dst_binding(0)
             .set_descriptor_type(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
             .set_descriptor_count(1)
@@ -59,27 +77,61 @@ VulkanMaterial::VulkanMaterial(
             .to_vk();
 
         vkUpdateDescriptorSets(_device.handle(), 1, &ubo_write, 0, nullptr);
+
+        vmaMapMemory(_allocator.handle(), _uniform_buffer.allocation(), &_uniform_mapped);
+    }
+}
+
+VulkanMaterial::VulkanMaterial(VulkanMaterial&& other) noexcept
+    : _device(other._device),
+      _allocator(other._allocator),
+      _descriptor_allocator(other._descriptor_allocator),
+      _pipeline_layout(other._pipeline_layout),
+      _uniform_allocator(other._uniform_allocator),
+      _set_layout(other._set_layout),
+      _descriptor_set(std::exchange(other._descriptor_set, VK_NULL_HANDLE)),
+      _dynamic_uniform(other._dynamic_uniform),
+      _dynamic_offset(other._dynamic_offset),
+      _uniform_buffer(std::move(other._uniform_buffer)),
+      _uniform_mapped(std::exchange(other._uniform_mapped, nullptr)),
+      _uniform_buffer_size(other._uniform_buffer_size) {}
+
+VulkanMaterial::~VulkanMaterial() {
+    if (_uniform_mapped && _uniform_buffer.allocation() != VK_NULL_HANDLE) {
+        vmaUnmapMemory(_allocator.handle(), _uniform_buffer.allocation());
     }
+
+    // back to the allocator's free list, reused once in-flight frames are done with it
+    _descriptor_allocator.free(_set_layout, _descriptor_set);
 }
 
 void VulkanMaterial::update_uniform_buffer(const void* data) {
     ENGINE_ASSERT(data != nullptr, "Attempted to update uniform buffer with null data");
 
-    void* mapped = nullptr;
-    vmaMapMemory(_allocator.handle(), _uniform_buffer.allocation(), &mapped);
-    std::memcpy(mapped, data, _uniform_buffer_size);
-    vmaUnmapMemory(_allocator.handle(), _uniform_buffer.allocation());
+    // every update gets fresh ring memory, so frames still in flight keep reading their own copy
+    if (_dynamic_uniform) {
+        _dynamic_offset = _uniform_allocator.push(data, _uniform_buffer_size);
+        return;
+    }
+
+    ENGINE_ASSERT(_uniform_mapped != nullptr, "Attempted to update a material without a uniform buffer");
+    std::memcpy(_uniform_mapped, data, _uniform_buffer_size);
 }
 
 void VulkanMaterial::bind(void* cb) const {
+    bind(cb, static_cast<void*>(_pipeline_layout.handle()), 0);
+}
+
+void VulkanMaterial::bind(void* cb, void* pipeline_layout, uint32_t set) const {
     ENGINE_ASSERT(cb != nullptr, "Attempted to bind material with null command buffer");
+    ENGINE_ASSERT(pipeline_layout != nullptr, "Attempted to bind material with null pipeline layout");
 
     vkCmdBindDescriptorSets(static_cast<VkCommandBuffer>(cb),
         VK_PIPELINE_BIND_POINT_GRAPHICS,
-        _pipeline_layout.handle(),
-        0,
-        1, &_descriptor_set.handle(),
-        0, nullptr);
+        static_cast<VkPipelineLayout>(pipeline_layout),
+        set,
+        1, &_descriptor_set,
+        _dynamic_uniform ? 1 : 0, &_dynamic_offset);
 }
 
 } // namespace engine::drivers::vulkan
@@ -2,8 +2,11 @@
 #define engine_drivers_vulkan_VULKAN_MATERIAL_HPP
 
 #include "vulkan_pipeline.hpp"
+#include "vulkan_uniform_allocator.hpp"
+#include "vulkan_descriptor_allocator.hpp"
 
 #include "engine/core/graphics/material.hpp"
+#include "engine/core/graphics/descriptor_set_layout.hpp"
 
 #include <wk/wulkan.hpp>
 #include <string>
@@ -16,32 +19,40 @@ class VulkanMaterial final : public core::graphics::Material {
 public:
     VulkanMaterial(
         const VulkanPipeline& device,
-        VkDescriptorSetLayout layout,
+        const core::graphics::DescriptorSetLayout& layout,
         uint32_t uniform_buffer_size
     );
 
-    VulkanMaterial(VulkanMaterial&& other) = default;
+    VulkanMaterial(VulkanMaterial&& other) noexcept;
     VulkanMaterial& operator=(VulkanMaterial&& other) = default;
 
     VulkanMaterial(const VulkanMaterial&) = delete;
     VulkanMaterial& operator=(const VulkanMaterial&) = delete;
 
-    ~VulkanMaterial() override = default;
+    ~VulkanMaterial() override;
 
     void bind(void* cb) const override;
+    void bind(void* cb, void* pipeline_layout, uint32_t set) const override;
     void update_uniform_buffer(const void* data) override;
 
-    void* native_descriptor_set() const { return static_cast<void*>(_descriptor_set.handle()); }
+    void* native_descriptor_set() const { return static_cast<void*>(_descriptor_set); }
     std::string backend_name() const override { return "Vulkan"; }
 
 private:
     const wk::Device& _device;
     const wk::Allocator& _allocator;
-    const wk::DescriptorPool& _descriptor_pool;
+    VulkanDescriptorAllocator& _descriptor_allocator;
     const wk::PipelineLayout& _pipeline_layout;
+    VulkanUniformAllocator& _uniform_allocator;
 
-    wk::DescriptorSet _descriptor_set;
+    VkDescriptorSetLayout _set_layout = VK_NULL_HANDLE;
+    VkDescriptorSet _descriptor_set = VK_NULL_HANDLE;
+
+    // dynamic uniforms live in the frame's uniform ring, static ones in a buffer of their own
+    bool _dynamic_uniform = false;
+    uint32_t _dynamic_offset = 0;
     wk::Buffer _uniform_buffer;
+    void* _uniform_mapped = nullptr;
 
     uint32_t _uniform_buffer_size;
 };
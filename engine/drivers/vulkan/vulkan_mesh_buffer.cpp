@@ -4,118 +4,93 @@
 
 #include "engine/core/debug/assert.hpp"
 
-#include <cstring>
+#include <algorithm>
 
 namespace engine::drivers::vulkan {
 
 VulkanMeshBuffer::VulkanMeshBuffer(
     const VulkanDevice& device,
-    const void* vertex_data, uint32_t vertex_size, uint32_t vertex_count,
-    const void* index_data, uint32_t index_size, uint32_t index_count)
-    : _device(device.device()),
-      _allocator(device.allocator()), _command_pool(device.command_pool()),
-      _vertex_count(vertex_count), _index_count(index_count)
+    const std::vector<core::graphics::VertexStream>& vertex_streams, uint32_t vertex_count,
+    const void* index_data, uint32_t index_size, uint32_t index_count,
+    const std::vector<core::graphics::SubMesh>& submeshes,
+    const std::vector<core::graphics::MeshLod>& lods)
+    : _pool(&device.mesh_pool()),
+      _vertex_count(vertex_count), _index_count(index_count),
+      _submeshes(submeshes), _lods(lods)
 {
-    // geometry buffers
-    _vertex_buffer = wk::Buffer(
-        _allocator.handle(),
-        wk::BufferCreateInfo{}
-            .set_size(_vertex_count * vertex_size)
-            .set_usage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
-            .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
-            .to_vk(),
-        wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_GPU_ONLY).to_vk()
-    );
-
-    _index_buffer = wk::Buffer(
-        _allocator.handle(),
-        wk::BufferCreateInfo{}
-            .set_size(_index_count * index_size)
-            .set_usage(VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
-            .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
-            .to_vk(),
-        wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_GPU_ONLY).to_vk()
-    );
+    // a buffer without a submesh table is one submesh spanning every index
+    if (_submeshes.empty()) {
+        _submeshes.push_back(core::graphics::SubMesh{ "default", 0, index_count });
+    }
+    for (const core::graphics::SubMesh& submesh : _submeshes) {
+        ENGINE_ASSERT(submesh.first_index + submesh.index_count <= index_count, "Submesh range exceeds mesh index count");
+    }
+
+    // and one without a lod table has only its full detail level, the span of its submeshes
+    if (_lods.empty()) {
+        uint32_t lod0_count = 0;
+        for (const core::graphics::SubMesh& submesh : _submeshes) lod0_count = std::max(lod0_count, submesh.first_index + submesh.index_count);
+        _lods.push_back(core::graphics::MeshLod{ 0, lod0_count, 0.0f });
+    }
+    for (const core::graphics::MeshLod& lod : _lods) {
+        ENGINE_ASSERT(lod.first_index + lod.index_count <= index_count, "Lod range exceeds mesh index count");
+    }
 
     _index_type = (index_size == 4) ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
 
-    // staging buffers
-    wk::Buffer vertex_staging(
-        _allocator.handle(),
-        wk::BufferCreateInfo{}
-            .set_size(_vertex_count * vertex_size)
-            .set_usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
-            .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
-            .to_vk(),
-        wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_CPU_ONLY).to_vk()
-    );
-
-    wk::Buffer index_staging(
-        _allocator.handle(),
-        wk::BufferCreateInfo{}
-            .set_size(_index_count * index_size)
-            .set_usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
-            .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
-            .to_vk(),
-        wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_CPU_ONLY).to_vk()
-    );
-
-    // upload
-    {
-        void* mapped_vertex = nullptr;
-        vmaMapMemory(_allocator.handle(), vertex_staging.allocation(), &mapped_vertex);
-        std::memcpy(mapped_vertex, vertex_data, _vertex_count * vertex_size);
-        vmaUnmapMemory(_allocator.handle(), vertex_staging.allocation());
-
-        void* mapped_index = nullptr;
-        vmaMapMemory(_allocator.handle(), index_staging.allocation(), &mapped_index);
-        std::memcpy(mapped_index, index_data, _index_count * index_size);
-        vmaUnmapMemory(_allocator.handle(), index_staging.allocation());
-
-        // record copy command
-        wk::CommandBuffer upload_cb(
-            _device.handle(),
-            wk::CommandBufferAllocateInfo{}.set_command_pool(_command_pool.handle()).to_vk()
-        );
-
-        VkCommandBufferBeginInfo begin_info = wk::CommandBufferBeginInfo{}
-            .set_flags(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
-            .to_vk();
-        vkBeginCommandBuffer(upload_cb.handle(), &begin_info);
-
-        VkBufferCopy vertex_copy = {0, 0, _vertex_count * vertex_size};
-        vkCmdCopyBuffer(upload_cb.handle(), vertex_staging.handle(), _vertex_buffer.handle(), 1, &vertex_copy);
-
-        VkBufferCopy index_copy = {0, 0, _index_count * index_size};
-        vkCmdCopyBuffer(upload_cb.handle(), index_staging.handle(), _index_buffer.handle(), 1, &index_copy);
-
-        vkEndCommandBuffer(upload_cb.handle());
-
-        // submit and wait
-        VkSubmitInfo submit_info = wk::SubmitInfo{}
-            .set_command_buffers(1, &upload_cb.handle())
-            .to_vk();
-
-        vkQueueSubmit(_device.graphics_queue().handle(), 1, &submit_info, VK_NULL_HANDLE);
-        vkQueueWaitIdle(_device.graphics_queue().handle());
-    }
+    // suballocate from the shared buffers and upload
+    _allocation = _pool->allocate(vertex_streams, vertex_count, index_size, index_count);
+    _pool->write(_allocation, vertex_streams, index_data);
 }
 
 void VulkanMeshBuffer::bind(engine::core::graphics::CommandBuffer* command_buffer) const {
     ENGINE_ASSERT(command_buffer != nullptr, "Attempted to bind mesh buffer with null command buffer");
 
-    VkDeviceSize offset = 0;
+    // every mesh shares these buffers, so consecutive single stream draws only need one bind per index type.
+    // stream i goes to binding i, a pipeline declaring fewer bindings just never reads the rest
+    uint32_t stream_count = _pool->stream_count(_allocation);
+    VkBuffer vertex_buffers[VulkanMeshPool::MAX_VERTEX_STREAMS];
+    VkDeviceSize offsets[VulkanMeshPool::MAX_VERTEX_STREAMS];
+    for (uint32_t s = 0; s < stream_count; ++s) {
+        vertex_buffers[s] = _pool->vertex_buffer();
+        offsets[s] = _pool->binding_offset(_allocation, s);
+    }
+
     VkCommandBuffer cb = static_cast<VkCommandBuffer>(command_buffer->native_command_buffer());
-    vkCmdBindVertexBuffers(cb, 0, 1, &_vertex_buffer.handle(), &offset);
-    vkCmdBindIndexBuffer(cb, _index_buffer.handle(), 0, _index_type);
+    vkCmdBindVertexBuffers(cb, 0, stream_count, vertex_buffers, offsets);
+    vkCmdBindIndexBuffer(cb, _pool->index_buffer(), 0, _index_type);
 }
 
 void VulkanMeshBuffer::draw(engine::core::graphics::CommandBuffer* command_buffer) const {
     ENGINE_ASSERT(command_buffer != nullptr, "Attempted to draw mesh buffer with null command buffer");
 
-    VkDeviceSize offset = 0;
+    draw_lod(command_buffer, 0);
+}
+
+void VulkanMeshBuffer::draw_lod(engine::core::graphics::CommandBuffer* command_buffer, uint32_t lod) const {
+    ENGINE_ASSERT(command_buffer != nullptr, "Attempted to draw mesh buffer with null command buffer");
+    ENGINE_ASSERT(lod < _lods.size(), "Lod index out of range");
+
+    const core::graphics::MeshLod& range = _lods[lod];
+    VkCommandBuffer cb = static_cast<VkCommandBuffer>(command_buffer->native_command_buffer());
+    vkCmdDrawIndexed(cb, range.index_count, 1, first_index() + range.first_index, static_cast<int32_t>(base_vertex()), 0);
+}
+
+void VulkanMeshBuffer::draw_submesh(engine::core::graphics::CommandBuffer* command_buffer, uint32_t submesh) const {
+    ENGINE_ASSERT(command_buffer != nullptr, "Attempted to draw mesh buffer with null command buffer");
+    ENGINE_ASSERT(submesh < _submeshes.size(), "Submesh index out of range");
+
+    const core::graphics::SubMesh& range = _submeshes[submesh];
     VkCommandBuffer cb = static_cast<VkCommandBuffer>(command_buffer->native_command_buffer());
-    vkCmdDrawIndexed(cb, _index_count, 1, 0, 0, 0);
+    vkCmdDrawIndexed(cb, range.index_count, 1, first_index() + range.first_index, static_cast<int32_t>(base_vertex()), 0);
 }
 
-}
\ No newline at end of file
+void VulkanMeshBuffer::release() {
+    if (_pool && _allocation != VulkanMeshPool::INVALID_ALLOCATION) {
+        _pool->free(_allocation);
+    }
+    _pool = nullptr;
+    _allocation = VulkanMeshPool::INVALID_ALLOCATION;
+}
+
+}
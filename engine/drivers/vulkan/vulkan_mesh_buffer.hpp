@@ -3,8 +3,13 @@
 
 #include "engine/core/graphics/mesh_buffer.hpp"
 
+#include "vulkan_mesh_pool.hpp"
+
 #include <wk/wulkan.hpp>
 
+#include <utility>
+#include <vector>
+
 namespace engine::drivers::vulkan {
 
 class VulkanDevice;
@@ -12,38 +17,64 @@ class VulkanDevice;
 class VulkanMeshBuffer : public core::graphics::MeshBuffer {
 public:
     VulkanMeshBuffer(const VulkanDevice& device,
-        const void* vertex_data, uint32_t vertex_size, uint32_t vertex_count,
-        const void* index_data, uint32_t index_size, uint32_t index_count
+        const std::vector<core::graphics::VertexStream>& vertex_streams, uint32_t vertex_count,
+        const void* index_data, uint32_t index_size, uint32_t index_count,
+        const std::vector<core::graphics::SubMesh>& submeshes = {},
+        const std::vector<core::graphics::MeshLod>& lods = {}
     );
 
-    VulkanMeshBuffer(VulkanMeshBuffer&& other) = default;
-    VulkanMeshBuffer& operator=(VulkanMeshBuffer&& other) = default;
+    VulkanMeshBuffer(VulkanMeshBuffer&& other) noexcept
+        : _pool(std::exchange(other._pool, nullptr)),
+          _allocation(std::exchange(other._allocation, VulkanMeshPool::INVALID_ALLOCATION)),
+          _vertex_count(other._vertex_count), _index_count(other._index_count), _index_type(other._index_type),
+          _submeshes(std::move(other._submeshes)), _lods(std::move(other._lods)) {}
+    VulkanMeshBuffer& operator=(VulkanMeshBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            _pool = std::exchange(other._pool, nullptr);
+            _allocation = std::exchange(other._allocation, VulkanMeshPool::INVALID_ALLOCATION);
+            _vertex_count = other._vertex_count;
+            _index_count = other._index_count;
+            _index_type = other._index_type;
+            _submeshes = std::move(other._submeshes);
+            _lods = std::move(other._lods);
+        }
+        return *this;
+    }
 
     VulkanMeshBuffer(const VulkanMeshBuffer&) = delete;
     VulkanMeshBuffer& operator=(const VulkanMeshBuffer&) = delete;
 
-    ~VulkanMeshBuffer() override = default;
+    ~VulkanMeshBuffer() override { release(); }
 
     void bind(engine::core::graphics::CommandBuffer* command_buffer) const override;
     void draw(engine::core::graphics::CommandBuffer* command_buffer) const override;
+    void draw_lod(engine::core::graphics::CommandBuffer* command_buffer, uint32_t lod) const override;
+    void draw_submesh(engine::core::graphics::CommandBuffer* command_buffer, uint32_t submesh) const override;
 
     uint32_t vertex_count() const override { return _vertex_count; }
+    uint32_t vertex_stream_count() const override { return _pool->stream_count(_allocation); }
     uint32_t index_count() const override { return _index_count; }
+    const std::vector<core::graphics::SubMesh>& submeshes() const override { return _submeshes; }
+    const std::vector<core::graphics::MeshLod>& lods() const override { return _lods; }
+    uint32_t base_vertex() const override { return _pool->base_vertex(_allocation); }
+    uint32_t first_index() const override { return _pool->first_index(_allocation); }
 
-    void* vertex_buffer_handle() const override { return (void*)_vertex_buffer.handle(); }
-    void* index_buffer_handle() const override { return (void*)_index_buffer.handle(); }
+    void* vertex_buffer_handle() const override { return (void*)_pool->vertex_buffer(); }
+    void* index_buffer_handle() const override { return (void*)_pool->index_buffer(); }
 
 private:
-    const wk::Device& _device;
-    const wk::Allocator& _allocator;
-    const wk::CommandPool& _command_pool;
+    void release();
 
-    wk::Buffer _vertex_buffer;
-    wk::Buffer _index_buffer;
+    VulkanMeshPool* _pool = nullptr;
+    VulkanMeshPool::AllocationId _allocation = VulkanMeshPool::INVALID_ALLOCATION;
 
     uint32_t _vertex_count;
     uint32_t _index_count;
     VkIndexType _index_type;
+
+    std::vector<core::graphics::SubMesh> _submeshes;
+    std::vector<core::graphics::MeshLod> _lods;
 };
 
 } // namespace engine::drivers::vulkan
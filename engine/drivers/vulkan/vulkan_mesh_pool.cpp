@@ -0,0 +1,246 @@
+#include "vulkan_mesh_pool.hpp"
+
+#include "vulkan_device.hpp"
+
+#include "engine/core/debug/assert.hpp"
+#include "engine/core/debug/logger.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace engine::drivers::vulkan {
+
+namespace {
+
+// half again the live data, and only when that at least halves the buffer; growth doubles, so a pool
+// hovering around one size does not alternate between growing and trimming
+VkDeviceSize TrimmedCapacity(VkDeviceSize allocated_end, VkDeviceSize capacity, VkDeviceSize initial_capacity) {
+    VkDeviceSize target = std::max(initial_capacity, allocated_end + allocated_end / 2);
+    return target <= capacity / 2 ? target : capacity;
+}
+
+// frames a trim waits after the pool last grew or shrank, so eviction churn settles before capacity is handed
+// back and a reupload right after does not grow it straight back
+constexpr uint64_t TRIM_COOLDOWN_FRAMES = 300;
+
+} // namespace
+
+VulkanMeshPool::VulkanMeshPool(const VulkanDevice& device, VkDeviceSize vertex_capacity, VkDeviceSize index_capacity)
+    : _allocator(device.allocator()), _upload_manager(device.upload_manager()),
+      _frames_in_flight(device.frames_in_flight()),
+      _vertex_allocator(vertex_capacity), _index_allocator(index_capacity),
+      _initial_vertex_capacity(vertex_capacity), _initial_index_capacity(index_capacity)
+{
+    // buffers are written on the transfer queue and read on the graphics queue
+    _queue_families = { device.graphics_queue().family_index() };
+    if (_upload_manager.queue_family() != _queue_families.front()) {
+        _queue_families.push_back(_upload_manager.queue_family());
+    }
+
+    _vertex_buffer = create_buffer(vertex_capacity, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    _index_buffer = create_buffer(index_capacity, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+}
+
+VulkanMeshPool::AllocationId VulkanMeshPool::allocate(const std::vector<core::graphics::VertexStream>& streams, uint32_t vertex_count, uint32_t index_size, uint32_t index_count) {
+    ENGINE_ASSERT(!streams.empty() && streams.size() <= MAX_VERTEX_STREAMS, "Mesh pool allocation requires 1 to MAX_VERTEX_STREAMS vertex streams");
+    ENGINE_ASSERT(vertex_count > 0, "Mesh pool allocation requires vertices");
+    ENGINE_ASSERT(index_size == 2 || index_size == 4, "Mesh pool only supports 16 or 32 bit indices");
+    ENGINE_ASSERT(index_count > 0, "Mesh pool allocation requires indices");
+
+    Range range;
+    range.stream_count = static_cast<uint32_t>(streams.size());
+    range.index_size = static_cast<uint64_t>(index_size) * index_count;
+    range.index_stride = index_size;
+    range.live = true;
+
+    for (uint32_t s = 0; s < range.stream_count; ++s) {
+        ENGINE_ASSERT(streams[s].stride > 0, "Mesh pool vertex stream stride must be greater than zero");
+        range.vertex[s].stride = streams[s].stride;
+        range.vertex[s].size = static_cast<uint64_t>(streams[s].stride) * vertex_count;
+        range.vertex[s].offset = allocate_vertices(range.vertex[s].size, streams[s].stride);
+    }
+
+    range.index_offset = _index_allocator.allocate(range.index_size, index_size);
+    if (range.index_offset == core::memory::OffsetAllocator::INVALID_OFFSET) {
+        grow_index_buffer(std::max(_index_allocator.capacity() * 2, _index_allocator.capacity() + range.index_size + index_size));
+        range.index_offset = _index_allocator.allocate(range.index_size, index_size);
+    }
+
+    ENGINE_ASSERT(range.index_offset != core::memory::OffsetAllocator::INVALID_OFFSET, "Mesh pool failed to allocate after growing");
+
+    AllocationId id;
+    if (!_free_ids.empty()) {
+        id = _free_ids.back();
+        _free_ids.pop_back();
+        _ranges[id] = range;
+    } else {
+        id = static_cast<AllocationId>(_ranges.size());
+        _ranges.push_back(range);
+    }
+    return id;
+}
+
+void VulkanMeshPool::free(AllocationId id) {
+    ENGINE_ASSERT(id < _ranges.size() && _ranges[id].live, "Attempted to free an invalid mesh pool allocation");
+
+    for (uint32_t s = 0; s < _ranges[id].stream_count; ++s) _vertex_allocator.free(_ranges[id].vertex[s].offset);
+    _index_allocator.free(_ranges[id].index_offset);
+    _ranges[id].live = false;
+    _free_ids.push_back(id);
+}
+
+void VulkanMeshPool::write(AllocationId id, const std::vector<core::graphics::VertexStream>& streams, const void* index_data) {
+    ENGINE_ASSERT(id < _ranges.size() && _ranges[id].live, "Attempted to write an invalid mesh pool allocation");
+    const Range& range = _ranges[id];
+    ENGINE_ASSERT(streams.size() == range.stream_count, "Mesh pool write stream count differs from the allocation");
+
+    // staged through the ring; draws wait on the upload timeline before reading
+    for (uint32_t s = 0; s < range.stream_count; ++s) {
+        _upload_manager.upload_buffer(_vertex_buffer.handle(), range.vertex[s].offset, streams[s].data, range.vertex[s].size);
+    }
+    _upload_manager.upload_buffer(_index_buffer.handle(), range.index_offset, index_data, range.index_size);
+}
+
+void VulkanMeshPool::defragment() {
+    repack(_vertex_allocator.capacity(), _index_allocator.capacity());
+}
+
+void VulkanMeshPool::trim() {
+    if (_frame - _last_resize_frame < TRIM_COOLDOWN_FRAMES) return;
+
+    // sized from what would be left after packing, the repack then does the packing
+    VkDeviceSize vertex_live = 0, index_live = 0;
+    for (const Range& range : _ranges) {
+        if (!range.live) continue;
+        for (uint32_t s = 0; s < range.stream_count; ++s) vertex_live += range.vertex[s].size + range.vertex[s].stride;
+        index_live += range.index_size + range.index_stride;
+    }
+    VkDeviceSize vertex_capacity = TrimmedCapacity(vertex_live, _vertex_allocator.capacity(), _initial_vertex_capacity);
+    VkDeviceSize index_capacity = TrimmedCapacity(index_live, _index_allocator.capacity(), _initial_index_capacity);
+    if (vertex_capacity == _vertex_allocator.capacity() && index_capacity == _index_allocator.capacity()) return;
+
+    VkDeviceSize before = capacity();
+    repack(vertex_capacity, index_capacity);
+    core::debug::Logger::get_singleton().info("Mesh pool trimmed from {} to {} bytes", before, capacity());
+}
+
+void VulkanMeshPool::next_frame() {
+    ++_frame;
+    std::erase_if(_retired, [this](const RetiredBuffer& retired) {
+        return _frame - retired.frame >= _frames_in_flight && _upload_manager.is_complete(retired.token);
+    });
+}
+
+void VulkanMeshPool::repack(VkDeviceSize vertex_capacity, VkDeviceSize index_capacity) {
+    std::vector<core::memory::OffsetAllocator::Relocation> vertex_moves = _vertex_allocator.defragment();
+    std::vector<core::memory::OffsetAllocator::Relocation> index_moves = _index_allocator.defragment();
+    vertex_capacity = std::max(vertex_capacity, _vertex_allocator.allocated_end());
+    index_capacity = std::max(index_capacity, _index_allocator.allocated_end());
+    if (vertex_moves.empty() && index_moves.empty()
+        && vertex_capacity == _vertex_allocator.capacity() && index_capacity == _index_allocator.capacity()) return;
+
+    std::unordered_map<uint64_t, uint64_t> vertex_remap, index_remap;
+    for (const auto& move : vertex_moves) vertex_remap[move.old_offset] = move.new_offset;
+    for (const auto& move : index_moves) index_remap[move.old_offset] = move.new_offset;
+
+    // copy every live range into fresh buffers, source and destination ranges may overlap otherwise
+    std::vector<VkBufferCopy> vertex_regions, index_regions;
+    for (Range& range : _ranges) {
+        if (!range.live) continue;
+
+        for (uint32_t s = 0; s < range.stream_count; ++s) {
+            VertexRange& vertex = range.vertex[s];
+            auto v = vertex_remap.find(vertex.offset);
+            uint64_t new_vertex_offset = (v != vertex_remap.end()) ? v->second : vertex.offset;
+            vertex_regions.push_back(VkBufferCopy{ vertex.offset, new_vertex_offset, vertex.size });
+            vertex.offset = new_vertex_offset;
+        }
+
+        auto i = index_remap.find(range.index_offset);
+        uint64_t new_index_offset = (i != index_remap.end()) ? i->second : range.index_offset;
+        index_regions.push_back(VkBufferCopy{ range.index_offset, new_index_offset, range.index_size });
+        range.index_offset = new_index_offset;
+    }
+
+    // uploads already queued target the old offsets in the old buffers, and land there before the copy reads them
+    replace_buffer(_vertex_buffer, create_buffer(vertex_capacity, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT), vertex_regions);
+    replace_buffer(_index_buffer, create_buffer(index_capacity, VK_BUFFER_USAGE_INDEX_BUFFER_BIT), index_regions);
+    _last_resize_frame = _frame;
+
+    // live ranges are packed below allocated_end now, so either direction is safe
+    if (vertex_capacity < _vertex_allocator.capacity()) _vertex_allocator.shrink(vertex_capacity);
+    else _vertex_allocator.grow(vertex_capacity);
+    if (index_capacity < _index_allocator.capacity()) _index_allocator.shrink(index_capacity);
+    else _index_allocator.grow(index_capacity);
+
+    if (!vertex_moves.empty() || !index_moves.empty()) {
+        core::debug::Logger::get_singleton().info("Mesh pool defragmented: {} vertex and {} index ranges moved",
+            vertex_moves.size(), index_moves.size());
+    }
+}
+
+wk::Buffer VulkanMeshPool::create_buffer(VkDeviceSize size, VkBufferUsageFlags usage) const {
+    VkBufferCreateInfo buffer_ci = wk::BufferCreateInfo{}
+        .set_size(size)
+        .set_usage(usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+        .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
+        .to_vk();
+    if (_queue_families.size() > 1) {
+        buffer_ci.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        buffer_ci.queueFamilyIndexCount = static_cast<uint32_t>(_queue_families.size());
+        buffer_ci.pQueueFamilyIndices = _queue_families.data();
+    }
+
+    return wk::Buffer(
+        _allocator.handle(),
+        buffer_ci,
+        wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_GPU_ONLY).to_vk()
+    );
+}
+
+uint64_t VulkanMeshPool::allocate_vertices(uint64_t size, uint32_t stride) {
+    // vertex ranges are aligned to their stride so the offset is a whole base vertex
+    uint64_t offset = _vertex_allocator.allocate(size, stride);
+    if (offset == core::memory::OffsetAllocator::INVALID_OFFSET) {
+        grow_vertex_buffer(std::max(_vertex_allocator.capacity() * 2, _vertex_allocator.capacity() + size + stride));
+        offset = _vertex_allocator.allocate(size, stride);
+    }
+    ENGINE_ASSERT(offset != core::memory::OffsetAllocator::INVALID_OFFSET, "Mesh pool failed to allocate after growing");
+    return offset;
+}
+
+void VulkanMeshPool::grow_vertex_buffer(VkDeviceSize capacity) {
+    std::vector<VkBufferCopy> regions;
+    for (const Range& range : _ranges) {
+        if (!range.live) continue;
+        for (uint32_t s = 0; s < range.stream_count; ++s) {
+            regions.push_back(VkBufferCopy{ range.vertex[s].offset, range.vertex[s].offset, range.vertex[s].size });
+        }
+    }
+
+    replace_buffer(_vertex_buffer, create_buffer(capacity, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT), regions);
+    _vertex_allocator.grow(capacity);
+    _last_resize_frame = _frame;
+}
+
+void VulkanMeshPool::grow_index_buffer(VkDeviceSize capacity) {
+    std::vector<VkBufferCopy> regions;
+    for (const Range& range : _ranges) {
+        if (range.live) regions.push_back(VkBufferCopy{ range.index_offset, range.index_offset, range.index_size });
+    }
+
+    replace_buffer(_index_buffer, create_buffer(capacity, VK_BUFFER_USAGE_INDEX_BUFFER_BIT), regions);
+    _index_allocator.grow(capacity);
+    _last_resize_frame = _frame;
+}
+
+void VulkanMeshPool::replace_buffer(wk::Buffer& old, wk::Buffer&& replacement, const std::vector<VkBufferCopy>& regions) {
+    // graphics submits wait on the upload timeline, so no draw reads the new buffer before the copy lands
+    _upload_manager.copy_buffer(old.handle(), replacement.handle(), regions);
+    // copy_buffer flushed anything queued before it, so the copy goes out with the next token
+    UploadToken token = _upload_manager.last_submitted() + (regions.empty() ? 0 : 1);
+    _retired.push_back(RetiredBuffer{ std::move(old), _frame, token });
+    old = std::move(replacement);
+}
+
+} // namespace engine::drivers::vulkan
@@ -0,0 +1,130 @@
+#ifndef engine_drivers_vulkan_VULKAN_MESH_POOL_HPP
+#define engine_drivers_vulkan_VULKAN_MESH_POOL_HPP
+
+#include "engine/core/memory/offset_allocator.hpp"
+#include "engine/core/graphics/mesh_buffer.hpp"
+
+#include "vulkan_upload_manager.hpp"
+
+#include <wk/wulkan.hpp>
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace engine::drivers::vulkan {
+
+class VulkanDevice;
+
+// shared vertex and index buffers that every mesh buffer suballocates from
+class VulkanMeshPool {
+public:
+    using AllocationId = uint32_t;
+    static constexpr AllocationId INVALID_ALLOCATION = UINT32_MAX;
+    static constexpr uint32_t MAX_VERTEX_STREAMS = 4;
+
+    VulkanMeshPool(const VulkanDevice& device, VkDeviceSize vertex_capacity, VkDeviceSize index_capacity);
+
+    VulkanMeshPool(const VulkanMeshPool&) = delete;
+    VulkanMeshPool& operator=(const VulkanMeshPool&) = delete;
+
+    ~VulkanMeshPool() { _upload_manager.wait_idle(); }
+
+    // one vertex range per stream, only the strides of streams are read
+    AllocationId allocate(const std::vector<core::graphics::VertexStream>& streams, uint32_t vertex_count, uint32_t index_size, uint32_t index_count);
+    void free(AllocationId id);
+    // queued on the upload manager, visible to draws submitted after the next flush
+    void write(AllocationId id, const std::vector<core::graphics::VertexStream>& streams, const void* index_data);
+
+    // compacts live ranges. the copy runs on the transfer queue and the old buffers live on until the frames
+    // that may have bound them finish, so command buffers already recorded stay valid. mesh buffers read their
+    // offsets when drawn, so draws recorded afterwards see the new layout
+    void defragment();
+    // compacts and gives capacity back to the device once most of it is unused, so evicted meshes free vram.
+    // does nothing while the pool is reasonably full, or for a while after it last changed size
+    void trim();
+
+    // call once per frame after the oldest frame in flight has finished, destroys buffers it no longer reads
+    void next_frame();
+
+    // a single stream is bound at the start of the buffer and addressed by base vertex, so meshes share one bind;
+    // streams of a split mesh can not share a base vertex and are bound at their own offsets instead
+    uint32_t base_vertex(AllocationId id) const {
+        const Range& range = _ranges[id];
+        return range.stream_count == 1 ? static_cast<uint32_t>(range.vertex[0].offset / range.vertex[0].stride) : 0;
+    }
+    VkDeviceSize binding_offset(AllocationId id, uint32_t stream) const {
+        const Range& range = _ranges[id];
+        return range.stream_count == 1 ? 0 : range.vertex[stream].offset;
+    }
+    uint32_t stream_count(AllocationId id) const { return _ranges[id].stream_count; }
+    uint32_t first_index(AllocationId id) const { return static_cast<uint32_t>(_ranges[id].index_offset / _ranges[id].index_stride); }
+
+    VkBuffer vertex_buffer() const { return _vertex_buffer.handle(); }
+    VkBuffer index_buffer() const { return _index_buffer.handle(); }
+
+    VkDeviceSize vertex_capacity() const { return _vertex_allocator.capacity(); }
+    VkDeviceSize index_capacity() const { return _index_allocator.capacity(); }
+    VkDeviceSize vertex_bytes_used() const { return _vertex_allocator.used(); }
+    VkDeviceSize index_bytes_used() const { return _index_allocator.used(); }
+    // what the pool holds on the device, used or not
+    VkDeviceSize capacity() const { return vertex_capacity() + index_capacity(); }
+
+private:
+    struct VertexRange {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t stride = 1;
+    };
+
+    // replaced by a grow or repack, destroyed once no frame can read it and the copy out of it has run
+    struct RetiredBuffer {
+        wk::Buffer buffer;
+        uint64_t frame;
+        UploadToken token;
+    };
+
+    struct Range {
+        std::array<VertexRange, MAX_VERTEX_STREAMS> vertex{};
+        uint32_t stream_count = 0;
+        uint64_t index_offset = 0;
+        uint64_t index_size = 0;
+        uint32_t index_stride = 1;
+        bool live = false;
+    };
+
+    // moves live ranges to the front of buffers of the given capacities
+    void repack(VkDeviceSize vertex_capacity, VkDeviceSize index_capacity);
+    wk::Buffer create_buffer(VkDeviceSize size, VkBufferUsageFlags usage) const;
+    uint64_t allocate_vertices(uint64_t size, uint32_t stride);
+    void grow_vertex_buffer(VkDeviceSize capacity);
+    void grow_index_buffer(VkDeviceSize capacity);
+    // copies the live regions of old into replacement on the transfer queue and retires old
+    void replace_buffer(wk::Buffer& old, wk::Buffer&& replacement, const std::vector<VkBufferCopy>& regions);
+
+    const wk::Allocator& _allocator;
+    VulkanUploadManager& _upload_manager;
+    uint32_t _frames_in_flight;
+
+    std::vector<uint32_t> _queue_families;
+
+    wk::Buffer _vertex_buffer;
+    wk::Buffer _index_buffer;
+    core::memory::OffsetAllocator _vertex_allocator;
+    core::memory::OffsetAllocator _index_allocator;
+
+    // trim never goes below the starting size
+    VkDeviceSize _initial_vertex_capacity;
+    VkDeviceSize _initial_index_capacity;
+
+    std::vector<Range> _ranges;
+    std::vector<AllocationId> _free_ids;
+
+    std::vector<RetiredBuffer> _retired;
+    uint64_t _frame = 0;
+    uint64_t _last_resize_frame = 0;
+};
+
+} // namespace engine::drivers::vulkan
+
+#endif // engine_drivers_vulkan_VULKAN_MESH_POOL_HPP
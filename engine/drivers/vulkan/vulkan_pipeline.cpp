@@ -3,6 +3,7 @@
 #include "vulkan_device.hpp"
 #include "vulkan_material.hpp"
 #include "convert_vulkan.hpp"
+#include "vulkan_barrier.hpp"
 
 #include "engine/core/debug/assert.hpp"
 #include "engine/core/debug/logger.hpp"
@@ -11,18 +12,20 @@ namespace engine::drivers::vulkan {
 
 VulkanPipeline::VulkanPipeline(const VulkanDevice& device,
     VkShaderModule vert, VkShaderModule frag,
-    const core::graphics::VertexBindingDescription& vertex_binding, // TODO: add support for multiple bindings
+    const std::vector<core::graphics::VertexBindingDescription>& vertex_bindings,
     const core::graphics::DescriptorSetLayout& layout,
     const std::vector<core::graphics::ImageAttachmentInfo>& attachment_info,
     const core::graphics::PipelineConfig& config) 
-    : _device(device.device()), _allocator(device.allocator()), _descriptor_pool(device.descriptor_pool()),
-      _attachment_info(attachment_info)
+    : _device(device.device()), _allocator(device.allocator()), _descriptor_allocator(device.descriptor_allocator()),
+      _uniform_allocator(device.uniform_allocator()),
+      _attachment_info(attachment_info), _dynamic_rendering(device.dynamic_rendering_enabled())
 {
     ENGINE_ASSERT(!attachment_info.empty(), "VulkanPipeline requires at least one image attachment");
 
     // render pass
     std::vector<VkAttachmentDescription> attachment_descriptions;
     std::vector<VkAttachmentReference> color_attachment_references;
+    std::vector<VkFormat> color_attachment_formats;
     bool has_depth = false;
     VkAttachmentReference depth_attachment_reference{};
     for (int i = 0; i < _attachment_info.size(); ++i) {
@@ -63,44 +66,60 @@ VulkanPipeline::VulkanPipeline(const VulkanDevice& device,
                     .set_layout(ToVkSubpassLayout(_attachment_info[i].usage))
                     .to_vk()
             );
+            color_attachment_formats.push_back(ToVkFormat(_attachment_info[i].format));
             _color_format = _attachment_info[i].format;
         }
     }
 
     ENGINE_ASSERT(has_depth || !color_attachment_references.empty(), "Pipeline must have at least one color or depth attachment");
 
-    VkSubpassDescription subpass;
-    if (has_depth) {
-        subpass = wk::SubpassDescription{}
-            .set_pipeline_bind_point(VK_PIPELINE_BIND_POINT_GRAPHICS)
-            .set_color_attachments(color_attachment_references.size(), color_attachment_references.data())
-            .set_depth_stencil_attachment(&depth_attachment_reference)
-            .to_vk();
-    } else {
-        subpass = wk::SubpassDescription{}
-            .set_pipeline_bind_point(VK_PIPELINE_BIND_POINT_GRAPHICS)
-            .set_color_attachments(color_attachment_references.size(), color_attachment_references.data())
-            .to_vk();
-    }
+    // attachments are described by formats alone when rendering dynamically
+    VkPipelineRenderingCreateInfo rendering_ci{};
+    rendering_ci.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    rendering_ci.colorAttachmentCount = static_cast<uint32_t>(color_attachment_formats.size());
+    rendering_ci.pColorAttachmentFormats = color_attachment_formats.data();
+    rendering_ci.depthAttachmentFormat = has_depth ? ToVkFormat(_depth_format) : VK_FORMAT_UNDEFINED;
+    rendering_ci.stencilAttachmentFormat = (has_depth && HasStencilComponent(rendering_ci.depthAttachmentFormat))
+        ? rendering_ci.depthAttachmentFormat : VK_FORMAT_UNDEFINED;
 
-    VkSubpassDependency dependency = wk::SubpassDependency{}
-        .set_src_subpass(VK_SUBPASS_EXTERNAL)
-        .set_dst_subpass(0)
-        .set_src_stage_mask(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT)
-        .set_dst_stage_mask(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT)
-        .set_src_access_mask(0)
-        .set_dst_access_mask(VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT)
-        .to_vk();
+    if (!_dynamic_rendering) {
+        VkSubpassDescription subpass;
+        if (has_depth) {
+            subpass = wk::SubpassDescription{}
+                .set_pipeline_bind_point(VK_PIPELINE_BIND_POINT_GRAPHICS)
+                .set_color_attachments(color_attachment_references.size(), color_attachment_references.data())
+                .set_depth_stencil_attachment(&depth_attachment_reference)
+                .to_vk();
+        } else {
+            subpass = wk::SubpassDescription{}
+                .set_pipeline_bind_point(VK_PIPELINE_BIND_POINT_GRAPHICS)
+                .set_color_attachments(color_attachment_references.size(), color_attachment_references.data())
+                .to_vk();
+        }
 
-    _render_pass = wk::RenderPass(_device.handle(),
-        wk::RenderPassCreateInfo{}
-            .set_attachments(attachment_descriptions.size(), attachment_descriptions.data())
-            .set_subpasses(1, &subpass)
-            .set_dependencies(1, &dependency)
-            .to_vk()
-    );
+        VkSubpassDependency dependency = wk::SubpassDependency{}
+            .set_src_subpass(VK_SUBPASS_EXTERNAL)
+            .set_dst_subpass(0)
+            .set_src_stage_mask(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT)
+            .set_dst_stage_mask(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT)
+            .set_src_access_mask(0)
+            .set_dst_access_mask(VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT)
+            .to_vk();
+
+        _render_pass = wk::RenderPass(_device.handle(),
+            wk::RenderPassCreateInfo{}
+                .set_attachments(attachment_descriptions.size(), attachment_descriptions.data())
+                .set_subpasses(1, &subpass)
+                .set_dependencies(1, &dependency)
+                .to_vk()
+        );
+    }
 
     std::vector<VkDescriptorSetLayout> layouts = { static_cast<VkDescriptorSetLayout>(layout.native_descriptor_set_layout())};
+    if (config.bindless) {
+        ENGINE_ASSERT(layouts.size() == core::graphics::BindlessTable::SET, "Bindless table must directly follow the pipeline's own sets");
+        layouts.push_back(static_cast<VkDescriptorSetLayout>(config.bindless->native_descriptor_set_layout()));
+    }
     std::vector<VkPushConstantRange> push_constant_ranges;
     if (config.push_constant.size > 0) {
         push_constant_ranges.emplace_back(wk::PushConstantRange{}
@@ -132,27 +151,37 @@ VulkanPipeline::VulkanPipeline(const VulkanDevice& device,
             .to_vk()
     };
 
-    // vertex input
-    VkVertexInputBindingDescription vertex_input_binding = wk::VertexInputBindingDescription{}
-        .set_binding(vertex_binding.binding)
-        .set_stride(vertex_binding.stride)
-        .set_input_rate(VK_VERTEX_INPUT_RATE_VERTEX)
-        .to_vk();
-
+    // vertex input, one buffer binding per stream
+    std::vector<VkVertexInputBindingDescription> vertex_input_bindings;
     std::vector<VkVertexInputAttributeDescription> vertex_input_attributes;
-    vertex_input_attributes.reserve(vertex_binding.attributes.size());
-    for (const core::graphics::VertexAttribute& a : vertex_binding.attributes) {
-        vertex_input_attributes.emplace_back(
-            a.location,
-            vertex_binding.binding,
-            ToVkFormat(a.format),
-            a.offset
+    vertex_input_bindings.reserve(vertex_bindings.size());
+    for (const core::graphics::VertexBindingDescription& vertex_binding : vertex_bindings) {
+        for (const VkVertexInputBindingDescription& other : vertex_input_bindings)
+            ENGINE_ASSERT(other.binding != vertex_binding.binding, "Duplicate vertex binding index in pipeline");
+
+        vertex_input_bindings.emplace_back(wk::VertexInputBindingDescription{}
+            .set_binding(vertex_binding.binding)
+            .set_stride(vertex_binding.stride)
+            .set_input_rate(VK_VERTEX_INPUT_RATE_VERTEX)
+            .to_vk()
         );
+
+        for (const core::graphics::VertexAttribute& a : vertex_binding.attributes) {
+            for (const VkVertexInputAttributeDescription& other : vertex_input_attributes)
+                ENGINE_ASSERT(other.location != a.location, "Vertex attribute location used by more than one binding");
+
+            vertex_input_attributes.emplace_back(
+                a.location,
+                vertex_binding.binding,
+                ToVkFormat(a.format),
+                a.offset
+            );
+        }
     }
 
     VkPipelineVertexInputStateCreateInfo vertex_input_ci =
         wk::PipelineVertexInputStateCreateInfo{}
-            .set_vertex_binding_descriptions(1, &vertex_input_binding)
+            .set_vertex_binding_descriptions(vertex_input_bindings.size(), vertex_input_bindings.data())
             .set_vertex_attribute_descriptions(vertex_input_attributes.size(), vertex_input_attributes.data())
             .to_vk();
 
@@ -209,9 +238,14 @@ VulkanPipeline::VulkanPipeline(const VulkanDevice& device,
             .set_alpha_blend_op(VK_BLEND_OP_ADD)
             .to_vk();
 
+    // one blend state per color attachment
+    std::vector<VkPipelineColorBlendAttachmentState> color_blend_attachments(
+        color_attachment_formats.size(), color_blend_attachment
+    );
+
     VkPipelineColorBlendStateCreateInfo color_blend_state_ci =
         wk::PipelineColorBlendStateCreateInfo{}
-            .set_attachments(1, &color_blend_attachment)
+            .set_attachments(color_blend_attachments.size(), color_blend_attachments.data())
             .to_vk();
 
     VkDynamicState dynamic_states[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
@@ -221,22 +255,26 @@ VulkanPipeline::VulkanPipeline(const VulkanDevice& device,
             .to_vk();
 
     // pipeline
-    _pipeline = wk::Pipeline(_device.handle(),
-        wk::PipelineCreateInfo{}
-            .set_stages(2, shader_stages)
-            .set_p_vertex_input_state(&vertex_input_ci)
-            .set_p_input_assembly_state(&input_assembly_ci)
-            .set_p_viewport_state(&viewport_state_ci)
-            .set_p_rasterization_state(&raster_ci)
-            .set_p_multisample_state(&multisample_ci)
-            .set_p_depth_stencil_state(&depth_stencil_ci)
-            .set_p_color_blend_state(&color_blend_state_ci)
-            .set_p_dynamic_state(&dynamic_ci)
-            .set_layout(_pipeline_layout.handle())
-            .set_render_pass(_render_pass.handle())
-            .set_subpass(0)
-            .to_vk()
-    );
+    VkGraphicsPipelineCreateInfo pipeline_ci = wk::PipelineCreateInfo{}
+        .set_stages(2, shader_stages)
+        .set_p_vertex_input_state(&vertex_input_ci)
+        .set_p_input_assembly_state(&input_assembly_ci)
+        .set_p_viewport_state(&viewport_state_ci)
+        .set_p_rasterization_state(&raster_ci)
+        .set_p_multisample_state(&multisample_ci)
+        .set_p_depth_stencil_state(&depth_stencil_ci)
+        .set_p_color_blend_state(&color_blend_state_ci)
+        .set_p_dynamic_state(&dynamic_ci)
+        .set_layout(_pipeline_layout.handle())
+        .set_render_pass(_dynamic_rendering ? VK_NULL_HANDLE : _render_pass.handle())
+        .set_subpass(0)
+        .to_vk();
+    if (_dynamic_rendering) {
+        rendering_ci.pNext = pipeline_ci.pNext;
+        pipeline_ci.pNext = &rendering_ci;
+    }
+
+    _pipeline = wk::Pipeline(_device.handle(), pipeline_ci);
 }
 
 void VulkanPipeline::bind(void* cb) const {
@@ -249,10 +287,7 @@ std::unique_ptr<core::graphics::Material> VulkanPipeline::create_material(
     const core::graphics::DescriptorSetLayout& layout,
     uint32_t uniform_buffer_size
 ) const {
-    return std::make_unique<VulkanMaterial>(
-        *this, static_cast<VkDescriptorSetLayout>(layout.native_descriptor_set_layout()),
-        uniform_buffer_size
-    );
+    return std::make_unique<VulkanMaterial>(*this, layout, uniform_buffer_size);
 }
 
 }
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include "engine/core/graphics/descriptor_types.hpp"
 #include "engine/core/graphics/vertex_types.hpp"
 
+#include "vulkan_uniform_allocator.hpp"
+#include "vulkan_descriptor_allocator.hpp"
+
 #include <wk/wulkan.hpp>
 
 namespace engine::drivers::vulkan {
@@ -18,7 +21,7 @@ class VulkanPipeline final : public core::graphics::Pipeline {
 public:
     VulkanPipeline(const VulkanDevice& device,
         VkShaderModule vert, VkShaderModule frag,
-        const core::graphics::VertexBindingDescription& vertex_binding,
+        const std::vector<core::graphics::VertexBindingDescription>& vertex_bindings,
         const core::graphics::DescriptorSetLayout& layout,
         const std::vector<core::graphics::ImageAttachmentInfo>& attachment_info,
         const core::graphics::PipelineConfig& config
@@ -41,21 +44,25 @@ public:
 
     const wk::Device& device() const { return _device; }
     const wk::Allocator& allocator() const { return _allocator; }
-    const wk::DescriptorPool& descriptor_pool() const { return _descriptor_pool; }
+    VulkanDescriptorAllocator& descriptor_allocator() const { return _descriptor_allocator; }
+    VulkanUniformAllocator& uniform_allocator() const { return _uniform_allocator; }
     const wk::PipelineLayout& pipeline_layout() const { return _pipeline_layout; }
+    const std::vector<core::graphics::ImageAttachmentInfo>& attachment_info() const { return _attachment_info; }
+    bool dynamic_rendering() const { return _dynamic_rendering; }
 
     core::graphics::ImageFormat color_format() const override { return _color_format; }
     core::graphics::ImageFormat depth_format() const override { return _depth_format; }
 
     void* native_pipeline() const override { return static_cast<void*>(_pipeline.handle()); }
     void* native_pipeline_layout() const override { return static_cast<void*>(_pipeline_layout.handle()); }
-    void* native_render_pass() const override { return static_cast<void*>(_render_pass.handle()); }
+    void* native_render_pass() const override { return _dynamic_rendering ? nullptr : static_cast<void*>(_render_pass.handle()); }
     std::string backend_name() const override { return "Vulkan"; }
 
 private:
     const wk::Device& _device;
     const wk::Allocator& _allocator;
-    const wk::DescriptorPool& _descriptor_pool;
+    VulkanDescriptorAllocator& _descriptor_allocator;
+    VulkanUniformAllocator& _uniform_allocator;
 
     wk::RenderPass _render_pass;
     wk::PipelineLayout _pipeline_layout;
@@ -64,6 +71,8 @@ private:
     std::vector<core::graphics::ImageAttachmentInfo> _attachment_info;
     core::graphics::ImageFormat _color_format;
     core::graphics::ImageFormat _depth_format;
+
+    bool _dynamic_rendering = false;
 };
 
 } // namespace engine::drivers::vulkan
@@ -3,6 +3,8 @@
 #include "vulkan_device.hpp"
 #include "vulkan_texture.hpp"
 #include "vulkan_command_buffer.hpp"
+#include "vulkan_pipeline.hpp"
+#include "vulkan_barrier.hpp"
 #include "convert_vulkan.hpp"
 
 #include "engine/core/graphics/image_types.hpp"
@@ -30,6 +32,7 @@ VulkanSwapchainRenderTarget::VulkanSwapchainRenderTarget(
       _command_pool(device.command_pool()),
       _graphics_queue(device.graphics_queue()),
       _render_pass(static_cast<VkRenderPass>(pipeline.native_render_pass())),
+      _dynamic_rendering(device.dynamic_rendering_enabled()),
       _extent{0,0},
       _color_format(ToVkFormat(pipeline.color_format())),
       _depth_format(ToVkFormat(device.depth_format())),
@@ -59,6 +62,14 @@ VulkanSwapchainRenderTarget::VulkanSwapchainRenderTarget(
     }
     _present_queue = wk::Queue(_device.handle(), present_family);
 
+    // final color layout follows the pipeline's attachment usage, as the render pass would
+    for (const core::graphics::ImageAttachmentInfo& info : static_cast<const VulkanPipeline&>(pipeline).attachment_info()) {
+        if (!static_cast<uint32_t>(info.usage & core::graphics::TextureUsage::DEPTH_ATTACHMENT)) {
+            _color_final_layout = ToVkFinalLayout(info.usage);
+            break;
+        }
+    }
+
     // initial swapchain build
     rebuild();
 }
@@ -96,6 +107,12 @@ core::graphics::CommandBuffer* VulkanSwapchainRenderTarget::begin_frame(
 
     _command_buffers[_frame_index]->begin();
 
+    VkCommandBuffer cmd = static_cast<VkCommandBuffer>(_command_buffers[_frame_index]->native_command_buffer());
+    if (_dynamic_rendering) {
+        begin_rendering(cmd, color_clear, depth_clear);
+        return _command_buffers[_frame_index].get();
+    }
+
     // clear values
     std::vector<VkClearValue> clear_values;
     clear_values.push_back(wk::ClearValue{}.set_color(color_clear.r, color_clear.g, color_clear.b, color_clear.a).to_vk());
@@ -110,28 +127,44 @@ core::graphics::CommandBuffer* VulkanSwapchainRenderTarget::begin_frame(
         .set_clear_values(static_cast<uint32_t>(clear_values.size()), clear_values.data())
         .to_vk();
 
-    vkCmdBeginRenderPass(
-        static_cast<VkCommandBuffer>(_command_buffers[_frame_index]->native_command_buffer()),
-        &rp_begin_info, VK_SUBPASS_CONTENTS_INLINE
-    );
+    vkCmdBeginRenderPass(cmd, &rp_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
     return _command_buffers[_frame_index].get();
 }
 
 void VulkanSwapchainRenderTarget::end_frame() {
-    vkCmdEndRenderPass(static_cast<VkCommandBuffer>(_command_buffers[_frame_index]->native_command_buffer()));
+    VkCommandBuffer cmd = static_cast<VkCommandBuffer>(_command_buffers[_frame_index]->native_command_buffer());
+    if (_dynamic_rendering)
+        end_rendering(cmd);
+    else
+        vkCmdEndRenderPass(cmd);
 
     _command_buffers[_frame_index]->end();
 
-    // submit
-    VkCommandBuffer cmd = static_cast<VkCommandBuffer>(_command_buffers[_frame_index]->native_command_buffer());
-    VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    // submit, waiting on the swapchain image and on any mesh data still being uploaded
+    VulkanUploadManager& upload_manager = _vulkan_device.upload_manager();
+    uint64_t wait_values[] = { 0, upload_manager.flush() };
+    VkSemaphore wait_semaphores[] = {
+        _image_available_semaphores[_frame_index].handle(),
+        upload_manager.timeline_semaphore()
+    };
+    VkPipelineStageFlags wait_stages[] = {
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+    };
+
+    VkTimelineSemaphoreSubmitInfo timeline_info{};
+    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timeline_info.waitSemaphoreValueCount = 2;
+    timeline_info.pWaitSemaphoreValues = wait_values;
+
     VkSubmitInfo submit_info = wk::SubmitInfo{}
-        .set_wait_semaphores(1, &_image_available_semaphores[_frame_index].handle())
-        .set_wait_dst_stage_masks(1, &wait_stage)
+        .set_wait_semaphores(2, wait_semaphores)
+        .set_wait_dst_stage_masks(2, wait_stages)
         .set_command_buffers(1, &cmd)
         .set_signal_semaphores(1, &_render_finished_semaphores[_frame_index].handle())
         .to_vk();
+    submit_info.pNext = &timeline_info;
 
     if (vkQueueSubmit(_graphics_queue.handle(), 1, &submit_info, _in_flight_fences[_frame_index].handle()) != VK_SUCCESS) {
         core::debug::Logger::get_singleton().error("Failed to submit draw queue");
@@ -270,7 +303,7 @@ void VulkanSwapchainRenderTarget::rebuild() {
     }
 
     // framebuffers
-    for (uint32_t i = 0; i < _frame_count; ++i) {
+    for (uint32_t i = 0; i < _frame_count && !_dynamic_rendering; ++i) {
         VkImageView attachments[2] = {
             static_cast<VkImageView>(_color_textures[i]->native_image_view())
         };
@@ -317,4 +350,60 @@ void VulkanSwapchainRenderTarget::rebuild() {
     _acquired_image_index = 0;
 }
 
+void VulkanSwapchainRenderTarget::begin_rendering(VkCommandBuffer cmd, glm::vec4 color_clear, glm::vec2 depth_clear) {
+    const core::graphics::Texture* color_texture = _color_textures[_acquired_image_index].get();
+
+    // contents are discarded on acquire, same as the render pass' undefined initial layout
+    CmdTransitionImage(cmd, static_cast<VkImage>(color_texture->native_image()), _color_format,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+    );
+
+    VkRenderingAttachmentInfo color_attachment{};
+    color_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    color_attachment.imageView = static_cast<VkImageView>(color_texture->native_image_view());
+    color_attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment.clearValue = wk::ClearValue{}.set_color(color_clear.r, color_clear.g, color_clear.b, color_clear.a).to_vk();
+
+    VkRenderingAttachmentInfo depth_attachment{};
+    VkRenderingAttachmentInfo stencil_attachment{};
+    VkFormat depth_format = ToVkFormat(core::graphics::ImageFormat::D32_FLOAT_S8_UINT);
+    if (_has_depth) {
+        const core::graphics::Texture* depth_texture = _depth_textures[_acquired_image_index].get();
+        CmdTransitionImage(cmd, static_cast<VkImage>(depth_texture->native_image()), depth_format,
+            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+        );
+
+        depth_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        depth_attachment.imageView = static_cast<VkImageView>(depth_texture->native_image_view());
+        depth_attachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        depth_attachment.clearValue = wk::ClearValue{}.set_depth_stencil(depth_clear.x, depth_clear.y).to_vk();
+
+        stencil_attachment = depth_attachment;
+        stencil_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    }
+
+    VkRenderingInfo rendering_info{};
+    rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    rendering_info.renderArea = { { 0, 0 }, _extent };
+    rendering_info.layerCount = 1;
+    rendering_info.colorAttachmentCount = 1;
+    rendering_info.pColorAttachments = &color_attachment;
+    rendering_info.pDepthAttachment = _has_depth ? &depth_attachment : nullptr;
+    rendering_info.pStencilAttachment = _has_depth ? &stencil_attachment : nullptr;
+
+    vkCmdBeginRendering(cmd, &rendering_info);
+}
+
+void VulkanSwapchainRenderTarget::end_rendering(VkCommandBuffer cmd) {
+    vkCmdEndRendering(cmd);
+
+    CmdTransitionImage(cmd, static_cast<VkImage>(_color_textures[_acquired_image_index]->native_image()), _color_format,
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, _color_final_layout
+    );
+}
+
 } // namespace engine::drivers::vulkan
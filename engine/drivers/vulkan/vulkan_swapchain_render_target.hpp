@@ -76,6 +76,8 @@ public:
 
 private:
     void rebuild();
+    void begin_rendering(VkCommandBuffer cmd, glm::vec4 color_clear, glm::vec2 depth_clear);
+    void end_rendering(VkCommandBuffer cmd);
 
 private:
     // Core Vulkan handles
@@ -91,6 +93,8 @@ private:
     wk::ext::glfw::Surface _surface;
     wk::Swapchain _swapchain;
     VkRenderPass _render_pass;
+    bool _dynamic_rendering = false;
+    VkImageLayout _color_final_layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
     // image and framebuffer resources
     std::vector<std::unique_ptr<core::graphics::Texture>> _color_textures;
@@ -5,7 +5,8 @@
 
 #include "engine/core/debug/assert.hpp"
 
-#include <cstring>
+#include <algorithm>
+
 
 namespace engine::drivers::vulkan {
 
@@ -21,6 +22,7 @@ VulkanTexture::VulkanTexture(
     : _device(device.device()),
       _allocator(device.allocator()),
       _command_pool(device.command_pool()),
+      _upload_manager(device.upload_manager()),
       _layers(layers),
       _mip_levels(mip_levels),
       _format(format),
@@ -32,42 +34,13 @@ VulkanTexture::VulkanTexture(
     _width = width;
     _height = height;
 
-    // create image (owning)
-    _image = wk::Image(
-        _allocator.handle(),
-        wk::ImageCreateInfo{}
-            .set_image_type(VK_IMAGE_TYPE_2D)
-            .set_format(_vk_format)
-            .set_extent({ _width, _height, 1 })
-            .set_mip_levels(_mip_levels)
-            .set_array_layers(_layers)
-            .set_samples(VK_SAMPLE_COUNT_1_BIT)
-            .set_tiling(VK_IMAGE_TILING_OPTIMAL)
-            .set_usage(_usage)
-            .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
-            .set_initial_layout(VK_IMAGE_LAYOUT_UNDEFINED)
-            .to_vk(),
-        wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_GPU_ONLY).to_vk()
-    );
+    _queue_families = { device.graphics_queue().family_index() };
+    if (_upload_manager.queue_family() != _queue_families.front()) {
+        _queue_families.push_back(_upload_manager.queue_family());
+    }
 
-    // create image view (owning)
-    _image_view = wk::ImageView(
-        _device.handle(),
-        wk::ImageViewCreateInfo{}
-            .set_image(_image.handle())
-            .set_view_type((_layers > 1) ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D)
-            .set_format(_vk_format)
-            .set_subresource_range(
-                wk::ImageSubresourceRange{}
-                    .set_aspect_mask(_is_depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT)
-                    .set_base_mip_level(0)
-                    .set_level_count(_mip_levels)
-                    .set_base_array_layer(0)
-                    .set_layer_count(_layers)
-                    .to_vk()
-            )
-            .to_vk()
-    );
+    // create image and view (owning)
+    create_image(_width, _height);
 
     _layout = core::graphics::TextureLayout::UNDEFINED;
 }
@@ -86,6 +59,7 @@ VulkanTexture::VulkanTexture(
     : _device(device.device()),
       _allocator(device.allocator()),
       _command_pool(device.command_pool()),
+      _upload_manager(device.upload_manager()),
       _layers(layers),
       _mip_levels(mip_levels),
       _format(format),
@@ -109,69 +83,13 @@ void VulkanTexture::bind(void* command_buffer, uint32_t binding) const {
 }
 
 void VulkanTexture::copy_to_cpu(std::vector<uint8_t>& out_pixels) const {
-    VkDeviceSize image_size = static_cast<VkDeviceSize>(_width) * _height * 4;
-    out_pixels.resize(static_cast<size_t>(image_size));
-
-    wk::Buffer staging(
-        _allocator.handle(),
-        wk::BufferCreateInfo{}
-            .set_size(image_size)
-            .set_usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
-            .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
-            .to_vk(),
-        wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_CPU_ONLY).to_vk()
-    );
-
-    wk::CommandBuffer cb(
-        _device.handle(),
-        wk::CommandBufferAllocateInfo{}
-            .set_command_pool(_command_pool.handle())
-            .to_vk()
-    );
-
-    VkCommandBufferBeginInfo begin_info = wk::CommandBufferBeginInfo{}
-        .set_flags(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
-        .to_vk();
-    vkBeginCommandBuffer(cb.handle(), &begin_info);
-
-    VkBufferImageCopy region = wk::BufferImageCopy{}
-        .set_buffer_offset(0)
-        .set_buffer_row_length(0)
-        .set_buffer_image_height(0)
-        .set_image_subresource(
-            wk::ImageSubresourceLayers{}
-                .set_aspect_mask(_is_depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT)
-                .set_mip_level(0)
-                .set_base_array_layer(0)
-                .set_layer_count(1)
-                .to_vk()
-        )
-        .set_image_offset({0, 0, 0})
-        .set_image_extent({ _width, _height, 1 })
-        .to_vk();
-
-    vkCmdCopyImageToBuffer(
-        cb.handle(),
+    _upload_manager.download_image(
         _image.handle(),
         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        staging.handle(),
-        1,
-        &region
+        _is_depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT,
+        _width, _height, 4,
+        out_pixels
     );
-
-    vkEndCommandBuffer(cb.handle());
-
-    VkSubmitInfo submit_info = wk::SubmitInfo{}
-        .set_command_buffers(1, &cb.handle())
-        .to_vk();
-
-    vkQueueSubmit(_device.graphics_queue().handle(), 1, &submit_info, VK_NULL_HANDLE);
-    vkQueueWaitIdle(_device.graphics_queue().handle());
-
-    void* mapped = nullptr;
-    vmaMapMemory(_allocator.handle(), staging.allocation(), &mapped);
-    std::memcpy(out_pixels.data(), mapped, static_cast<size_t>(image_size));
-    vmaUnmapMemory(_allocator.handle(), staging.allocation());
 }
 
 void VulkanTexture::transition(const core::graphics::TextureBarrier& layout_barrier) {
@@ -249,26 +167,69 @@ void VulkanTexture::resize(uint32_t width, uint32_t height) {
     _width = width;
     _height = height;
 
-    // recreate image
+    // recreate image and view
+    create_image(_width, _height);
+
+    _layout = core::graphics::TextureLayout::UNDEFINED;
+}
+
+void VulkanTexture::upload(uint32_t mip, const void* data, uint64_t size) {
+    ENGINE_ASSERT(_usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT, "Attempted to upload to a texture created without COPY_DST");
+    ENGINE_ASSERT(mip < _mip_levels, "Attempted to upload past the last mip level");
+    ENGINE_ASSERT(_layers == 1 && !_is_depth, "Texture uploads take single layer color textures");
+
+    // compressed levels go up as their blocks, which the copy expands to the level's texel size
+    _upload_manager.upload_image(_image.handle(), mip,
+        std::max(_width >> mip, 1u), std::max(_height >> mip, 1u), data, size,
+        core::graphics::IsCompressedFormat(_format) ? 4 : 1);
+    _layout = core::graphics::TextureLayout::SAMPLE;
+}
+
+void VulkanTexture::set_base_mip(uint32_t mip) {
+    ENGINE_ASSERT(mip < _mip_levels, "Base mip must be one of the texture's levels");
+
+    // frames in flight may still sample through an earlier base, so views are only ever added
+    while (_base_mip_views.size() < mip) {
+        _base_mip_views.push_back(create_view(static_cast<uint32_t>(_base_mip_views.size()) + 1));
+    }
+    _base_mip = mip;
+}
+
+void VulkanTexture::create_image(uint32_t width, uint32_t height) {
+    VkImageCreateInfo image_ci = wk::ImageCreateInfo{}
+        .set_image_type(VK_IMAGE_TYPE_2D)
+        .set_format(_vk_format)
+        .set_extent({ width, height, 1 })
+        .set_mip_levels(_mip_levels)
+        .set_array_layers(_layers)
+        .set_samples(VK_SAMPLE_COUNT_1_BIT)
+        .set_tiling(VK_IMAGE_TILING_OPTIMAL)
+        .set_usage(_usage)
+        .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
+        .set_initial_layout(VK_IMAGE_LAYOUT_UNDEFINED)
+        .to_vk();
+
+    // uploaded textures are written on the transfer queue and sampled on the graphics queue. attachments stay
+    // exclusive, concurrent sharing can cost them their compression
+    const VkImageUsageFlags attachment_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    if ((_usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT) && !(_usage & attachment_usage) && _queue_families.size() > 1) {
+        image_ci.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        image_ci.queueFamilyIndexCount = static_cast<uint32_t>(_queue_families.size());
+        image_ci.pQueueFamilyIndices = _queue_families.data();
+    }
+
     _image = wk::Image(
         _allocator.handle(),
-        wk::ImageCreateInfo{}
-            .set_image_type(VK_IMAGE_TYPE_2D)
-            .set_format(_vk_format)
-            .set_extent({ _width, _height, 1 })
-            .set_mip_levels(_mip_levels)
-            .set_array_layers(_layers)
-            .set_samples(VK_SAMPLE_COUNT_1_BIT)
-            .set_tiling(VK_IMAGE_TILING_OPTIMAL)
-            .set_usage(_usage)
-            .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
-            .set_initial_layout(VK_IMAGE_LAYOUT_UNDEFINED)
-            .to_vk(),
+        image_ci,
         wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_GPU_ONLY).to_vk()
     );
+    _image_view = create_view(0);
+    _base_mip_views.clear();
+    _base_mip = 0;
+}
 
-    // recreate image view
-    _image_view = wk::ImageView(
+wk::ImageView VulkanTexture::create_view(uint32_t base_mip) const {
+    return wk::ImageView(
         _device.handle(),
         wk::ImageViewCreateInfo{}
             .set_image(_image.handle())
@@ -277,16 +238,14 @@ void VulkanTexture::resize(uint32_t width, uint32_t height) {
             .set_subresource_range(
                 wk::ImageSubresourceRange{}
                     .set_aspect_mask(_is_depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT)
-                    .set_base_mip_level(0)
-                    .set_level_count(_mip_levels)
+                    .set_base_mip_level(base_mip)
+                    .set_level_count(_mip_levels - base_mip)
                     .set_base_array_layer(0)
                     .set_layer_count(_layers)
                     .to_vk()
             )
             .to_vk()
     );
-
-    _layout = core::graphics::TextureLayout::UNDEFINED;
 }
 
 } // namespace engine::drivers::vulkan
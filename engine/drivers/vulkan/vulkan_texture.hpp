@@ -4,8 +4,12 @@
 #include "engine/core/graphics/texture.hpp"
 #include "engine/core/graphics/image_types.hpp"
 
+#include "vulkan_upload_manager.hpp"
+
 #include <wk/wulkan.hpp>
 
+#include <vector>
+
 namespace engine::drivers::vulkan {
 
 class VulkanDevice;
@@ -46,6 +50,10 @@ public:
     void transition(const core::graphics::TextureBarrier& barrier) override;
     void resize(uint32_t width, uint32_t height) override;
 
+    void upload(uint32_t mip, const void* data, uint64_t size) override;
+    void set_base_mip(uint32_t mip) override;
+    uint32_t base_mip() const override { return _base_mip; }
+
     uint32_t layers() const override { return _layers; }
     uint32_t mip_levels() const override { return _mip_levels; }
     core::graphics::ImageFormat format() const override { return _format; }
@@ -54,30 +62,40 @@ public:
     void set_layout(core::graphics::TextureLayout layout) override { _layout = layout; }
 
     void* native_image() const override { return (void*)_image.handle(); }
-    void* native_image_view() const override { return (void*)_image_view.handle(); }
+    void* native_image_view() const override { return (void*)sampled_view(); }
 
     VkImage image() const { return _image.handle(); }
+    // every mip, for attachments
     VkImageView view() const { return _image_view.handle(); }
     VkFormat vk_format() const { return _vk_format; }
 
 private:
     void create_image(uint32_t width, uint32_t height);
     void destroy_image();
+    wk::ImageView create_view(uint32_t base_mip) const;
+    VkImageView sampled_view() const { return _base_mip == 0 ? _image_view.handle() : _base_mip_views[_base_mip - 1].handle(); }
 
 private:
     const wk::Device& _device;
     const wk::Allocator& _allocator;
     const wk::CommandPool& _command_pool;
+    VulkanUploadManager& _upload_manager;
 
     wk::Image _image;
     wk::ImageView _image_view;
+    // [mip - 1] views mips [mip, _mip_levels), made the first time set_base_mip asks for them
+    std::vector<wk::ImageView> _base_mip_views;
     bool _owns_image;
 
+    // graphics and, when it is a different family, transfer; images that are uploaded to are shared by both
+    std::vector<uint32_t> _queue_families;
+
     VkFormat _vk_format;
     VkImageUsageFlags _usage;
 
     uint32_t _layers;
     uint32_t _mip_levels;
+    uint32_t _base_mip = 0;
     bool _is_depth;
 
     core::graphics::ImageFormat _format;
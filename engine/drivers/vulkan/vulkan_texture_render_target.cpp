@@ -2,6 +2,8 @@
 
 #include "vulkan_device.hpp"
 #include "vulkan_command_buffer.hpp"
+#include "vulkan_pipeline.hpp"
+#include "vulkan_barrier.hpp"
 #include "convert_vulkan.hpp"
 
 #include "engine/core/debug/logger.hpp"
@@ -22,6 +24,7 @@ VulkanTextureRenderTarget::VulkanTextureRenderTarget(
       _command_pool(device.command_pool()),
       _allocator(device.allocator()),
       _graphics_queue(device.graphics_queue()),
+      _upload_manager(device.upload_manager()),
       _color_textures(attachments.color_textures),
       _depth_texture(attachments.depth_texture)
 {
@@ -29,6 +32,16 @@ VulkanTextureRenderTarget::VulkanTextureRenderTarget(
     _frame_count = max_in_flight;
 
     _render_pass = static_cast<VkRenderPass>(pipeline.native_render_pass());
+    _dynamic_rendering = device.dynamic_rendering_enabled();
+
+    // final layouts follow the pipeline's attachment usage, as the render pass would
+    for (const core::graphics::ImageAttachmentInfo& info : static_cast<const VulkanPipeline&>(pipeline).attachment_info()) {
+        if (static_cast<uint32_t>(info.usage & core::graphics::TextureUsage::DEPTH_ATTACHMENT))
+            _depth_final_layout = ToVkFinalLayout(info.usage);
+        else
+            _color_final_layouts.push_back(ToVkFinalLayout(info.usage));
+    }
+    _color_final_layouts.resize(_color_textures.size(), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
     // extract formats from first attachments (assumed consistent)
     if (!_color_textures.empty())
@@ -69,6 +82,12 @@ core::graphics::CommandBuffer* VulkanTextureRenderTarget::begin_frame(const core
 
     _command_buffers[_frame_index].begin();
 
+    VkCommandBuffer cmd = static_cast<VkCommandBuffer>(_command_buffers[_frame_index].native_command_buffer());
+    if (_dynamic_rendering) {
+        begin_rendering(cmd, color_clear, depth_clear);
+        return &_command_buffers[_frame_index];
+    }
+
     // clear values (color + optional depth)
     std::vector<VkClearValue> clear_values;
     clear_values.push_back(wk::ClearValue{}.set_color(color_clear.r, color_clear.g, color_clear.b, color_clear.a).to_vk());
@@ -82,23 +101,37 @@ core::graphics::CommandBuffer* VulkanTextureRenderTarget::begin_frame(const core
         .set_clear_values(static_cast<uint32_t>(clear_values.size()), clear_values.data())
         .to_vk();
 
-    vkCmdBeginRenderPass(static_cast<VkCommandBuffer>(_command_buffers[_frame_index].native_command_buffer()),
-        &rp_begin_info,
-        VK_SUBPASS_CONTENTS_INLINE
-    );
+    vkCmdBeginRenderPass(cmd, &rp_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
     return &_command_buffers[_frame_index];
 }
 
 void VulkanTextureRenderTarget::end_frame() {
-    vkCmdEndRenderPass(static_cast<VkCommandBuffer>(_command_buffers[_frame_index].native_command_buffer()));
+    VkCommandBuffer cmd = static_cast<VkCommandBuffer>(_command_buffers[_frame_index].native_command_buffer());
+    if (_dynamic_rendering)
+        end_rendering(cmd);
+    else
+        vkCmdEndRenderPass(cmd);
 
     _command_buffers[_frame_index].end();
 
+    // mesh data may still be in flight on the transfer queue
+    uint64_t wait_value = _upload_manager.flush();
+    VkSemaphore wait_semaphore = _upload_manager.timeline_semaphore();
+    VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+    VkTimelineSemaphoreSubmitInfo timeline_info{};
+    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timeline_info.waitSemaphoreValueCount = 1;
+    timeline_info.pWaitSemaphoreValues = &wait_value;
+
     VkSubmitInfo submit_info{};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.pNext = &timeline_info;
+    submit_info.waitSemaphoreCount = 1;
+    submit_info.pWaitSemaphores = &wait_semaphore;
+    submit_info.pWaitDstStageMask = &wait_stage;
     submit_info.commandBufferCount = 1;
-    VkCommandBuffer cmd = static_cast<VkCommandBuffer>(_command_buffers[_frame_index].native_command_buffer());
     submit_info.pCommandBuffers = &cmd;
 
     if (vkQueueSubmit(_graphics_queue.handle(), 1, &submit_info, _in_flight_fences[_frame_index].handle()) != VK_SUCCESS)
@@ -120,6 +153,8 @@ void VulkanTextureRenderTarget::rebuild() {
     }
 
     _framebuffers.clear();
+    if (_dynamic_rendering) return;
+
     _framebuffers.reserve(_max_in_flight);
 
     for (size_t i = 0; i < _max_in_flight; ++i) {
@@ -141,4 +176,73 @@ void VulkanTextureRenderTarget::rebuild() {
     }
 }
 
+void VulkanTextureRenderTarget::begin_rendering(VkCommandBuffer cmd, glm::vec4 color_clear, glm::vec2 depth_clear) {
+    std::vector<VkRenderingAttachmentInfo> color_attachments;
+    color_attachments.reserve(_color_textures.size());
+    for (const core::graphics::Texture* texture : _color_textures) {
+        CmdTransitionImage(cmd, static_cast<VkImage>(texture->native_image()), ToVkFormat(texture->format()),
+            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            texture->mip_levels(), texture->layers()
+        );
+
+        VkRenderingAttachmentInfo attachment{};
+        attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        attachment.imageView = static_cast<VkImageView>(texture->native_image_view());
+        attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        attachment.clearValue = wk::ClearValue{}.set_color(color_clear.r, color_clear.g, color_clear.b, color_clear.a).to_vk();
+        color_attachments.push_back(attachment);
+    }
+
+    VkRenderingAttachmentInfo depth_attachment{};
+    VkRenderingAttachmentInfo stencil_attachment{};
+    if (_depth_texture) {
+        CmdTransitionImage(cmd, static_cast<VkImage>(_depth_texture->native_image()), _depth_format,
+            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            _depth_texture->mip_levels(), _depth_texture->layers()
+        );
+
+        depth_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        depth_attachment.imageView = static_cast<VkImageView>(_depth_texture->native_image_view());
+        depth_attachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        depth_attachment.clearValue = wk::ClearValue{}.set_depth_stencil(depth_clear.r, depth_clear.g).to_vk();
+
+        stencil_attachment = depth_attachment;
+        stencil_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    }
+
+    VkRenderingInfo rendering_info{};
+    rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    rendering_info.renderArea = { { 0, 0 }, _extent };
+    rendering_info.layerCount = 1;
+    rendering_info.colorAttachmentCount = static_cast<uint32_t>(color_attachments.size());
+    rendering_info.pColorAttachments = color_attachments.data();
+    rendering_info.pDepthAttachment = _depth_texture ? &depth_attachment : nullptr;
+    rendering_info.pStencilAttachment = (_depth_texture && HasStencilComponent(_depth_format)) ? &stencil_attachment : nullptr;
+
+    vkCmdBeginRendering(cmd, &rendering_info);
+}
+
+void VulkanTextureRenderTarget::end_rendering(VkCommandBuffer cmd) {
+    vkCmdEndRendering(cmd);
+
+    for (size_t i = 0; i < _color_textures.size(); ++i) {
+        if (_color_final_layouts[i] == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) continue;
+        CmdTransitionImage(cmd, static_cast<VkImage>(_color_textures[i]->native_image()), ToVkFormat(_color_textures[i]->format()),
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, _color_final_layouts[i],
+            _color_textures[i]->mip_levels(), _color_textures[i]->layers()
+        );
+    }
+
+    if (_depth_texture && _depth_final_layout != VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
+        CmdTransitionImage(cmd, static_cast<VkImage>(_depth_texture->native_image()), _depth_format,
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, _depth_final_layout,
+            _depth_texture->mip_levels(), _depth_texture->layers()
+        );
+    }
+}
+
 } // namespace engine::drivers::vulkan
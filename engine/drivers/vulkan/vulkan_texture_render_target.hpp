@@ -3,6 +3,7 @@
 
 #include "vulkan_render_target.hpp"
 #include "vulkan_command_buffer.hpp"
+#include "vulkan_upload_manager.hpp"
 
 #include "engine/core/graphics/command_buffer.hpp"
 #include "engine/core/graphics/texture.hpp"
@@ -44,11 +45,14 @@ public:
 
 private:
     void rebuild();
+    void begin_rendering(VkCommandBuffer cmd, glm::vec4 color_clear, glm::vec2 depth_clear);
+    void end_rendering(VkCommandBuffer cmd);
 
     const wk::Device& _device;
     const wk::Allocator& _allocator;
     const wk::CommandPool& _command_pool;
     const wk::Queue& _graphics_queue;
+    VulkanUploadManager& _upload_manager;
 
     VkRenderPass _render_pass;
     std::vector<const core::graphics::Texture*> _color_textures;
@@ -58,6 +62,11 @@ private:
     VkFormat _color_format;
     VkFormat _depth_format;
     VkExtent2D _extent;
+
+    // dynamic rendering replaces the render pass' implicit transitions
+    bool _dynamic_rendering = false;
+    std::vector<VkImageLayout> _color_final_layouts;
+    VkImageLayout _depth_final_layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 };
 
 } // namespace engine::drivers::vulkan
@@ -0,0 +1,89 @@
+#include "vulkan_uniform_allocator.hpp"
+
+#include "vulkan_device.hpp"
+
+#include "engine/core/debug/assert.hpp"
+#include "engine/core/debug/logger.hpp"
+#include "engine/core/memory/offset_allocator.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace engine::drivers::vulkan {
+
+VulkanUniformAllocator::VulkanUniformAllocator(const VulkanDevice& device, VkDeviceSize segment_size, uint32_t segment_count)
+    : _device(device.device()), _allocator(device.allocator()), _graphics_queue(device.graphics_queue()),
+      _segment_count(segment_count)
+{
+    ENGINE_ASSERT(segment_count > 0, "Uniform allocator requires at least one segment");
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(device.physical_device().handle(), &properties);
+    _alignment = std::max<VkDeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 1);
+
+    // segments start on an aligned boundary so offsets within them stay aligned
+    _segment_size = core::memory::OffsetAllocator::AlignUp(segment_size, _alignment);
+
+    _buffer = wk::Buffer(
+        _allocator.handle(),
+        wk::BufferCreateInfo{}
+            .set_size(_segment_size * _segment_count)
+            .set_usage(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+            .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
+            .to_vk(),
+        wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_CPU_TO_GPU).to_vk()
+    );
+
+    void* mapped = nullptr;
+    vmaMapMemory(_allocator.handle(), _buffer.allocation(), &mapped);
+    _mapped = static_cast<uint8_t*>(mapped);
+
+    _segment_fences.reserve(_segment_count);
+    for (uint32_t i = 0; i < _segment_count; ++i) {
+        _segment_fences.emplace_back(_device.handle(), wk::FenceCreateInfo{}.to_vk());
+    }
+    _segment_pending.assign(_segment_count, false);
+}
+
+VulkanUniformAllocator::~VulkanUniformAllocator() {
+    for (uint32_t i = 0; i < _segment_count; ++i) {
+        if (_segment_pending[i]) vkWaitForFences(_device.handle(), 1, &_segment_fences[i].handle(), VK_TRUE, UINT64_MAX);
+    }
+    if (_mapped) vmaUnmapMemory(_allocator.handle(), _buffer.allocation());
+}
+
+uint32_t VulkanUniformAllocator::push(const void* data, VkDeviceSize size) {
+    ENGINE_ASSERT(data != nullptr, "Attempted to push null uniform data");
+
+    VkDeviceSize offset = core::memory::OffsetAllocator::AlignUp(_head, _alignment);
+    if (offset + size > _segment_size) {
+        core::debug::Logger::get_singleton().fatal("Uniform ring segment exhausted ({} bytes), raise its size", _segment_size);
+    }
+
+    VkDeviceSize absolute = static_cast<VkDeviceSize>(_segment) * _segment_size + offset;
+    std::memcpy(_mapped + absolute, data, static_cast<size_t>(size));
+
+    _head = offset + size;
+    _peak = std::max(_peak, _head);
+    return static_cast<uint32_t>(absolute);
+}
+
+void VulkanUniformAllocator::next_frame() {
+    // an empty submit signals once all work queued so far, i.e. every draw reading this segment, completes
+    if (vkQueueSubmit(_graphics_queue.handle(), 0, nullptr, _segment_fences[_segment].handle()) == VK_SUCCESS) {
+        _segment_pending[_segment] = true;
+    } else {
+        core::debug::Logger::get_singleton().error("Failed to fence uniform ring segment");
+    }
+
+    _segment = (_segment + 1) % _segment_count;
+    _head = 0;
+
+    if (_segment_pending[_segment]) {
+        vkWaitForFences(_device.handle(), 1, &_segment_fences[_segment].handle(), VK_TRUE, UINT64_MAX);
+        vkResetFences(_device.handle(), 1, &_segment_fences[_segment].handle());
+        _segment_pending[_segment] = false;
+    }
+}
+
+} // namespace engine::drivers::vulkan
@@ -0,0 +1,57 @@
+#ifndef engine_drivers_vulkan_VULKAN_UNIFORM_ALLOCATOR_HPP
+#define engine_drivers_vulkan_VULKAN_UNIFORM_ALLOCATOR_HPP
+
+#include <wk/wulkan.hpp>
+
+#include <vector>
+#include <cstdint>
+
+namespace engine::drivers::vulkan {
+
+class VulkanDevice;
+
+// persistently mapped uniform ring, one linear segment per frame in flight, addressed with dynamic offsets
+class VulkanUniformAllocator {
+public:
+    VulkanUniformAllocator(const VulkanDevice& device, VkDeviceSize segment_size, uint32_t segment_count);
+
+    VulkanUniformAllocator(const VulkanUniformAllocator&) = delete;
+    VulkanUniformAllocator& operator=(const VulkanUniformAllocator&) = delete;
+
+    ~VulkanUniformAllocator();
+
+    // copies data into the current segment and returns its dynamic offset
+    uint32_t push(const void* data, VkDeviceSize size);
+
+    // fences the segment just recorded and waits until the next one is no longer read by the gpu
+    void next_frame();
+
+    VkBuffer buffer() const { return _buffer.handle(); }
+    VkDeviceSize alignment() const { return _alignment; }
+    VkDeviceSize segment_size() const { return _segment_size; }
+
+    VkDeviceSize bytes_used() const { return _head; }
+    VkDeviceSize peak_bytes_used() const { return _peak; }
+
+private:
+    const wk::Device& _device;
+    const wk::Allocator& _allocator;
+    const wk::Queue& _graphics_queue;
+
+    wk::Buffer _buffer;
+    uint8_t* _mapped = nullptr;
+
+    VkDeviceSize _segment_size;
+    VkDeviceSize _alignment;
+    uint32_t _segment_count;
+    uint32_t _segment = 0;
+    VkDeviceSize _head = 0;
+    VkDeviceSize _peak = 0;
+
+    std::vector<wk::Fence> _segment_fences;
+    std::vector<bool> _segment_pending;
+};
+
+} // namespace engine::drivers::vulkan
+
+#endif // engine_drivers_vulkan_VULKAN_UNIFORM_ALLOCATOR_HPP
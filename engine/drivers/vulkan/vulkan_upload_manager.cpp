@@ -0,0 +1,444 @@
+#include "vulkan_upload_manager.hpp"
+
+#include "vulkan_device.hpp"
+
+#include "engine/core/debug/assert.hpp"
+#include "engine/core/debug/logger.hpp"
+#include "engine/core/memory/offset_allocator.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace engine::drivers::vulkan {
+
+VulkanUploadManager::VulkanUploadManager(const VulkanDevice& device, VkDeviceSize staging_capacity)
+    : _device(device.device()), _allocator(device.allocator()),
+      _transfer_queue(device.transfer_queue()), _graphics_queue(device.graphics_queue()),
+      _graphics_command_pool(device.command_pool()), _capacity(staging_capacity)
+{
+    _command_pool = wk::CommandPool(_device.handle(),
+        wk::CommandPoolCreateInfo{}
+            .set_flags(VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT |
+                    VK_COMMAND_POOL_CREATE_TRANSIENT_BIT)
+            .set_queue_family_index(_transfer_queue.family_index())
+            .to_vk()
+    );
+
+    // timeline semaphore, graphics submits wait on the last token before reading uploaded data
+    VkSemaphoreTypeCreateInfo type_ci{};
+    type_ci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    type_ci.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type_ci.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphore_ci = wk::SemaphoreCreateInfo{}.to_vk();
+    semaphore_ci.pNext = &type_ci;
+    _timeline = wk::Semaphore(_device.handle(), semaphore_ci);
+
+    // staging ring, mapped for its whole lifetime
+    _staging = wk::Buffer(
+        _allocator.handle(),
+        wk::BufferCreateInfo{}
+            .set_size(_capacity)
+            .set_usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+            .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
+            .to_vk(),
+        wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_CPU_ONLY).to_vk()
+    );
+
+    void* mapped = nullptr;
+    vmaMapMemory(_allocator.handle(), _staging.allocation(), &mapped);
+    _staging_mapped = static_cast<uint8_t*>(mapped);
+
+    _readback_fence = wk::Fence(_device.handle(), wk::FenceCreateInfo{}.to_vk());
+    _readback_command_buffer = wk::CommandBuffer(
+        _device.handle(),
+        wk::CommandBufferAllocateInfo{}.set_command_pool(_graphics_command_pool.handle()).to_vk()
+    );
+}
+
+VulkanUploadManager::~VulkanUploadManager() {
+    wait(flush());
+
+    if (_staging_mapped) vmaUnmapMemory(_allocator.handle(), _staging.allocation());
+    if (_readback_mapped) vmaUnmapMemory(_allocator.handle(), _readback.allocation());
+}
+
+void VulkanUploadManager::upload_buffer(VkBuffer dst, VkDeviceSize dst_offset, const void* data, VkDeviceSize size) {
+    ENGINE_ASSERT(dst != VK_NULL_HANDLE, "Attempted to upload into a null buffer");
+
+    // uploads larger than the ring are split into ring-sized chunks
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        VkDeviceSize chunk = std::min(size, _capacity);
+        VkDeviceSize offset = reserve(chunk);
+        std::memcpy(_staging_mapped + offset, src, static_cast<size_t>(chunk));
+        _pending.push_back(PendingCopy{ dst, VkBufferCopy{ offset, dst_offset, chunk } });
+
+        _bytes_uploaded += chunk;
+        src += chunk;
+        dst_offset += chunk;
+        size -= chunk;
+    }
+}
+
+void VulkanUploadManager::upload_image(VkImage dst, uint32_t mip, uint32_t width, uint32_t height,
+    const void* data, VkDeviceSize size, uint32_t block_height)
+{
+    ENGINE_ASSERT(dst != VK_NULL_HANDLE, "Attempted to upload into a null image");
+    ENGINE_ASSERT(width > 0 && height > 0 && block_height > 0, "Image upload must cover at least one texel");
+
+    // levels larger than the ring are split into bands of whole rows, of blocks for compressed formats
+    const uint32_t row_count = (height + block_height - 1) / block_height;
+    ENGINE_ASSERT(size % row_count == 0, "Image upload size must be whole rows");
+    const VkDeviceSize row_size = size / row_count;
+    ENGINE_ASSERT(row_size <= _capacity, "Image row exceeds staging ring capacity");
+    const uint32_t rows_per_chunk = static_cast<uint32_t>(std::min<VkDeviceSize>(_capacity / row_size, row_count));
+
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    for (uint32_t row = 0; row < row_count; row += rows_per_chunk) {
+        const uint32_t rows = std::min(rows_per_chunk, row_count - row);
+        const VkDeviceSize chunk = rows * row_size;
+        VkDeviceSize offset = reserve(chunk);
+        std::memcpy(_staging_mapped + offset, src, static_cast<size_t>(chunk));
+
+        // the last band of a compressed level may end part way through its blocks, at the level's edge
+        const uint32_t y = row * block_height;
+        VkBufferImageCopy region = wk::BufferImageCopy{}
+            .set_buffer_offset(offset)
+            .set_buffer_row_length(0)
+            .set_buffer_image_height(0)
+            .set_image_subresource(
+                wk::ImageSubresourceLayers{}
+                    .set_aspect_mask(VK_IMAGE_ASPECT_COLOR_BIT)
+                    .set_mip_level(mip)
+                    .set_base_array_layer(0)
+                    .set_layer_count(1)
+                    .to_vk()
+            )
+            .set_image_offset({ 0, static_cast<int32_t>(y), 0 })
+            .set_image_extent({ width, std::min(rows * block_height, height - y), 1 })
+            .to_vk();
+        _pending_images.push_back(PendingImageCopy{ dst, region, row == 0 });
+
+        _bytes_uploaded += chunk;
+        src += chunk;
+    }
+}
+
+void VulkanUploadManager::copy_buffer(VkBuffer src, VkBuffer dst, const std::vector<VkBufferCopy>& regions) {
+    ENGINE_ASSERT(src != VK_NULL_HANDLE && dst != VK_NULL_HANDLE, "Attempted to copy between null buffers");
+    if (regions.empty()) return;
+
+    // a batch records buffer copies ahead of its uploads, so uploads already queued go out in their own batch
+    if (!_pending.empty() || !_pending_images.empty()) flush();
+    _pending_buffer_copies.push_back(PendingBufferCopy{ src, dst, regions });
+}
+
+UploadToken VulkanUploadManager::flush() {
+    if (_pending.empty() && _pending_images.empty() && _pending_buffer_copies.empty()) return _last_submitted;
+
+    // one vkCmdCopyBuffer per destination buffer
+    std::stable_sort(_pending.begin(), _pending.end(),
+        [](const PendingCopy& a, const PendingCopy& b) { return a.dst < b.dst; });
+
+    wk::CommandBuffer cb = acquire_command_buffer();
+
+    VkCommandBufferBeginInfo begin_info = wk::CommandBufferBeginInfo{}
+        .set_flags(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
+        .to_vk();
+    vkBeginCommandBuffer(cb.handle(), &begin_info);
+
+    if (!_pending_buffer_copies.empty()) record_buffer_copies(cb.handle());
+
+    std::vector<VkBufferCopy> regions;
+    for (size_t i = 0; i < _pending.size();) {
+        VkBuffer dst = _pending[i].dst;
+        regions.clear();
+        for (; i < _pending.size() && _pending[i].dst == dst; ++i) regions.push_back(_pending[i].region);
+        vkCmdCopyBuffer(cb.handle(), _staging.handle(), dst, static_cast<uint32_t>(regions.size()), regions.data());
+    }
+
+    if (!_pending_images.empty()) record_image_copies(cb.handle());
+
+    vkEndCommandBuffer(cb.handle());
+
+    UploadToken token = _last_submitted + 1;
+
+    VkTimelineSemaphoreSubmitInfo timeline_info{};
+    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timeline_info.signalSemaphoreValueCount = 1;
+    timeline_info.pSignalSemaphoreValues = &token;
+
+    VkSubmitInfo submit_info = wk::SubmitInfo{}
+        .set_command_buffers(1, &cb.handle())
+        .set_signal_semaphores(1, &_timeline.handle())
+        .to_vk();
+    submit_info.pNext = &timeline_info;
+
+    if (vkQueueSubmit(_transfer_queue.handle(), 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS) {
+        core::debug::Logger::get_singleton().fatal("Failed to submit upload batch");
+    }
+
+    _submissions.push_back(Submission{ token, _head, std::move(cb) });
+    _pending.clear();
+    _pending_images.clear();
+    _pending_buffer_copies.clear();
+    _last_submitted = token;
+    ++_submit_count;
+    return token;
+}
+
+void VulkanUploadManager::record_buffer_copies(VkCommandBuffer cb) {
+    // every copy reads what earlier submissions on this queue and the copies before it wrote, and the uploads
+    // that follow may write where it reads. a buffer grown twice in one batch copies from the first new buffer
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    for (const PendingBufferCopy& copy : _pending_buffer_copies) {
+        vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+        vkCmdCopyBuffer(cb, copy.src, copy.dst, static_cast<uint32_t>(copy.regions.size()), copy.regions.data());
+    }
+    vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void VulkanUploadManager::record_image_copies(VkCommandBuffer cb) {
+    // one barrier pair and one vkCmdCopyBufferToImage per level, chunks of a level stay in upload order
+    std::stable_sort(_pending_images.begin(), _pending_images.end(), [](const PendingImageCopy& a, const PendingImageCopy& b) {
+        return a.dst != b.dst ? a.dst < b.dst : a.region.imageSubresource.mipLevel < b.region.imageSubresource.mipLevel;
+    });
+
+    struct Level {
+        size_t begin;
+        size_t end;
+    };
+    std::vector<Level> levels;
+    for (size_t i = 0; i < _pending_images.size();) {
+        size_t end = i + 1;
+        while (end < _pending_images.size() && _pending_images[end].dst == _pending_images[i].dst &&
+            _pending_images[end].region.imageSubresource.mipLevel == _pending_images[i].region.imageSubresource.mipLevel) ++end;
+        levels.push_back(Level{ i, end });
+        i = end;
+    }
+
+    auto level_barrier = [this](const Level& level, VkImageLayout old_layout, VkImageLayout new_layout,
+        VkAccessFlags src_access, VkAccessFlags dst_access) {
+        const PendingImageCopy& copy = _pending_images[level.begin];
+        return wk::ImageMemoryBarrier{}
+            .set_old_layout(old_layout)
+            .set_new_layout(new_layout)
+            .set_src_access(src_access)
+            .set_dst_access(dst_access)
+            .set_image(copy.dst)
+            .set_subresource_range(
+                wk::ImageSubresourceRange{}
+                    .set_aspect_mask(VK_IMAGE_ASPECT_COLOR_BIT)
+                    .set_base_mip_level(copy.region.imageSubresource.mipLevel)
+                    .set_level_count(1)
+                    .set_base_array_layer(0)
+                    .set_layer_count(1)
+                    .to_vk()
+            )
+            .to_vk();
+    };
+
+    std::vector<VkImageMemoryBarrier> barriers;
+    barriers.reserve(levels.size());
+    for (const Level& level : levels) {
+        VkImageLayout old_layout = _pending_images[level.begin].first
+            ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barriers.push_back(level_barrier(level, old_layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, VK_ACCESS_TRANSFER_WRITE_BIT));
+    }
+    vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    std::vector<VkBufferImageCopy> regions;
+    for (const Level& level : levels) {
+        regions.clear();
+        for (size_t i = level.begin; i < level.end; ++i) regions.push_back(_pending_images[i].region);
+        vkCmdCopyBufferToImage(cb, _staging.handle(), _pending_images[level.begin].dst,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+    }
+
+    // graphics reads are ordered by the timeline semaphore wait, the transfer queue only has to finish the layout change
+    barriers.clear();
+    for (const Level& level : levels) {
+        barriers.push_back(level_barrier(level, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_TRANSFER_WRITE_BIT, 0));
+    }
+    vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+}
+
+bool VulkanUploadManager::is_complete(UploadToken token) const {
+    if (token == 0) return true;
+
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(_device.handle(), _timeline.handle(), &value);
+    return value >= token;
+}
+
+void VulkanUploadManager::wait(UploadToken token) const {
+    if (token == 0) return;
+
+    VkSemaphoreWaitInfo wait_info{};
+    wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    wait_info.semaphoreCount = 1;
+    wait_info.pSemaphores = &_timeline.handle();
+    wait_info.pValues = &token;
+    vkWaitSemaphores(_device.handle(), &wait_info, UINT64_MAX);
+}
+
+void VulkanUploadManager::download_image(VkImage image, VkImageLayout layout, VkImageAspectFlags aspect,
+    uint32_t width, uint32_t height, uint32_t bytes_per_pixel, std::vector<uint8_t>& out_data)
+{
+    VkDeviceSize size = static_cast<VkDeviceSize>(width) * height * bytes_per_pixel;
+    out_data.resize(static_cast<size_t>(size));
+
+    // readback buffer only grows
+    if (size > _readback_capacity) {
+        if (_readback_mapped) vmaUnmapMemory(_allocator.handle(), _readback.allocation());
+
+        _readback = wk::Buffer(
+            _allocator.handle(),
+            wk::BufferCreateInfo{}
+                .set_size(size)
+                .set_usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+                .set_sharing_mode(VK_SHARING_MODE_EXCLUSIVE)
+                .to_vk(),
+            wk::AllocationCreateInfo{}.set_usage(VMA_MEMORY_USAGE_GPU_TO_CPU).to_vk()
+        );
+        vmaMapMemory(_allocator.handle(), _readback.allocation(), &_readback_mapped);
+        _readback_capacity = size;
+    }
+
+    VkCommandBuffer cmd = _readback_command_buffer.handle();
+    vkResetCommandBuffer(cmd, 0);
+
+    VkCommandBufferBeginInfo begin_info = wk::CommandBufferBeginInfo{}
+        .set_flags(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
+        .to_vk();
+    vkBeginCommandBuffer(cmd, &begin_info);
+
+    // prior writes to the image on this queue must land before the copy reads it
+    VkMemoryBarrier before{};
+    before.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    before.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    before.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 1, &before, 0, nullptr, 0, nullptr);
+
+    VkBufferImageCopy region = wk::BufferImageCopy{}
+        .set_buffer_offset(0)
+        .set_buffer_row_length(0)
+        .set_buffer_image_height(0)
+        .set_image_subresource(
+            wk::ImageSubresourceLayers{}
+                .set_aspect_mask(aspect)
+                .set_mip_level(0)
+                .set_base_array_layer(0)
+                .set_layer_count(1)
+                .to_vk()
+        )
+        .set_image_offset({0, 0, 0})
+        .set_image_extent({ width, height, 1 })
+        .to_vk();
+    vkCmdCopyImageToBuffer(cmd, image, layout, _readback.handle(), 1, &region);
+
+    VkMemoryBarrier after{};
+    after.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    after.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    after.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+        0, 1, &after, 0, nullptr, 0, nullptr);
+
+    vkEndCommandBuffer(cmd);
+
+    VkSubmitInfo submit_info = wk::SubmitInfo{}
+        .set_command_buffers(1, &cmd)
+        .to_vk();
+
+    // images are owned by the graphics family, so readback stays on that queue and only waits on its own fence
+    vkQueueSubmit(_graphics_queue.handle(), 1, &submit_info, _readback_fence.handle());
+    vkWaitForFences(_device.handle(), 1, &_readback_fence.handle(), VK_TRUE, UINT64_MAX);
+    vkResetFences(_device.handle(), 1, &_readback_fence.handle());
+
+    vmaInvalidateAllocation(_allocator.handle(), _readback.allocation(), 0, size);
+    std::memcpy(out_data.data(), _readback_mapped, static_cast<size_t>(size));
+}
+
+bool VulkanUploadManager::try_reserve(VkDeviceSize size, VkDeviceSize& offset) {
+    VkDeviceSize head = core::memory::OffsetAllocator::AlignUp(_head, STAGING_ALIGNMENT);
+
+    if (_head >= _tail) {
+        // free space is [head, capacity) and then [0, tail)
+        if (head + size <= _capacity) {
+            offset = head;
+            _head = head + size;
+            return true;
+        }
+        if (size < _tail) {
+            offset = 0;
+            _head = size;
+            return true;
+        }
+        return false;
+    }
+
+    // wrapped, free space is [head, tail); strict so head never catches up with tail
+    if (head + size < _tail) {
+        offset = head;
+        _head = head + size;
+        return true;
+    }
+    return false;
+}
+
+VkDeviceSize VulkanUploadManager::reserve(VkDeviceSize size) {
+    ENGINE_ASSERT(size <= _capacity, "Upload chunk exceeds staging ring capacity");
+
+    VkDeviceSize offset = 0;
+    while (true) {
+        retire_completed();
+        if (try_reserve(size, offset)) return offset;
+
+        // ring is full, submit what is pending and wait on the oldest batch
+        flush();
+        ENGINE_ASSERT(!_submissions.empty(), "Staging ring is full with nothing in flight");
+        wait(_submissions.front().token);
+    }
+}
+
+void VulkanUploadManager::retire_completed() {
+    while (!_submissions.empty() && is_complete(_submissions.front().token)) {
+        _tail = _submissions.front().ring_end;
+        _free_command_buffers.push_back(std::move(_submissions.front().command_buffer));
+        _submissions.pop_front();
+    }
+
+    if (_submissions.empty() && _pending.empty() && _pending_images.empty()) {
+        _head = 0;
+        _tail = 0;
+    }
+}
+
+wk::CommandBuffer VulkanUploadManager::acquire_command_buffer() {
+    retire_completed();
+
+    if (!_free_command_buffers.empty()) {
+        wk::CommandBuffer cb = std::move(_free_command_buffers.back());
+        _free_command_buffers.pop_back();
+        vkResetCommandBuffer(cb.handle(), 0);
+        return cb;
+    }
+
+    return wk::CommandBuffer(
+        _device.handle(),
+        wk::CommandBufferAllocateInfo{}.set_command_pool(_command_pool.handle()).to_vk()
+    );
+}
+
+} // namespace engine::drivers::vulkan
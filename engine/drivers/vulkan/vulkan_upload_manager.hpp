@@ -0,0 +1,129 @@
+#ifndef engine_drivers_vulkan_VULKAN_UPLOAD_MANAGER_HPP
+#define engine_drivers_vulkan_VULKAN_UPLOAD_MANAGER_HPP
+
+#include <wk/wulkan.hpp>
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+
+namespace engine::drivers::vulkan {
+
+class VulkanDevice;
+
+// value of the upload timeline semaphore once the work is complete
+using UploadToken = uint64_t;
+
+// batches host -> device copies through a persistently mapped staging ring on the transfer queue
+class VulkanUploadManager {
+public:
+    VulkanUploadManager(const VulkanDevice& device, VkDeviceSize staging_capacity);
+
+    VulkanUploadManager(const VulkanUploadManager&) = delete;
+    VulkanUploadManager& operator=(const VulkanUploadManager&) = delete;
+
+    ~VulkanUploadManager();
+
+    // copies data into the ring now, the gpu copy is recorded and submitted on the next flush()
+    void upload_buffer(VkBuffer dst, VkDeviceSize dst_offset, const void* data, VkDeviceSize size);
+
+    // one mip level of a color image, rows tightly packed. the level goes from UNDEFINED to SHADER_READ_ONLY
+    // around the copy, so the image must be shared with the transfer family; other levels are untouched.
+    // block compressed levels pass their block height and are packed as rows of blocks
+    void upload_image(VkImage dst, uint32_t mip, uint32_t width, uint32_t height, const void* data, VkDeviceSize size,
+        uint32_t block_height = 1);
+
+    // device side copy between two buffers, recorded on the next flush() after every upload queued before it
+    // and before every upload queued after it. src must stay alive until the returned flush's token completes
+    void copy_buffer(VkBuffer src, VkBuffer dst, const std::vector<VkBufferCopy>& regions);
+
+    // submits pending copies; returns the token of the latest submission (0 if nothing was ever submitted)
+    UploadToken flush();
+
+    bool is_complete(UploadToken token) const;
+    void wait(UploadToken token) const;
+    void wait_idle() { wait(flush()); }
+
+    // synchronous image -> host readback on the graphics queue, reusing one mapped buffer
+    void download_image(VkImage image, VkImageLayout layout, VkImageAspectFlags aspect,
+        uint32_t width, uint32_t height, uint32_t bytes_per_pixel, std::vector<uint8_t>& out_data);
+
+    VkSemaphore timeline_semaphore() const { return _timeline.handle(); }
+    UploadToken last_submitted() const { return _last_submitted; }
+    uint32_t queue_family() const { return _transfer_queue.family_index(); }
+
+    uint64_t submit_count() const { return _submit_count; }
+    uint64_t bytes_uploaded() const { return _bytes_uploaded; }
+
+private:
+    static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+    struct PendingCopy {
+        VkBuffer dst;
+        VkBufferCopy region;
+    };
+
+    struct PendingBufferCopy {
+        VkBuffer src;
+        VkBuffer dst;
+        std::vector<VkBufferCopy> regions;
+    };
+
+    // first marks the chunk that takes the level out of UNDEFINED, later chunks of a level split across
+    // submissions find it already in SHADER_READ_ONLY
+    struct PendingImageCopy {
+        VkImage dst;
+        VkBufferImageCopy region;
+        bool first;
+    };
+
+    struct Submission {
+        UploadToken token;
+        VkDeviceSize ring_end;
+        wk::CommandBuffer command_buffer;
+    };
+
+    bool try_reserve(VkDeviceSize size, VkDeviceSize& offset);
+    VkDeviceSize reserve(VkDeviceSize size);
+    void retire_completed();
+    void record_buffer_copies(VkCommandBuffer cb);
+    void record_image_copies(VkCommandBuffer cb);
+    wk::CommandBuffer acquire_command_buffer();
+
+    const wk::Device& _device;
+    const wk::Allocator& _allocator;
+    const wk::Queue& _transfer_queue;
+    const wk::Queue& _graphics_queue;
+    const wk::CommandPool& _graphics_command_pool;
+
+    wk::CommandPool _command_pool;
+    wk::Semaphore _timeline;
+
+    // staging ring, [_tail, _head) is in use
+    wk::Buffer _staging;
+    uint8_t* _staging_mapped = nullptr;
+    VkDeviceSize _capacity;
+    VkDeviceSize _head = 0;
+    VkDeviceSize _tail = 0;
+
+    std::vector<PendingCopy> _pending;
+    std::vector<PendingBufferCopy> _pending_buffer_copies;
+    std::vector<PendingImageCopy> _pending_images;
+    std::deque<Submission> _submissions;
+    std::vector<wk::CommandBuffer> _free_command_buffers;
+
+    UploadToken _last_submitted = 0;
+    uint64_t _submit_count = 0;
+    uint64_t _bytes_uploaded = 0;
+
+    // readback
+    wk::Buffer _readback;
+    void* _readback_mapped = nullptr;
+    VkDeviceSize _readback_capacity = 0;
+    wk::Fence _readback_fence;
+    wk::CommandBuffer _readback_command_buffer;
+};
+
+} // namespace engine::drivers::vulkan
+
+#endif // engine_drivers_vulkan_VULKAN_UPLOAD_MANAGER_HPP
@@ -0,0 +1,397 @@
+#include "asset_database.hpp"
+#include "mapped_file.hpp"
+
+#include "engine/core/memory/hash.hpp"
+#include "engine/core/debug/logger.hpp"
+#include "engine/core/debug/assert.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <random>
+
+namespace engine::import {
+
+namespace {
+
+constexpr const char* DATABASE_FILE = "assets.db";
+constexpr const char* DATABASE_MAGIC = "jengine-assets";
+
+bool ParseHex(std::string_view text, uint64_t& value) {
+    if (text.empty() || text.size() > 16) return false;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+template <typename T>
+bool ParseDecimal(std::string_view text, T& value) {
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && error == std::errc() && end == text.data() + text.size();
+}
+
+std::vector<std::string_view> Split(std::string_view text, char separator) {
+    std::vector<std::string_view> fields;
+    size_t begin = 0;
+    for (size_t end; (end = text.find(separator, begin)) != std::string_view::npos; begin = end + 1) {
+        fields.push_back(text.substr(begin, end - begin));
+    }
+    fields.push_back(text.substr(begin));
+    return fields;
+}
+
+} // namespace
+
+AssetGuid AssetGuid::Generate() {
+    // seeded once per thread from the os and the clock, either alone may be weak on some platforms
+    thread_local std::mt19937_64 generator([] {
+        std::random_device device;
+        std::seed_seq seed{ device(), device(), device(), device(),
+            static_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count()) };
+        return std::mt19937_64(seed);
+    }());
+
+    AssetGuid guid;
+    while (!guid.valid()) {
+        guid.high = generator();
+        guid.low = generator();
+    }
+    return guid;
+}
+
+AssetGuid AssetGuid::Parse(std::string_view text) {
+    AssetGuid guid;
+    if (text.size() != 32 || !ParseHex(text.substr(0, 16), guid.high) || !ParseHex(text.substr(16), guid.low)) return {};
+    return guid;
+}
+
+std::string AssetGuid::to_string() const {
+    return std::format("{:016x}{:016x}", high, low);
+}
+
+AssetDatabase::AssetDatabase(std::string cache_directory) : _cache_directory(std::move(cache_directory)) {
+    load();
+}
+
+AssetDatabase::~AssetDatabase() {
+    if (_dirty) save();
+}
+
+void AssetDatabase::register_importer(const std::string& name, AssetImporter importer) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    ENGINE_ASSERT(!name.empty() && importer.cook, "Asset importers need a name and a cook function");
+    _importers[name] = std::move(importer);
+}
+
+AssetGuid AssetDatabase::import(const std::string& source_path, const std::string& importer) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    const std::string path = Normalize(source_path);
+    auto existing = _by_path.find(path);
+    if (existing != _by_path.end()) {
+        AssetRecord& record = _records.at(existing->second);
+        if (record.importer != importer) {
+            record.importer = importer;
+            record.cooked_key = 0;
+            _dirty = true;
+        }
+        return record.guid;
+    }
+
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        core::debug::Logger::get_singleton().error("Asset source {} does not exist", path);
+        return {};
+    }
+
+    AssetRecord record;
+    record.guid = AssetGuid::Generate();
+    record.source_path = path;
+    record.importer = importer;
+    _by_path[path] = record.guid;
+    AssetGuid guid = record.guid;
+    _records.emplace(guid, std::move(record));
+    _dirty = true;
+    return guid;
+}
+
+std::string AssetDatabase::resolve(AssetGuid guid) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto it = _records.find(guid);
+    if (it == _records.end()) {
+        core::debug::Logger::get_singleton().warn("Resolved unknown asset {}", guid.to_string());
+        return {};
+    }
+    AssetRecord& record = it->second;
+    if (record.importer.empty()) {
+        bool changed = false;
+        update_source(record, changed);
+        return record.source_path;
+    }
+
+    auto importer = _importers.find(record.importer);
+    if (importer == _importers.end()) {
+        core::debug::Logger::get_singleton().error("No importer {} for asset {}", record.importer, record.source_path);
+        return record.source_path;
+    }
+
+    std::vector<AssetGuid> visiting;
+    uint64_t key = cooked_key(guid, visiting);
+    if (key == 0) {
+        // the source is gone, the last cooked output still loads
+        std::error_code error;
+        std::string last = cooked_path(importer->second, record.cooked_key);
+        if (record.cooked_key != 0 && std::filesystem::exists(last, error)) return last;
+        core::debug::Logger::get_singleton().error("Asset {} has no source and nothing cooked", record.source_path);
+        return {};
+    }
+
+    std::error_code error;
+    std::string path = cooked_path(importer->second, key);
+    if (std::filesystem::exists(path, error)) {
+        if (record.cooked_key != key) {
+            record.cooked_key = key;
+            _dirty = true;
+        }
+        ++_cache_hit_count;
+        return path;
+    }
+
+    // sources the importer reads besides this one become dependencies, which can change the key
+    if (importer->second.dependencies) {
+        for (const std::string& dependency : importer->second.dependencies(record.source_path)) {
+            AssetGuid dependency_guid = import(dependency);
+            if (dependency_guid.valid()) add_dependency(guid, dependency_guid);
+        }
+        key = cooked_key(guid, visiting);
+        path = cooked_path(importer->second, key);
+    }
+
+    std::filesystem::create_directories(_cache_directory, error);
+    if (!importer->second.cook(record.source_path, path)) {
+        core::debug::Logger::get_singleton().error("Failed to cook asset {} with {}", record.source_path, record.importer);
+        return record.source_path;
+    }
+    record.cooked_key = key;
+    _dirty = true;
+    ++_cooked_count;
+    return path;
+}
+
+void AssetDatabase::add_dependency(AssetGuid dependent, AssetGuid dependency) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto it = _records.find(dependent);
+    if (it == _records.end() || dependent == dependency) return;
+    std::vector<AssetGuid>& dependencies = it->second.dependencies;
+    auto position = std::lower_bound(dependencies.begin(), dependencies.end(), dependency);
+    if (position != dependencies.end() && *position == dependency) return;
+    dependencies.insert(position, dependency);
+    _dirty = true;
+}
+
+std::vector<AssetGuid> AssetDatabase::dependents(AssetGuid guid) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    std::vector<AssetGuid> found;
+    std::vector<AssetGuid> frontier = { guid };
+    while (!frontier.empty()) {
+        AssetGuid current = frontier.back();
+        frontier.pop_back();
+        for (const auto& [candidate, record] : _records) {
+            if (candidate == guid || std::find(found.begin(), found.end(), candidate) != found.end()) continue;
+            if (!std::binary_search(record.dependencies.begin(), record.dependencies.end(), current)) continue;
+            found.push_back(candidate);
+            frontier.push_back(candidate);
+        }
+    }
+    return found;
+}
+
+std::vector<AssetGuid> AssetDatabase::refresh() {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    std::vector<AssetGuid> changed;
+    for (auto& [guid, record] : _records) {
+        bool source_changed = false;
+        update_source(record, source_changed);
+        if (source_changed) changed.push_back(guid);
+    }
+
+    const size_t changed_count = changed.size();
+    for (size_t i = 0; i < changed_count; ++i) {
+        for (AssetGuid dependent : dependents(changed[i])) {
+            if (std::find(changed.begin(), changed.end(), dependent) == changed.end()) changed.push_back(dependent);
+        }
+    }
+    if (!changed.empty()) {
+        core::debug::Logger::get_singleton().info("Asset refresh: {} sources changed, {} assets to reload",
+            changed_count, changed.size());
+    }
+    return changed;
+}
+
+const AssetRecord* AssetDatabase::find(AssetGuid guid) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto it = _records.find(guid);
+    return it != _records.end() ? &it->second : nullptr;
+}
+
+AssetGuid AssetDatabase::find(const std::string& source_path) const {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    auto it = _by_path.find(Normalize(source_path));
+    return it != _by_path.end() ? it->second : AssetGuid{};
+}
+
+bool AssetDatabase::save() {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    std::error_code error;
+    std::filesystem::create_directories(_cache_directory, error);
+
+    // sorted by path so the file diffs cleanly between runs
+    std::vector<const AssetRecord*> records;
+    records.reserve(_records.size());
+    for (const auto& [guid, record] : _records) records.push_back(&record);
+    std::sort(records.begin(), records.end(), [](const AssetRecord* a, const AssetRecord* b) { return a->source_path < b->source_path; });
+
+    std::string text = std::format("{} {}\n", DATABASE_MAGIC, DATABASE_VERSION);
+    for (const AssetRecord* record : records) {
+        std::string dependencies;
+        for (const AssetGuid& dependency : record->dependencies) {
+            if (!dependencies.empty()) dependencies += ',';
+            dependencies += dependency.to_string();
+        }
+        text += std::format("{}\t{}\t{}\t{}\t{:016x}\t{:016x}\t{}\t{}\n",
+            record->guid.to_string(), record->importer.empty() ? "-" : record->importer,
+            record->modified_time, record->size, record->hash, record->cooked_key,
+            dependencies.empty() ? "-" : dependencies, record->source_path);
+    }
+
+    const std::filesystem::path path = std::filesystem::path(_cache_directory) / DATABASE_FILE;
+    const std::string temp_path = path.string() + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out || !out.write(text.data(), static_cast<std::streamsize>(text.size()))) {
+            core::debug::Logger::get_singleton().error("Failed to write asset database {}", temp_path);
+            return false;
+        }
+    }
+    std::filesystem::rename(temp_path, path, error);
+    if (error) {
+        core::debug::Logger::get_singleton().error("Failed to move asset database into place at {}: {}", path.string(), error.message());
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    _dirty = false;
+    return true;
+}
+
+std::string AssetDatabase::Normalize(const std::string& path) {
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+bool AssetDatabase::load() {
+    const std::filesystem::path path = std::filesystem::path(_cache_directory) / DATABASE_FILE;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    // a database from another version is dropped whole, everything is rehashed and found in the cache again
+    std::string line;
+    if (!std::getline(in, line) || line != std::format("{} {}", DATABASE_MAGIC, DATABASE_VERSION)) {
+        core::debug::Logger::get_singleton().warn("Ignoring asset database {} from another version", path.string());
+        return false;
+    }
+
+    size_t line_number = 1;
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line.empty()) continue;
+
+        std::vector<std::string_view> fields = Split(line, '\t');
+        AssetRecord record;
+        bool parsed = fields.size() == 8
+            && (record.guid = AssetGuid::Parse(fields[0])).valid()
+            && ParseDecimal(fields[2], record.modified_time)
+            && ParseDecimal(fields[3], record.size)
+            && ParseHex(fields[4], record.hash)
+            && ParseHex(fields[5], record.cooked_key)
+            && !fields[7].empty();
+        if (parsed && fields[6] != "-") {
+            for (std::string_view text : Split(fields[6], ',')) {
+                AssetGuid dependency = AssetGuid::Parse(text);
+                parsed = parsed && dependency.valid();
+                record.dependencies.push_back(dependency);
+            }
+            std::sort(record.dependencies.begin(), record.dependencies.end());
+        }
+        if (!parsed) {
+            core::debug::Logger::get_singleton().warn("Skipping malformed line {} of asset database {}", line_number, path.string());
+            continue;
+        }
+
+        if (fields[1] != "-") record.importer = std::string(fields[1]);
+        record.source_path = std::string(fields[7]);
+        _by_path[record.source_path] = record.guid;
+        AssetGuid guid = record.guid;
+        _records.emplace(guid, std::move(record));
+    }
+
+    core::debug::Logger::get_singleton().info("Loaded asset database {} with {} assets", path.string(), _records.size());
+    return true;
+}
+
+bool AssetDatabase::update_source(AssetRecord& record, bool& changed) {
+    changed = false;
+    std::error_code error;
+    const auto modified = std::filesystem::last_write_time(record.source_path, error);
+    if (error) return false;
+    const uint64_t size = std::filesystem::file_size(record.source_path, error);
+    if (error) return false;
+
+    const int64_t modified_time = static_cast<int64_t>(modified.time_since_epoch().count());
+    if (record.hash != 0 && modified_time == record.modified_time && size == record.size) return true;
+
+    // a touched file with the same bytes, as after a fresh copy into the build tree, keeps its key
+    MappedFile file(record.source_path);
+    if (!file.valid()) return false;
+    const uint64_t hash = core::memory::Hash64(file.data(), file.size());
+    ++_hashed_count;
+
+    changed = record.hash != 0 && hash != record.hash;
+    record.hash = hash;
+    record.modified_time = modified_time;
+    record.size = size;
+    _dirty = true;
+    return true;
+}
+
+uint64_t AssetDatabase::cooked_key(AssetGuid guid, std::vector<AssetGuid>& visiting) {
+    AssetRecord& current = _records.at(guid);
+    bool changed = false;
+    if (!update_source(current, changed)) return 0;
+    if (current.importer.empty() && current.dependencies.empty()) return current.hash;
+
+    // a cycle would never settle, the asset closing it is left out of the key
+    if (std::find(visiting.begin(), visiting.end(), current.guid) != visiting.end()) return current.hash;
+    visiting.push_back(current.guid);
+
+    core::memory::Hasher hasher;
+    hasher.add(current.hash);
+    hasher.add_bytes(current.importer.data(), current.importer.size());
+    auto importer = _importers.find(current.importer);
+    if (importer != _importers.end()) {
+        hasher.add(importer->second.version);
+        hasher.add(importer->second.settings_hash);
+    }
+    for (const AssetGuid& dependency : current.dependencies) {
+        auto it = _records.find(dependency);
+        hasher.add(it != _records.end() ? cooked_key(dependency, visiting) : uint64_t(0));
+    }
+
+    visiting.pop_back();
+    return std::max<uint64_t>(hasher.finish(), 1);
+}
+
+std::string AssetDatabase::cooked_path(const AssetImporter& importer, uint64_t key) const {
+    return (std::filesystem::path(_cache_directory) / std::format("{:016x}{}", key, importer.cooked_extension)).generic_string();
+}
+
+} // namespace engine::import
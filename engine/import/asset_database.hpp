@@ -0,0 +1,140 @@
+#ifndef engine_import_ASSET_DATABASE_HPP
+#define engine_import_ASSET_DATABASE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace engine::import {
+
+// names an asset for good: assigned the first time a source is seen and kept in the database, so it survives
+// runs and does not depend on how the asset happens to be cooked
+struct AssetGuid {
+    uint64_t high = 0;
+    uint64_t low = 0;
+
+    static AssetGuid Generate();
+    // 32 hex digits as written by to_string, the null guid for anything else
+    static AssetGuid Parse(std::string_view text);
+
+    bool valid() const { return high != 0 || low != 0; }
+    std::string to_string() const;
+
+    bool operator==(const AssetGuid& other) const noexcept { return high == other.high && low == other.low; }
+    bool operator!=(const AssetGuid& other) const noexcept { return !(*this == other); }
+    bool operator<(const AssetGuid& other) const noexcept { return high != other.high ? high < other.high : low < other.low; }
+};
+
+struct AssetGuidHash {
+    size_t operator()(const AssetGuid& guid) const noexcept {
+        return static_cast<size_t>(guid.high ^ (guid.low * 0x9E3779B97F4A7C15ull));
+    }
+};
+
+// turns a source file into its cooked form. bump version whenever the output for the same input changes,
+// and fold anything else the output depends on into settings_hash
+struct AssetImporter {
+    uint32_t version = 1;
+    uint64_t settings_hash = 0;
+    std::string cooked_extension;
+    std::function<bool(const std::string& source_path, const std::string& cooked_path)> cook;
+    // other source files the output reads, found from the source itself; may be empty
+    std::function<std::vector<std::string>(const std::string& source_path)> dependencies;
+};
+
+struct AssetRecord {
+    AssetGuid guid;
+    std::string source_path;
+    std::string importer;       // empty for assets loaded as they are
+    int64_t modified_time = 0;  // file clock ticks when the hash was taken
+    uint64_t size = 0;
+    uint64_t hash = 0;          // of the contents
+    uint64_t cooked_key = 0;    // what the cooked output on disk was built from, 0 until cooked
+    std::vector<AssetGuid> dependencies;
+};
+
+// every asset the engine loads, by guid, with what is known of its source and its cooked output. cooked files
+// live in the cache directory named after their key, a hash of the source contents, the importer's version and
+// settings and the keys of the asset's dependencies, so an unchanged asset is never imported twice and a change
+// anywhere below an asset gives it a new key. sources are only rehashed when their time or size moved.
+// any thread may use the database; calls take turns, so cooks started on several threads run one at a time
+class AssetDatabase {
+public:
+    static constexpr uint32_t DATABASE_VERSION = 1;
+
+    // loads cache_directory/assets.db when there is one, the directory is created on first save
+    explicit AssetDatabase(std::string cache_directory);
+    AssetDatabase(const AssetDatabase&) = delete;
+    AssetDatabase& operator=(const AssetDatabase&) = delete;
+    // saves if anything changed
+    ~AssetDatabase();
+
+    // replaces any importer of the same name; assets cooked by the old one get new keys if version or settings moved
+    void register_importer(const std::string& name, AssetImporter importer);
+
+    // the asset for a source, added on first sight; an empty importer loads the source as it is.
+    // the null guid when the source does not exist
+    AssetGuid import(const std::string& source_path, const std::string& importer = "");
+
+    // path to load for the asset: its cooked output, cooking it first when missing or stale; the source itself
+    // for assets without an importer or when cooking fails. empty for unknown guids
+    std::string resolve(AssetGuid guid);
+    // import then resolve
+    std::string cook(const std::string& source_path, const std::string& importer = "") { return resolve(import(source_path, importer)); }
+
+    // the dependent's key takes in the dependency's, so it is cooked again whenever the dependency changes
+    void add_dependency(AssetGuid dependent, AssetGuid dependency);
+    // assets that depend on guid directly or through others
+    std::vector<AssetGuid> dependents(AssetGuid guid) const;
+
+    // checks every source against its recorded time and size, rehashing those that moved; returns the assets
+    // whose contents changed followed by everything depending on them, each once, for callers to reload
+    std::vector<AssetGuid> refresh();
+
+    // records are never removed, the pointer stays valid for the database's lifetime
+    const AssetRecord* find(AssetGuid guid) const;
+    AssetGuid find(const std::string& source_path) const;
+    size_t size() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _records.size();
+    }
+
+    bool save();
+
+    // work done since construction, a warm start with nothing changed cooks and hashes nothing
+    uint32_t cooked_count() const { return _cooked_count.load(); }
+    uint32_t hashed_count() const { return _hashed_count.load(); }
+    uint32_t cache_hit_count() const { return _cache_hit_count.load(); }
+
+private:
+    static std::string Normalize(const std::string& path);
+
+    bool load();
+    // refreshes time, size and hash when the file moved; false when it cannot be read
+    bool update_source(AssetRecord& record, bool& changed);
+    // 0 when the source cannot be read
+    uint64_t cooked_key(AssetGuid guid, std::vector<AssetGuid>& visiting);
+    std::string cooked_path(const AssetImporter& importer, uint64_t key) const;
+
+    std::string _cache_directory;
+    std::unordered_map<AssetGuid, AssetRecord, AssetGuidHash> _records;
+    std::unordered_map<std::string, AssetGuid> _by_path;
+    std::unordered_map<std::string, AssetImporter> _importers;
+    bool _dirty = false;
+    // recursive, resolve imports an importer's dependencies through the public calls
+    mutable std::recursive_mutex _mutex;
+
+    std::atomic<uint32_t> _cooked_count{ 0 };
+    std::atomic<uint32_t> _hashed_count{ 0 };
+    std::atomic<uint32_t> _cache_hit_count{ 0 };
+};
+
+} // namespace engine::import
+
+#endif // engine_import_ASSET_DATABASE_HPP
@@ -0,0 +1,360 @@
+#include "cooked_mesh.hpp"
+
+#include "engine/core/memory/hash.hpp"
+#include "engine/core/debug/logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace engine::import {
+
+namespace {
+
+uint64_t AlignUp(uint64_t value) {
+    return (value + COOKED_MESH_BLOB_ALIGNMENT - 1) & ~(COOKED_MESH_BLOB_ALIGNMENT - 1);
+}
+
+bool SectionFits(uint64_t offset, uint64_t size, uint64_t file_size) {
+    return offset <= file_size && size <= file_size - offset;
+}
+
+// a max reduction rather than an early out, so the loop vectorizes
+template <typename Index>
+bool IndicesInRange(const Index* indices, uint64_t count, uint32_t vertex_count) {
+    if (count == 0) return true;
+    Index largest = 0;
+    for (uint64_t i = 0; i < count; ++i) largest = std::max(largest, indices[i]);
+    return largest < vertex_count;
+}
+
+} // namespace
+
+bool CookMesh(const ObjModel& model, const std::string& filepath, const VertexQuantization& quantization) {
+    const size_t lod_count = model.lod_count();
+    size_t vertex_count = 0;
+    size_t index_count = 0;
+    for (const ObjMesh& mesh : model.meshes) {
+        vertex_count += mesh.vertices.size();
+        for (size_t level = 0; level < lod_count; ++level) index_count += mesh.lod_indices(level).size();
+    }
+    if (index_count == 0) {
+        core::debug::Logger::get_singleton().error("Refusing to cook {} with no triangles", filepath);
+        return false;
+    }
+    if (vertex_count > std::numeric_limits<uint32_t>::max() || index_count > std::numeric_limits<uint32_t>::max()) {
+        core::debug::Logger::get_singleton().error("Mesh too large to cook into {}", filepath);
+        return false;
+    }
+
+    // quantized over the whole model, so every submesh shares one dequantization
+    std::vector<ObjVertex> vertices;
+    vertices.reserve(vertex_count);
+    for (const ObjMesh& mesh : model.meshes) {
+        if (!mesh.indices.empty()) vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+    }
+    vertex_count = vertices.size();
+    QuantizedVertices packed = QuantizeVertices(vertices, quantization);
+    if (packed.layout.size() > COOKED_MESH_MAX_STREAMS) {
+        core::debug::Logger::get_singleton().error("Too many vertex streams to cook into {}", filepath);
+        return false;
+    }
+
+    std::vector<CookedVertexAttribute> attributes;
+    for (const core::graphics::VertexBindingDescription& binding : packed.layout) {
+        for (const core::graphics::VertexAttribute& attribute : binding.attributes) {
+            attributes.push_back(CookedVertexAttribute{
+                binding.binding, attribute.location, static_cast<uint32_t>(attribute.format), attribute.offset
+            });
+        }
+    }
+
+    CookedMeshHeader header{};
+    std::memcpy(header.magic, COOKED_MESH_MAGIC, sizeof(header.magic));
+    header.version = COOKED_MESH_VERSION;
+    header.vertex_stream_count = static_cast<uint32_t>(packed.layout.size());
+    for (size_t s = 0; s < packed.layout.size(); ++s) header.vertex_strides[s] = packed.layout[s].stride;
+    header.vertex_count = static_cast<uint32_t>(vertex_count);
+    header.index_size = FitsIndex16(vertex_count) ? sizeof(uint16_t) : sizeof(uint32_t);
+    header.index_count = static_cast<uint32_t>(index_count);
+    header.attribute_count = static_cast<uint32_t>(attributes.size());
+
+    // submesh table and names, lod table. like the mesh cache, every submesh at lod 0 comes first and each
+    // coarser level follows
+    std::vector<CookedSubMesh> submeshes;
+    std::vector<CookedLod> lods;
+    std::string names;
+    uint32_t first_index = 0;
+    for (size_t level = 0; level < lod_count; ++level) {
+        CookedLod lod{ first_index, 0, 0.0f };
+        for (const ObjMesh& mesh : model.meshes) {
+            if (mesh.indices.empty()) continue;
+            uint32_t count = static_cast<uint32_t>(mesh.lod_indices(level).size());
+            if (level == 0) {
+                submeshes.push_back(CookedSubMesh{
+                    first_index, count,
+                    static_cast<uint32_t>(names.size()), static_cast<uint32_t>(mesh.name.size())
+                });
+                names += mesh.name;
+            }
+            first_index += count;
+            lod.error = std::max(lod.error, mesh.lod_error(level));
+        }
+        lod.index_count = first_index - lod.first_index;
+        lods.push_back(lod);
+    }
+    header.submesh_count = static_cast<uint32_t>(submeshes.size());
+    header.lod_count = static_cast<uint32_t>(lods.size());
+
+    Meshlets meshlets = BuildMeshlets(model);
+    header.meshlet_count = static_cast<uint32_t>(meshlets.meshlets.size());
+    header.meshlet_vertex_count = static_cast<uint32_t>(meshlets.vertices.size());
+    header.meshlet_triangle_size = static_cast<uint32_t>(meshlets.triangles.size());
+
+    header.attributes_offset = AlignUp(sizeof(CookedMeshHeader));
+    header.submeshes_offset = AlignUp(header.attributes_offset + attributes.size() * sizeof(CookedVertexAttribute));
+    header.lods_offset = AlignUp(header.submeshes_offset + submeshes.size() * sizeof(CookedSubMesh));
+    header.names_offset = AlignUp(header.lods_offset + lods.size() * sizeof(CookedLod));
+    header.names_size = names.size();
+    header.meshlets_offset = AlignUp(header.names_offset + names.size());
+    header.meshlet_bounds_offset = AlignUp(header.meshlets_offset + meshlets.meshlets.size() * sizeof(Meshlet));
+    header.meshlet_vertices_offset = AlignUp(header.meshlet_bounds_offset + meshlets.bounds.size() * sizeof(MeshletBounds));
+    header.meshlet_triangles_offset = AlignUp(header.meshlet_vertices_offset + meshlets.vertices.size() * sizeof(uint32_t));
+    uint64_t cursor = AlignUp(header.meshlet_triangles_offset + meshlets.triangles.size());
+    for (size_t s = 0; s < packed.streams.size(); ++s) {
+        header.vertex_offsets[s] = cursor;
+        cursor = AlignUp(cursor + packed.streams[s].size());
+    }
+    header.index_offset = cursor;
+    header.file_size = header.index_offset + index_count * header.index_size;
+
+    // the whole file is assembled in memory and written once
+    std::vector<char> bytes(header.file_size, 0);
+    auto put = [&bytes](uint64_t offset, const void* data, size_t size) {
+        if (size > 0) std::memcpy(bytes.data() + offset, data, size);
+    };
+
+    uint64_t index_cursor = header.index_offset;
+    for (size_t level = 0; level < lod_count; ++level) {
+        uint32_t base_vertex = 0;
+        for (const ObjMesh& mesh : model.meshes) {
+            if (mesh.indices.empty()) continue;
+
+            for (uint32_t index : mesh.lod_indices(level)) {
+                uint32_t rebased = base_vertex + index;
+                if (header.index_size == sizeof(uint16_t)) {
+                    uint16_t narrow = static_cast<uint16_t>(rebased);
+                    put(index_cursor, &narrow, sizeof(narrow));
+                } else {
+                    put(index_cursor, &rebased, sizeof(rebased));
+                }
+                index_cursor += header.index_size;
+            }
+            base_vertex += static_cast<uint32_t>(mesh.vertices.size());
+        }
+    }
+
+    MeshBounds bounds = ComputeMeshBounds(vertices);
+    for (int i = 0; i < 3; ++i) {
+        header.bounds_min[i] = bounds.min[i];
+        header.bounds_max[i] = bounds.max[i];
+        header.dequant_offset[i] = packed.dequantization.offset[i];
+    }
+    header.bounds_radius = bounds.radius;
+    header.dequant_scale = packed.dequantization.scale;
+
+    put(0, &header, sizeof(header));
+    put(header.attributes_offset, attributes.data(), attributes.size() * sizeof(CookedVertexAttribute));
+    put(header.submeshes_offset, submeshes.data(), submeshes.size() * sizeof(CookedSubMesh));
+    put(header.lods_offset, lods.data(), lods.size() * sizeof(CookedLod));
+    put(header.names_offset, names.data(), names.size());
+    put(header.meshlets_offset, meshlets.meshlets.data(), meshlets.meshlets.size() * sizeof(Meshlet));
+    put(header.meshlet_bounds_offset, meshlets.bounds.data(), meshlets.bounds.size() * sizeof(MeshletBounds));
+    put(header.meshlet_vertices_offset, meshlets.vertices.data(), meshlets.vertices.size() * sizeof(uint32_t));
+    put(header.meshlet_triangles_offset, meshlets.triangles.data(), meshlets.triangles.size());
+    for (size_t s = 0; s < packed.streams.size(); ++s) {
+        put(header.vertex_offsets[s], packed.streams[s].data(), packed.streams[s].size());
+    }
+
+    // written beside the destination and renamed over it, so a reader never maps a half written file
+    std::string temp_path = filepath + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out || !out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()))) {
+            core::debug::Logger::get_singleton().error("Failed to write cooked mesh {}", temp_path);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, filepath, error);
+    if (error) {
+        core::debug::Logger::get_singleton().error("Failed to move cooked mesh into place at {}: {}", filepath, error.message());
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+
+    uint32_t vertex_size = 0;
+    for (const core::graphics::VertexBindingDescription& binding : packed.layout) vertex_size += binding.stride;
+    core::debug::Logger::get_singleton().info("Cooked {} ({} vertices of {} bytes in {} streams, {} indices in {} lods, {} bytes)",
+        filepath, vertex_count, vertex_size, packed.layout.size(), index_count, lods.size(), header.file_size);
+    return true;
+}
+
+AssetImporter MeshImporter(const VertexQuantization& quantization) {
+    AssetImporter importer;
+    importer.version = COOKED_MESH_VERSION;
+    importer.settings_hash = core::memory::Hasher{}
+        .add(static_cast<uint32_t>(quantization.position))
+        .add(static_cast<uint32_t>(quantization.octahedral_normals))
+        .add(static_cast<uint32_t>(quantization.half_texcoords))
+        .add(static_cast<uint32_t>(quantization.split_positions))
+        .finish();
+    importer.cooked_extension = ".jmesh";
+    importer.cook = [quantization](const std::string& source_path, const std::string& cooked_path) {
+        ObjModel model = ReadObj(source_path);
+        return !model.meshes.empty() && CookMesh(model, cooked_path, quantization);
+    };
+    return importer;
+}
+
+CookedMesh::CookedMesh(const std::string& filepath) : _file(filepath) {
+    if (!_file.valid()) return;
+
+    const CookedMeshHeader* header = reinterpret_cast<const CookedMeshHeader*>(_file.data());
+    if (_file.size() < sizeof(CookedMeshHeader) || std::memcmp(header->magic, COOKED_MESH_MAGIC, sizeof(header->magic)) != 0) {
+        core::debug::Logger::get_singleton().error("{} is not a cooked mesh", filepath);
+        return;
+    }
+    if (header->version != COOKED_MESH_VERSION) {
+        core::debug::Logger::get_singleton().warn("{} is cooked mesh version {}, expected {}", filepath, header->version, COOKED_MESH_VERSION);
+        return;
+    }
+
+    // every section must lie inside the file before any pointer into it is handed out
+    uint64_t size = _file.size();
+    bool intact = header->file_size == size
+        && (header->index_size == 2 || header->index_size == 4)
+        && header->vertex_stream_count > 0 && header->vertex_stream_count <= COOKED_MESH_MAX_STREAMS
+        && header->dequant_scale > 0.0f
+        && SectionFits(header->attributes_offset, uint64_t(header->attribute_count) * sizeof(CookedVertexAttribute), size)
+        && SectionFits(header->submeshes_offset, uint64_t(header->submesh_count) * sizeof(CookedSubMesh), size)
+        && header->lod_count > 0
+        && SectionFits(header->lods_offset, uint64_t(header->lod_count) * sizeof(CookedLod), size)
+        && SectionFits(header->names_offset, header->names_size, size)
+        && SectionFits(header->meshlets_offset, uint64_t(header->meshlet_count) * sizeof(Meshlet), size)
+        && SectionFits(header->meshlet_bounds_offset, uint64_t(header->meshlet_count) * sizeof(MeshletBounds), size)
+        && SectionFits(header->meshlet_vertices_offset, uint64_t(header->meshlet_vertex_count) * sizeof(uint32_t), size)
+        && SectionFits(header->meshlet_triangles_offset, header->meshlet_triangle_size, size)
+        && SectionFits(header->index_offset, uint64_t(header->index_size) * header->index_count, size);
+    for (uint32_t s = 0; intact && s < header->vertex_stream_count; ++s) {
+        intact = header->vertex_strides[s] > 0
+            && SectionFits(header->vertex_offsets[s], uint64_t(header->vertex_strides[s]) * header->vertex_count, size);
+    }
+    const CookedVertexAttribute* attributes = reinterpret_cast<const CookedVertexAttribute*>(_file.data() + header->attributes_offset);
+    for (uint32_t i = 0; intact && i < header->attribute_count; ++i) {
+        intact = attributes[i].binding < header->vertex_stream_count;
+    }
+    const CookedSubMesh* submeshes = reinterpret_cast<const CookedSubMesh*>(_file.data() + header->submeshes_offset);
+    for (uint32_t i = 0; intact && i < header->submesh_count; ++i) {
+        intact = submeshes[i].first_index <= header->index_count
+            && submeshes[i].index_count <= header->index_count - submeshes[i].first_index;
+    }
+    const CookedLod* lods = reinterpret_cast<const CookedLod*>(_file.data() + header->lods_offset);
+    for (uint32_t i = 0; intact && i < header->lod_count; ++i) {
+        intact = lods[i].first_index <= header->index_count && lods[i].index_count <= header->index_count - lods[i].first_index;
+    }
+    const Meshlet* meshlets = reinterpret_cast<const Meshlet*>(_file.data() + header->meshlets_offset);
+    for (uint32_t i = 0; intact && i < header->meshlet_count; ++i) {
+        intact = meshlets[i].vertex_offset <= header->meshlet_vertex_count
+            && meshlets[i].vertex_count <= header->meshlet_vertex_count - meshlets[i].vertex_offset
+            && meshlets[i].triangle_offset <= header->meshlet_triangle_size
+            && uint64_t(meshlets[i].triangle_count) * 3 <= header->meshlet_triangle_size - meshlets[i].triangle_offset;
+    }
+    // the index and meshlet vertex blobs go to the gpu and the culling code as they are, so every vertex
+    // they name must exist
+    if (intact) {
+        const char* index_data = _file.data() + header->index_offset;
+        intact = header->index_size == 2
+            ? IndicesInRange(reinterpret_cast<const uint16_t*>(index_data), header->index_count, header->vertex_count)
+            : IndicesInRange(reinterpret_cast<const uint32_t*>(index_data), header->index_count, header->vertex_count);
+    }
+    if (intact) {
+        const uint32_t* meshlet_vertices = reinterpret_cast<const uint32_t*>(_file.data() + header->meshlet_vertices_offset);
+        intact = IndicesInRange(meshlet_vertices, header->meshlet_vertex_count, header->vertex_count);
+    }
+    if (!intact) {
+        core::debug::Logger::get_singleton().error("Cooked mesh {} is truncated or corrupt", filepath);
+        return;
+    }
+
+    _header = header;
+}
+
+std::vector<core::graphics::VertexStream> CookedMesh::vertex_streams() const {
+    std::vector<core::graphics::VertexStream> streams;
+    for (uint32_t s = 0; s < _header->vertex_stream_count; ++s) {
+        streams.push_back(core::graphics::VertexStream{ _file.data() + _header->vertex_offsets[s], _header->vertex_strides[s] });
+    }
+    return streams;
+}
+
+std::vector<core::graphics::VertexBindingDescription> CookedMesh::vertex_layout() const {
+    std::vector<core::graphics::VertexBindingDescription> layout(_header->vertex_stream_count);
+    for (uint32_t s = 0; s < _header->vertex_stream_count; ++s) {
+        layout[s].set_binding(s).set_stride(_header->vertex_strides[s]);
+    }
+
+    const CookedVertexAttribute* attributes = reinterpret_cast<const CookedVertexAttribute*>(_file.data() + _header->attributes_offset);
+    for (uint32_t i = 0; i < _header->attribute_count; ++i) {
+        layout[attributes[i].binding].add_attribute(
+            attributes[i].location, static_cast<core::graphics::VertexFormat>(attributes[i].format), attributes[i].offset);
+    }
+    return layout;
+}
+
+std::vector<core::graphics::SubMesh> CookedMesh::submeshes() const {
+    const CookedSubMesh* cooked = reinterpret_cast<const CookedSubMesh*>(_file.data() + _header->submeshes_offset);
+    const char* names = _file.data() + _header->names_offset;
+
+    std::vector<core::graphics::SubMesh> submeshes;
+    submeshes.reserve(_header->submesh_count);
+    for (uint32_t i = 0; i < _header->submesh_count; ++i) {
+        std::string name;
+        if (cooked[i].name_offset <= _header->names_size && cooked[i].name_length <= _header->names_size - cooked[i].name_offset) {
+            name.assign(names + cooked[i].name_offset, cooked[i].name_length);
+        }
+        submeshes.push_back(core::graphics::SubMesh{ std::move(name), cooked[i].first_index, cooked[i].index_count });
+    }
+    return submeshes;
+}
+
+std::vector<core::graphics::MeshLod> CookedMesh::lods() const {
+    const CookedLod* cooked = reinterpret_cast<const CookedLod*>(_file.data() + _header->lods_offset);
+
+    std::vector<core::graphics::MeshLod> lods;
+    lods.reserve(_header->lod_count);
+    for (uint32_t i = 0; i < _header->lod_count; ++i) {
+        lods.push_back(core::graphics::MeshLod{ cooked[i].first_index, cooked[i].index_count, cooked[i].error });
+    }
+    return lods;
+}
+
+Meshlets CookedMesh::meshlets() const {
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(_file.data());
+    const Meshlet* meshlets = reinterpret_cast<const Meshlet*>(base + _header->meshlets_offset);
+    const MeshletBounds* bounds = reinterpret_cast<const MeshletBounds*>(base + _header->meshlet_bounds_offset);
+    const uint32_t* vertices = reinterpret_cast<const uint32_t*>(base + _header->meshlet_vertices_offset);
+    const uint8_t* triangles = base + _header->meshlet_triangles_offset;
+
+    Meshlets out;
+    out.meshlets.assign(meshlets, meshlets + _header->meshlet_count);
+    out.bounds.assign(bounds, bounds + _header->meshlet_count);
+    out.vertices.assign(vertices, vertices + _header->meshlet_vertex_count);
+    out.triangles.assign(triangles, triangles + _header->meshlet_triangle_size);
+    return out;
+}
+
+} // namespace engine::import
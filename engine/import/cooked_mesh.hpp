@@ -0,0 +1,163 @@
+#ifndef engine_import_COOKED_MESH_HPP
+#define engine_import_COOKED_MESH_HPP
+
+#include "mesh.hpp"
+#include "mapped_file.hpp"
+#include "vertex_quantize.hpp"
+#include "meshlet.hpp"
+#include "asset_database.hpp"
+
+#include "engine/core/graphics/vertex_types.hpp"
+#include "engine/core/graphics/mesh_buffer.hpp"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+namespace engine::import {
+
+// .jmesh: one model packed the way the gpu wants it, so loading is a map and an upload.
+//   header | attributes | submeshes | lods | names | meshlets | meshlet bounds | meshlet vertices |
+//   meshlet triangles | vertex stream blobs | index blob
+// every section starts on a BLOB_ALIGNMENT boundary, offsets are from the start of the file, little endian
+constexpr char COOKED_MESH_MAGIC[4] = { 'J', 'M', 'S', 'H' };
+constexpr uint32_t COOKED_MESH_VERSION = 6;
+constexpr uint64_t COOKED_MESH_BLOB_ALIGNMENT = 16;
+constexpr uint32_t COOKED_MESH_MAX_STREAMS = 4;
+
+struct CookedMeshHeader {
+    char magic[4];
+    uint32_t version;
+
+    uint32_t vertex_stream_count;
+    uint32_t vertex_strides[COOKED_MESH_MAX_STREAMS];
+    uint32_t vertex_count;
+    uint32_t index_size;        // 2 or 4
+    uint32_t index_count;       // every lod, level major
+    uint32_t attribute_count;
+    uint32_t submesh_count;
+    uint32_t lod_count;
+    uint32_t meshlet_count;
+    uint32_t meshlet_vertex_count;
+    uint32_t meshlet_triangle_size;     // bytes
+
+    float bounds_min[3];
+    float bounds_max[3];
+    float bounds_radius;        // around the center of the box
+    float dequant_offset[3];    // position = dequant_offset + dequant_scale * stored
+    float dequant_scale;
+
+    uint64_t attributes_offset;
+    uint64_t submeshes_offset;
+    uint64_t lods_offset;
+    uint64_t names_offset;
+    uint64_t names_size;
+    uint64_t meshlets_offset;
+    uint64_t meshlet_bounds_offset;
+    uint64_t meshlet_vertices_offset;
+    uint64_t meshlet_triangles_offset;
+    uint64_t vertex_offsets[COOKED_MESH_MAX_STREAMS];
+    uint64_t index_offset;
+    uint64_t file_size;
+};
+
+struct CookedVertexAttribute {
+    uint32_t binding;           // the stream it is read from
+    uint32_t location;
+    uint32_t format;            // core::graphics::VertexFormat
+    uint32_t offset;
+};
+
+struct CookedSubMesh {
+    uint32_t first_index;
+    uint32_t index_count;
+    uint32_t name_offset;       // into the names section
+    uint32_t name_length;
+};
+
+struct CookedLod {
+    uint32_t first_index;
+    uint32_t index_count;
+    float error;
+};
+
+// packs every shape of the model into one vertex and index blob, with 16-bit indices when they fit and the
+// vertices in the layout quantization describes; the lod chains of the shapes follow lod 0 in the index blob,
+// and lod 0 is also stored as meshlets
+bool CookMesh(const ObjModel& model, const std::string& filepath,
+    const VertexQuantization& quantization = VertexQuantization::None());
+
+// obj to .jmesh for the asset database, keyed on the format version and the vertex layout
+AssetImporter MeshImporter(const VertexQuantization& quantization = VertexQuantization::None());
+
+// a mapped .jmesh, its blobs point straight into the mapping and stay valid as long as this object
+class CookedMesh {
+public:
+    CookedMesh() = default;
+    // logs and stays invalid when the file is missing, truncated or from another format version
+    explicit CookedMesh(const std::string& filepath);
+
+    // the mapping does not move, so the header pointer carries over
+    CookedMesh(CookedMesh&& other) noexcept
+        : _file(std::move(other._file)), _header(std::exchange(other._header, nullptr)) {}
+
+    CookedMesh& operator=(CookedMesh&& other) noexcept {
+        if (this != &other) {
+            _file = std::move(other._file);
+            _header = std::exchange(other._header, nullptr);
+        }
+        return *this;
+    }
+
+    CookedMesh(const CookedMesh&) = delete;
+    CookedMesh& operator=(const CookedMesh&) = delete;
+
+    ~CookedMesh() = default;
+
+    bool valid() const { return _header != nullptr; }
+
+    uint32_t vertex_stream_count() const { return _header->vertex_stream_count; }
+    uint32_t vertex_count() const { return _header->vertex_count; }
+    std::vector<core::graphics::VertexStream> vertex_streams() const;
+
+    const void* index_data() const { return _file.data() + _header->index_offset; }
+    uint32_t index_size() const { return _header->index_size; }
+    uint32_t index_count() const { return _header->index_count; }
+
+    uint64_t blob_size() const {
+        uint64_t size = static_cast<uint64_t>(index_size()) * index_count();
+        for (uint32_t s = 0; s < vertex_stream_count(); ++s) size += static_cast<uint64_t>(_header->vertex_strides[s]) * vertex_count();
+        return size;
+    }
+
+    MeshBounds bounds() const {
+        MeshBounds bounds;
+        bounds.min = glm::vec3(_header->bounds_min[0], _header->bounds_min[1], _header->bounds_min[2]);
+        bounds.max = glm::vec3(_header->bounds_max[0], _header->bounds_max[1], _header->bounds_max[2]);
+        bounds.center = (bounds.min + bounds.max) * 0.5f;
+        bounds.radius = _header->bounds_radius;
+        return bounds;
+    }
+
+    PositionDequantization dequantization() const {
+        return { { _header->dequant_offset[0], _header->dequant_offset[1], _header->dequant_offset[2] }, _header->dequant_scale };
+    }
+
+    // binding i reads stream i
+    std::vector<core::graphics::VertexBindingDescription> vertex_layout() const;
+    std::vector<core::graphics::SubMesh> submeshes() const;
+    std::vector<core::graphics::MeshLod> lods() const;
+    Meshlets meshlets() const;
+
+private:
+    MappedFile _file;
+    const CookedMeshHeader* _header = nullptr;
+};
+
+} // namespace engine::import
+
+#endif // engine_import_COOKED_MESH_HPP
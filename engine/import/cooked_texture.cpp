@@ -0,0 +1,137 @@
+#include "cooked_texture.hpp"
+#include "mapped_file.hpp"
+
+#include "engine/core/memory/hash.hpp"
+#include "engine/core/debug/logger.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace engine::import {
+
+namespace {
+
+uint64_t AlignUp(uint64_t value) {
+    return (value + COOKED_TEXTURE_BLOB_ALIGNMENT - 1) & ~(COOKED_TEXTURE_BLOB_ALIGNMENT - 1);
+}
+
+bool SectionFits(uint64_t offset, uint64_t size, uint64_t file_size) {
+    return offset <= file_size && size <= file_size - offset;
+}
+
+} // namespace
+
+bool CookTexture(const TextureData& texture, const std::string& filepath) {
+    if (texture.empty()) {
+        core::debug::Logger::get_singleton().error("Refusing to cook {} with no mips", filepath);
+        return false;
+    }
+
+    CookedTextureHeader header{};
+    std::memcpy(header.magic, COOKED_TEXTURE_MAGIC, sizeof(header.magic));
+    header.version = COOKED_TEXTURE_VERSION;
+    header.width = texture.width;
+    header.height = texture.height;
+    header.format = static_cast<uint32_t>(texture.format);
+    header.mip_count = texture.mip_count();
+    header.mips_offset = AlignUp(sizeof(CookedTextureHeader));
+    header.data_offset = AlignUp(header.mips_offset + texture.mips.size() * sizeof(CookedTextureMip));
+    header.data_size = texture.data.size();
+    header.file_size = header.data_offset + header.data_size;
+
+    std::vector<CookedTextureMip> mips;
+    mips.reserve(texture.mips.size());
+    for (const TextureMip& mip : texture.mips) mips.push_back(CookedTextureMip{ mip.width, mip.height, mip.offset, mip.size });
+
+    std::vector<char> bytes(header.file_size, 0);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + header.mips_offset, mips.data(), mips.size() * sizeof(CookedTextureMip));
+    std::memcpy(bytes.data() + header.data_offset, texture.data.data(), texture.data.size());
+
+    // written beside the destination and renamed over it, as for meshes
+    std::string temp_path = filepath + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out || !out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()))) {
+            core::debug::Logger::get_singleton().error("Failed to write cooked texture {}", temp_path);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, filepath, error);
+    if (error) {
+        core::debug::Logger::get_singleton().error("Failed to move cooked texture into place at {}: {}", filepath, error.message());
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+
+    core::debug::Logger::get_singleton().info("Cooked {} ({}x{}, {} mips, {} bytes)",
+        filepath, texture.width, texture.height, texture.mip_count(), header.file_size);
+    return true;
+}
+
+TextureData ReadCookedTexture(const std::string& filepath) {
+    MappedFile file(filepath);
+    if (!file.valid()) return {};
+
+    const CookedTextureHeader* header = reinterpret_cast<const CookedTextureHeader*>(file.data());
+    if (file.size() < sizeof(CookedTextureHeader) || std::memcmp(header->magic, COOKED_TEXTURE_MAGIC, sizeof(header->magic)) != 0) {
+        core::debug::Logger::get_singleton().error("{} is not a cooked texture", filepath);
+        return {};
+    }
+    if (header->version != COOKED_TEXTURE_VERSION) {
+        core::debug::Logger::get_singleton().warn("{} is cooked texture version {}, expected {}", filepath, header->version, COOKED_TEXTURE_VERSION);
+        return {};
+    }
+
+    const uint64_t size = file.size();
+    bool intact = header->file_size == size
+        && header->mip_count > 0
+        && SectionFits(header->mips_offset, uint64_t(header->mip_count) * sizeof(CookedTextureMip), size)
+        && SectionFits(header->data_offset, header->data_size, size);
+    const CookedTextureMip* mips = intact ? reinterpret_cast<const CookedTextureMip*>(file.data() + header->mips_offset) : nullptr;
+    for (uint32_t level = 0; intact && level < header->mip_count; ++level) {
+        intact = SectionFits(mips[level].offset, mips[level].size, header->data_size);
+    }
+    if (!intact) {
+        core::debug::Logger::get_singleton().error("Cooked texture {} is truncated or corrupt", filepath);
+        return {};
+    }
+
+    TextureData texture;
+    texture.width = header->width;
+    texture.height = header->height;
+    texture.format = static_cast<core::graphics::ImageFormat>(header->format);
+    texture.mips.reserve(header->mip_count);
+    for (uint32_t level = 0; level < header->mip_count; ++level) {
+        texture.mips.push_back(TextureMip{ mips[level].width, mips[level].height,
+            static_cast<size_t>(mips[level].offset), static_cast<size_t>(mips[level].size) });
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(file.data() + header->data_offset);
+    texture.data.assign(data, data + header->data_size);
+    return texture;
+}
+
+AssetImporter TextureImporter(bool srgb, TextureCompression compression) {
+    AssetImporter importer;
+    importer.version = COOKED_TEXTURE_VERSION;
+    importer.settings_hash = core::memory::Hasher{}
+        .add(static_cast<uint32_t>(srgb))
+        .add(static_cast<uint32_t>(compression))
+        .finish();
+    importer.cooked_extension = ".jtex";
+    importer.cook = [srgb, compression](const std::string& source_path, const std::string& cooked_path) {
+        TextureData texture = ImportTexture(source_path, srgb, compression);
+        return !texture.empty() && CookTexture(texture, cooked_path);
+    };
+    return importer;
+}
+
+TextureData LoadTexture(const std::string& filepath, bool srgb, TextureCompression compression, core::thread::ThreadPool& pool) {
+    if (std::filesystem::path(filepath).extension() == ".jtex") return ReadCookedTexture(filepath);
+    return ImportTexture(filepath, srgb, compression, pool);
+}
+
+} // namespace engine::import
@@ -0,0 +1,57 @@
+#ifndef engine_import_COOKED_TEXTURE_HPP
+#define engine_import_COOKED_TEXTURE_HPP
+
+#include "texture.hpp"
+#include "asset_database.hpp"
+
+#include <string>
+#include <cstdint>
+
+namespace engine::import {
+
+// .jtex: a mip chain in the format it is uploaded in, so loading is a read and no decode or encode.
+//   header | mips | level data
+// the level data starts on a BLOB_ALIGNMENT boundary, offsets are from the start of the file, little endian
+constexpr char COOKED_TEXTURE_MAGIC[4] = { 'J', 'T', 'E', 'X' };
+constexpr uint32_t COOKED_TEXTURE_VERSION = 1;
+constexpr uint64_t COOKED_TEXTURE_BLOB_ALIGNMENT = 16;
+
+struct CookedTextureHeader {
+    char magic[4];
+    uint32_t version;
+
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;            // core::graphics::ImageFormat
+    uint32_t mip_count;
+
+    uint64_t mips_offset;
+    uint64_t data_offset;
+    uint64_t data_size;
+    uint64_t file_size;
+};
+
+struct CookedTextureMip {
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;            // into the level data
+    uint64_t size;
+};
+
+bool CookTexture(const TextureData& texture, const std::string& filepath);
+
+// the whole chain read into memory; logs and returns an empty chain when the file is missing, truncated or
+// from another format version
+TextureData ReadCookedTexture(const std::string& filepath);
+
+// image to .jtex for the asset database, keyed on the format version, color space and compression. cook with
+// a compression the device samples, TextureCompression::NONE where it has no bc support
+AssetImporter TextureImporter(bool srgb, TextureCompression compression);
+
+// reads a .jtex as it is and imports anything else
+TextureData LoadTexture(const std::string& filepath, bool srgb, TextureCompression compression,
+    core::thread::ThreadPool& pool = core::thread::ThreadPool::get_singleton());
+
+} // namespace engine::import
+
+#endif // engine_import_COOKED_TEXTURE_HPP
@@ -0,0 +1,665 @@
+#include "image.hpp"
+#include "mapped_file.hpp"
+
+#include "engine/core/debug/logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+namespace engine::import {
+
+namespace {
+
+// least significant bit first, as deflate packs them
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : _data(data), _size(size) {}
+
+    // past the end reads as zeros and sets overrun, callers check it once per block
+    uint32_t peek(uint32_t count) {
+        refill(count);
+        return static_cast<uint32_t>(_bits & ((uint64_t(1) << count) - 1));
+    }
+    void consume(uint32_t count) {
+        _bits >>= count;
+        _count -= count;
+    }
+    uint32_t read(uint32_t count) {
+        if (count == 0) return 0;
+        uint32_t value = peek(count);
+        consume(count);
+        return value;
+    }
+
+    // drops the partial byte, stored blocks start on a byte boundary
+    void align() { consume(_count % 8); }
+    // only valid after align
+    bool read_bytes(uint8_t* out, size_t size) {
+        while (size > 0 && _count >= 8) {
+            *out++ = static_cast<uint8_t>(_bits);
+            consume(8);
+            --size;
+        }
+        if (size > _size - _position) return false;
+        std::memcpy(out, _data + _position, size);
+        _position += size;
+        return true;
+    }
+
+    bool overrun() const { return _overrun; }
+
+private:
+    void refill(uint32_t count) {
+        while (_count < count) {
+            uint64_t byte = 0;
+            if (_position < _size) byte = _data[_position++];
+            else _overrun = true;
+            _bits |= byte << _count;
+            _count += 8;
+        }
+    }
+
+    const uint8_t* _data;
+    size_t _size;
+    size_t _position = 0;
+    uint64_t _bits = 0;
+    uint32_t _count = 0;
+    bool _overrun = false;
+};
+
+// canonical huffman code. codes up to FAST_BITS long resolve with one table lookup, longer ones walk
+// the per-length counts
+class Huffman {
+public:
+    static constexpr uint32_t MAX_BITS = 15;
+    static constexpr uint32_t FAST_BITS = 10;
+
+    bool build(const uint8_t* lengths, uint32_t count) {
+        std::fill(std::begin(_counts), std::end(_counts), uint16_t(0));
+        for (uint32_t i = 0; i < count; ++i) ++_counts[lengths[i]];
+        _counts[0] = 0;
+
+        // over-subscribed sets are malformed, incomplete ones are allowed (a single distance code is common)
+        int32_t left = 1;
+        for (uint32_t length = 1; length <= MAX_BITS; ++length) {
+            left = (left << 1) - _counts[length];
+            if (left < 0) return false;
+        }
+
+        uint16_t offsets[MAX_BITS + 2] = {};
+        for (uint32_t length = 1; length <= MAX_BITS; ++length) offsets[length + 1] = offsets[length] + _counts[length];
+        for (uint32_t i = 0; i < count; ++i) {
+            if (lengths[i] != 0) _symbols[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+        }
+
+        // codes are stored msb first but read lsb first, the fast table is indexed by the reversed code
+        std::fill(std::begin(_fast), std::end(_fast), uint16_t(0));
+        uint32_t code = 0;
+        uint32_t index = 0;
+        for (uint32_t length = 1; length <= FAST_BITS; ++length) {
+            for (uint32_t i = 0; i < _counts[length]; ++i, ++code, ++index) {
+                uint32_t reversed = 0;
+                for (uint32_t b = 0; b < length; ++b) reversed |= ((code >> b) & 1u) << (length - 1 - b);
+                const uint16_t entry = static_cast<uint16_t>((_symbols[index] << 4) | length);
+                for (uint32_t fill = reversed; fill < (1u << FAST_BITS); fill += 1u << length) _fast[fill] = entry;
+            }
+            code <<= 1;
+        }
+        return true;
+    }
+
+    // -1 on a code that is not in the set
+    int32_t decode(BitReader& reader) const {
+        const uint16_t entry = _fast[reader.peek(FAST_BITS)];
+        if (entry != 0) {
+            reader.consume(entry & 0xF);
+            return entry >> 4;
+        }
+
+        int32_t code = 0;
+        int32_t first = 0;
+        int32_t index = 0;
+        for (uint32_t length = 1; length <= MAX_BITS; ++length) {
+            code |= static_cast<int32_t>(reader.read(1));
+            const int32_t count = _counts[length];
+            if (code - first < count) return _symbols[index + (code - first)];
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+
+private:
+    uint16_t _counts[MAX_BITS + 1];
+    uint16_t _symbols[288];
+    uint16_t _fast[1u << FAST_BITS];
+};
+
+constexpr uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+constexpr uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+constexpr uint16_t DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+constexpr uint8_t DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// limit is the largest out.size() the stream may reach, anything longer fails as soon as it is exceeded
+bool InflateCodes(BitReader& reader, const Huffman& lengths, const Huffman& distances, std::vector<uint8_t>& out, size_t limit) {
+    for (;;) {
+        int32_t symbol = lengths.decode(reader);
+        if (symbol < 0 || reader.overrun()) return false;
+        if (symbol < 256) {
+            if (out.size() >= limit) return false;
+            out.push_back(static_cast<uint8_t>(symbol));
+            continue;
+        }
+        if (symbol == 256) return true;
+
+        symbol -= 257;
+        if (symbol >= 29) return false;
+        const size_t length = LENGTH_BASE[symbol] + reader.read(LENGTH_EXTRA[symbol]);
+
+        int32_t distance_symbol = distances.decode(reader);
+        if (distance_symbol < 0 || distance_symbol >= 30) return false;
+        const size_t distance = DISTANCE_BASE[distance_symbol] + reader.read(DISTANCE_EXTRA[distance_symbol]);
+        if (distance > out.size() || length > limit - out.size()) return false;
+
+        // overlapping copies repeat the last distance bytes, so this goes byte by byte
+        const size_t from = out.size() - distance;
+        out.resize(out.size() + length);
+        uint8_t* dst = out.data() + out.size() - length;
+        const uint8_t* src = out.data() + from;
+        for (size_t i = 0; i < length; ++i) dst[i] = src[i];
+    }
+}
+
+bool Inflate(BitReader& reader, std::vector<uint8_t>& out, size_t limit) {
+    Huffman lengths;
+    Huffman distances;
+
+    bool last = false;
+    while (!last) {
+        last = reader.read(1) != 0;
+        const uint32_t type = reader.read(2);
+
+        if (type == 0) {
+            reader.align();
+            uint8_t header[4];
+            if (!reader.read_bytes(header, 4)) return false;
+            const uint16_t length = static_cast<uint16_t>(header[0] | (header[1] << 8));
+            const uint16_t complement = static_cast<uint16_t>(header[2] | (header[3] << 8));
+            if (length != static_cast<uint16_t>(~complement) || length > limit - out.size()) return false;
+            out.resize(out.size() + length);
+            if (!reader.read_bytes(out.data() + out.size() - length, length)) return false;
+            continue;
+        }
+
+        uint8_t code_lengths[288 + 32] = {};
+        uint32_t literal_count = 288;
+        uint32_t distance_count = 30;
+
+        if (type == 1) {
+            std::fill(code_lengths, code_lengths + 144, uint8_t(8));
+            std::fill(code_lengths + 144, code_lengths + 256, uint8_t(9));
+            std::fill(code_lengths + 256, code_lengths + 280, uint8_t(7));
+            std::fill(code_lengths + 280, code_lengths + 288, uint8_t(8));
+            std::fill(code_lengths + 288, code_lengths + 288 + 30, uint8_t(5));
+        } else if (type == 2) {
+            literal_count = reader.read(5) + 257;
+            distance_count = reader.read(5) + 1;
+            const uint32_t header_count = reader.read(4) + 4;
+            if (literal_count > 286 || distance_count > 30) return false;
+
+            static constexpr uint8_t ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+            uint8_t header_lengths[19] = {};
+            for (uint32_t i = 0; i < header_count; ++i) header_lengths[ORDER[i]] = static_cast<uint8_t>(reader.read(3));
+
+            Huffman header;
+            if (!header.build(header_lengths, 19)) return false;
+
+            // literal and distance lengths are one run, repeats may cross from one into the other
+            uint32_t index = 0;
+            while (index < literal_count + distance_count) {
+                int32_t symbol = header.decode(reader);
+                if (symbol < 0 || reader.overrun()) return false;
+                if (symbol < 16) {
+                    code_lengths[index++] = static_cast<uint8_t>(symbol);
+                    continue;
+                }
+
+                uint8_t value = 0;
+                uint32_t repeat = 0;
+                if (symbol == 16) {
+                    if (index == 0) return false;
+                    value = code_lengths[index - 1];
+                    repeat = 3 + reader.read(2);
+                } else if (symbol == 17) {
+                    repeat = 3 + reader.read(3);
+                } else {
+                    repeat = 11 + reader.read(7);
+                }
+                if (index + repeat > literal_count + distance_count) return false;
+                std::fill(code_lengths + index, code_lengths + index + repeat, value);
+                index += repeat;
+            }
+            if (code_lengths[256] == 0) return false;
+
+            // the distance lengths follow the literals directly, move them to where the fixed layout has them
+            std::memmove(code_lengths + 288, code_lengths + literal_count, distance_count);
+            std::fill(code_lengths + literal_count, code_lengths + 288, uint8_t(0));
+        } else {
+            return false;
+        }
+
+        if (!lengths.build(code_lengths, literal_count) || !distances.build(code_lengths + 288, distance_count)) return false;
+        if (!InflateCodes(reader, lengths, distances, out, limit)) return false;
+    }
+    return !reader.overrun();
+}
+
+uint32_t Adler32(const uint8_t* data, size_t size) {
+    constexpr uint32_t MOD = 65521;
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (size > 0) {
+        // 5552 is the most bytes that cannot overflow b before the modulo
+        const size_t block = std::min<size_t>(size, 5552);
+        for (size_t i = 0; i < block; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= MOD;
+        b %= MOD;
+        data += block;
+        size -= block;
+    }
+    return (b << 16) | a;
+}
+
+uint32_t ReadBigEndian32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+uint8_t Paeth(uint8_t a, uint8_t b, uint8_t c) {
+    const int32_t p = int32_t(a) + int32_t(b) - int32_t(c);
+    const int32_t pa = std::abs(p - int32_t(a));
+    const int32_t pb = std::abs(p - int32_t(b));
+    const int32_t pc = std::abs(p - int32_t(c));
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+Image DecodePng(const uint8_t* data, size_t size) {
+    auto& logger = engine::core::debug::Logger::get_singleton();
+
+    uint32_t width = 0, height = 0;
+    uint8_t bit_depth = 0, color_type = 0, interlace = 0;
+    std::vector<uint8_t> idat;
+    uint8_t palette[256][4] = {};
+    uint32_t palette_size = 0;
+    bool has_key = false;
+    uint16_t key[3] = {};
+
+    // entries without a tRNS value are opaque
+    for (auto& entry : palette) entry[3] = 255;
+
+    size_t position = 8;
+    bool ended = false;
+    while (!ended && position + 8 <= size) {
+        const uint32_t length = ReadBigEndian32(data + position);
+        const uint8_t* type = data + position + 4;
+        const uint8_t* chunk = data + position + 8;
+        if (length > size - position - 8) break;
+
+        if (std::memcmp(type, "IHDR", 4) == 0 && length >= 13) {
+            width = ReadBigEndian32(chunk);
+            height = ReadBigEndian32(chunk + 4);
+            bit_depth = chunk[8];
+            color_type = chunk[9];
+            interlace = chunk[12];
+        } else if (std::memcmp(type, "PLTE", 4) == 0) {
+            palette_size = std::min<uint32_t>(length / 3, 256);
+            for (uint32_t p = 0; p < palette_size; ++p) {
+                palette[p][0] = chunk[3 * p];
+                palette[p][1] = chunk[3 * p + 1];
+                palette[p][2] = chunk[3 * p + 2];
+            }
+        } else if (std::memcmp(type, "tRNS", 4) == 0) {
+            if (color_type == 3) {
+                for (uint32_t p = 0; p < std::min<uint32_t>(length, 256); ++p) palette[p][3] = chunk[p];
+            } else if (color_type == 0 && length >= 2) {
+                has_key = true;
+                key[0] = static_cast<uint16_t>((chunk[0] << 8) | chunk[1]);
+            } else if (color_type == 2 && length >= 6) {
+                has_key = true;
+                for (size_t c = 0; c < 3; ++c) key[c] = static_cast<uint16_t>((chunk[2 * c] << 8) | chunk[2 * c + 1]);
+            }
+        } else if (std::memcmp(type, "IDAT", 4) == 0) {
+            idat.insert(idat.end(), chunk, chunk + length);
+        } else if (std::memcmp(type, "IEND", 4) == 0) {
+            ended = true;
+        }
+        position += 12 + static_cast<size_t>(length);
+    }
+
+    uint32_t channels = 0;
+    switch (color_type) {
+        case 0: channels = 1; break;
+        case 2: channels = 3; break;
+        case 3: channels = 1; break;
+        case 4: channels = 2; break;
+        case 6: channels = 4; break;
+        default: break;
+    }
+    const bool depth_valid = (bit_depth == 8 || bit_depth == 16) ||
+        ((color_type == 0 || color_type == 3) && (bit_depth == 1 || bit_depth == 2 || bit_depth == 4));
+    if (width == 0 || height == 0 || channels == 0 || !depth_valid || (color_type == 3 && bit_depth == 16)) {
+        logger.error("Unsupported png: {}x{}, color type {}, bit depth {}", width, height, color_type, bit_depth);
+        return {};
+    }
+    if (interlace != 0) {
+        logger.error("Interlaced png is not supported");
+        return {};
+    }
+    if (color_type == 3 && palette_size == 0) {
+        logger.error("Palette png has no PLTE chunk");
+        return {};
+    }
+
+    const size_t bits_per_pixel = static_cast<size_t>(channels) * bit_depth;
+    const size_t stride = (static_cast<size_t>(width) * bits_per_pixel + 7) / 8;
+    const size_t filter_bytes = std::max<size_t>(bits_per_pixel / 8, 1);
+    if (height > std::numeric_limits<size_t>::max() / (stride + 1)) {
+        logger.error("Unsupported png: {}x{} is too large", width, height);
+        return {};
+    }
+
+    // every row is a filter byte and stride bytes, a stream inflating to more than that is rejected as it
+    // happens. deflate expands at most about 1032 to 1, so a tiny file claiming huge dimensions cannot make
+    // the reserve large
+    const size_t raw_size = (stride + 1) * height;
+    std::vector<uint8_t> raw;
+    raw.reserve(std::min(raw_size, idat.size() * 1032));
+    if (!ZlibDecompress(idat.data(), idat.size(), raw, raw_size) || raw.size() < raw_size) {
+        logger.error("Corrupt png image data");
+        return {};
+    }
+
+    // filters run in place, each row against the already unfiltered one above
+    std::vector<uint8_t> zero_row(stride, 0);
+    for (uint32_t y = 0; y < height; ++y) {
+        uint8_t* row = raw.data() + y * (stride + 1);
+        const uint8_t filter = row[0];
+        uint8_t* current = row + 1;
+        const uint8_t* above = y == 0 ? zero_row.data() : raw.data() + (y - 1) * (stride + 1) + 1;
+
+        switch (filter) {
+            case 0: break;
+            case 1:
+                for (size_t i = filter_bytes; i < stride; ++i) current[i] = static_cast<uint8_t>(current[i] + current[i - filter_bytes]);
+                break;
+            case 2:
+                for (size_t i = 0; i < stride; ++i) current[i] = static_cast<uint8_t>(current[i] + above[i]);
+                break;
+            case 3:
+                for (size_t i = 0; i < stride; ++i) {
+                    const uint32_t left = i >= filter_bytes ? current[i - filter_bytes] : 0;
+                    current[i] = static_cast<uint8_t>(current[i] + ((left + above[i]) >> 1));
+                }
+                break;
+            case 4:
+                for (size_t i = 0; i < stride; ++i) {
+                    const uint8_t left = i >= filter_bytes ? current[i - filter_bytes] : 0;
+                    const uint8_t corner = i >= filter_bytes ? above[i - filter_bytes] : 0;
+                    current[i] = static_cast<uint8_t>(current[i] + Paeth(left, above[i], corner));
+                }
+                break;
+            default:
+                logger.error("Corrupt png filter type {}", filter);
+                return {};
+        }
+    }
+
+    Image image;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(static_cast<size_t>(width) * height * 4);
+
+    // samples scaled to 16 bits so the transparency key compares at the image's own depth
+    auto sample = [bit_depth](const uint8_t* row, size_t index) -> uint16_t {
+        if (bit_depth == 16) return static_cast<uint16_t>((row[2 * index] << 8) | row[2 * index + 1]);
+        if (bit_depth == 8) return row[index];
+        const size_t bit = index * bit_depth;
+        return static_cast<uint16_t>((row[bit / 8] >> (8 - bit_depth - bit % 8)) & ((1u << bit_depth) - 1));
+    };
+    auto to_8 = [bit_depth](uint16_t value) -> uint8_t {
+        if (bit_depth == 16) return static_cast<uint8_t>(value >> 8);
+        return static_cast<uint8_t>(value * 255u / ((1u << bit_depth) - 1));
+    };
+
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t* row = raw.data() + y * (stride + 1) + 1;
+        uint8_t* out = image.pixels.data() + static_cast<size_t>(y) * width * 4;
+        for (uint32_t x = 0; x < width; ++x, out += 4) {
+            if (color_type == 3) {
+                std::memcpy(out, palette[std::min<uint32_t>(sample(row, x), 255)], 4);
+            } else if (color_type == 0 || color_type == 4) {
+                const uint16_t gray = sample(row, static_cast<size_t>(x) * channels);
+                out[0] = out[1] = out[2] = to_8(gray);
+                out[3] = color_type == 4 ? to_8(sample(row, static_cast<size_t>(x) * channels + 1))
+                    : (has_key && gray == key[0] ? 0 : 255);
+            } else {
+                uint16_t rgb[3];
+                for (size_t c = 0; c < 3; ++c) {
+                    rgb[c] = sample(row, static_cast<size_t>(x) * channels + c);
+                    out[c] = to_8(rgb[c]);
+                }
+                out[3] = color_type == 6 ? to_8(sample(row, static_cast<size_t>(x) * channels + 3))
+                    : (has_key && rgb[0] == key[0] && rgb[1] == key[1] && rgb[2] == key[2] ? 0 : 255);
+            }
+        }
+    }
+    return image;
+}
+
+Image DecodeTga(const uint8_t* data, size_t size) {
+    auto& logger = engine::core::debug::Logger::get_singleton();
+    if (size < 18) return {};
+
+    const uint8_t id_length = data[0];
+    const uint8_t colormap_type = data[1];
+    const uint8_t image_type = data[2];
+    const uint16_t colormap_length = static_cast<uint16_t>(data[5] | (data[6] << 8));
+    const uint8_t colormap_depth = data[7];
+    const uint32_t width = static_cast<uint32_t>(data[12] | (data[13] << 8));
+    const uint32_t height = static_cast<uint32_t>(data[14] | (data[15] << 8));
+    const uint8_t depth = data[16];
+    const uint8_t descriptor = data[17];
+
+    const bool rle = image_type == 10 || image_type == 11;
+    const bool gray = image_type == 3 || image_type == 11;
+    const bool depth_valid = gray ? (depth == 8 || depth == 16) : (depth == 16 || depth == 24 || depth == 32);
+    if ((image_type != 2 && image_type != 3 && !rle) || !depth_valid || width == 0 || height == 0) {
+        logger.error("Unsupported tga: type {}, {} bits per pixel", image_type, depth);
+        return {};
+    }
+
+    size_t position = 18 + static_cast<size_t>(id_length);
+    if (colormap_type == 1) position += static_cast<size_t>(colormap_length) * ((colormap_depth + 7) / 8);
+
+    const size_t bytes_per_pixel = depth / 8;
+    const size_t pixel_count = static_cast<size_t>(width) * height;
+
+    // unpacked to the file's own pixel format first, rle packets may cross rows
+    std::vector<uint8_t> packed(pixel_count * bytes_per_pixel);
+    if (!rle) {
+        if (position + packed.size() > size) {
+            logger.error("Truncated tga image data");
+            return {};
+        }
+        std::memcpy(packed.data(), data + position, packed.size());
+    } else {
+        size_t pixel = 0;
+        while (pixel < pixel_count) {
+            if (position >= size) {
+                logger.error("Truncated tga image data");
+                return {};
+            }
+            const uint8_t header = data[position++];
+            const size_t count = std::min<size_t>((header & 0x7F) + 1, pixel_count - pixel);
+            if (header & 0x80) {
+                if (position + bytes_per_pixel > size) return {};
+                for (size_t i = 0; i < count; ++i) {
+                    std::memcpy(packed.data() + (pixel + i) * bytes_per_pixel, data + position, bytes_per_pixel);
+                }
+                position += bytes_per_pixel;
+            } else {
+                if (position + count * bytes_per_pixel > size) return {};
+                std::memcpy(packed.data() + pixel * bytes_per_pixel, data + position, count * bytes_per_pixel);
+                position += count * bytes_per_pixel;
+            }
+            pixel += count;
+        }
+    }
+
+    Image image;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(pixel_count * 4);
+
+    // rows are stored bottom up unless bit 5 of the descriptor says otherwise
+    const bool top_down = (descriptor & 0x20) != 0;
+    const bool has_alpha = (descriptor & 0x0F) != 0;
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint32_t source_y = top_down ? y : height - 1 - y;
+        const uint8_t* in = packed.data() + static_cast<size_t>(source_y) * width * bytes_per_pixel;
+        uint8_t* out = image.pixels.data() + static_cast<size_t>(y) * width * 4;
+        for (uint32_t x = 0; x < width; ++x, in += bytes_per_pixel, out += 4) {
+            if (gray) {
+                out[0] = out[1] = out[2] = in[0];
+                out[3] = depth == 16 ? in[1] : 255;
+            } else if (depth == 16) {
+                // a1r5g5b5, little endian
+                const uint16_t value = static_cast<uint16_t>(in[0] | (in[1] << 8));
+                out[0] = static_cast<uint8_t>(((value >> 10) & 0x1F) * 255 / 31);
+                out[1] = static_cast<uint8_t>(((value >> 5) & 0x1F) * 255 / 31);
+                out[2] = static_cast<uint8_t>((value & 0x1F) * 255 / 31);
+                out[3] = has_alpha && !(value & 0x8000) ? 0 : 255;
+            } else {
+                out[0] = in[2];
+                out[1] = in[1];
+                out[2] = in[0];
+                out[3] = depth == 32 ? in[3] : 255;
+            }
+        }
+    }
+    return image;
+}
+
+Image DecodePnm(const uint8_t* data, size_t size) {
+    auto& logger = engine::core::debug::Logger::get_singleton();
+
+    const bool color = data[1] == '6';
+    size_t position = 2;
+
+    // width, height and maxval, separated by whitespace and # comments, then exactly one whitespace byte
+    uint32_t fields[3] = {};
+    for (uint32_t& field : fields) {
+        for (;;) {
+            while (position < size && std::isspace(data[position])) ++position;
+            if (position < size && data[position] == '#') {
+                while (position < size && data[position] != '\n') ++position;
+                continue;
+            }
+            break;
+        }
+        if (position >= size || !std::isdigit(data[position])) {
+            logger.error("Malformed pnm header");
+            return {};
+        }
+        while (position < size && std::isdigit(data[position])) field = field * 10 + (data[position++] - '0');
+    }
+    ++position;
+
+    const uint32_t width = fields[0], height = fields[1], max_value = fields[2];
+    if (width == 0 || height == 0 || max_value == 0 || max_value > 65535) {
+        logger.error("Unsupported pnm: {}x{}, max value {}", width, height, max_value);
+        return {};
+    }
+
+    const size_t channels = color ? 3 : 1;
+    const size_t sample_bytes = max_value > 255 ? 2 : 1;
+    const size_t pixel_count = static_cast<size_t>(width) * height;
+    if (position > size || size - position < pixel_count * channels * sample_bytes) {
+        logger.error("Truncated pnm image data");
+        return {};
+    }
+
+    Image image;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(pixel_count * 4);
+
+    const uint8_t* in = data + position;
+    for (size_t p = 0; p < pixel_count; ++p) {
+        uint8_t* out = image.pixels.data() + p * 4;
+        for (size_t c = 0; c < channels; ++c, in += sample_bytes) {
+            const uint32_t value = sample_bytes == 2 ? (uint32_t(in[0]) << 8) | in[1] : in[0];
+            out[c] = static_cast<uint8_t>((std::min(value, max_value) * 255 + max_value / 2) / max_value);
+        }
+        if (!color) out[1] = out[2] = out[0];
+        out[3] = 255;
+    }
+    return image;
+}
+
+} // namespace
+
+bool ZlibDecompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out, size_t max_size) {
+    if (size < 6) return false;
+
+    // deflate with a window no larger than 32k, no preset dictionary, and a header that checks out
+    const uint8_t cmf = data[0];
+    const uint8_t flags = data[1];
+    if ((cmf & 0x0F) != 8 || (cmf >> 4) > 7 || (flags & 0x20) || ((cmf << 8) | flags) % 31 != 0) return false;
+
+    // the reader may look a few bytes past the last code, the trailing checksum keeps that in bounds
+    const size_t start = out.size();
+    const size_t limit = max_size > std::numeric_limits<size_t>::max() - start ? std::numeric_limits<size_t>::max() : start + max_size;
+    BitReader reader(data + 2, size - 2);
+    if (!Inflate(reader, out, limit)) return false;
+
+    return Adler32(out.data() + start, out.size() - start) == ReadBigEndian32(data + size - 4);
+}
+
+Image DecodeImage(const uint8_t* data, size_t size) {
+    static constexpr uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+    if (size >= 8 && std::memcmp(data, PNG_SIGNATURE, 8) == 0) return DecodePng(data, size);
+    if (size >= 3 && data[0] == 'P' && (data[1] == '5' || data[1] == '6')) return DecodePnm(data, size);
+    // tga has no signature, its header is checked field by field
+    if (size >= 18) return DecodeTga(data, size);
+
+    engine::core::debug::Logger::get_singleton().error("Unrecognized image format");
+    return {};
+}
+
+Image ReadImage(const std::string& filepath) {
+    MappedFile file(filepath);
+    if (!file.valid() || file.size() == 0) return {};
+
+    Image image = DecodeImage(reinterpret_cast<const uint8_t*>(file.data()), file.size());
+    if (image.empty()) engine::core::debug::Logger::get_singleton().error("Failed to decode image {}", filepath);
+    return image;
+}
+
+} // namespace engine::import
@@ -0,0 +1,34 @@
+#ifndef engine_import_IMAGE_HPP
+#define engine_import_IMAGE_HPP
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+namespace engine::import {
+
+// 8-bit rgba, rows top to bottom
+struct Image {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> pixels;
+
+    bool empty() const { return pixels.empty(); }
+};
+
+// png (8-bit, non-interlaced), tga (true color, grayscale and their rle variants) and binary pgm/ppm.
+// channels a format lacks are filled in: gray is spread over rgb and alpha is opaque.
+// logs and returns an empty image when the data is not one of those
+Image DecodeImage(const uint8_t* data, size_t size);
+Image ReadImage(const std::string& filepath);
+
+// zlib stream (rfc 1950) around deflate data (rfc 1951), appended to out. false on a malformed stream, a bad
+// checksum, or once it inflates to more than max_size bytes
+bool ZlibDecompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out,
+    size_t max_size = std::numeric_limits<size_t>::max());
+
+} // namespace engine::import
+
+#endif // engine_import_IMAGE_HPP
@@ -0,0 +1,145 @@
+#include "mapped_file.hpp"
+
+#include "engine/core/debug/logger.hpp"
+
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace engine::import {
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::string& filepath) {
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        core::debug::Logger::get_singleton().error("Failed to open {}", filepath);
+        return;
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) {
+        core::debug::Logger::get_singleton().error("Failed to stat {}", filepath);
+        CloseHandle(file);
+        return;
+    }
+
+    _file = file;
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size == 0) {
+        _valid = true;
+        return;
+    }
+
+    _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mapping) _data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!_data) {
+        core::debug::Logger::get_singleton().error("Failed to map {}", filepath);
+        unmap();
+        return;
+    }
+    _valid = true;
+}
+
+void MappedFile::unmap() {
+    if (_data) UnmapViewOfFile(_data);
+    if (_mapping) CloseHandle(static_cast<HANDLE>(_mapping));
+    if (_file) CloseHandle(static_cast<HANDLE>(_file));
+    _data = nullptr;
+    _mapping = nullptr;
+    _file = nullptr;
+    _size = 0;
+    _valid = false;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filepath) {
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        core::debug::Logger::get_singleton().error("Failed to open {}", filepath);
+        return;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        core::debug::Logger::get_singleton().error("Failed to stat {}", filepath);
+        close(fd);
+        return;
+    }
+
+    _size = static_cast<size_t>(info.st_size);
+    if (_size == 0) {
+        close(fd);
+        _valid = true;
+        return;
+    }
+
+    // the mapping keeps its own reference to the file
+    void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        core::debug::Logger::get_singleton().error("Failed to map {}", filepath);
+        _size = 0;
+        return;
+    }
+
+    // parsers read front to back
+    madvise(data, _size, MADV_SEQUENTIAL);
+
+    _data = static_cast<const char*>(data);
+    _valid = true;
+}
+
+void MappedFile::unmap() {
+    if (_data) munmap(const_cast<char*>(_data), _size);
+    _data = nullptr;
+    _size = 0;
+    _valid = false;
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data(std::exchange(other._data, nullptr)),
+      _size(std::exchange(other._size, 0)),
+      _valid(std::exchange(other._valid, false))
+#if defined(_WIN32)
+    , _file(std::exchange(other._file, nullptr)),
+      _mapping(std::exchange(other._mapping, nullptr))
+#endif
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+        _valid = std::exchange(other._valid, false);
+#if defined(_WIN32)
+        _file = std::exchange(other._file, nullptr);
+        _mapping = std::exchange(other._mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+} // namespace engine::import
@@ -0,0 +1,44 @@
+#ifndef engine_import_MAPPED_FILE_HPP
+#define engine_import_MAPPED_FILE_HPP
+
+#include <string>
+#include <cstddef>
+
+namespace engine::import {
+
+// read-only view of a whole file through the os page cache, nothing is copied until pages are touched
+class MappedFile {
+public:
+    MappedFile() = default;
+    // logs and stays invalid when the file cannot be opened or mapped
+    explicit MappedFile(const std::string& filepath);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    // an empty file is valid with a null data pointer
+    bool valid() const { return _valid; }
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    void unmap();
+
+    const char* _data = nullptr;
+    size_t _size = 0;
+    bool _valid = false;
+
+#if defined(_WIN32)
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif
+};
+
+} // namespace engine::import
+
+#endif // engine_import_MAPPED_FILE_HPP
@@ -1,13 +1,18 @@
 #ifndef engine_import_MESH_HPP
 #define engine_import_MESH_HPP
 
+#include "obj_parser.hpp"
+#include "mesh_bounds.hpp"
+
 #include "engine/core/debug/logger.hpp"
 
-#include <tiny_obj_loader.h>
 #include <glm/glm.hpp>
 
+#include <algorithm>
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <cstddef>
 
 namespace engine::import {
 
@@ -17,17 +22,55 @@ struct ObjVertex {
     glm::vec2 texcoord{};
 };
 
+// a coarser index list over the vertices of its mesh
+struct ObjLod {
+    std::vector<uint32_t> indices;
+    float error = 0.0f; // object space distance from the full detail surface
+};
+
+// position leads ObjVertex, so the vector path of ComputeMeshBounds applies
+inline MeshBounds ComputeMeshBounds(const std::vector<ObjVertex>& vertices) {
+    return ComputeMeshBounds(vertices.empty() ? nullptr : &vertices.front().position, vertices.size(), sizeof(ObjVertex));
+}
+
+// vertices are unique per (position, normal, texcoord) index tuple, indices reference them
 struct ObjMesh {
     std::string name;
     std::vector<ObjVertex> vertices;
     std::vector<uint32_t> indices;
+    std::vector<ObjLod> lods; // coarsest last, indices is the full detail level
+    MeshBounds bounds;
+
+    // level 0 is indices, levels past the coarsest repeat it
+    const std::vector<uint32_t>& lod_indices(size_t level) const {
+        return level == 0 || lods.empty() ? indices : lods[std::min(level, lods.size()) - 1].indices;
+    }
+    float lod_error(size_t level) const {
+        return level == 0 || lods.empty() ? 0.0f : lods[std::min(level, lods.size()) - 1].error;
+    }
 };
 
 struct ObjModel {
     std::vector<ObjMesh> meshes;
+
+    // the longest chain of any mesh, shorter ones stay at their coarsest for the remaining levels
+    size_t lod_count() const {
+        size_t count = 1;
+        for (const ObjMesh& mesh : meshes) count = std::max(count, mesh.lods.size() + 1);
+        return count;
+    }
 };
 
+// 16-bit indices halve index memory whenever every vertex is addressable by them
+constexpr bool FitsIndex16(size_t vertex_count) { return vertex_count <= UINT16_MAX + 1; }
+
+// maps the file and parses it on every core
 ObjModel ReadObj(const std::string& filepath);
+// same result through tinyobjloader's single threaded stream parser, kept as a reference
+ObjModel ReadObjTinyObj(const std::string& filepath);
+
+// logs parse throughput of the native parser, on all cores and on one, against tinyobjloader
+void BenchmarkObjImport(const std::string& filepath, uint32_t iterations = 3);
 
 } // namespace engine::import
 
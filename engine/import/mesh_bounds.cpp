@@ -0,0 +1,126 @@
+#include "mesh_bounds.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ENGINE_BOUNDS_SSE2 1
+#endif
+
+namespace engine::import {
+
+namespace {
+
+const glm::vec3& PositionAt(const glm::vec3* positions, size_t stride, size_t i) {
+    return *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const char*>(positions) + i * stride);
+}
+
+void BoxScalar(const glm::vec3* positions, size_t count, size_t stride, glm::vec3& min, glm::vec3& max) {
+    min = max = PositionAt(positions, stride, 0);
+    for (size_t i = 1; i < count; ++i) {
+        const glm::vec3& p = PositionAt(positions, stride, i);
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+}
+
+float RadiusSquaredScalar(const glm::vec3* positions, size_t first, size_t count, size_t stride, const glm::vec3& center) {
+    float radius_squared = 0.0f;
+    for (size_t i = first; i < count; ++i) {
+        glm::vec3 d = PositionAt(positions, stride, i) - center;
+        radius_squared = std::max(radius_squared, glm::dot(d, d));
+    }
+    return radius_squared;
+}
+
+#if defined(ENGINE_BOUNDS_SSE2)
+// a 16 byte load per position takes whatever follows it as w, which the box ignores
+__m128 LoadPosition(const glm::vec3* positions, size_t stride, size_t i) {
+    return _mm_loadu_ps(reinterpret_cast<const float*>(reinterpret_cast<const char*>(positions) + i * stride));
+}
+
+void BoxSse2(const glm::vec3* positions, size_t count, size_t stride, glm::vec3& min, glm::vec3& max) {
+    // two accumulator pairs so consecutive min/max do not wait on each other
+    __m128 min0 = LoadPosition(positions, stride, 0);
+    __m128 max0 = min0;
+    __m128 min1 = min0;
+    __m128 max1 = min0;
+
+    size_t i = 1;
+    for (; i + 2 <= count; i += 2) {
+        __m128 a = LoadPosition(positions, stride, i);
+        __m128 b = LoadPosition(positions, stride, i + 1);
+        min0 = _mm_min_ps(min0, a);
+        max0 = _mm_max_ps(max0, a);
+        min1 = _mm_min_ps(min1, b);
+        max1 = _mm_max_ps(max1, b);
+    }
+    if (i < count) {
+        __m128 a = LoadPosition(positions, stride, i);
+        min0 = _mm_min_ps(min0, a);
+        max0 = _mm_max_ps(max0, a);
+    }
+
+    alignas(16) float out_min[4];
+    alignas(16) float out_max[4];
+    _mm_store_ps(out_min, _mm_min_ps(min0, min1));
+    _mm_store_ps(out_max, _mm_max_ps(max0, max1));
+    min = glm::vec3(out_min[0], out_min[1], out_min[2]);
+    max = glm::vec3(out_max[0], out_max[1], out_max[2]);
+}
+
+// four positions transposed to x, y and z registers give four squared distances per step
+float RadiusSquaredSse2(const glm::vec3* positions, size_t count, size_t stride, const glm::vec3& center) {
+    const __m128 cx = _mm_set1_ps(center.x);
+    const __m128 cy = _mm_set1_ps(center.y);
+    const __m128 cz = _mm_set1_ps(center.z);
+    __m128 furthest = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 p0 = LoadPosition(positions, stride, i);
+        __m128 p1 = LoadPosition(positions, stride, i + 1);
+        __m128 p2 = LoadPosition(positions, stride, i + 2);
+        __m128 p3 = LoadPosition(positions, stride, i + 3);
+        _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+        __m128 dx = _mm_sub_ps(p0, cx);
+        __m128 dy = _mm_sub_ps(p1, cy);
+        __m128 dz = _mm_sub_ps(p2, cz);
+        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        furthest = _mm_max_ps(furthest, d2);
+    }
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, furthest);
+    float radius_squared = std::max({ lanes[0], lanes[1], lanes[2], lanes[3] });
+    return std::max(radius_squared, RadiusSquaredScalar(positions, i, count, stride, center));
+}
+#endif
+
+} // namespace
+
+MeshBounds ComputeMeshBounds(const glm::vec3* positions, size_t count, size_t stride) {
+    MeshBounds bounds;
+    if (count == 0 || positions == nullptr) return bounds;
+
+    float radius_squared;
+#if defined(ENGINE_BOUNDS_SSE2)
+    if (stride >= 4 * sizeof(float)) {
+        BoxSse2(positions, count, stride, bounds.min, bounds.max);
+        bounds.center = (bounds.min + bounds.max) * 0.5f;
+        radius_squared = RadiusSquaredSse2(positions, count, stride, bounds.center);
+    } else
+#endif
+    {
+        BoxScalar(positions, count, stride, bounds.min, bounds.max);
+        bounds.center = (bounds.min + bounds.max) * 0.5f;
+        radius_squared = RadiusSquaredScalar(positions, 0, count, stride, bounds.center);
+    }
+
+    bounds.radius = std::sqrt(radius_squared);
+    return bounds;
+}
+
+} // namespace engine::import
@@ -0,0 +1,25 @@
+#ifndef engine_import_MESH_BOUNDS_HPP
+#define engine_import_MESH_BOUNDS_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+namespace engine::import {
+
+// object space box and the sphere around its center
+struct MeshBounds {
+    glm::vec3 min{0.0f};
+    glm::vec3 max{0.0f};
+    glm::vec3 center{0.0f};
+    float radius = 0.0f;
+};
+
+// positions are stride bytes apart. with sse2 and a stride of at least 16 bytes the box is a vector min/max
+// reduction and the radius a max over four vertices at a time; the 4 bytes after every position are read then,
+// so they must belong to the same vertex. empty input gives empty bounds at the origin
+MeshBounds ComputeMeshBounds(const glm::vec3* positions, size_t count, size_t stride);
+
+} // namespace engine::import
+
+#endif // engine_import_MESH_BOUNDS_HPP
@@ -0,0 +1,239 @@
+#include "mesh_optimize.hpp"
+
+#include "engine/core/debug/assert.hpp"
+#include "engine/core/debug/logger.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace engine::import {
+
+namespace {
+
+// vertex -> triangles using it, as offsets into one flat array
+struct Adjacency {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> triangles;
+};
+
+Adjacency BuildAdjacency(const std::vector<uint32_t>& indices, size_t vertex_count) {
+    Adjacency adjacency;
+    adjacency.offsets.assign(vertex_count + 1, 0);
+    for (uint32_t index : indices) ++adjacency.offsets[index + 1];
+    std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+
+    adjacency.triangles.resize(indices.size());
+    std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        adjacency.triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+    return adjacency;
+}
+
+} // namespace
+
+VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size) {
+    VertexCacheStats stats;
+    if (indices.empty() || vertex_count == 0) return stats;
+
+    // a vertex is in the fifo while fewer than cache_size misses happened since it was last loaded
+    std::vector<uint64_t> loaded_at(vertex_count, 0);
+    std::vector<bool> seen(vertex_count, false);
+    uint64_t misses = 0;
+    size_t unique = 0;
+
+    for (uint32_t index : indices) {
+        ENGINE_ASSERT(index < vertex_count, "Index out of range in vertex cache analysis");
+        if (!seen[index]) {
+            seen[index] = true;
+            ++unique;
+        } else if (misses - loaded_at[index] < cache_size) {
+            continue;
+        }
+        ++misses;
+        loaded_at[index] = misses;
+    }
+
+    stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    stats.atvr = static_cast<float>(misses) / static_cast<float>(unique);
+    return stats;
+}
+
+void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertex_count, std::vector<uint32_t>* clusters, uint32_t cache_size) {
+    ENGINE_ASSERT(indices.size() % 3 == 0, "Vertex cache optimization requires a triangle list");
+    if (clusters) clusters->clear();
+    if (indices.empty()) return;
+
+    const size_t triangle_count = indices.size() / 3;
+    Adjacency adjacency = BuildAdjacency(indices, vertex_count);
+
+    std::vector<uint32_t> live(vertex_count);
+    for (size_t v = 0; v < vertex_count; ++v) live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+    std::vector<uint32_t> cache_time(vertex_count, 0);
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<uint32_t> dead_end;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    uint32_t time = cache_size + 1;
+    size_t scan = 0;
+
+    // a dead end restarts from the most recently used vertex that still has triangles, else from the next in input order
+    auto skip_dead_end = [&]() -> int64_t {
+        while (!dead_end.empty()) {
+            uint32_t v = dead_end.back();
+            dead_end.pop_back();
+            if (live[v] > 0) return v;
+        }
+        for (; scan < vertex_count; ++scan) {
+            if (live[scan] > 0) return static_cast<int64_t>(scan);
+        }
+        return -1;
+    };
+
+    int64_t fan = skip_dead_end();
+    bool restarted = true;
+
+    while (fan >= 0) {
+        if (restarted && clusters) clusters->push_back(static_cast<uint32_t>(output.size() / 3));
+
+        // emit every remaining triangle around the fanning vertex
+        candidates.clear();
+        for (uint32_t a = adjacency.offsets[fan]; a < adjacency.offsets[fan + 1]; ++a) {
+            uint32_t t = adjacency.triangles[a];
+            if (emitted[t]) continue;
+            emitted[t] = true;
+
+            for (uint32_t c = 0; c < 3; ++c) {
+                uint32_t v = indices[3 * t + c];
+                output.push_back(v);
+                dead_end.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (time - cache_time[v] > cache_size) cache_time[v] = time++;
+            }
+        }
+
+        // next fan is the candidate that stays cached longest once its remaining triangles are emitted
+        int64_t next = -1;
+        int64_t best = -1;
+        for (uint32_t v : candidates) {
+            if (live[v] == 0) continue;
+            int64_t priority = 0;
+            if (time - cache_time[v] + 2 * live[v] <= cache_size) priority = time - cache_time[v];
+            if (priority > best) {
+                best = priority;
+                next = v;
+            }
+        }
+
+        restarted = next < 0;
+        fan = restarted ? skip_dead_end() : next;
+    }
+
+    ENGINE_ASSERT(output.size() == indices.size(), "Vertex cache optimization lost triangles");
+    indices.swap(output);
+}
+
+void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<ObjVertex>& vertices,
+    const std::vector<uint32_t>& clusters, float threshold, uint32_t cache_size)
+{
+    const size_t triangle_count = indices.size() / 3;
+    if (clusters.size() < 2 || triangle_count == 0) return;
+
+    // area weighted centroid of the whole mesh
+    glm::vec3 mesh_centroid(0.0f);
+    float mesh_area = 0.0f;
+    for (size_t t = 0; t < triangle_count; ++t) {
+        const glm::vec3& a = vertices[indices[3 * t + 0]].position;
+        const glm::vec3& b = vertices[indices[3 * t + 1]].position;
+        const glm::vec3& c = vertices[indices[3 * t + 2]].position;
+        float area = glm::length(glm::cross(b - a, c - a));
+        mesh_centroid += (a + b + c) * (area / 3.0f);
+        mesh_area += area;
+    }
+    if (mesh_area > 0.0f) mesh_centroid /= mesh_area;
+
+    // a cluster facing away from the centroid occludes more than it is occluded, so it goes first
+    struct Cluster {
+        uint32_t first;
+        uint32_t count;
+        float sort_key;
+    };
+
+    std::vector<Cluster> sorted;
+    sorted.reserve(clusters.size());
+    for (size_t i = 0; i < clusters.size(); ++i) {
+        uint32_t first = clusters[i];
+        uint32_t end = (i + 1 < clusters.size()) ? clusters[i + 1] : static_cast<uint32_t>(triangle_count);
+
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+        float area_sum = 0.0f;
+        for (uint32_t t = first; t < end; ++t) {
+            const glm::vec3& a = vertices[indices[3 * t + 0]].position;
+            const glm::vec3& b = vertices[indices[3 * t + 1]].position;
+            const glm::vec3& c = vertices[indices[3 * t + 2]].position;
+            glm::vec3 scaled_normal = glm::cross(b - a, c - a);
+            float area = glm::length(scaled_normal);
+            centroid += (a + b + c) * (area / 3.0f);
+            normal += scaled_normal;
+            area_sum += area;
+        }
+        if (area_sum > 0.0f) centroid /= area_sum;
+
+        sorted.push_back(Cluster{ first, end - first, glm::dot(centroid - mesh_centroid, normal) });
+    }
+
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](const Cluster& a, const Cluster& b) { return a.sort_key > b.sort_key; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (const Cluster& cluster : sorted) {
+        output.insert(output.end(), indices.begin() + 3 * cluster.first, indices.begin() + 3 * (cluster.first + cluster.count));
+    }
+
+    // cluster seams cost a few cache misses each, keep the cache order if that cost is too high
+    float before = AnalyzeVertexCache(indices, vertices.size(), cache_size).acmr;
+    float after = AnalyzeVertexCache(output, vertices.size(), cache_size).acmr;
+    if (after <= before * threshold) indices.swap(output);
+}
+
+void OptimizeVertexFetch(std::vector<ObjVertex>& vertices, std::vector<uint32_t>& indices) {
+    constexpr uint32_t UNUSED = UINT32_MAX;
+
+    std::vector<uint32_t> remap(vertices.size(), UNUSED);
+    std::vector<ObjVertex> reordered;
+    reordered.reserve(vertices.size());
+
+    for (uint32_t& index : indices) {
+        if (remap[index] == UNUSED) {
+            remap[index] = static_cast<uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices.swap(reordered);
+}
+
+void OptimizeMesh(ObjMesh& mesh) {
+    if (mesh.indices.size() < 3) return;
+
+    VertexCacheStats before = AnalyzeVertexCache(mesh.indices, mesh.vertices.size());
+
+    std::vector<uint32_t> clusters;
+    OptimizeVertexCache(mesh.indices, mesh.vertices.size(), &clusters);
+    OptimizeOverdraw(mesh.indices, mesh.vertices, clusters);
+    OptimizeVertexFetch(mesh.vertices, mesh.indices);
+
+    VertexCacheStats after = AnalyzeVertexCache(mesh.indices, mesh.vertices.size());
+
+    engine::core::debug::Logger::get_singleton().info("Optimized {}: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f} ({} clusters)",
+        mesh.name, before.acmr, after.acmr, before.atvr, after.atvr, clusters.size());
+}
+
+} // namespace engine::import
@@ -0,0 +1,43 @@
+#ifndef engine_import_MESH_OPTIMIZE_HPP
+#define engine_import_MESH_OPTIMIZE_HPP
+
+#include "mesh.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace engine::import {
+
+// a fifo of this many entries stands in for the post-transform cache; real hardware varies but
+// orderings tuned for 16 hold up well on both smaller and larger caches
+constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+struct VertexCacheStats {
+    float acmr = 0.0f; // vertices transformed per triangle, 0.5 is ideal on large meshes and 3 the worst
+    float atvr = 0.0f; // vertices transformed per unique vertex, 1 is ideal
+};
+
+// simulates the fifo cache over an indexed triangle list
+VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertex_count, uint32_t cache_size = VERTEX_CACHE_SIZE);
+
+// reorders triangles for the post-transform cache with tipsify (sander et al. 2007); fills clusters with the
+// first triangle of every run that had to restart from a dead end, the natural split points for overdraw
+void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertex_count,
+    std::vector<uint32_t>* clusters = nullptr, uint32_t cache_size = VERTEX_CACHE_SIZE);
+
+// sorts the clusters of a cache-optimized list so outward facing ones draw first, which lets early depth
+// reject more of the rest from any view; the result is dropped if acmr grows by more than threshold
+void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<ObjVertex>& vertices,
+    const std::vector<uint32_t>& clusters, float threshold = 1.05f, uint32_t cache_size = VERTEX_CACHE_SIZE);
+
+// renumbers vertices in the order the index list first uses them so fetches walk memory forward,
+// unreferenced vertices are dropped
+void OptimizeVertexFetch(std::vector<ObjVertex>& vertices, std::vector<uint32_t>& indices);
+
+// runs the three passes above in order and logs acmr and atvr before and after
+void OptimizeMesh(ObjMesh& mesh);
+
+} // namespace engine::import
+
+#endif // engine_import_MESH_OPTIMIZE_HPP
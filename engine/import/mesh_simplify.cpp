@@ -0,0 +1,286 @@
+#include "mesh_simplify.hpp"
+#include "mesh_optimize.hpp"
+
+#include "engine/core/memory/hash.hpp"
+
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace engine::import {
+
+namespace {
+
+// sum of squared distances to a set of planes, weighted by the area of the triangles they came from
+struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0;
+    double b2 = 0, bc = 0, bd = 0;
+    double c2 = 0, cd = 0;
+    double d2 = 0;
+    double weight = 0;
+
+    void add_plane(const glm::vec3& n, float d, double w) {
+        a2 += w * n.x * n.x; ab += w * n.x * n.y; ac += w * n.x * n.z; ad += w * n.x * d;
+        b2 += w * n.y * n.y; bc += w * n.y * n.z; bd += w * n.y * d;
+        c2 += w * n.z * n.z; cd += w * n.z * d;
+        d2 += w * d * d;
+        weight += w;
+    }
+
+    Quadric& operator+=(const Quadric& q) {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+        weight += q.weight;
+        return *this;
+    }
+
+    double evaluate(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a2 * x * x + b2 * y * y + c2 * z * z
+            + 2.0 * (ab * x * y + ac * x * z + bc * y * z)
+            + 2.0 * (ad * x + bd * y + cd * z)
+            + d2;
+        return std::max(e, 0.0);
+    }
+};
+
+struct PositionKey {
+    glm::vec3 position;
+
+    bool operator==(const PositionKey& other) const noexcept {
+        return position.x == other.position.x && position.y == other.position.y && position.z == other.position.z;
+    }
+};
+
+struct PositionKeyHash {
+    size_t operator()(const PositionKey& key) const noexcept {
+        return static_cast<size_t>(core::memory::Hash64(&key.position, sizeof(key.position)));
+    }
+};
+
+// from moves onto to, cost is the mean squared distance of the merged quadric at to
+struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    double cost;
+};
+
+uint64_t EdgeKey(uint32_t a, uint32_t b) {
+    return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+}
+
+} // namespace
+
+std::vector<uint32_t> SimplifyMesh(const std::vector<ObjVertex>& vertices, const std::vector<uint32_t>& indices,
+    size_t target_index_count, float max_error, float* error) {
+    std::vector<uint32_t> result = indices;
+    if (error) *error = 0.0f;
+    if (indices.size() <= target_index_count || indices.size() % 3 != 0) return result;
+
+    // collapses work on positions, so vertices split only by their normal or uv move together
+    std::vector<uint32_t> position_of(vertices.size());
+    std::vector<glm::vec3> positions;
+    {
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> welded;
+        welded.reserve(vertices.size());
+        for (size_t v = 0; v < vertices.size(); ++v) {
+            auto [it, inserted] = welded.try_emplace(PositionKey{ vertices[v].position }, static_cast<uint32_t>(positions.size()));
+            if (inserted) positions.push_back(vertices[v].position);
+            position_of[v] = it->second;
+        }
+    }
+    const size_t position_count = positions.size();
+    const size_t triangle_count = indices.size() / 3;
+
+    std::vector<std::vector<uint32_t>> vertices_at(position_count);
+    for (size_t v = 0; v < vertices.size(); ++v) vertices_at[position_of[v]].push_back(static_cast<uint32_t>(v));
+
+    // seams carry more than one vertex, borders and non-manifold edges are not shared by exactly two triangles
+    std::vector<uint8_t> locked(position_count, 0);
+    for (size_t p = 0; p < position_count; ++p) locked[p] = vertices_at[p].size() > 1;
+    {
+        std::unordered_map<uint64_t, uint32_t> edge_uses;
+        edge_uses.reserve(indices.size());
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (size_t e = 0; e < 3; ++e) {
+                uint32_t a = position_of[indices[i + e]];
+                uint32_t b = position_of[indices[i + (e + 1) % 3]];
+                if (a != b) ++edge_uses[EdgeKey(a, b)];
+            }
+        }
+        for (const auto& [key, uses] : edge_uses) {
+            if (uses == 2) continue;
+            locked[key >> 32] = 1;
+            locked[key & 0xFFFFFFFFu] = 1;
+        }
+    }
+
+    std::vector<Quadric> quadrics(position_count);
+    std::vector<std::vector<uint32_t>> triangles_at(position_count);
+    for (size_t t = 0; t < triangle_count; ++t) {
+        uint32_t p[3] = { position_of[indices[3 * t]], position_of[indices[3 * t + 1]], position_of[indices[3 * t + 2]] };
+        for (size_t c = 0; c < 3; ++c) {
+            if (c == 0 || (p[c] != p[0] && (c == 1 || p[c] != p[1]))) triangles_at[p[c]].push_back(static_cast<uint32_t>(t));
+        }
+
+        glm::vec3 n = glm::cross(positions[p[1]] - positions[p[0]], positions[p[2]] - positions[p[0]]);
+        float length = glm::length(n);
+        if (length <= 0.0f) continue;
+        n /= length;
+        float d = -glm::dot(n, positions[p[0]]);
+        for (uint32_t corner : p) quadrics[corner].add_plane(n, d, 0.5 * length);
+    }
+
+    std::vector<uint8_t> alive(triangle_count, 1);
+    auto corner_position = [&](uint32_t t, size_t c) { return position_of[result[3 * t + c]]; };
+    auto has_position = [&](uint32_t t, uint32_t p) {
+        return corner_position(t, 0) == p || corner_position(t, 1) == p || corner_position(t, 2) == p;
+    };
+
+    auto collapse_cost = [&](uint32_t from, uint32_t to) {
+        Quadric q = quadrics[from];
+        q += quadrics[to];
+        return q.weight > 0.0 ? q.evaluate(positions[to]) / q.weight : 0.0;
+    };
+
+    // a collapse is fine unless a surviving triangle around from turns over
+    auto keeps_orientation = [&](uint32_t from, uint32_t to) {
+        for (uint32_t t : triangles_at[from]) {
+            if (!alive[t] || has_position(t, to)) continue;
+            glm::vec3 before[3], after[3];
+            for (size_t c = 0; c < 3; ++c) {
+                uint32_t p = corner_position(t, c);
+                before[c] = positions[p];
+                after[c] = positions[p == from ? to : p];
+            }
+            glm::vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+            glm::vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+            if (glm::dot(n0, n1) <= 0.0f) return false;
+        }
+        return true;
+    };
+
+    // on a seam the vertex with the closest attributes takes over the corner
+    auto target_vertex = [&](uint32_t vertex, uint32_t to) {
+        const std::vector<uint32_t>& candidates = vertices_at[to];
+        uint32_t best = candidates.front();
+        float best_distance = std::numeric_limits<float>::max();
+        for (uint32_t candidate : candidates) {
+            glm::vec3 dn = vertices[candidate].normal - vertices[vertex].normal;
+            glm::vec2 dt = vertices[candidate].texcoord - vertices[vertex].texcoord;
+            float distance = glm::dot(dn, dn) + glm::dot(dt, dt);
+            if (distance < best_distance) {
+                best_distance = distance;
+                best = candidate;
+            }
+        }
+        return best;
+    };
+
+    size_t index_count = indices.size();
+    const double max_cost = static_cast<double>(max_error) * static_cast<double>(max_error);
+    double worst_cost = 0.0;
+    std::vector<Collapse> collapses;
+    std::vector<uint8_t> touched(position_count);
+
+    // each pass sorts every candidate edge and takes the cheapest ones whose neighbourhoods do not overlap,
+    // so costs stay exact without a priority queue that needs updating
+    while (index_count > target_index_count) {
+        collapses.clear();
+        for (uint32_t t = 0; t < triangle_count; ++t) {
+            if (!alive[t]) continue;
+            for (size_t e = 0; e < 3; ++e) {
+                uint32_t a = corner_position(t, e);
+                uint32_t b = corner_position(t, (e + 1) % 3);
+                if (a == b || (locked[a] && locked[b])) continue;
+
+                double ab = locked[a] ? std::numeric_limits<double>::max() : collapse_cost(a, b);
+                double ba = locked[b] ? std::numeric_limits<double>::max() : collapse_cost(b, a);
+                collapses.push_back(ab <= ba ? Collapse{ a, b, ab } : Collapse{ b, a, ba });
+            }
+        }
+        if (collapses.empty()) break;
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+        // a collapse removes about two triangles, taking more than the remainder needs per pass would
+        // spend the budget on whatever happened to sort first
+        const size_t pass_limit = (index_count - target_index_count) / 6 + 1;
+        size_t collapsed = 0;
+        std::fill(touched.begin(), touched.end(), 0);
+
+        for (const Collapse& collapse : collapses) {
+            if (collapse.cost > max_cost) break;
+            if (touched[collapse.from] || touched[collapse.to]) continue;
+            if (!keeps_orientation(collapse.from, collapse.to)) continue;
+
+            for (uint32_t t : triangles_at[collapse.from]) {
+                if (!alive[t]) continue;
+                if (has_position(t, collapse.to)) {
+                    alive[t] = 0;
+                    index_count -= 3;
+                    continue;
+                }
+                for (size_t c = 0; c < 3; ++c) {
+                    uint32_t& vertex = result[3 * t + c];
+                    if (position_of[vertex] == collapse.from) vertex = target_vertex(vertex, collapse.to);
+                }
+                triangles_at[collapse.to].push_back(t);
+            }
+            triangles_at[collapse.from].clear();
+            quadrics[collapse.to] += quadrics[collapse.from];
+
+            // the neighbours' costs changed, they wait for the next pass
+            for (uint32_t t : triangles_at[collapse.to]) {
+                if (!alive[t]) continue;
+                for (size_t c = 0; c < 3; ++c) touched[corner_position(t, c)] = 1;
+            }
+            touched[collapse.from] = 1;
+
+            worst_cost = std::max(worst_cost, collapse.cost);
+            if (index_count <= target_index_count || ++collapsed >= pass_limit) break;
+        }
+        if (collapsed == 0) break;
+    }
+
+    size_t write = 0;
+    for (size_t t = 0; t < triangle_count; ++t) {
+        if (!alive[t]) continue;
+        for (size_t c = 0; c < 3; ++c) result[write++] = result[3 * t + c];
+    }
+    result.resize(write);
+
+    if (error) *error = static_cast<float>(std::sqrt(worst_cost));
+    return result;
+}
+
+void GenerateLods(ObjMesh& mesh, const LodSettings& settings) {
+    mesh.lods.clear();
+    if (settings.max_lods <= 1) return;
+    mesh.lods.reserve(settings.max_lods - 1);
+
+    float error = 0.0f;
+    for (uint32_t level = 1; level < settings.max_lods; ++level) {
+        const std::vector<uint32_t>& source = mesh.lods.empty() ? mesh.indices : mesh.lods.back().indices;
+        size_t target = static_cast<size_t>(static_cast<float>(source.size() / 3) * settings.reduction) * 3;
+        if (target < settings.min_triangles * 3) break;
+
+        float level_error = 0.0f;
+        std::vector<uint32_t> lod = SimplifyMesh(mesh.vertices, source, target, std::numeric_limits<float>::max(), &level_error);
+        if (lod.empty() || static_cast<float>(lod.size()) > static_cast<float>(source.size()) * settings.min_progress) break;
+
+        OptimizeVertexCache(lod, mesh.vertices.size());
+        // errors add up along the chain, each level only knows its distance from the one before
+        error += level_error;
+        mesh.lods.push_back(ObjLod{ std::move(lod), error });
+    }
+
+    if (!mesh.lods.empty()) {
+        engine::core::debug::Logger::get_singleton().info("Generated {} lods for {}: {} -> {} triangles, error {:.4f}",
+            mesh.lods.size(), mesh.name, mesh.indices.size() / 3, mesh.lods.back().indices.size() / 3, mesh.lods.back().error);
+    }
+}
+
+} // namespace engine::import
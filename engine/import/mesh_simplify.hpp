@@ -0,0 +1,34 @@
+#ifndef engine_import_MESH_SIMPLIFY_HPP
+#define engine_import_MESH_SIMPLIFY_HPP
+
+#include "mesh.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace engine::import {
+
+struct LodSettings {
+    uint32_t max_lods = 5;          // including the full detail mesh
+    float reduction = 0.35f;        // target triangle count of each level relative to the one before
+    size_t min_triangles = 32;      // levels below this are not worth a draw of their own
+    // a level that keeps more than this share of the previous one's triangles is stuck on locked vertices
+    float min_progress = 0.85f;
+};
+
+// collapses edges in order of quadric error (garland and heckbert 1997) until the list is down to
+// target_index_count or the next collapse would move the surface further than max_error; returns a new
+// index list over the same vertices. vertices on borders, normal or uv seams and non-manifold edges stay
+// put, so seams do not tear and neighbouring tiles stay watertight. error gets the object space distance
+// the result strays from the input
+std::vector<uint32_t> SimplifyMesh(const std::vector<ObjVertex>& vertices, const std::vector<uint32_t>& indices,
+    size_t target_index_count, float max_error, float* error = nullptr);
+
+// fills mesh.lods with successively coarser index lists, each simplified from the one before and cache
+// optimized; run after OptimizeMesh so every level shares its vertex order
+void GenerateLods(ObjMesh& mesh, const LodSettings& settings = {});
+
+} // namespace engine::import
+
+#endif // engine_import_MESH_SIMPLIFY_HPP
@@ -0,0 +1,364 @@
+#include "meshlet.hpp"
+
+#include "engine/core/renderer/meshlet_culling.hpp"
+#include "engine/core/debug/assert.hpp"
+#include "engine/core/debug/logger.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <cmath>
+
+namespace engine::import {
+
+namespace {
+
+// how much a quarter turn away from the meshlet's average normal counts against a triangle, in new vertices
+constexpr float CONE_WEIGHT = 0.5f;
+// cones wider than this are useless for culling, they are stored as never culled
+constexpr float MIN_CONE_SPREAD = 0.1f;
+
+// ritter's sphere: start from two far apart points and grow to take in the rest
+void BoundSphere(const std::vector<glm::vec3>& points, glm::vec3& center, float& radius) {
+    auto farthest = [&points](const glm::vec3& from) {
+        size_t best = 0;
+        float best_distance = -1.0f;
+        for (size_t i = 0; i < points.size(); ++i) {
+            glm::vec3 d = points[i] - from;
+            float distance = glm::dot(d, d);
+            if (distance > best_distance) {
+                best_distance = distance;
+                best = i;
+            }
+        }
+        return points[best];
+    };
+
+    glm::vec3 a = farthest(points.front());
+    glm::vec3 b = farthest(a);
+    center = (a + b) * 0.5f;
+    radius = glm::length(b - a) * 0.5f;
+
+    for (const glm::vec3& p : points) {
+        float distance = glm::length(p - center);
+        if (distance <= radius) continue;
+        float grown = (radius + distance) * 0.5f;
+        center = center + (p - center) * ((grown - radius) / distance);
+        radius = grown;
+    }
+}
+
+MeshletBounds ComputeBounds(const std::vector<ObjVertex>& vertices, const Meshlets& out, const Meshlet& meshlet) {
+    std::vector<glm::vec3> points;
+    points.reserve(meshlet.vertex_count);
+    for (uint32_t i = 0; i < meshlet.vertex_count; ++i) points.push_back(vertices[out.vertices[meshlet.vertex_offset + i]].position);
+
+    MeshletBounds bounds{};
+    BoundSphere(points, bounds.center, bounds.radius);
+
+    // unit face normals, and a point on each face's plane
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec3> corners;
+    glm::vec3 axis(0.0f);
+    for (uint32_t t = 0; t < meshlet.triangle_count; ++t) {
+        const uint8_t* local = &out.triangles[meshlet.triangle_offset + 3 * t];
+        glm::vec3 p0 = points[local[0]];
+        glm::vec3 n = glm::cross(points[local[1]] - p0, points[local[2]] - p0);
+        float length = glm::length(n);
+        if (length <= 0.0f) continue;
+        n = n * (1.0f / length);
+        normals.push_back(n);
+        corners.push_back(p0);
+        axis += n;
+    }
+
+    bounds.cone_axis = glm::vec3(0.0f, 0.0f, 1.0f);
+    bounds.cone_cutoff = 1.0f;
+    bounds.cone_apex = bounds.center;
+
+    float axis_length = glm::length(axis);
+    if (axis_length <= 0.0f) return bounds;
+    axis = axis * (1.0f / axis_length);
+
+    float min_dot = 1.0f;
+    for (const glm::vec3& n : normals) min_dot = std::min(min_dot, glm::dot(n, axis));
+    bounds.cone_axis = axis;
+    if (min_dot <= MIN_CONE_SPREAD) return bounds;
+
+    // slide the apex back along the axis until it is behind every face, so the test holds for any viewpoint
+    // and not just distant ones
+    float max_t = 0.0f;
+    for (size_t i = 0; i < normals.size(); ++i) {
+        float t = glm::dot(bounds.center - corners[i], normals[i]) / glm::dot(axis, normals[i]);
+        max_t = std::max(max_t, t);
+    }
+    bounds.cone_apex = bounds.center - axis * max_t;
+    bounds.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+    return bounds;
+}
+
+} // namespace
+
+Meshlets BuildMeshlets(const std::vector<ObjVertex>& vertices, const std::vector<uint32_t>& indices,
+    uint32_t max_vertices, uint32_t max_triangles) {
+    ENGINE_ASSERT(max_vertices >= 3 && max_vertices <= 256, "Meshlet vertex limit must fit a byte index");
+    ENGINE_ASSERT(max_triangles >= 1, "Meshlet triangle limit must be positive");
+
+    Meshlets out;
+    const size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) return out;
+
+    // vertex -> triangles using it, as offsets into one flat array
+    std::vector<uint32_t> offsets(vertices.size() + 1, 0);
+    for (uint32_t index : indices) ++offsets[index + 1];
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i) adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<glm::vec3> face_normals(triangle_count, glm::vec3(0.0f));
+    for (size_t t = 0; t < triangle_count; ++t) {
+        const glm::vec3& p0 = vertices[indices[3 * t]].position;
+        glm::vec3 n = glm::cross(vertices[indices[3 * t + 1]].position - p0, vertices[indices[3 * t + 2]].position - p0);
+        float length = glm::length(n);
+        if (length > 0.0f) face_normals[t] = n * (1.0f / length);
+    }
+
+    std::vector<int32_t> local(vertices.size(), -1);
+    std::vector<uint8_t> emitted(triangle_count, 0);
+    std::vector<uint32_t> candidate_of(triangle_count, UINT32_MAX);     // meshlet that last queued the triangle
+    std::vector<uint32_t> candidates;
+
+    Meshlet current{ 0, 0, 0, 0 };
+    glm::vec3 normal_sum(0.0f);
+    size_t scan = 0;
+
+    auto new_vertices = [&](size_t t) {
+        uint32_t count = 0;
+        for (size_t c = 0; c < 3; ++c) count += local[indices[3 * t + c]] < 0;
+        return count;
+    };
+
+    auto finish = [&]() {
+        if (current.triangle_count == 0) return;
+        for (uint32_t i = 0; i < current.vertex_count; ++i) local[out.vertices[current.vertex_offset + i]] = -1;
+        while (out.triangles.size() % 4 != 0) out.triangles.push_back(0);
+
+        out.bounds.push_back(ComputeBounds(vertices, out, current));
+        out.meshlets.push_back(current);
+        current = Meshlet{ static_cast<uint32_t>(out.vertices.size()), static_cast<uint32_t>(out.triangles.size()), 0, 0 };
+        normal_sum = glm::vec3(0.0f);
+        candidates.clear();
+    };
+
+    auto add = [&](size_t t) {
+        for (size_t c = 0; c < 3; ++c) {
+            uint32_t vertex = indices[3 * t + c];
+            if (local[vertex] < 0) {
+                local[vertex] = static_cast<int32_t>(current.vertex_count++);
+                out.vertices.push_back(vertex);
+            }
+            out.triangles.push_back(static_cast<uint8_t>(local[vertex]));
+        }
+        ++current.triangle_count;
+        emitted[t] = 1;
+        normal_sum += face_normals[t];
+
+        const uint32_t meshlet_index = static_cast<uint32_t>(out.meshlets.size());
+        for (size_t c = 0; c < 3; ++c) {
+            uint32_t vertex = indices[3 * t + c];
+            for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; ++i) {
+                uint32_t neighbour = adjacency[i];
+                if (emitted[neighbour] || candidate_of[neighbour] == meshlet_index) continue;
+                candidate_of[neighbour] = meshlet_index;
+                candidates.push_back(neighbour);
+            }
+        }
+    };
+
+    for (;;) {
+        std::erase_if(candidates, [&](uint32_t t) { return emitted[t] != 0; });
+
+        glm::vec3 average = normal_sum;
+        float average_length = glm::length(average);
+        if (average_length > 0.0f) average = average * (1.0f / average_length);
+
+        size_t best = SIZE_MAX;
+        float best_score = std::numeric_limits<float>::max();
+        for (uint32_t t : candidates) {
+            uint32_t added = new_vertices(t);
+            if (current.vertex_count + added > max_vertices) continue;
+            float score = static_cast<float>(added) + CONE_WEIGHT * (1.0f - glm::dot(face_normals[t], average));
+            if (score < best_score) {
+                best_score = score;
+                best = t;
+            }
+        }
+
+        if (best == SIZE_MAX) {
+            // neighbours left that do not fit means the meshlet is out of vertices
+            if (!candidates.empty()) {
+                finish();
+                continue;
+            }
+
+            // the neighbourhood ran out, carry on from the next triangle in index order, which the cache
+            // optimizer left close by
+            while (scan < triangle_count && emitted[scan]) ++scan;
+            if (scan == triangle_count) break;
+            if (current.vertex_count + new_vertices(scan) > max_vertices) finish();
+            best = scan;
+        }
+
+        add(best);
+        if (current.triangle_count == max_triangles) finish();
+    }
+    finish();
+
+    return out;
+}
+
+Meshlets BuildMeshlets(const ObjModel& model) {
+    Meshlets out;
+    uint32_t base_vertex = 0;
+    for (const ObjMesh& mesh : model.meshes) {
+        if (mesh.indices.empty()) continue;
+
+        Meshlets built = BuildMeshlets(mesh.vertices, mesh.indices);
+        const uint32_t vertex_offset = static_cast<uint32_t>(out.vertices.size());
+        const uint32_t triangle_offset = static_cast<uint32_t>(out.triangles.size());
+        for (Meshlet meshlet : built.meshlets) {
+            meshlet.vertex_offset += vertex_offset;
+            meshlet.triangle_offset += triangle_offset;
+            out.meshlets.push_back(meshlet);
+        }
+        out.bounds.insert(out.bounds.end(), built.bounds.begin(), built.bounds.end());
+        for (uint32_t vertex : built.vertices) out.vertices.push_back(base_vertex + vertex);
+        out.triangles.insert(out.triangles.end(), built.triangles.begin(), built.triangles.end());
+
+        base_vertex += static_cast<uint32_t>(mesh.vertices.size());
+    }
+
+    if (!out.empty()) {
+        size_t triangles = 0;
+        for (const Meshlet& meshlet : out.meshlets) triangles += meshlet.triangle_count;
+        engine::core::debug::Logger::get_singleton().info("Built {} meshlets, {:.1f} triangles and {:.1f} vertices each",
+            out.meshlets.size(), static_cast<double>(triangles) / static_cast<double>(out.meshlets.size()),
+            static_cast<double>(out.vertices.size()) / static_cast<double>(out.meshlets.size()));
+    }
+    return out;
+}
+
+bool CheckMeshletCulling(uint32_t iterations, uint32_t seed) {
+    std::mt19937 random(seed);
+    auto uniform = [&random](float low, float high) { return std::uniform_real_distribution<float>(low, high)(random); };
+    auto direction = [&uniform]() {
+        glm::vec3 d(0.0f);
+        while (glm::dot(d, d) < 1e-4f) d = glm::vec3(uniform(-1.0f, 1.0f), uniform(-1.0f, 1.0f), uniform(-1.0f, 1.0f));
+        return glm::normalize(d);
+    };
+
+    uint64_t backfacing = 0, culled_backfacing = 0;
+    core::renderer::MeshletCullStats totals;
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        // a bumpy uv sphere, closed and consistently wound but with folds that face away from its center
+        const uint32_t rings = 8 + random() % 40;
+        const uint32_t segments = 8 + random() % 40;
+        const float bumpiness = uniform(0.0f, 0.4f);
+        std::vector<ObjVertex> vertices;
+        for (uint32_t r = 0; r <= rings; ++r) {
+            float theta = 3.14159265f * static_cast<float>(r) / static_cast<float>(rings);
+            for (uint32_t s = 0; s <= segments; ++s) {
+                float phi = 6.2831853f * static_cast<float>(s) / static_cast<float>(segments);
+                glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+                vertices.push_back(ObjVertex{ normal * (1.0f + uniform(-bumpiness, bumpiness)), normal, glm::vec2(0.0f) });
+            }
+        }
+        std::vector<uint32_t> indices;
+        for (uint32_t r = 0; r < rings; ++r) {
+            for (uint32_t s = 0; s < segments; ++s) {
+                uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+                indices.insert(indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+            }
+        }
+        const Meshlets meshlets = BuildMeshlets(vertices, indices);
+
+        // rotated, non-uniformly scaled and moved, never mirrored since the cone test assumes it is not
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(uniform(-3.0f, 3.0f), uniform(-3.0f, 3.0f), uniform(-3.0f, 3.0f)));
+        model = glm::rotate(model, uniform(0.0f, 6.2831853f), direction());
+        model = glm::scale(model, glm::vec3(uniform(0.2f, 3.0f), uniform(0.2f, 3.0f), uniform(0.2f, 3.0f)));
+
+        const glm::vec3 camera = direction() * uniform(2.0f, 12.0f);
+        const glm::vec3 target = glm::vec3(model[3]) + direction() * uniform(0.0f, 4.0f);
+        const glm::mat4 view = glm::lookAt(camera, target, std::abs(glm::normalize(target - camera).y) > 0.99f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0));
+        const glm::mat4 projection = glm::perspective(uniform(0.3f, 1.6f), uniform(0.5f, 2.0f), 0.1f, uniform(5.0f, 50.0f));
+        const core::renderer::Frustum frustum = core::renderer::Frustum::FromMatrix(projection * view);
+
+        std::vector<uint32_t> visible;
+        const core::renderer::MeshletCullStats stats = core::renderer::CullMeshlets(meshlets, model, frustum, camera, visible);
+        if (stats.total != meshlets.meshlets.size() || stats.frustum_culled + stats.backface_culled + visible.size() != stats.total) {
+            core::debug::Logger::get_singleton().error("Meshlet culling check: iteration {} of seed {} lost meshlets", iteration, seed);
+            return false;
+        }
+        totals.total += stats.total;
+        totals.frustum_culled += stats.frustum_culled;
+        totals.backface_culled += stats.backface_culled;
+
+        std::vector<bool> shown(meshlets.meshlets.size(), false);
+        for (uint32_t index : visible) shown[index] = true;
+
+        for (size_t m = 0; m < meshlets.meshlets.size(); ++m) {
+            const Meshlet& meshlet = meshlets.meshlets[m];
+            auto world = [&](uint32_t local) {
+                return glm::vec3(model * glm::vec4(vertices[meshlets.vertices[meshlet.vertex_offset + local]].position, 1.0f));
+            };
+
+            // per triangle reference: facing away when the camera is behind its plane, with a little slack
+            // for the rounding of nearly edge on triangles
+            bool all_backfacing = true;
+            for (uint32_t t = 0; t < meshlet.triangle_count; ++t) {
+                const uint8_t* corners = &meshlets.triangles[meshlet.triangle_offset + 3 * t];
+                glm::vec3 p0 = world(corners[0]), p1 = world(corners[1]), p2 = world(corners[2]);
+                glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                glm::vec3 to_triangle = p0 - camera;
+                float length = glm::length(normal) * glm::length(to_triangle);
+                if (length <= 0.0f) continue;
+
+                bool away = glm::dot(normal, to_triangle) >= -1e-4f * length;
+                if (away) ++backfacing;
+                all_backfacing = all_backfacing && away;
+            }
+
+            bool all_outside = false;
+            for (const glm::vec4& plane : frustum.planes) {
+                bool outside = true;
+                for (uint32_t v = 0; outside && v < meshlet.vertex_count; ++v) {
+                    glm::vec3 p = world(v);
+                    outside = plane.x * p.x + plane.y * p.y + plane.z * p.z + plane.w < 1e-4f;
+                }
+                all_outside = all_outside || outside;
+            }
+
+            if (!shown[m] && !all_backfacing && !all_outside) {
+                core::debug::Logger::get_singleton().error(
+                    "Meshlet culling check: iteration {} of seed {} culled meshlet {} with visible triangles", iteration, seed, m);
+                return false;
+            }
+            if (!shown[m] && all_backfacing) culled_backfacing += meshlet.triangle_count;
+        }
+    }
+
+    core::debug::Logger::get_singleton().info(
+        "Meshlet culling check passed: {} meshlets, {} frustum and {} backface culled, {:.1f}% of backfacing triangles culled",
+        totals.total, totals.frustum_culled, totals.backface_culled,
+        backfacing > 0 ? 100.0 * static_cast<double>(culled_backfacing) / static_cast<double>(backfacing) : 0.0);
+    return true;
+}
+
+} // namespace engine::import
@@ -0,0 +1,59 @@
+#ifndef engine_import_MESHLET_HPP
+#define engine_import_MESHLET_HPP
+
+#include "mesh.hpp"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace engine::import {
+
+// sized for mesh shading hardware: 64 vertices and 124 triangles fill one output block on most gpus
+constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+struct Meshlet {
+    uint32_t vertex_offset;     // into Meshlets::vertices
+    uint32_t triangle_offset;   // into Meshlets::triangles, a multiple of 4 so the gpu can read whole words
+    uint32_t vertex_count;
+    uint32_t triangle_count;
+};
+
+// object space. the meshlet faces away from every viewpoint where
+// dot(normalize(cone_apex - viewpoint), cone_axis) >= cone_cutoff; a cutoff of 1 is never culled
+struct MeshletBounds {
+    glm::vec3 center;
+    float radius;
+    glm::vec3 cone_axis;
+    float cone_cutoff;
+    glm::vec3 cone_apex;
+};
+
+struct Meshlets {
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletBounds> bounds;  // one per meshlet
+    std::vector<uint32_t> vertices;     // meshlet local vertex -> mesh vertex
+    std::vector<uint8_t> triangles;     // three meshlet local vertices per triangle
+
+    bool empty() const { return meshlets.empty(); }
+};
+
+// greedy clustering that grows each meshlet across shared vertices, preferring triangles that add the fewest
+// new vertices and face the way the meshlet already does, which keeps spheres small and cones narrow
+Meshlets BuildMeshlets(const std::vector<ObjVertex>& vertices, const std::vector<uint32_t>& indices,
+    uint32_t max_vertices = MESHLET_MAX_VERTICES, uint32_t max_triangles = MESHLET_MAX_TRIANGLES);
+
+// lod 0 of every shape, vertices numbered as in the packed model where shapes follow each other
+Meshlets BuildMeshlets(const ObjModel& model);
+
+// runs CullMeshlets over random displaced spheres, transforms and cameras, and checks every culled meshlet
+// against its triangles: a backface culled one may hold only triangles facing away from the camera, a
+// frustum culled one only vertices outside one frustum plane. logs the first mismatch and returns false
+bool CheckMeshletCulling(uint32_t iterations = 200, uint32_t seed = 1);
+
+} // namespace engine::import
+
+#endif // engine_import_MESHLET_HPP
@@ -0,0 +1,331 @@
+#include "obj_parser.hpp"
+
+#include "engine/core/debug/logger.hpp"
+#include "engine/core/thread/thread_pool.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace engine::import {
+
+namespace {
+
+// below this a chunk costs more to hand to a worker than to parse
+constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+// a corner whose index was negative, resolved against the chunk's own counts until the merge knows its bases
+struct RelativeCorner {
+    uint32_t corner;
+    uint8_t mask; // 1 position, 2 normal, 4 texcoord
+};
+
+struct ShapeStart {
+    std::string name;
+    size_t first_corner;
+};
+
+struct Chunk {
+    const char* begin;
+    const char* end;
+
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> texcoords;
+    std::vector<ObjIndex> corners;
+    std::vector<RelativeCorner> relative;
+    std::vector<ShapeStart> shapes;
+
+    const char* error = nullptr; // message, set on the first malformed line
+    const char* error_at = nullptr;
+};
+
+inline bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline const char* SkipBlank(const char* p, const char* end) {
+    while (p < end && IsBlank(*p)) ++p;
+    return p;
+}
+
+inline const char* LineEnd(const char* p, const char* end) {
+    const void* nl = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return nl ? static_cast<const char*>(nl) : end;
+}
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+
+inline const char* ParseFloat(const char* p, const char* end, float& out) {
+    // from_chars rejects a leading '+'
+    if (p < end && *p == '+') ++p;
+    std::from_chars_result result = std::from_chars(p, end, out);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+#else
+
+// standard libraries without floating point from_chars, exact to within an ulp for the short decimals obj files hold
+inline const char* ParseFloat(const char* p, const char* end, float& out) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int digits = 0;
+    const char* start = p;
+
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        if (digits < 19) { mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0'); ++digits; }
+        else ++exponent;
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+            if (digits < 19) { mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0'); ++digits; --exponent; }
+        }
+    }
+    if (p == start) return nullptr;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool exp_negative = false;
+        if (q < end && (*q == '-' || *q == '+')) exp_negative = (*q++ == '-');
+        int e = 0;
+        const char* exp_start = q;
+        for (; q < end && *q >= '0' && *q <= '9'; ++q) e = std::min(e * 10 + (*q - '0'), 9999);
+        if (q != exp_start) {
+            exponent += exp_negative ? -e : e;
+            p = q;
+        }
+    }
+
+    double value = static_cast<double>(mantissa) * std::pow(10.0, exponent);
+    out = static_cast<float>(negative ? -value : value);
+    return p;
+}
+
+#endif
+
+inline const char* ParseInt(const char* p, const char* end, int32_t& out) {
+    std::from_chars_result result = std::from_chars(p, end, out);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+// reads up to count floats, missing trailing components stay zero
+inline bool ParseFloats(const char* p, const char* end, float* out, int count) {
+    for (int i = 0; i < count; ++i) {
+        p = SkipBlank(p, end);
+        if (p >= end) return i > 0;
+        p = ParseFloat(p, end, out[i]);
+        if (!p) return false;
+    }
+    return true;
+}
+
+// one "v", "v/t", "v//n" or "v/t/n" corner; positive indices are global, negative ones count back from the chunk
+bool ParseCorner(const char*& p, const char* end, const Chunk& chunk, ObjIndex& index, uint8_t& relative) {
+    auto resolve = [](int32_t raw, size_t local_count, int32_t& out, uint8_t bit, uint8_t& mask) {
+        if (raw > 0) {
+            out = raw - 1;
+        } else if (raw < 0) {
+            out = static_cast<int32_t>(local_count) + raw;
+            mask |= bit;
+        } else {
+            return false;
+        }
+        return true;
+    };
+
+    int32_t raw = 0;
+    index = ObjIndex{};
+    relative = 0;
+
+    p = ParseInt(p, end, raw);
+    if (!p || !resolve(raw, chunk.positions.size() / 3, index.position, 1, relative)) return false;
+
+    if (p < end && *p == '/') {
+        ++p;
+        if (p < end && *p != '/') {
+            p = ParseInt(p, end, raw);
+            if (!p || !resolve(raw, chunk.texcoords.size() / 2, index.texcoord, 4, relative)) return false;
+        }
+        if (p < end && *p == '/') {
+            ++p;
+            p = ParseInt(p, end, raw);
+            if (!p || !resolve(raw, chunk.normals.size() / 3, index.normal, 2, relative)) return false;
+        }
+    }
+    return true;
+}
+
+void ParseChunk(Chunk& chunk) {
+    // generous guesses, a typical line is 25 to 40 bytes
+    size_t expected_lines = static_cast<size_t>(chunk.end - chunk.begin) / 32;
+    chunk.positions.reserve(expected_lines * 3 / 2);
+    chunk.corners.reserve(expected_lines * 3);
+
+    // reused across faces, so only polygons larger than any before allocate
+    std::vector<ObjIndex> polygon;
+    std::vector<uint8_t> polygon_relative;
+
+    auto fail = [&](const char* message, const char* at) {
+        chunk.error = message;
+        chunk.error_at = at;
+    };
+
+    for (const char* line = chunk.begin; line < chunk.end; ) {
+        const char* end = LineEnd(line, chunk.end);
+        const char* next = end + 1;
+
+        // everything after a '#' is a comment, trailing ones included
+        if (const void* comment = std::memchr(line, '#', static_cast<size_t>(end - line))) {
+            end = static_cast<const char*>(comment);
+        }
+        const char* p = SkipBlank(line, end);
+
+        if (p + 1 < end && p[0] == 'v' && IsBlank(p[1])) {
+            float v[3] = {};
+            if (!ParseFloats(p + 2, end, v, 3)) {
+                fail("bad vertex position", line);
+                return;
+            }
+            chunk.positions.insert(chunk.positions.end(), v, v + 3);
+        } else if (p + 2 < end && p[0] == 'v' && p[1] == 'n' && IsBlank(p[2])) {
+            float n[3] = {};
+            if (!ParseFloats(p + 3, end, n, 3)) {
+                fail("bad vertex normal", line);
+                return;
+            }
+            chunk.normals.insert(chunk.normals.end(), n, n + 3);
+        } else if (p + 2 < end && p[0] == 'v' && p[1] == 't' && IsBlank(p[2])) {
+            float t[2] = {};
+            if (!ParseFloats(p + 3, end, t, 2)) {
+                fail("bad texture coordinate", line);
+                return;
+            }
+            chunk.texcoords.insert(chunk.texcoords.end(), t, t + 2);
+        } else if (p + 1 < end && p[0] == 'f' && IsBlank(p[1])) {
+            polygon.clear();
+            polygon_relative.clear();
+            p = SkipBlank(p + 2, end);
+            while (p < end) {
+                ObjIndex index;
+                uint8_t relative;
+                if (!ParseCorner(p, end, chunk, index, relative)) {
+                    fail("bad face", line);
+                    return;
+                }
+                polygon.push_back(index);
+                polygon_relative.push_back(relative);
+                p = SkipBlank(p, end);
+            }
+
+            const size_t count = polygon.size();
+            if (count < 3) {
+                fail("face with fewer than 3 corners", line);
+                return;
+            }
+
+            // fan around the first corner
+            for (size_t i = 1; i + 1 < count; ++i) {
+                for (size_t c : { size_t(0), i, i + 1 }) {
+                    if (polygon_relative[c]) {
+                        chunk.relative.push_back(RelativeCorner{ static_cast<uint32_t>(chunk.corners.size()), polygon_relative[c] });
+                    }
+                    chunk.corners.push_back(polygon[c]);
+                }
+            }
+        } else if (p + 1 < end && (p[0] == 'o' || p[0] == 'g') && IsBlank(p[1])) {
+            const char* name = SkipBlank(p + 2, end);
+            const char* name_end = end;
+            while (name_end > name && IsBlank(name_end[-1])) --name_end;
+            chunk.shapes.push_back(ShapeStart{ std::string(name, name_end), chunk.corners.size() });
+        }
+
+        line = next;
+    }
+}
+
+} // namespace
+
+bool ParseObj(const char* data, size_t size, ObjData& out, uint32_t thread_count, core::thread::ThreadPool& pool) {
+    out = ObjData{};
+    if (size == 0) return true;
+
+    // the calling thread parses a chunk too
+    if (thread_count == 0) thread_count = pool.worker_count() + 1;
+    size_t chunk_count = std::clamp<size_t>(size / MIN_CHUNK_SIZE, 1, thread_count);
+
+    // cut at the first line break after each even split
+    std::vector<Chunk> chunks(chunk_count);
+    const char* end = data + size;
+    const char* cursor = data;
+    for (size_t i = 0; i < chunk_count; ++i) {
+        const char* split = (i + 1 == chunk_count) ? end : std::max(cursor, data + size * (i + 1) / chunk_count);
+        if (split < end) split = std::min(LineEnd(split, end) + 1, end);
+        chunks[i].begin = cursor;
+        chunks[i].end = split;
+        cursor = split;
+    }
+
+    pool.parallel_for(chunk_count, 1, [&chunks](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) ParseChunk(chunks[i]);
+    });
+
+    for (const Chunk& chunk : chunks) {
+        if (chunk.error) {
+            core::debug::Logger::get_singleton().error("OBJ parse error: {} at byte {}", chunk.error, chunk.error_at - data);
+            return false;
+        }
+    }
+
+    // concatenate attributes, resolving negative indices against the counts of the chunks before
+    size_t position_count = 0, normal_count = 0, texcoord_count = 0;
+    for (const Chunk& chunk : chunks) {
+        position_count += chunk.positions.size();
+        normal_count += chunk.normals.size();
+        texcoord_count += chunk.texcoords.size();
+    }
+    out.positions.reserve(position_count);
+    out.normals.reserve(normal_count);
+    out.texcoords.reserve(texcoord_count);
+
+    // faces before the first 'o' or 'g' go into an unnamed shape, and a shape may continue across chunks
+    out.shapes.push_back(ObjShape{});
+
+    for (Chunk& chunk : chunks) {
+        int32_t position_base = static_cast<int32_t>(out.positions.size() / 3);
+        int32_t normal_base = static_cast<int32_t>(out.normals.size() / 3);
+        int32_t texcoord_base = static_cast<int32_t>(out.texcoords.size() / 2);
+
+        for (const RelativeCorner& relative : chunk.relative) {
+            ObjIndex& index = chunk.corners[relative.corner];
+            if (relative.mask & 1) index.position += position_base;
+            if (relative.mask & 2) index.normal += normal_base;
+            if (relative.mask & 4) index.texcoord += texcoord_base;
+        }
+
+        out.positions.insert(out.positions.end(), chunk.positions.begin(), chunk.positions.end());
+        out.normals.insert(out.normals.end(), chunk.normals.begin(), chunk.normals.end());
+        out.texcoords.insert(out.texcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+
+        size_t first = 0;
+        for (ShapeStart& start : chunk.shapes) {
+            out.shapes.back().corners.insert(out.shapes.back().corners.end(),
+                chunk.corners.begin() + first, chunk.corners.begin() + start.first_corner);
+            first = start.first_corner;
+
+            // a name with no faces yet just renames the current shape
+            if (out.shapes.back().corners.empty()) out.shapes.back().name = std::move(start.name);
+            else out.shapes.push_back(ObjShape{ std::move(start.name), {} });
+        }
+        out.shapes.back().corners.insert(out.shapes.back().corners.end(), chunk.corners.begin() + first, chunk.corners.end());
+
+        // release the chunk as soon as it is merged to keep peak memory down
+        chunk = Chunk{};
+    }
+
+    if (out.shapes.back().corners.empty()) out.shapes.pop_back();
+    return true;
+}
+
+} // namespace engine::import
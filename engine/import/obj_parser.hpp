@@ -0,0 +1,46 @@
+#ifndef engine_import_OBJ_PARSER_HPP
+#define engine_import_OBJ_PARSER_HPP
+
+#include "engine/core/thread/thread_pool.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace engine::import {
+
+// zero based attribute indices of one face corner, -1 when the corner has no such attribute
+struct ObjIndex {
+    int32_t position = -1;
+    int32_t normal = -1;
+    int32_t texcoord = -1;
+
+    bool operator==(const ObjIndex& other) const noexcept {
+        return position == other.position && normal == other.normal && texcoord == other.texcoord;
+    }
+};
+
+// faces of one 'o' or 'g' block, fan triangulated
+struct ObjShape {
+    std::string name;
+    std::vector<ObjIndex> corners;
+};
+
+// raw attribute streams as the file lists them, 3 floats per position and normal, 2 per texcoord
+struct ObjData {
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> texcoords;
+    std::vector<ObjShape> shapes;
+};
+
+// splits the text at line boundaries and parses up to thread_count pieces on the pool, 0 uses every worker.
+// understands v, vn, vt, f, o and g, other statements and '#' comments are skipped. returns false on
+// malformed faces
+bool ParseObj(const char* data, size_t size, ObjData& out, uint32_t thread_count = 0,
+    core::thread::ThreadPool& pool = core::thread::ThreadPool::get_singleton());
+
+} // namespace engine::import
+
+#endif // engine_import_OBJ_PARSER_HPP
@@ -0,0 +1,223 @@
+#include "texture.hpp"
+#include "texture_compress.hpp"
+
+#include "engine/core/debug/logger.hpp"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+
+namespace engine::import {
+
+namespace {
+
+constexpr uint32_t MAX_TAPS = 3;
+// rows per parallel_for chunk, small levels stay on one thread
+constexpr size_t ROW_GRAIN = 32;
+
+// a destination texel covers s / d source texels, which for d = s / 2 is two or, on odd sizes, up to three
+struct Taps {
+    uint32_t first;
+    float weights[MAX_TAPS];
+};
+
+std::vector<Taps> BuildTaps(uint32_t source, uint32_t destination) {
+    std::vector<Taps> taps(destination);
+    const double scale = static_cast<double>(source) / static_cast<double>(destination);
+    for (uint32_t i = 0; i < destination; ++i) {
+        const double begin = i * scale;
+        const double end = (i + 1) * scale;
+        Taps& tap = taps[i];
+        tap.first = static_cast<uint32_t>(begin);
+        for (uint32_t t = 0; t < MAX_TAPS; ++t) {
+            const double lo = std::max(begin, static_cast<double>(tap.first + t));
+            const double hi = std::min(end, static_cast<double>(tap.first + t + 1));
+            tap.weights[t] = hi > lo ? static_cast<float>((hi - lo) / scale) : 0.0f;
+        }
+        // past the edge weights are zero, clamping the index keeps the reads in bounds
+        tap.first = std::min(tap.first, source - 1);
+    }
+    return taps;
+}
+
+float SrgbToLinear(float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+// decode table for the 256 stored values, and for encoding the linear value at each midpoint between two
+// stored srgb values, so comparing against them rounds exactly like encoding and then rounding would.
+// a coarse table gets the search to within a step or two of the answer
+struct ColorTables {
+    static constexpr uint32_t COARSE_STEPS = 4096;
+
+    std::array<float, 256> srgb_to_linear;
+    std::array<float, 256> srgb_midpoints;  // the last one is past any linear value
+    std::array<uint8_t, COARSE_STEPS + 1> coarse;
+
+    ColorTables() {
+        for (uint32_t i = 0; i < 256; ++i) srgb_to_linear[i] = SrgbToLinear(static_cast<float>(i) / 255.0f);
+        for (uint32_t i = 0; i < 255; ++i) srgb_midpoints[i] = SrgbToLinear((static_cast<float>(i) + 0.5f) / 255.0f);
+        srgb_midpoints[255] = 2.0f;
+
+        uint32_t value = 0;
+        for (uint32_t i = 0; i <= COARSE_STEPS; ++i) {
+            const float linear = static_cast<float>(i) / COARSE_STEPS;
+            while (linear >= srgb_midpoints[value]) ++value;
+            coarse[i] = static_cast<uint8_t>(value);
+        }
+    }
+
+    uint8_t encode_srgb(float linear) const {
+        linear = std::clamp(linear, 0.0f, 1.0f);
+        uint32_t value = coarse[static_cast<uint32_t>(linear * COARSE_STEPS)];
+        while (linear >= srgb_midpoints[value]) ++value;
+        return static_cast<uint8_t>(value);
+    }
+};
+
+const ColorTables& Tables() {
+    static const ColorTables tables;
+    return tables;
+}
+
+uint8_t EncodeUnorm(float value) {
+    return static_cast<uint8_t>(std::clamp(value * 255.0f + 0.5f, 0.0f, 255.0f));
+}
+
+void Downsample(const uint8_t* source, uint32_t source_width, uint32_t source_height,
+    uint8_t* destination, uint32_t width, uint32_t height, bool srgb, core::thread::ThreadPool& pool) {
+    const ColorTables& tables = Tables();
+
+    auto decode = [&tables, srgb](uint8_t value) {
+        return srgb ? tables.srgb_to_linear[value] : static_cast<float>(value) * (1.0f / 255.0f);
+    };
+
+    // resolves the weighted sums of one destination texel
+    auto store = [&tables, srgb](uint8_t* out, const float* weighted, const float* plain, float alpha) {
+        // fully transparent texels keep their plain average so the color under them is still sensible
+        for (size_t c = 0; c < 3; ++c) {
+            const float value = alpha > 0.0f ? weighted[c] / alpha : plain[c];
+            out[c] = srgb ? tables.encode_srgb(value) : EncodeUnorm(value);
+        }
+        out[3] = EncodeUnorm(alpha);
+    };
+
+    // even sizes, the common case, are exactly four texels each
+    if (source_width == width * 2 && source_height == height * 2) {
+        pool.parallel_for(height, ROW_GRAIN, [&](size_t row_begin, size_t row_end) {
+            for (size_t y = row_begin; y < row_end; ++y) {
+                const uint8_t* top = source + (2 * y) * source_width * 4;
+                const uint8_t* bottom = top + static_cast<size_t>(source_width) * 4;
+                uint8_t* out = destination + y * width * 4;
+
+                for (uint32_t x = 0; x < width; ++x, out += 4, top += 8, bottom += 8) {
+                    const uint8_t* texels[4] = { top, top + 4, bottom, bottom + 4 };
+                    float weighted[3] = {};
+                    float plain[3] = {};
+                    float alpha = 0.0f;
+                    for (const uint8_t* texel : texels) {
+                        const float texel_alpha = static_cast<float>(texel[3]) * (0.25f / 255.0f);
+                        for (size_t c = 0; c < 3; ++c) {
+                            const float value = decode(texel[c]);
+                            plain[c] += 0.25f * value;
+                            weighted[c] += texel_alpha * value;
+                        }
+                        alpha += texel_alpha;
+                    }
+                    store(out, weighted, plain, alpha);
+                }
+            }
+        });
+        return;
+    }
+
+    const std::vector<Taps> columns = BuildTaps(source_width, width);
+    const std::vector<Taps> rows = BuildTaps(source_height, height);
+    pool.parallel_for(height, ROW_GRAIN, [&](size_t row_begin, size_t row_end) {
+        for (size_t y = row_begin; y < row_end; ++y) {
+            const Taps& row = rows[y];
+            uint8_t* out = destination + y * width * 4;
+
+            for (uint32_t x = 0; x < width; ++x, out += 4) {
+                const Taps& column = columns[x];
+                float weighted[3] = {};
+                float plain[3] = {};
+                float alpha = 0.0f;
+
+                for (uint32_t ty = 0; ty < MAX_TAPS; ++ty) {
+                    if (row.weights[ty] == 0.0f) continue;
+                    const uint32_t sy = std::min(row.first + ty, source_height - 1);
+                    const uint8_t* line = source + static_cast<size_t>(sy) * source_width * 4;
+
+                    for (uint32_t tx = 0; tx < MAX_TAPS; ++tx) {
+                        const float weight = row.weights[ty] * column.weights[tx];
+                        if (weight == 0.0f) continue;
+                        const uint8_t* texel = line + static_cast<size_t>(std::min(column.first + tx, source_width - 1)) * 4;
+
+                        const float texel_alpha = static_cast<float>(texel[3]) * (1.0f / 255.0f);
+                        for (size_t c = 0; c < 3; ++c) {
+                            const float value = decode(texel[c]);
+                            plain[c] += weight * value;
+                            weighted[c] += weight * texel_alpha * value;
+                        }
+                        alpha += weight * texel_alpha;
+                    }
+                }
+
+                store(out, weighted, plain, alpha);
+            }
+        }
+    });
+}
+
+} // namespace
+
+TextureData GenerateMips(Image&& image, bool srgb, core::thread::ThreadPool& pool) {
+    TextureData texture;
+    if (image.empty()) return texture;
+
+    texture.width = image.width;
+    texture.height = image.height;
+    texture.format = srgb ? core::graphics::ImageFormat::SRGBA8 : core::graphics::ImageFormat::RGBA8_UNORM;
+
+    const uint32_t mip_count = MipCount(image.width, image.height);
+    texture.mips.reserve(mip_count);
+    size_t offset = 0;
+    for (uint32_t level = 0; level < mip_count; ++level) {
+        const uint32_t width = std::max(image.width >> level, 1u);
+        const uint32_t height = std::max(image.height >> level, 1u);
+        const size_t size = static_cast<size_t>(width) * height * 4;
+        texture.mips.push_back(TextureMip{ width, height, offset, size });
+        offset += size;
+    }
+
+    // level 0 moves in as is, every other level is filtered from the one before it
+    texture.data = std::move(image.pixels);
+    texture.data.resize(offset);
+    for (uint32_t level = 1; level < mip_count; ++level) {
+        const TextureMip& source = texture.mips[level - 1];
+        const TextureMip& mip = texture.mips[level];
+        Downsample(texture.data.data() + source.offset, source.width, source.height,
+            texture.data.data() + mip.offset, mip.width, mip.height, srgb, pool);
+    }
+    return texture;
+}
+
+TextureData ImportTexture(const std::string& filepath, bool srgb, TextureCompression compression,
+    core::thread::ThreadPool& pool)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    Image image = ReadImage(filepath);
+    if (image.empty()) return {};
+
+    TextureData texture = GenerateMips(std::move(image), srgb, pool);
+    if (compression != TextureCompression::NONE) texture = CompressTexture(texture, compression, pool);
+
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    engine::core::debug::Logger::get_singleton().info("Imported texture {}: {}x{}, {} mips, {} KB in {:.1f} ms",
+        filepath, texture.width, texture.height, texture.mip_count(), texture.data.size() / 1024, milliseconds);
+    return texture;
+}
+
+} // namespace engine::import
@@ -0,0 +1,69 @@
+#ifndef engine_import_TEXTURE_HPP
+#define engine_import_TEXTURE_HPP
+
+#include "image.hpp"
+
+#include "engine/core/graphics/image_types.hpp"
+#include "engine/core/thread/thread_pool.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace engine::import {
+
+struct TextureMip {
+    uint32_t width;
+    uint32_t height;
+    size_t offset;  // into TextureData::data
+    size_t size;
+};
+
+// a full mip chain in one allocation, finest first
+struct TextureData {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    core::graphics::ImageFormat format = core::graphics::ImageFormat::UNDEFINED;
+    std::vector<TextureMip> mips;
+    std::vector<uint8_t> data;
+
+    bool empty() const { return mips.empty(); }
+    uint32_t mip_count() const { return static_cast<uint32_t>(mips.size()); }
+    const uint8_t* mip_data(uint32_t level) const { return data.data() + mips[level].offset; }
+};
+
+// block compression applied after the chain is built. BC1 is half a byte per texel for opaque color or cutout
+// alpha, BC3 adds smooth alpha, BC5 keeps two independent channels (normal xy) and BC7 is the best looking
+// color and alpha, all three at a byte per texel
+enum class TextureCompression {
+    NONE,
+    BC1,
+    BC3,
+    BC5,
+    BC7
+};
+
+// down to 1x1
+inline uint32_t MipCount(uint32_t width, uint32_t height) {
+    uint32_t count = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size >>= 1) ++count;
+    return count;
+}
+
+// box filtered chain, each level half the one before rounded down. srgb color is averaged in linear space,
+// and color is weighted by alpha so transparent texels do not bleed into their neighbours. rows of each level
+// are split over the pool
+TextureData GenerateMips(Image&& image, bool srgb,
+    core::thread::ThreadPool& pool = core::thread::ThreadPool::get_singleton());
+
+// decodes, builds the chain and compresses it, empty when the file cannot be read. albedo and other colors
+// want srgb, normals, roughness and masks do not
+TextureData ImportTexture(const std::string& filepath, bool srgb,
+    TextureCompression compression = TextureCompression::NONE,
+    core::thread::ThreadPool& pool = core::thread::ThreadPool::get_singleton());
+
+} // namespace engine::import
+
+#endif // engine_import_TEXTURE_HPP
@@ -0,0 +1,872 @@
+#include "texture_compress.hpp"
+
+#include "image.hpp"
+
+#include "engine/core/debug/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ENGINE_TEXTURE_COMPRESS_SSE2 1
+#endif
+
+namespace engine::import {
+
+namespace {
+
+using core::graphics::ImageFormat;
+
+// block rows per parallel_for chunk
+constexpr size_t BLOCK_ROW_GRAIN = 4;
+// power iterations for the principal axis, plenty for 16 points
+constexpr uint32_t AXIS_ITERATIONS = 8;
+// least squares passes over the endpoints once indices are known
+constexpr uint32_t REFINE_PASSES = 2;
+
+// interpolation weights out of 64 for 4-bit and 2-bit bc7 indices
+constexpr uint8_t BC7_WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+constexpr uint8_t BC7_WEIGHTS_2[4] = { 0, 21, 43, 64 };
+
+// one 4x4 block as a row of floats per channel, so four texels of a channel load at once
+struct Block {
+    alignas(16) float channels[4][16];
+};
+
+void LoadBlock(const uint8_t* level, uint32_t width, uint32_t height, uint32_t block_x, uint32_t block_y, Block& block) {
+    for (uint32_t y = 0; y < 4; ++y) {
+        const uint32_t sy = std::min(block_y * 4 + y, height - 1);
+        for (uint32_t x = 0; x < 4; ++x) {
+            const uint32_t sx = std::min(block_x * 4 + x, width - 1);
+            const uint8_t* texel = level + (static_cast<size_t>(sy) * width + sx) * 4;
+            for (uint32_t c = 0; c < 4; ++c) block.channels[c][y * 4 + x] = texel[c];
+        }
+    }
+}
+
+// nearest palette entry to each texel over N channels, palette[k][i] being entry k in channel channels[i].
+// returns the summed squared error; ties go to the lower index, and the scalar path sums in the same order
+// as the simd one so both choose the same blocks
+template <uint32_t N>
+float FindIndices(const Block& block, const uint32_t (&channels)[N], const float (*palette)[4], uint32_t palette_size,
+    uint8_t* indices)
+{
+#if defined(ENGINE_TEXTURE_COMPRESS_SSE2)
+    __m128 total = _mm_setzero_ps();
+    for (uint32_t group = 0; group < 16; group += 4) {
+        __m128 texels[N];
+        for (uint32_t i = 0; i < N; ++i) texels[i] = _mm_load_ps(block.channels[channels[i]] + group);
+
+        __m128 best = _mm_set1_ps(std::numeric_limits<float>::max());
+        __m128i best_index = _mm_setzero_si128();
+        for (uint32_t k = 0; k < palette_size; ++k) {
+            __m128 distance = _mm_setzero_ps();
+            for (uint32_t i = 0; i < N; ++i) {
+                __m128 d = _mm_sub_ps(texels[i], _mm_set1_ps(palette[k][i]));
+                distance = _mm_add_ps(distance, _mm_mul_ps(d, d));
+            }
+            __m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, best));
+            best = _mm_min_ps(distance, best);
+            best_index = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(static_cast<int32_t>(k))),
+                _mm_andnot_si128(closer, best_index));
+        }
+
+        alignas(16) int32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), best_index);
+        for (uint32_t lane = 0; lane < 4; ++lane) indices[group + lane] = static_cast<uint8_t>(lanes[lane]);
+        total = _mm_add_ps(total, best);
+    }
+
+    alignas(16) float sums[4];
+    _mm_store_ps(sums, total);
+    return sums[0] + sums[1] + sums[2] + sums[3];
+#else
+    float sums[4] = {};
+    for (uint32_t t = 0; t < 16; ++t) {
+        float best = std::numeric_limits<float>::max();
+        uint8_t best_index = 0;
+        for (uint32_t k = 0; k < palette_size; ++k) {
+            float distance = 0.0f;
+            for (uint32_t i = 0; i < N; ++i) {
+                const float d = block.channels[channels[i]][t] - palette[k][i];
+                distance += d * d;
+            }
+            if (distance < best) {
+                best = distance;
+                best_index = static_cast<uint8_t>(k);
+            }
+        }
+        indices[t] = best_index;
+        sums[t % 4] += best;
+    }
+    return sums[0] + sums[1] + sums[2] + sums[3];
+#endif
+}
+
+// ends of the line through the texels along their principal axis, texels outside the mask are ignored
+template <uint32_t N>
+void FitLine(const Block& block, const uint32_t (&channels)[N], uint32_t mask, float (&start)[N], float (&end)[N]) {
+    float mean[N] = {};
+    float low[N];
+    float high[N];
+    std::fill(std::begin(low), std::end(low), 255.0f);
+    std::fill(std::begin(high), std::end(high), 0.0f);
+    uint32_t count = 0;
+    for (uint32_t t = 0; t < 16; ++t) {
+        if (!(mask & (1u << t))) continue;
+        for (uint32_t i = 0; i < N; ++i) {
+            const float value = block.channels[channels[i]][t];
+            mean[i] += value;
+            low[i] = std::min(low[i], value);
+            high[i] = std::max(high[i], value);
+        }
+        ++count;
+    }
+    for (uint32_t i = 0; i < N; ++i) mean[i] /= static_cast<float>(count);
+
+    float covariance[N][N] = {};
+    for (uint32_t t = 0; t < 16; ++t) {
+        if (!(mask & (1u << t))) continue;
+        float d[N];
+        for (uint32_t i = 0; i < N; ++i) d[i] = block.channels[channels[i]][t] - mean[i];
+        for (uint32_t i = 0; i < N; ++i) {
+            for (uint32_t j = 0; j < N; ++j) covariance[i][j] += d[i] * d[j];
+        }
+    }
+
+    // the box diagonal is already close to the axis for most blocks
+    float axis[N];
+    for (uint32_t i = 0; i < N; ++i) axis[i] = high[i] - low[i];
+    for (uint32_t iteration = 0; iteration < AXIS_ITERATIONS; ++iteration) {
+        float next[N] = {};
+        float length = 0.0f;
+        for (uint32_t i = 0; i < N; ++i) {
+            for (uint32_t j = 0; j < N; ++j) next[i] += covariance[i][j] * axis[j];
+            length = std::max(length, std::abs(next[i]));
+        }
+        if (length < 1e-6f) break;
+        for (uint32_t i = 0; i < N; ++i) axis[i] = next[i] / length;
+    }
+
+    float length_squared = 0.0f;
+    for (uint32_t i = 0; i < N; ++i) length_squared += axis[i] * axis[i];
+    if (length_squared < 1e-12f) {
+        // one color, or texels that do not vary along any axis
+        for (uint32_t i = 0; i < N; ++i) start[i] = end[i] = mean[i];
+        return;
+    }
+
+    float min_t = std::numeric_limits<float>::max();
+    float max_t = std::numeric_limits<float>::lowest();
+    for (uint32_t t = 0; t < 16; ++t) {
+        if (!(mask & (1u << t))) continue;
+        float projection = 0.0f;
+        for (uint32_t i = 0; i < N; ++i) projection += (block.channels[channels[i]][t] - mean[i]) * axis[i];
+        min_t = std::min(min_t, projection);
+        max_t = std::max(max_t, projection);
+    }
+    for (uint32_t i = 0; i < N; ++i) {
+        start[i] = std::clamp(mean[i] + axis[i] * min_t / length_squared, 0.0f, 255.0f);
+        end[i] = std::clamp(mean[i] + axis[i] * max_t / length_squared, 0.0f, 255.0f);
+    }
+}
+
+// best endpoints for fixed indices, where index k puts a texel at weights[k] of the way from start to end.
+// false when the indices leave the fit undetermined (every texel on one index)
+template <uint32_t N>
+bool RefineLine(const Block& block, const uint32_t (&channels)[N], uint32_t mask, const uint8_t* indices,
+    const float* weights, float (&start)[N], float (&end)[N])
+{
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    float ax[N] = {};
+    float bx[N] = {};
+    for (uint32_t t = 0; t < 16; ++t) {
+        if (!(mask & (1u << t))) continue;
+        const float b = weights[indices[t]];
+        const float a = 1.0f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (uint32_t i = 0; i < N; ++i) {
+            ax[i] += a * block.channels[channels[i]][t];
+            bx[i] += b * block.channels[channels[i]][t];
+        }
+    }
+
+    const float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f) return false;
+    for (uint32_t i = 0; i < N; ++i) {
+        start[i] = std::clamp((bb * ax[i] - ab * bx[i]) / determinant, 0.0f, 255.0f);
+        end[i] = std::clamp((aa * bx[i] - ab * ax[i]) / determinant, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+void WriteLittleEndian(uint8_t* out, uint64_t value, uint32_t bytes) {
+    for (uint32_t i = 0; i < bytes; ++i) out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+uint64_t ReadLittleEndian(const uint8_t* in, uint32_t bytes) {
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < bytes; ++i) value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+// ---- bc1 ----
+
+uint16_t Pack565(const float (&color)[3]) {
+    const uint32_t r = static_cast<uint32_t>(color[0] * (31.0f / 255.0f) + 0.5f);
+    const uint32_t g = static_cast<uint32_t>(color[1] * (63.0f / 255.0f) + 0.5f);
+    const uint32_t b = static_cast<uint32_t>(color[2] * (31.0f / 255.0f) + 0.5f);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void Unpack565(uint16_t packed, float (&color)[4]) {
+    const uint32_t r = (packed >> 11) & 31;
+    const uint32_t g = (packed >> 5) & 63;
+    const uint32_t b = packed & 31;
+    color[0] = static_cast<float>((r << 3) | (r >> 2));
+    color[1] = static_cast<float>((g << 2) | (g >> 4));
+    color[2] = static_cast<float>((b << 3) | (b >> 2));
+    color[3] = 255.0f;
+}
+
+// palette in the order the indices refer to it. four colors when c0 > c1 (or always, inside BC3), otherwise
+// three and transparent black
+uint32_t Bc1Palette(uint16_t c0, uint16_t c1, bool four_color, float (*palette)[4]) {
+    Unpack565(c0, palette[0]);
+    Unpack565(c1, palette[1]);
+    if (four_color) {
+        for (uint32_t c = 0; c < 3; ++c) {
+            palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+            palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+        }
+        palette[2][3] = palette[3][3] = 255.0f;
+        return 4;
+    }
+    for (uint32_t c = 0; c < 3; ++c) {
+        palette[2][c] = (palette[0][c] + palette[1][c]) / 2.0f;
+        palette[3][c] = 0.0f;
+    }
+    palette[2][3] = 255.0f;
+    palette[3][3] = 0.0f;
+    return 3;
+}
+
+// texels with alpha under half are cut out, which needs the three color mode. BC3 keeps alpha elsewhere and
+// always reads its color block as four colors
+void EncodeBc1(const Block& block, bool cutout, uint8_t* out) {
+    static constexpr uint32_t RGB[3] = { 0, 1, 2 };
+    static constexpr float FOUR_COLOR_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    static constexpr float THREE_COLOR_WEIGHTS[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+    uint32_t opaque = 0xffff;
+    if (cutout) {
+        for (uint32_t t = 0; t < 16; ++t) {
+            if (block.channels[3][t] < 128.0f) opaque &= ~(1u << t);
+        }
+    }
+    if (opaque == 0) {
+        WriteLittleEndian(out, 0, 4);
+        WriteLittleEndian(out + 4, 0xffffffffu, 4);
+        return;
+    }
+
+    // cut out texels take the color of an opaque one, so they do not pull the search either way
+    Block colors = block;
+    if (opaque != 0xffff) {
+        uint32_t first = 0;
+        while (!(opaque & (1u << first))) ++first;
+        for (uint32_t t = 0; t < 16; ++t) {
+            if (opaque & (1u << t)) continue;
+            for (uint32_t c = 0; c < 3; ++c) colors.channels[c][t] = block.channels[c][first];
+        }
+    }
+    const bool four_color = opaque == 0xffff;
+    const float* weights = four_color ? FOUR_COLOR_WEIGHTS : THREE_COLOR_WEIGHTS;
+
+    float start[3];
+    float end[3];
+    FitLine(colors, RGB, opaque, start, end);
+
+    // the mode is picked by endpoint order
+    auto order = [four_color](uint16_t& c0, uint16_t& c1) {
+        if (four_color ? c0 < c1 : c0 > c1) std::swap(c0, c1);
+    };
+
+    uint16_t best_c0 = Pack565(start);
+    uint16_t best_c1 = Pack565(end);
+    order(best_c0, best_c1);
+    uint8_t best_indices[16];
+    float palette[4][4];
+    float best_error = FindIndices(colors, RGB, palette, Bc1Palette(best_c0, best_c1, four_color, palette), best_indices);
+
+    for (uint32_t pass = 0; pass < REFINE_PASSES && best_error > 0.0f; ++pass) {
+        if (!RefineLine(colors, RGB, opaque, best_indices, weights, start, end)) break;
+        uint16_t c0 = Pack565(start);
+        uint16_t c1 = Pack565(end);
+        order(c0, c1);
+        uint8_t indices[16];
+        const float error = FindIndices(colors, RGB, palette, Bc1Palette(c0, c1, four_color, palette), indices);
+        if (error >= best_error) break;
+        best_error = error;
+        best_c0 = c0;
+        best_c1 = c1;
+        std::memcpy(best_indices, indices, sizeof(indices));
+    }
+
+    // equal endpoints in four color mode read as three color, where every index but 3 is still c0
+    uint32_t bits = 0;
+    for (uint32_t t = 0; t < 16; ++t) {
+        const uint32_t index = !(opaque & (1u << t)) ? 3u : (best_c0 == best_c1 ? 0u : best_indices[t]);
+        bits |= index << (2 * t);
+    }
+    WriteLittleEndian(out, best_c0, 2);
+    WriteLittleEndian(out + 2, best_c1, 2);
+    WriteLittleEndian(out + 4, bits, 4);
+}
+
+void DecodeBc1(const uint8_t* in, bool always_four_color, uint8_t* out) {
+    const uint16_t c0 = static_cast<uint16_t>(ReadLittleEndian(in, 2));
+    const uint16_t c1 = static_cast<uint16_t>(ReadLittleEndian(in + 2, 2));
+    const uint32_t bits = static_cast<uint32_t>(ReadLittleEndian(in + 4, 4));
+    float palette[4][4];
+    Bc1Palette(c0, c1, always_four_color || c0 > c1, palette);
+    for (uint32_t t = 0; t < 16; ++t) {
+        const float* color = palette[(bits >> (2 * t)) & 3];
+        for (uint32_t c = 0; c < 4; ++c) out[t * 4 + c] = static_cast<uint8_t>(color[c] + 0.5f);
+    }
+}
+
+// ---- bc4, one channel; alpha in BC3 and each of the two in BC5 ----
+
+// eight steps when a0 > a1, otherwise six and exact 0 and 255
+void Bc4Palette(uint32_t a0, uint32_t a1, float (*palette)[4]) {
+    palette[0][0] = static_cast<float>(a0);
+    palette[1][0] = static_cast<float>(a1);
+    if (a0 > a1) {
+        for (uint32_t i = 2; i < 8; ++i) palette[i][0] = static_cast<float>((8 - i) * a0 + (i - 1) * a1) / 7.0f;
+        return;
+    }
+    for (uint32_t i = 2; i < 6; ++i) palette[i][0] = static_cast<float>((6 - i) * a0 + (i - 1) * a1) / 5.0f;
+    palette[6][0] = 0.0f;
+    palette[7][0] = 255.0f;
+}
+
+void EncodeBc4(const Block& block, uint32_t channel, uint8_t* out) {
+    const uint32_t channels[1] = { channel };
+    const float* values = block.channels[channel];
+
+    float low = 255.0f, high = 0.0f;
+    float inner_low = 255.0f, inner_high = 0.0f;
+    for (uint32_t t = 0; t < 16; ++t) {
+        low = std::min(low, values[t]);
+        high = std::max(high, values[t]);
+        if (values[t] > 0.0f && values[t] < 255.0f) {
+            inner_low = std::min(inner_low, values[t]);
+            inner_high = std::max(inner_high, values[t]);
+        }
+    }
+
+    float palette[8][4];
+    uint8_t best_indices[16];
+    uint32_t best_a0 = static_cast<uint32_t>(high);
+    uint32_t best_a1 = static_cast<uint32_t>(low);
+    Bc4Palette(best_a0, best_a1, palette);
+    float best_error = FindIndices(block, channels, palette, 8, best_indices);
+
+    // blocks reaching 0 or 255 may do better spending the six steps on the values in between
+    if (best_error > 0.0f && (low == 0.0f || high == 255.0f)) {
+        const uint32_t a0 = inner_low <= inner_high ? static_cast<uint32_t>(inner_low) : 0;
+        const uint32_t a1 = inner_low <= inner_high ? static_cast<uint32_t>(inner_high) : 0;
+        Bc4Palette(a0, a1, palette);
+        uint8_t indices[16];
+        const float error = FindIndices(block, channels, palette, 8, indices);
+        if (error < best_error) {
+            best_a0 = a0;
+            best_a1 = a1;
+            std::memcpy(best_indices, indices, sizeof(indices));
+        }
+    }
+
+    uint64_t bits = 0;
+    for (uint32_t t = 0; t < 16; ++t) bits |= static_cast<uint64_t>(best_indices[t]) << (3 * t);
+    out[0] = static_cast<uint8_t>(best_a0);
+    out[1] = static_cast<uint8_t>(best_a1);
+    WriteLittleEndian(out + 2, bits, 6);
+}
+
+void DecodeBc4(const uint8_t* in, uint32_t channel, uint8_t* out) {
+    float palette[8][4];
+    Bc4Palette(in[0], in[1], palette);
+    const uint64_t bits = ReadLittleEndian(in + 2, 6);
+    for (uint32_t t = 0; t < 16; ++t) {
+        out[t * 4 + channel] = static_cast<uint8_t>(palette[(bits >> (3 * t)) & 7][0] + 0.5f);
+    }
+}
+
+// ---- bc7: mode 6 (one rgba line, 4-bit indices) for every block, and mode 5 (rgb and alpha fitted and
+// indexed apart, 2-bit indices each) for blocks where alpha does not follow color ----
+
+// writes fields from the lowest bit up, as the format lays them out
+struct BitWriter {
+    uint8_t* out;
+    uint32_t position = 0;
+
+    void write(uint32_t value, uint32_t bits) {
+        for (uint32_t i = 0; i < bits; ++i, ++position) {
+            if ((value >> i) & 1) out[position >> 3] |= static_cast<uint8_t>(1u << (position & 7));
+        }
+    }
+};
+
+struct BitReader {
+    const uint8_t* in;
+    uint32_t position = 0;
+
+    uint32_t read(uint32_t bits) {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < bits; ++i, ++position) value |= ((in[position >> 3] >> (position & 7)) & 1u) << i;
+        return value;
+    }
+};
+
+template <size_t K>
+void Bc7Palette(const uint32_t* e0, const uint32_t* e1, uint32_t channel_count, const uint8_t (&weights)[K],
+    float (*palette)[4])
+{
+    for (uint32_t c = 0; c < channel_count; ++c) {
+        for (uint32_t k = 0; k < K; ++k) {
+            palette[k][c] = static_cast<float>(((64 - weights[k]) * e0[c] + weights[k] * e1[c] + 32) >> 6);
+        }
+    }
+}
+
+template <size_t K>
+void Bc7Weights(const uint8_t (&weights)[K], float (&out)[K]) {
+    for (size_t k = 0; k < K; ++k) out[k] = weights[k] / 64.0f;
+}
+
+// mode 6 endpoints are 7 bits and a low bit shared by the four channels, picked to suit the endpoint best
+void QuantizeMode6(const float (&endpoint)[4], uint32_t (&expanded)[4], uint32_t (&stored)[4], uint32_t& p_bit) {
+    float best_error = std::numeric_limits<float>::max();
+    for (uint32_t p = 0; p < 2; ++p) {
+        uint32_t candidate[4];
+        float error = 0.0f;
+        for (uint32_t c = 0; c < 4; ++c) {
+            candidate[c] = static_cast<uint32_t>(std::clamp((endpoint[c] - static_cast<float>(p)) * 0.5f + 0.5f, 0.0f, 127.0f));
+            const float d = static_cast<float>(candidate[c] * 2 + p) - endpoint[c];
+            error += d * d;
+        }
+        if (error < best_error) {
+            best_error = error;
+            p_bit = p;
+            for (uint32_t c = 0; c < 4; ++c) {
+                stored[c] = candidate[c];
+                expanded[c] = candidate[c] * 2 + p;
+            }
+        }
+    }
+}
+
+// mode 5 color endpoints are 7 bits, widened by repeating the top bit
+uint32_t QuantizeMode5Color(float value) {
+    return static_cast<uint32_t>(std::clamp(value * (127.0f / 255.0f) + 0.5f, 0.0f, 127.0f));
+}
+
+uint32_t ExpandMode5Color(uint32_t stored) {
+    return (stored << 1) | (stored >> 6);
+}
+
+float EncodeBc7Mode6(const Block& block, uint8_t* out) {
+    static constexpr uint32_t RGBA[4] = { 0, 1, 2, 3 };
+    float weights[16];
+    Bc7Weights(BC7_WEIGHTS_4, weights);
+
+    float start[4];
+    float end[4];
+    FitLine(block, RGBA, 0xffff, start, end);
+
+    uint32_t best_stored[2][4], best_expanded[2][4], best_p[2] = {};
+    QuantizeMode6(start, best_expanded[0], best_stored[0], best_p[0]);
+    QuantizeMode6(end, best_expanded[1], best_stored[1], best_p[1]);
+    float palette[16][4];
+    Bc7Palette(best_expanded[0], best_expanded[1], 4, BC7_WEIGHTS_4, palette);
+    uint8_t best_indices[16];
+    float best_error = FindIndices(block, RGBA, palette, 16, best_indices);
+
+    for (uint32_t pass = 0; pass < REFINE_PASSES && best_error > 0.0f; ++pass) {
+        if (!RefineLine(block, RGBA, 0xffff, best_indices, weights, start, end)) break;
+        uint32_t stored[2][4], expanded[2][4], p[2] = {};
+        QuantizeMode6(start, expanded[0], stored[0], p[0]);
+        QuantizeMode6(end, expanded[1], stored[1], p[1]);
+        Bc7Palette(expanded[0], expanded[1], 4, BC7_WEIGHTS_4, palette);
+        uint8_t indices[16];
+        const float error = FindIndices(block, RGBA, palette, 16, indices);
+        if (error >= best_error) break;
+        best_error = error;
+        std::memcpy(best_stored, stored, sizeof(stored));
+        std::memcpy(best_expanded, expanded, sizeof(expanded));
+        std::memcpy(best_p, p, sizeof(p));
+        std::memcpy(best_indices, indices, sizeof(indices));
+    }
+
+    // the first index is stored without its top bit, so it has to be in the lower half
+    if (best_indices[0] >= 8) {
+        std::swap(best_stored[0], best_stored[1]);
+        std::swap(best_p[0], best_p[1]);
+        for (uint8_t& index : best_indices) index = static_cast<uint8_t>(15 - index);
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{ out };
+    writer.write(1u << 6, 7);
+    for (uint32_t c = 0; c < 4; ++c) {
+        writer.write(best_stored[0][c], 7);
+        writer.write(best_stored[1][c], 7);
+    }
+    writer.write(best_p[0], 1);
+    writer.write(best_p[1], 1);
+    writer.write(best_indices[0], 3);
+    for (uint32_t t = 1; t < 16; ++t) writer.write(best_indices[t], 4);
+    return best_error;
+}
+
+float EncodeBc7Mode5(const Block& block, uint8_t* out) {
+    static constexpr uint32_t RGB[3] = { 0, 1, 2 };
+    static constexpr uint32_t ALPHA[1] = { 3 };
+    float weights[4];
+    Bc7Weights(BC7_WEIGHTS_2, weights);
+    float palette[4][4];
+
+    // color: a line through rgb, refined like mode 6
+    float start[3];
+    float end[3];
+    FitLine(block, RGB, 0xffff, start, end);
+    auto quantize_color = [](const float (&start)[3], const float (&end)[3], uint32_t (&stored)[2][3], uint32_t (&expanded)[2][3]) {
+        for (uint32_t c = 0; c < 3; ++c) {
+            stored[0][c] = QuantizeMode5Color(start[c]);
+            stored[1][c] = QuantizeMode5Color(end[c]);
+            expanded[0][c] = ExpandMode5Color(stored[0][c]);
+            expanded[1][c] = ExpandMode5Color(stored[1][c]);
+        }
+    };
+
+    uint32_t color_stored[2][3], color_expanded[2][3];
+    quantize_color(start, end, color_stored, color_expanded);
+    Bc7Palette(color_expanded[0], color_expanded[1], 3, BC7_WEIGHTS_2, palette);
+    uint8_t color_indices[16];
+    float color_error = FindIndices(block, RGB, palette, 4, color_indices);
+
+    for (uint32_t pass = 0; pass < REFINE_PASSES && color_error > 0.0f; ++pass) {
+        if (!RefineLine(block, RGB, 0xffff, color_indices, weights, start, end)) break;
+        uint32_t stored[2][3], expanded[2][3];
+        quantize_color(start, end, stored, expanded);
+        Bc7Palette(expanded[0], expanded[1], 3, BC7_WEIGHTS_2, palette);
+        uint8_t indices[16];
+        const float error = FindIndices(block, RGB, palette, 4, indices);
+        if (error >= color_error) break;
+        color_error = error;
+        std::memcpy(color_stored, stored, sizeof(stored));
+        std::memcpy(color_indices, indices, sizeof(indices));
+    }
+
+    // alpha: 8-bit endpoints from the range, refined once indices are known
+    float alpha_start[1] = { 255.0f };
+    float alpha_end[1] = { 0.0f };
+    for (uint32_t t = 0; t < 16; ++t) {
+        alpha_start[0] = std::min(alpha_start[0], block.channels[3][t]);
+        alpha_end[0] = std::max(alpha_end[0], block.channels[3][t]);
+    }
+    uint32_t alpha_stored[2] = { static_cast<uint32_t>(alpha_start[0]), static_cast<uint32_t>(alpha_end[0]) };
+    Bc7Palette(&alpha_stored[0], &alpha_stored[1], 1, BC7_WEIGHTS_2, palette);
+    uint8_t alpha_indices[16];
+    float alpha_error = FindIndices(block, ALPHA, palette, 4, alpha_indices);
+
+    for (uint32_t pass = 0; pass < REFINE_PASSES && alpha_error > 0.0f; ++pass) {
+        if (!RefineLine(block, ALPHA, 0xffff, alpha_indices, weights, alpha_start, alpha_end)) break;
+        const uint32_t stored[2] = { static_cast<uint32_t>(alpha_start[0] + 0.5f), static_cast<uint32_t>(alpha_end[0] + 0.5f) };
+        Bc7Palette(&stored[0], &stored[1], 1, BC7_WEIGHTS_2, palette);
+        uint8_t indices[16];
+        const float error = FindIndices(block, ALPHA, palette, 4, indices);
+        if (error >= alpha_error) break;
+        alpha_error = error;
+        std::memcpy(alpha_stored, stored, sizeof(stored));
+        std::memcpy(alpha_indices, indices, sizeof(indices));
+    }
+
+    // both index sets keep the first index in their lower half, each by swapping its own endpoints
+    if (color_indices[0] >= 2) {
+        std::swap(color_stored[0], color_stored[1]);
+        for (uint8_t& index : color_indices) index = static_cast<uint8_t>(3 - index);
+    }
+    if (alpha_indices[0] >= 2) {
+        std::swap(alpha_stored[0], alpha_stored[1]);
+        for (uint8_t& index : alpha_indices) index = static_cast<uint8_t>(3 - index);
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{ out };
+    writer.write(1u << 5, 6);
+    writer.write(0, 2); // no channel rotation
+    for (uint32_t c = 0; c < 3; ++c) {
+        writer.write(color_stored[0][c], 7);
+        writer.write(color_stored[1][c], 7);
+    }
+    writer.write(alpha_stored[0], 8);
+    writer.write(alpha_stored[1], 8);
+    writer.write(color_indices[0], 1);
+    for (uint32_t t = 1; t < 16; ++t) writer.write(color_indices[t], 2);
+    writer.write(alpha_indices[0], 1);
+    for (uint32_t t = 1; t < 16; ++t) writer.write(alpha_indices[t], 2);
+    return color_error + alpha_error;
+}
+
+void EncodeBc7(const Block& block, uint8_t* out) {
+    const float mode_6_error = EncodeBc7Mode6(block, out);
+    if (mode_6_error == 0.0f) return;
+
+    bool constant_alpha = true;
+    for (uint32_t t = 1; t < 16; ++t) constant_alpha = constant_alpha && block.channels[3][t] == block.channels[3][0];
+    if (constant_alpha) return;
+
+    uint8_t mode_5[16];
+    if (EncodeBc7Mode5(block, mode_5) < mode_6_error) std::memcpy(out, mode_5, sizeof(mode_5));
+}
+
+void DecodeBc7(const uint8_t* in, uint8_t* out) {
+    BitReader reader{ in };
+    uint32_t mode = 0;
+    while (mode < 8 && reader.read(1) == 0) ++mode;
+    ENGINE_ASSERT(mode == 5 || mode == 6, "Only mode 5 and 6 BC7 blocks can be decoded");
+
+    float palette[16][4];
+    if (mode == 6) {
+        uint32_t e0[4], e1[4];
+        for (uint32_t c = 0; c < 4; ++c) {
+            e0[c] = reader.read(7) << 1;
+            e1[c] = reader.read(7) << 1;
+        }
+        const uint32_t p0 = reader.read(1);
+        const uint32_t p1 = reader.read(1);
+        for (uint32_t c = 0; c < 4; ++c) {
+            e0[c] |= p0;
+            e1[c] |= p1;
+        }
+        Bc7Palette(e0, e1, 4, BC7_WEIGHTS_4, palette);
+        for (uint32_t t = 0; t < 16; ++t) {
+            const float* color = palette[reader.read(t == 0 ? 3 : 4)];
+            for (uint32_t c = 0; c < 4; ++c) out[t * 4 + c] = static_cast<uint8_t>(color[c]);
+        }
+        return;
+    }
+    if (mode != 5) {
+        std::memset(out, 0, 64);
+        return;
+    }
+
+    const uint32_t rotation = reader.read(2);
+    uint32_t e0[4], e1[4];
+    for (uint32_t c = 0; c < 3; ++c) {
+        e0[c] = ExpandMode5Color(reader.read(7));
+        e1[c] = ExpandMode5Color(reader.read(7));
+    }
+    e0[3] = reader.read(8);
+    e1[3] = reader.read(8);
+    Bc7Palette(e0, e1, 4, BC7_WEIGHTS_2, palette);
+    for (uint32_t t = 0; t < 16; ++t) {
+        const uint32_t index = reader.read(t == 0 ? 1 : 2);
+        for (uint32_t c = 0; c < 3; ++c) out[t * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+    }
+    for (uint32_t t = 0; t < 16; ++t) out[t * 4 + 3] = static_cast<uint8_t>(palette[reader.read(t == 0 ? 1 : 2)][3]);
+    if (rotation != 0) {
+        for (uint32_t t = 0; t < 16; ++t) std::swap(out[t * 4 + 3], out[t * 4 + rotation - 1]);
+    }
+}
+
+// ---- levels ----
+
+void EncodeBlock(const Block& block, ImageFormat format, uint8_t* out) {
+    switch (format) {
+        case ImageFormat::BC1_RGBA_UNORM: case ImageFormat::BC1_RGBA_SRGB:
+            EncodeBc1(block, true, out);
+            break;
+        case ImageFormat::BC3_UNORM: case ImageFormat::BC3_SRGB:
+            EncodeBc4(block, 3, out);
+            EncodeBc1(block, false, out + 8);
+            break;
+        case ImageFormat::BC5_UNORM:
+            EncodeBc4(block, 0, out);
+            EncodeBc4(block, 1, out + 8);
+            break;
+        default:
+            EncodeBc7(block, out);
+            break;
+    }
+}
+
+void DecodeBlock(const uint8_t* in, ImageFormat format, uint8_t* out) {
+    switch (format) {
+        case ImageFormat::BC1_RGBA_UNORM: case ImageFormat::BC1_RGBA_SRGB:
+            DecodeBc1(in, false, out);
+            break;
+        case ImageFormat::BC3_UNORM: case ImageFormat::BC3_SRGB:
+            DecodeBc1(in + 8, true, out);
+            DecodeBc4(in, 3, out);
+            break;
+        case ImageFormat::BC5_UNORM:
+            for (uint32_t t = 0; t < 16; ++t) {
+                out[t * 4 + 2] = 0;
+                out[t * 4 + 3] = 255;
+            }
+            DecodeBc4(in, 0, out);
+            DecodeBc4(in + 8, 1, out);
+            break;
+        default:
+            DecodeBc7(in, out);
+            break;
+    }
+}
+
+uint32_t BlockCount(uint32_t texels) {
+    return (texels + 3) / 4;
+}
+
+} // namespace
+
+ImageFormat CompressedFormat(TextureCompression compression, bool srgb) {
+    switch (compression) {
+        case TextureCompression::BC1: return srgb ? ImageFormat::BC1_RGBA_SRGB : ImageFormat::BC1_RGBA_UNORM;
+        case TextureCompression::BC3: return srgb ? ImageFormat::BC3_SRGB : ImageFormat::BC3_UNORM;
+        case TextureCompression::BC5: return ImageFormat::BC5_UNORM;
+        case TextureCompression::BC7: return srgb ? ImageFormat::BC7_SRGB : ImageFormat::BC7_UNORM;
+        default:                      return srgb ? ImageFormat::SRGBA8 : ImageFormat::RGBA8_UNORM;
+    }
+}
+
+TextureData CompressTexture(const TextureData& texture, TextureCompression compression, core::thread::ThreadPool& pool) {
+    ENGINE_ASSERT(texture.format == ImageFormat::RGBA8_UNORM || texture.format == ImageFormat::SRGBA8,
+        "Block compression takes an rgba8 chain");
+    if (texture.empty() || compression == TextureCompression::NONE) return texture;
+
+    TextureData compressed;
+    compressed.width = texture.width;
+    compressed.height = texture.height;
+    compressed.format = CompressedFormat(compression, texture.format == ImageFormat::SRGBA8);
+    const uint32_t block_bytes = core::graphics::CompressedBlockBytes(compressed.format);
+
+    compressed.mips.reserve(texture.mip_count());
+    size_t offset = 0;
+    for (const TextureMip& mip : texture.mips) {
+        const size_t size = static_cast<size_t>(BlockCount(mip.width)) * BlockCount(mip.height) * block_bytes;
+        compressed.mips.push_back(TextureMip{ mip.width, mip.height, offset, size });
+        offset += size;
+    }
+    compressed.data.resize(offset);
+
+    for (uint32_t level = 0; level < texture.mip_count(); ++level) {
+        const TextureMip& mip = texture.mips[level];
+        const uint8_t* source = texture.mip_data(level);
+        uint8_t* destination = compressed.data.data() + compressed.mips[level].offset;
+        const uint32_t blocks_x = BlockCount(mip.width);
+
+        pool.parallel_for(BlockCount(mip.height), BLOCK_ROW_GRAIN, [&](size_t row_begin, size_t row_end) {
+            Block block;
+            for (size_t y = row_begin; y < row_end; ++y) {
+                uint8_t* out = destination + y * blocks_x * block_bytes;
+                for (uint32_t x = 0; x < blocks_x; ++x, out += block_bytes) {
+                    LoadBlock(source, mip.width, mip.height, x, static_cast<uint32_t>(y), block);
+                    EncodeBlock(block, compressed.format, out);
+                }
+            }
+        });
+    }
+    return compressed;
+}
+
+std::vector<uint8_t> DecompressLevel(const TextureData& texture, uint32_t level) {
+    ENGINE_ASSERT(core::graphics::IsCompressedFormat(texture.format), "Decompressing an uncompressed chain");
+    const TextureMip& mip = texture.mips[level];
+    const uint32_t block_bytes = core::graphics::CompressedBlockBytes(texture.format);
+    const uint32_t blocks_x = BlockCount(mip.width);
+
+    std::vector<uint8_t> pixels(static_cast<size_t>(mip.width) * mip.height * 4);
+    const uint8_t* in = texture.mip_data(level);
+    uint8_t decoded[64];
+    for (uint32_t by = 0; by < BlockCount(mip.height); ++by) {
+        for (uint32_t bx = 0; bx < blocks_x; ++bx, in += block_bytes) {
+            DecodeBlock(in, texture.format, decoded);
+
+            // padding texels past the edge are dropped
+            for (uint32_t y = 0; y < 4 && by * 4 + y < mip.height; ++y) {
+                for (uint32_t x = 0; x < 4 && bx * 4 + x < mip.width; ++x) {
+                    std::memcpy(pixels.data() + ((static_cast<size_t>(by) * 4 + y) * mip.width + bx * 4 + x) * 4,
+                        decoded + (y * 4 + x) * 4, 4);
+                }
+            }
+        }
+    }
+    return pixels;
+}
+
+double CompressionPsnr(const TextureData& source, const TextureData& compressed, uint32_t level) {
+    const std::vector<uint8_t> decoded = DecompressLevel(compressed, level);
+    const uint8_t* reference = source.mip_data(level);
+
+    const bool bc1 = compressed.format == ImageFormat::BC1_RGBA_UNORM || compressed.format == ImageFormat::BC1_RGBA_SRGB;
+    const uint32_t channels = compressed.format == ImageFormat::BC5_UNORM ? 2 : 4;
+
+    double squared_error = 0.0;
+    size_t samples = 0;
+    for (size_t i = 0; i < decoded.size(); i += 4) {
+        for (uint32_t c = 0; c < channels; ++c) {
+            // the color of a texel BC1 cut out is never seen
+            if (bc1 && c < 3 && decoded[i + 3] == 0) continue;
+            const double d = static_cast<double>(decoded[i + c]) - static_cast<double>(reference[i + c]);
+            squared_error += d * d;
+            ++samples;
+        }
+    }
+    const double mean = squared_error / static_cast<double>(samples);
+    if (mean == 0.0) return std::numeric_limits<double>::infinity();
+    return 10.0 * std::log10(255.0 * 255.0 / mean);
+}
+
+void BenchmarkTextureCompression(const std::string& filepath, uint32_t iterations) {
+    Image image = ReadImage(filepath);
+    if (image.empty()) {
+        engine::core::debug::Logger::get_singleton().error("Texture compression benchmark failed to read {}", filepath);
+        return;
+    }
+    const TextureData source = GenerateMips(std::move(image), true);
+    const double megabytes = static_cast<double>(source.data.size()) / (1024.0 * 1024.0);
+    core::thread::ThreadPool& pool = core::thread::ThreadPool::get_singleton();
+
+    static constexpr TextureCompression FORMATS[] = {
+        TextureCompression::BC1, TextureCompression::BC3, TextureCompression::BC5, TextureCompression::BC7
+    };
+    static constexpr const char* NAMES[] = { "BC1", "BC3", "BC5", "BC7" };
+
+    for (size_t f = 0; f < std::size(FORMATS); ++f) {
+        // best of n, as for the obj benchmark
+        TextureData compressed;
+        double best = 1e30;
+        for (uint32_t i = 0; i < std::max(iterations, 1u); ++i) {
+            auto start = std::chrono::steady_clock::now();
+            compressed = CompressTexture(source, FORMATS[f], pool);
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        engine::core::debug::Logger::get_singleton().info(
+            "Texture compression {} {} ({}x{}, {:.1f} MB with mips): {:.1f} MB/s on {} threads, {:.1f} MB, {:.2f} dB psnr",
+            NAMES[f], filepath, source.width, source.height, megabytes, megabytes / best, pool.worker_count() + 1,
+            static_cast<double>(compressed.data.size()) / (1024.0 * 1024.0), CompressionPsnr(source, compressed));
+    }
+}
+
+} // namespace engine::import
@@ -0,0 +1,37 @@
+#ifndef engine_import_TEXTURE_COMPRESS_HPP
+#define engine_import_TEXTURE_COMPRESS_HPP
+
+#include "texture.hpp"
+
+#include "engine/core/graphics/image_types.hpp"
+#include "engine/core/thread/thread_pool.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace engine::import {
+
+// the format a chain ends up in, srgb picks the srgb variant where there is one (BC5 has none)
+core::graphics::ImageFormat CompressedFormat(TextureCompression compression, bool srgb);
+
+// encodes every level of an rgba8 chain into 4x4 blocks, levels smaller than a block are padded with their edge
+// texels. blocks are split over the pool, and the palette search runs four texels at a time with sse2.
+// BC7 uses the single subset modes only: 6 (one rgba line) and, where alpha varies apart from color, 5
+TextureData CompressTexture(const TextureData& texture, TextureCompression compression,
+    core::thread::ThreadPool& pool = core::thread::ThreadPool::get_singleton());
+
+// expands one level of a compressed chain back to rgba8. BC5 leaves blue at 0 and alpha opaque, and BC7
+// blocks must be in the modes CompressTexture writes
+std::vector<uint8_t> DecompressLevel(const TextureData& texture, uint32_t level);
+
+// peak signal to noise ratio of a compressed level against the same level of its source, in dB over the
+// channels the format keeps: rg for BC5, rgba otherwise, leaving out the color of texels BC1 cut out
+double CompressionPsnr(const TextureData& source, const TextureData& compressed, uint32_t level = 0);
+
+// logs encode throughput and level 0 psnr of each format for one image
+void BenchmarkTextureCompression(const std::string& filepath, uint32_t iterations = 3);
+
+} // namespace engine::import
+
+#endif // engine_import_TEXTURE_COMPRESS_HPP
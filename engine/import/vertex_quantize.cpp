@@ -0,0 +1,210 @@
+#include "vertex_quantize.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace engine::import {
+
+namespace {
+
+// attribute offsets stay 4 byte aligned, which every vertex fetch path handles at full rate
+uint32_t AlignAttribute(uint32_t offset) {
+    return (offset + 3u) & ~3u;
+}
+
+uint16_t ToUnorm16(float value) {
+    return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+int16_t ToSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+uint32_t PositionSize(PositionEncoding encoding) {
+    return encoding == PositionEncoding::FLOAT ? 3 * sizeof(float) : 4 * sizeof(uint16_t);
+}
+
+} // namespace
+
+glm::mat4 PositionDequantization::transform() const {
+    glm::mat4 m(scale);
+    m[3] = glm::vec4(offset, 1.0f);
+    return m;
+}
+
+std::vector<core::graphics::VertexBindingDescription> QuantizedVertexLayout(const VertexQuantization& quantization) {
+    using VF = core::graphics::VertexFormat;
+
+    VF position_format = VF::FLOAT_3;
+    if (quantization.position == PositionEncoding::HALF) position_format = VF::HALF_4;
+    if (quantization.position == PositionEncoding::UNORM16) position_format = VF::UNORM16_4;
+
+    uint32_t position_size = AlignAttribute(PositionSize(quantization.position));
+    uint32_t normal_size = quantization.octahedral_normals ? 2 * sizeof(int16_t) : 3 * sizeof(float);
+    uint32_t texcoord_size = quantization.half_texcoords ? 2 * sizeof(uint16_t) : 2 * sizeof(float);
+
+    // normal and texcoord follow the position, or start their own stream
+    uint32_t normal_offset = quantization.split_positions ? 0 : position_size;
+    uint32_t texcoord_offset = normal_offset + normal_size;
+    uint32_t attributes_stride = AlignAttribute(texcoord_offset + texcoord_size);
+
+    std::vector<core::graphics::VertexBindingDescription> layout;
+    if (quantization.split_positions) {
+        layout.emplace_back().set_binding(0).set_stride(position_size).add_attribute(0, position_format, 0);
+        layout.emplace_back().set_binding(1).set_stride(attributes_stride);
+    } else {
+        layout.emplace_back().set_binding(0).set_stride(attributes_stride).add_attribute(0, position_format, 0);
+    }
+    layout.back()
+        .add_attribute(1, quantization.octahedral_normals ? VF::SNORM16_2 : VF::FLOAT_3, normal_offset)
+        .add_attribute(2, quantization.half_texcoords ? VF::HALF_2 : VF::FLOAT_2, texcoord_offset);
+    return layout;
+}
+
+QuantizedVertices QuantizeVertices(const std::vector<ObjVertex>& vertices, const VertexQuantization& quantization) {
+    QuantizedVertices out;
+    out.layout = QuantizedVertexLayout(quantization);
+
+    MeshBounds bounds = ComputeMeshBounds(vertices);
+    const glm::vec3 bounds_min = bounds.min;
+    const glm::vec3 bounds_max = bounds.max;
+
+    // half keeps the most precision near zero, so positions are stored relative to the center; unorm
+    // spans the largest extent so one scale covers every axis
+    if (quantization.position == PositionEncoding::HALF) {
+        out.dequantization.offset = (bounds_min + bounds_max) * 0.5f;
+    } else if (quantization.position == PositionEncoding::UNORM16) {
+        glm::vec3 extent = bounds_max - bounds_min;
+        out.dequantization.offset = bounds_min;
+        out.dequantization.scale = std::max({ extent.x, extent.y, extent.z, std::numeric_limits<float>::min() });
+    }
+
+    const core::graphics::VertexBindingDescription& attributes = out.layout.back();
+    const uint32_t position_stride = out.layout.front().stride;
+    const uint32_t attributes_stride = attributes.stride;
+    const uint32_t normal_offset = attributes.attributes[attributes.attributes.size() - 2].offset;
+    const uint32_t texcoord_offset = attributes.attributes.back().offset;
+    const glm::vec3 offset = out.dequantization.offset;
+    const float inverse_scale = 1.0f / out.dequantization.scale;
+
+    for (const core::graphics::VertexBindingDescription& binding : out.layout) {
+        out.streams.emplace_back(vertices.size() * binding.stride, 0);
+    }
+    uint8_t* position_dst = out.streams.front().data();
+    uint8_t* dst = out.streams.back().data();
+    for (const ObjVertex& vertex : vertices) {
+        switch (quantization.position) {
+            case PositionEncoding::FLOAT:
+                std::memcpy(position_dst, &vertex.position, 3 * sizeof(float));
+                break;
+            case PositionEncoding::HALF: {
+                glm::vec3 p = vertex.position - offset;
+                uint16_t packed[4] = { FloatToHalf(p.x), FloatToHalf(p.y), FloatToHalf(p.z), FloatToHalf(1.0f) };
+                std::memcpy(position_dst, packed, sizeof(packed));
+                break;
+            }
+            case PositionEncoding::UNORM16: {
+                glm::vec3 p = (vertex.position - offset) * inverse_scale;
+                uint16_t packed[4] = { ToUnorm16(p.x), ToUnorm16(p.y), ToUnorm16(p.z), 65535 };
+                std::memcpy(position_dst, packed, sizeof(packed));
+                break;
+            }
+        }
+
+        if (quantization.octahedral_normals) {
+            glm::vec2 e = OctahedralEncode(vertex.normal);
+            int16_t packed[2] = { ToSnorm16(e.x), ToSnorm16(e.y) };
+            std::memcpy(dst + normal_offset, packed, sizeof(packed));
+        } else {
+            std::memcpy(dst + normal_offset, &vertex.normal, 3 * sizeof(float));
+        }
+
+        if (quantization.half_texcoords) {
+            uint16_t packed[2] = { FloatToHalf(vertex.texcoord.x), FloatToHalf(vertex.texcoord.y) };
+            std::memcpy(dst + texcoord_offset, packed, sizeof(packed));
+        } else {
+            std::memcpy(dst + texcoord_offset, &vertex.texcoord, 2 * sizeof(float));
+        }
+
+        // with one stream both cursors walk the same bytes
+        position_dst += position_stride;
+        dst += attributes_stride;
+    }
+
+    return out;
+}
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    bits &= 0x7FFFFFFFu;
+
+    uint32_t half;
+    if (bits >= 0x47800000u) {
+        // too large for a half becomes infinity, nan stays a quiet nan
+        half = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+    } else if (bits < 0x38800000u) {
+        // subnormal or zero: adding 0.5 lines the ten mantissa bits up at the bottom and the fpu rounds them
+        float magic;
+        const uint32_t magic_bits = 126u << 23;
+        std::memcpy(&magic, &magic_bits, sizeof(magic));
+        float shifted;
+        std::memcpy(&shifted, &bits, sizeof(shifted));
+        shifted += magic;
+        std::memcpy(&half, &shifted, sizeof(half));
+        half -= magic_bits;
+    } else {
+        // rebias the exponent and round the 13 dropped bits to nearest even
+        const uint32_t odd = (bits >> 13) & 1u;
+        bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFFu + odd;
+        half = bits >> 13;
+    }
+    return static_cast<uint16_t>(half | sign);
+}
+
+float HalfToFloat(uint16_t value) {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1Fu;
+    const uint32_t mantissa = value & 0x3FFu;
+
+    if (exponent == 0) {
+        float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -magnitude : magnitude;
+    }
+
+    uint32_t bits = sign | (mantissa << 13);
+    bits |= (exponent == 0x1Fu) ? 0x7F800000u : (exponent + 112u) << 23;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+glm::vec2 OctahedralEncode(const glm::vec3& normal) {
+    float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (l1 <= 0.0f) return glm::vec2(0.0f, 0.0f);
+
+    float x = normal.x / l1;
+    float y = normal.y / l1;
+    if (normal.z < 0.0f) {
+        // fold the lower hemisphere over the diagonals
+        float folded_x = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float folded_y = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = folded_x;
+        y = folded_y;
+    }
+    return glm::vec2(x, y);
+}
+
+glm::vec3 OctahedralDecode(const glm::vec2& encoded) {
+    glm::vec3 n(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+    float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    float length = glm::length(n);
+    return length > 0.0f ? n * (1.0f / length) : glm::vec3(0.0f, 0.0f, 1.0f);
+}
+
+} // namespace engine::import
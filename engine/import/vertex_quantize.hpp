@@ -0,0 +1,76 @@
+#ifndef engine_import_VERTEX_QUANTIZE_HPP
+#define engine_import_VERTEX_QUANTIZE_HPP
+
+#include "mesh.hpp"
+
+#include "engine/core/graphics/vertex_types.hpp"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+namespace engine::import {
+
+enum class PositionEncoding {
+    FLOAT,      // FLOAT_3, 12 bytes
+    HALF,       // HALF_4 relative to the bounds center, 8 bytes
+    UNORM16     // UNORM16_4 across the bounds, 8 bytes
+};
+
+// how ObjVertex is packed for the gpu. the default is the compact layout: 16 bytes a vertex instead of 32
+struct VertexQuantization {
+    PositionEncoding position = PositionEncoding::UNORM16;
+    bool octahedral_normals = true;     // SNORM16_2 instead of FLOAT_3
+    bool half_texcoords = true;         // HALF_2 instead of FLOAT_2
+    // positions alone in stream 0 and the other attributes in stream 1, so depth, pick and shadow passes
+    // fetch only the position stream
+    bool split_positions = false;
+
+    // the plain ObjVertex layout
+    static constexpr VertexQuantization None() { return { PositionEncoding::FLOAT, false, false, false }; }
+
+    bool is_none() const { return *this == None(); }
+
+    bool operator==(const VertexQuantization& other) const noexcept {
+        return position == other.position &&
+            octahedral_normals == other.octahedral_normals &&
+            half_texcoords == other.half_texcoords &&
+            split_positions == other.split_positions;
+    }
+};
+
+// position = offset + scale * stored. the scale is uniform so folding transform() into the model matrix
+// leaves normals transformed by that matrix correct
+struct PositionDequantization {
+    glm::vec3 offset = glm::vec3(0.0f);
+    float scale = 1.0f;
+
+    glm::mat4 transform() const;
+};
+
+// one byte stream per binding of layout
+struct QuantizedVertices {
+    std::vector<std::vector<uint8_t>> streams;
+    std::vector<core::graphics::VertexBindingDescription> layout;
+    PositionDequantization dequantization;
+};
+
+// position at location 0, normal at 1, texcoord at 2, the same locations the float layout uses. binding i of
+// the result reads stream i; with split_positions, binding 0 alone is the layout for position-only pipelines
+std::vector<core::graphics::VertexBindingDescription> QuantizedVertexLayout(const VertexQuantization& quantization);
+
+// dequantization is derived from the bounds of vertices, so every submesh packed in one call shares it
+QuantizedVertices QuantizeVertices(const std::vector<ObjVertex>& vertices, const VertexQuantization& quantization);
+
+// ieee binary16, round to nearest even
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+
+// unit vector to [-1, 1]^2 and back, a zero vector encodes as +z
+glm::vec2 OctahedralEncode(const glm::vec3& normal);
+glm::vec3 OctahedralDecode(const glm::vec2& encoded);
+
+} // namespace engine::import
+
+#endif // engine_import_VERTEX_QUANTIZE_HPP